@@ -0,0 +1,104 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_ARENA_H
+#  define __STUMPLESS_PRIVATE_ARENA_H
+
+#  include <stdarg.h>
+#  include <stddef.h>
+#  include <stumpless/arena.h>
+
+/*
+ * Each of the arena memory functions takes the arena that the memory belongs
+ * to as the first argument. If this is NULL, then the memory comes from the
+ * heap instead and the function behaves like its counterpart in memory.h or
+ * strhelper.h. This allows objects to use the same code regardless of where
+ * they were created.
+ */
+
+/**
+ * A block of memory in an arena. The memory available for allocations follows
+ * directly after this header.
+ *
+ * @since release v2.2.0
+ */
+struct arena_block {
+/** The next block in the arena, or NULL if this is the last one. */
+  struct arena_block *next;
+/** The number of bytes available for allocations in this block. */
+  size_t size;
+};
+
+/**
+ * Allocates memory from an arena, or from the heap if arena is NULL.
+ *
+ * @since release v2.2.0
+ */
+void *
+arena_alloc_mem( struct stumpless_arena *arena, size_t size );
+
+/**
+ * Copies a NULL-terminated string into an arena, or onto the heap if arena is
+ * NULL, and stores its length (without the NULL terminator) in length.
+ *
+ * @since release v2.2.0
+ */
+char *
+arena_copy_cstring_with_length( struct stumpless_arena *arena,
+                                const char *str,
+                                size_t *length );
+
+/**
+ * Formats a string into an arena, or onto the heap if arena is NULL, and stores
+ * its length (without the NULL terminator) in length.
+ *
+ * @since release v2.2.0
+ */
+char *
+arena_format_string( struct stumpless_arena *arena,
+                     const char *format,
+                     va_list subs,
+                     size_t *length );
+
+/**
+ * Frees memory allocated from the heap if arena is NULL, passing size on to
+ * the memory deallocation function as free_sized_mem does. Memory allocated
+ * from an arena is only released when the arena is reset or destroyed, so in
+ * this case nothing is done.
+ *
+ * @since release v2.2.0
+ */
+void
+arena_free_mem( const struct stumpless_arena *arena,
+                const void *mem,
+                size_t size );
+
+/**
+ * Resizes memory allocated with arena_alloc_mem. If the memory is the most
+ * recent allocation in the arena it is grown in place where possible, and
+ * otherwise a new region is allocated and old_size bytes are copied to it.
+ *
+ * @since release v2.2.0
+ */
+void *
+arena_realloc_mem( struct stumpless_arena *arena,
+                   void *mem,
+                   size_t old_size,
+                   size_t size );
+
+#endif /* __STUMPLESS_PRIVATE_ARENA_H */
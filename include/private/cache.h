@@ -21,6 +21,7 @@
 
 #  include <stddef.h>
 #  include <stumpless/config.h>
+#  include <stumpless/memory.h>
 #  include "private/config/wrapper/thread_safety.h"
 
 struct cache {
@@ -87,6 +88,9 @@ cache_destroy( const struct cache *c );
 void
 cache_free( const struct cache *c, const void *entry );
 
+void
+cache_get_usage( const struct cache *c, struct stumpless_memory_usage *usage );
+
 /**
  * **Thread Safety: MT-Safe**
  * This function is thread safe as it does not expose resources that need to
@@ -19,7 +19,18 @@
 #ifndef __STUMPLESS_PRIVATE_CONFIG_FALLBACK_H
 #  define __STUMPLESS_PRIVATE_CONFIG_FALLBACK_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
+
+/** No writes are assumed to be atomic appends without a lock. */
+#define FALLBACK_ATOMIC_APPEND_SIZE 0
+
+int
+fallback_close_fd( int fd );
+
+unsigned long long
+fallback_get_monotonic_milliseconds( void );
 
 int
 fallback_gethostname( char *buffer, size_t namelen );
@@ -30,4 +41,22 @@ fallback_getpagesize( void );
 int
 fallback_getpid( void );
 
+int
+fallback_open_append_fd( const char *filename );
+
+int
+fallback_reopen_append_fd( int fd, const char *filename );
+
+int
+fallback_sync_fd( int fd );
+
+int
+fallback_sync_stream( FILE *stream );
+
+bool
+fallback_write_fd( int fd, const char *buffer, size_t size );
+
+bool
+fallback_write_stream( FILE *stream, const char *buffer, size_t size );
+
 #endif /* __STUMPLESS_PRIVATE_CONFIG_FALLBACK_H */
@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Compact locks built directly on Linux futexes. Each lock is a single
+ * unsigned int that can be embedded in the structure it protects, and the
+ * uncontended lock and unlock paths are a single atomic operation that never
+ * enters the kernel.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_CONFIG_FUTEX_LOCKS_SUPPORTED_H
+#  define __STUMPLESS_PRIVATE_CONFIG_FUTEX_LOCKS_SUPPORTED_H
+
+/**
+ * Initializes a lock word to the unlocked state. This is valid for both mutex
+ * and reader-writer locks.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe, and should only be used on a lock that is
+ * not yet visible to other threads.
+ *
+ * **Async Signal Safety: AS-Safe**
+ * This function is safe to call from signal handlers.
+ *
+ * **Async Cancel Safety: AC-Safe**
+ * This function is safe to call from threads that may be asynchronously
+ * cancelled.
+ *
+ * @since release v2.2.0
+ *
+ * @param lock The lock word to initialize.
+ */
+void
+futex_init_lock( unsigned int *lock );
+
+void
+futex_lock_mutex( const unsigned int *mutex );
+
+void
+futex_read_lock_rwlock( const unsigned int *rwlock );
+
+void
+futex_read_unlock_rwlock( const unsigned int *rwlock );
+
+void
+futex_unlock_mutex( const unsigned int *mutex );
+
+void
+futex_write_lock_rwlock( const unsigned int *rwlock );
+
+void
+futex_write_unlock_rwlock( const unsigned int *rwlock );
+
+#endif /* __STUMPLESS_PRIVATE_CONFIG_FUTEX_LOCKS_SUPPORTED_H */
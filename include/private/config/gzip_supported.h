@@ -0,0 +1,163 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * Writers that compress messages with zlib and append them to a file
+ * descriptor as a series of gzip members.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_CONFIG_GZIP_SUPPORTED_H
+#  define __STUMPLESS_PRIVATE_CONFIG_GZIP_SUPPORTED_H
+
+#  include <stdbool.h>
+#  include <stddef.h>
+#  include <zlib.h>
+
+/**
+ * The size of the buffer that compressed output is collected in before it is
+ * written to the file.
+ */
+#  define GZIP_OUTPUT_SIZE 16384
+
+/**
+ * A zlib stream and the buffer that its output is collected in.
+ *
+ * Messages are compressed into the current gzip member until the writer is
+ * flushed, which finishes the member so that everything written so far can be
+ * read from the file. Concatenated gzip members form a single valid gzip
+ * file, so the next message simply starts a new member.
+ *
+ * Writers are not thread safe: callers must serialize all use of a writer
+ * themselves.
+ */
+struct gzip_writer {
+/** The zlib stream that messages are compressed with. */
+  z_stream stream;
+/** The file descriptor that compressed output is written to. */
+  int fd;
+/** The buffer of GZIP_OUTPUT_SIZE bytes that output is collected in. */
+  char *output;
+/** True if messages have been added since the last member was finished. */
+  bool pending;
+};
+
+/**
+ * Destroys a writer, finishing its current member and writing it first.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe as it destroys resources that other threads
+ * would use if they tried to reference this writer.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of the
+ * memory deallocation function.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory deallocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param writer The writer to destroy.
+ */
+void
+destroy_gzip_writer( struct gzip_writer *writer );
+
+/**
+ * Finishes the current gzip member and writes all of the output held by the
+ * writer to the file. Nothing is written if no messages have been added since
+ * the last flush.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe. Callers must make sure that no other
+ * thread uses the writer at the same time.
+ *
+ * **Async Signal Safety: AS-Unsafe**
+ * This function is not safe to call from signal handlers, as the writer may
+ * be in an inconsistent state.
+ *
+ * **Async Cancel Safety: AC-Unsafe**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the writer may be left in an inconsistent state.
+ *
+ * @since release v2.2.0
+ *
+ * @param writer The writer to flush.
+ *
+ * @return 0 if the output was written, or -1 if an error is encountered.
+ */
+int
+flush_gzip_writer( struct gzip_writer *writer );
+
+/**
+ * Creates a writer for a file descriptor.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory allocation functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory allocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param fd The file descriptor to write to, opened for appending.
+ *
+ * @param level The zlib compression level, from 1 to 9, or
+ * Z_DEFAULT_COMPRESSION.
+ *
+ * @return The new writer, or NULL if an error is encountered.
+ */
+struct gzip_writer *
+new_gzip_writer( int fd, int level );
+
+/**
+ * Compresses a message into the current member. Compressed output is written
+ * to the file whenever the output buffer fills.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe. Callers must make sure that no other
+ * thread uses the writer at the same time.
+ *
+ * **Async Signal Safety: AS-Unsafe**
+ * This function is not safe to call from signal handlers, as the writer may
+ * be in an inconsistent state.
+ *
+ * **Async Cancel Safety: AC-Unsafe**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the writer may be left in an inconsistent state.
+ *
+ * @since release v2.2.0
+ *
+ * @param writer The writer to add the message to.
+ *
+ * @param msg The message to compress.
+ *
+ * @param msg_length The length of the message in bytes.
+ *
+ * @return 0 if the message was compressed, or -1 if an error is encountered.
+ */
+int
+send_to_gzip_writer( struct gzip_writer *writer,
+                     const char *msg,
+                     size_t msg_length );
+
+#endif /* __STUMPLESS_PRIVATE_CONFIG_GZIP_SUPPORTED_H */
@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_CONFIG_GZIP_UNSUPPORTED_H
+#  define __STUMPLESS_PRIVATE_CONFIG_GZIP_UNSUPPORTED_H
+
+struct gzip_writer;
+
+/**
+ * Raises an error, as gzip writers are not supported by this build.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe.
+ *
+ * **Async Signal Safety: AS-Unsafe**
+ * This function is not safe to call from signal handlers, as raising an error
+ * is not signal safe.
+ *
+ * **Async Cancel Safety: AC-Safe**
+ * This function is safe to call from threads that may be asynchronously
+ * cancelled.
+ *
+ * @since release v2.2.0
+ *
+ * @param fd Ignored.
+ *
+ * @param level Ignored.
+ *
+ * @return Always NULL.
+ */
+struct gzip_writer *
+no_gzip_new_writer( int fd, int level );
+
+#endif /* __STUMPLESS_PRIVATE_CONFIG_GZIP_UNSUPPORTED_H */
@@ -19,9 +19,17 @@
 #ifndef __STUMPLESS_PRIVATE_CONFIG_HAVE_GMTIME_R_H
 #  define __STUMPLESS_PRIVATE_CONFIG_HAVE_GMTIME_R_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <time.h>
+
+size_t
+gmtime_r_format_time( char *buffer, const struct timespec *time );
 
 size_t
 gmtime_r_get_now( char *buffer );
 
+bool
+gmtime_r_get_time( struct timespec *time );
+
 #endif /* __STUMPLESS_PRIVATE_CONFIG_HAVE_GMTIME_R_H */
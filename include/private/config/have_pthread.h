@@ -20,17 +20,67 @@
 #  define __STUMPLESS_PRIVATE_CONFIG_HAVE_PTHREAD_H
 
 #  include <pthread.h>
+#  include <stdbool.h>
+
+void
+pthread_broadcast_cond( pthread_cond_t *cond );
+
+void
+pthread_destroy_cond( pthread_cond_t *cond );
 
 void
 pthread_destroy_mutex( const pthread_mutex_t *mutex );
 
+void
+pthread_destroy_rwlock( const pthread_rwlock_t *rwlock );
+
+void
+pthread_init_cond( pthread_cond_t *cond );
+
 void
 pthread_init_mutex( pthread_mutex_t *mutex );
 
+void
+pthread_init_rwlock( pthread_rwlock_t *rwlock );
+
 void
 pthread_lock_mutex( const pthread_mutex_t *mutex );
 
+void
+pthread_read_lock_rwlock( const pthread_rwlock_t *rwlock );
+
+void
+pthread_signal_cond( pthread_cond_t *cond );
+
+/**
+ * Waits on a condition variable until it is signalled or the given deadline
+ * passes. The deadline is in milliseconds of the monotonic clock, as returned
+ * by config_get_monotonic_milliseconds.
+ *
+ * @param cond The condition variable to wait on.
+ *
+ * @param mutex The mutex protecting the condition, which must be held.
+ *
+ * @param deadline The time after which waiting stops.
+ *
+ * @return false if the deadline passed before the condition was signalled,
+ * true otherwise.
+ */
+bool
+pthread_timed_wait_cond( pthread_cond_t *cond,
+                         const pthread_mutex_t *mutex,
+                         unsigned long long deadline );
+
 void
 pthread_unlock_mutex( const pthread_mutex_t *mutex );
 
+void
+pthread_unlock_rwlock( const pthread_rwlock_t *rwlock );
+
+void
+pthread_wait_cond( pthread_cond_t *cond, const pthread_mutex_t *mutex );
+
+void
+pthread_write_lock_rwlock( const pthread_rwlock_t *rwlock );
+
 #endif /* __STUMPLESS_PRIVATE_CONFIG_HAVE_PTHREAD_H */
@@ -21,6 +21,10 @@
 
 #  include <stdatomic.h>
 #  include <stdbool.h>
+#  include <stddef.h>
+
+size_t
+stdatomic_add_size( size_t *s, size_t n );
 
 bool
 stdatomic_compare_exchange_bool( atomic_bool *b,
@@ -32,16 +36,43 @@ stdatomic_compare_exchange_ptr( atomic_uintptr_t *p,
                                 const void *expected,
                                 const void *replacement );
 
+size_t
+stdatomic_decrement_size( size_t *s );
+
+size_t
+stdatomic_increment_size( size_t *s );
+
 bool
 stdatomic_read_bool( atomic_bool *b );
 
+bool
+stdatomic_read_flag( const bool *flag );
+
+int
+stdatomic_read_int( const int *i );
+
 void *
 stdatomic_read_ptr( atomic_uintptr_t *p );
 
+size_t
+stdatomic_read_size( size_t *s );
+
+size_t
+stdatomic_subtract_size( size_t *s, size_t n );
+
 void
 stdatomic_write_bool( atomic_bool *b, bool replacement );
 
+void
+stdatomic_write_flag( bool *flag, bool replacement );
+
+void
+stdatomic_write_int( int *i, int replacement );
+
 void
 stdatomic_write_ptr( atomic_uintptr_t *p, void *replacement );
 
+void
+stdatomic_write_size( size_t *s, size_t replacement );
+
 #endif /* __STUMPLESS_PRIVATE_CONFIG_HAVE_STDATOMIC_H */
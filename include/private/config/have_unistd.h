@@ -19,6 +19,45 @@
 #ifndef __STUMPLESS_PRIVATE_CONFIG_HAVE_UNISTD_H
 #  define __STUMPLESS_PRIVATE_CONFIG_HAVE_UNISTD_H
 
+#  include <limits.h>
+#  include <stdbool.h>
+#  include <stddef.h>
+#  include <stdio.h>
+
+/**
+ * The largest write that is appended to a file as a single unit, without being
+ * interleaved with writes from other threads or processes.
+ */
+#  ifdef PIPE_BUF
+#    define UNISTD_ATOMIC_APPEND_SIZE PIPE_BUF
+#  else
+#    define UNISTD_ATOMIC_APPEND_SIZE _POSIX_PIPE_BUF
+#  endif
+
+int
+unistd_close_fd( int fd );
+
+unsigned long long
+unistd_get_monotonic_milliseconds( void );
+
 int unistd_getpid( void );
 
+int
+unistd_open_append_fd( const char *filename );
+
+int
+unistd_reopen_append_fd( int fd, const char *filename );
+
+int
+unistd_sync_fd( int fd );
+
+int
+unistd_sync_stream( FILE *stream );
+
+bool
+unistd_write_fd( int fd, const char *buffer, size_t size );
+
+bool
+unistd_write_stream( FILE *stream, const char *buffer, size_t size );
+
 #endif /* __STUMPLESS_PRIVATE_CONFIG_HAVE_UNISTD_H */
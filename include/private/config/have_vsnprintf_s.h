@@ -25,4 +25,10 @@
 char *
 vsnprintf_s_format_string( const char *format, va_list subs, size_t *length );
 
+int
+vsnprintf_s_format_string_into( char *buffer,
+                                size_t size,
+                                const char *format,
+                                va_list subs );
+
 #endif /* __STUMPLESS_PRIVATE_CONFIG_HAVE_VSNPRINTF_S_H */
@@ -21,21 +21,43 @@
 
 #  include <stdbool.h>
 #  include <stddef.h>
+#  include <stdio.h>
 #  include "private/windows_wrapper.h"
 
+/**
+ * Appends to files on Windows are not guaranteed to be atomic, so all writes
+ * are serialized.
+ */
+#  define WINDOWS_ATOMIC_APPEND_SIZE 0
+
+size_t
+windows_add_size( size_t *s, size_t n );
+
 bool
 windows_compare_exchange_bool( LONG volatile *b,
                                LONG expected,
                                LONG replacement );
 
+void
+windows_broadcast_cond( PCONDITION_VARIABLE cond );
+
 bool
 windows_compare_exchange_ptr( PVOID volatile *p,
                               const void *expected,
                               PVOID replacement );
 
+size_t
+windows_decrement_size( size_t *s );
+
+int
+windows_close_fd( int fd );
+
 void
 windows_destroy_mutex( const CRITICAL_SECTION *mutex );
 
+unsigned long long
+windows_get_monotonic_milliseconds( void );
+
 int
 windows_gethostname( char *buffer, size_t namelen );
 
@@ -45,13 +67,84 @@ windows_getpagesize( void );
 int
 windows_getpid( void );
 
+size_t
+windows_increment_size( size_t *s );
+
+void
+windows_init_cond( PCONDITION_VARIABLE cond );
+
 void
 windows_init_mutex( LPCRITICAL_SECTION mutex );
 
+void
+windows_init_rwlock( PSRWLOCK rwlock );
+
 void
 windows_lock_mutex( const CRITICAL_SECTION *mutex );
 
+int
+windows_open_append_fd( const char *filename );
+
+void
+windows_read_lock_rwlock( const SRWLOCK *rwlock );
+
+int
+windows_reopen_append_fd( int fd, const char *filename );
+
+void
+windows_read_unlock_rwlock( const SRWLOCK *rwlock );
+
+void
+windows_signal_cond( PCONDITION_VARIABLE cond );
+
+size_t
+windows_subtract_size( size_t *s, size_t n );
+
+int
+windows_sync_fd( int fd );
+
+int
+windows_sync_stream( FILE *stream );
+
+/**
+ * Waits on a condition variable until it is woken or the given deadline
+ * passes. The deadline is in milliseconds, as returned by
+ * windows_get_monotonic_milliseconds.
+ *
+ * @param cond The condition variable to wait on.
+ *
+ * @param mutex The critical section protecting the condition, which must be
+ * held.
+ *
+ * @param deadline The time after which waiting stops.
+ *
+ * @return false if the deadline passed before the condition was woken, true
+ * otherwise.
+ */
+bool
+windows_timed_wait_cond( PCONDITION_VARIABLE cond,
+                         const CRITICAL_SECTION *mutex,
+                         unsigned long long deadline );
+
 void
 windows_unlock_mutex( const CRITICAL_SECTION *mutex );
 
+void
+windows_wait_cond( PCONDITION_VARIABLE cond, const CRITICAL_SECTION *mutex );
+
+void
+windows_write_lock_rwlock( const SRWLOCK *rwlock );
+
+bool
+windows_write_fd( int fd, const char *buffer, size_t size );
+
+bool
+windows_write_stream( FILE *stream, const char *buffer, size_t size );
+
+void
+windows_write_size( size_t *s, size_t replacement );
+
+void
+windows_write_unlock_rwlock( const SRWLOCK *rwlock );
+
 #endif /* __STUMPLESS_PRIVATE_CONFIG_HAVE_WINDOWS_H */
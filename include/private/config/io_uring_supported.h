@@ -0,0 +1,229 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Writers that queue messages for a file descriptor on a Linux io_uring
+ * instance instead of writing them with a system call each. The ring is set up
+ * directly with the io_uring system calls, without liburing.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_CONFIG_IO_URING_SUPPORTED_H
+#  define __STUMPLESS_PRIVATE_CONFIG_IO_URING_SUPPORTED_H
+
+#  include <linux/io_uring.h>
+#  include <stdbool.h>
+#  include <stddef.h>
+#  include <stumpless/memory.h>
+
+/**
+ * The size of each registered buffer that a queued message is copied into.
+ * Longer messages are written directly once the queue has been drained.
+ */
+#  define IO_URING_SLOT_SIZE 4096
+
+/**
+ * A ring and the registered buffers that messages are copied into while their
+ * writes are in progress. Each buffer slot holds a single message.
+ *
+ * Writers are not thread safe: callers must serialize all use of a writer
+ * themselves.
+ */
+struct io_uring_writer {
+/** The file descriptor of the ring. */
+  int ring_fd;
+/** The file descriptor that messages are written to. */
+  int fd;
+/** The number of buffer slots, which is also the most writes in progress. */
+  unsigned int depth;
+/** The number of writes to queue before submitting them to the kernel. */
+  unsigned int batch_size;
+/** The mapping of the submission queue ring. */
+  void *sq_ring;
+/** The size of the sq_ring mapping. */
+  size_t sq_ring_size;
+/** The mapping of the completion queue ring, which may be sq_ring. */
+  void *cq_ring;
+/** The size of the cq_ring mapping. */
+  size_t cq_ring_size;
+/** The mapping of the submission queue entries. */
+  struct io_uring_sqe *sqes;
+/** The size of the sqes mapping. */
+  size_t sqes_size;
+/** The head of the submission queue, advanced by the kernel. */
+  unsigned int *sq_head;
+/** The tail of the submission queue, advanced by the writer. */
+  unsigned int *sq_tail;
+/** The mask applied to submission queue positions. */
+  unsigned int sq_mask;
+/** The indirection array of the submission queue. */
+  unsigned int *sq_array;
+/** The head of the completion queue, advanced by the writer. */
+  unsigned int *cq_head;
+/** The tail of the completion queue, advanced by the kernel. */
+  unsigned int *cq_tail;
+/** The mask applied to completion queue positions. */
+  unsigned int cq_mask;
+/** The completion queue entries. */
+  struct io_uring_cqe *cqes;
+/** The buffer slots, each IO_URING_SLOT_SIZE bytes long. */
+  char *buffers;
+/** True if buffers are registered with the ring for fixed writes. */
+  bool registered;
+/** The length of the message in each slot that is in use. */
+  size_t *lengths;
+/** The indexes of the slots that are not in use. */
+  unsigned int *free_slots;
+/** The number of indexes in free_slots. */
+  unsigned int free_count;
+/** The number of writes queued that have not been submitted yet. */
+  unsigned int unsubmitted;
+/** The number of writes submitted that have not been completed yet. */
+  unsigned int in_flight;
+/**
+ * The error code of a write that failed since the last one was reported, or
+ * zero if none have failed.
+ */
+  int write_error;
+};
+
+/**
+ * Destroys a writer, waiting for all of its messages to be written first.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe as it destroys resources that other threads
+ * would use if they tried to reference this writer.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of the
+ * memory deallocation function.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory deallocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param writer The writer to destroy.
+ */
+void
+destroy_io_uring_writer( struct io_uring_writer *writer );
+
+/**
+ * Submits any queued messages and waits for all writes in progress to finish.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe. Callers must make sure that no other
+ * thread uses the writer at the same time.
+ *
+ * **Async Signal Safety: AS-Unsafe**
+ * This function is not safe to call from signal handlers, as the writer may
+ * be in an inconsistent state.
+ *
+ * **Async Cancel Safety: AC-Unsafe**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the writer may be left in an inconsistent state.
+ *
+ * @since release v2.2.0
+ *
+ * @param writer The writer to flush.
+ *
+ * @return 0 if every message was written, or -1 if any write failed since the
+ * last failure was reported, in which case an error is raised.
+ */
+int
+flush_io_uring_writer( struct io_uring_writer *writer );
+
+/**
+ * Adds the memory held by all writers to the given usage.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. Atomic reads are used to get the usage.
+ *
+ * **Async Signal Safety: AS-Safe**
+ * This function is safe to call from signal handlers.
+ *
+ * **Async Cancel Safety: AC-Safe**
+ * This function is safe to call from threads that may be asynchronously
+ * cancelled.
+ *
+ * @since release v2.2.0
+ *
+ * @param usage The usage to add to.
+ */
+void
+io_uring_get_usage( struct stumpless_memory_usage *usage );
+
+/**
+ * Creates a writer for a file descriptor.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory allocation functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory allocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param fd The file descriptor to write to. This must be a regular file
+ * opened for appending.
+ *
+ * @param depth The number of messages that may be in progress at once.
+ *
+ * @return The new writer, or NULL if an error is encountered.
+ */
+struct io_uring_writer *
+new_io_uring_writer( int fd, unsigned int depth );
+
+/**
+ * Queues a message to be written. The message is copied, and queued messages
+ * are submitted to the kernel in batches.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe. Callers must make sure that no other
+ * thread uses the writer at the same time.
+ *
+ * **Async Signal Safety: AS-Unsafe**
+ * This function is not safe to call from signal handlers, as the writer may
+ * be in an inconsistent state.
+ *
+ * **Async Cancel Safety: AC-Unsafe**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the writer may be left in an inconsistent state.
+ *
+ * @since release v2.2.0
+ *
+ * @param writer The writer to queue the message on.
+ *
+ * @param msg The message to write.
+ *
+ * @param msg_length The length of the message in bytes.
+ *
+ * @return 0 if the message was queued, or -1 if an earlier write failed or
+ * the message could not be queued, in which case an error is raised.
+ */
+int
+send_to_io_uring_writer( struct io_uring_writer *writer,
+                         const char *msg,
+                         size_t msg_length );
+
+#endif /* __STUMPLESS_PRIVATE_CONFIG_IO_URING_SUPPORTED_H */
@@ -49,9 +49,15 @@
 #  define L10N_FILE_OPEN_FAILURE_ERROR_MESSAGE \
 "FILE OPEN FAILURE MESSAGE"
 
+#  define L10N_FILE_ROTATION_FAILURE_ERROR_MESSAGE \
+"FILE ROTATION FAILURE ERROR MESSAGE"
+
 #  define L10N_FILE_WRITE_FAILURE_ERROR_MESSAGE \
 "FILE WRITE FAILURE MESSAGE"
 
+#  define L10N_FORMAT_FAILURE_ERROR_MESSAGE \
+"FORMAT FAILURE ERROR MESSAGE"
+
 #  define L10N_FUNCTION_TARGET_FAILURE_CODE_TYPE \
 "върната стойност от фунцията манипулатор на логове"
 
@@ -76,6 +82,12 @@
 #  define L10N_GETLASTERROR_ERROR_CODE_TYPE \
 "резултатът от GetLastError след неуспешното извикване"
 
+#  define L10N_GZIP_FAILURE_ERROR_MESSAGE \
+"GZIP FAILURE ERROR MESSAGE"
+
+#  define L10N_GZIP_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"GZIP FILES UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_INDEX_OUT_OF_BOUNDS_ERROR_CODE_TYPE \
 "невалиден индекс или -1, ако е твърде голям за да бъде представен, като int"
 
@@ -99,6 +111,15 @@
 "нивата на тежест трябва да бъдат дефинирани в съответствие с RFC 5424: стойности между 0" \
 " и 7 включително"
 
+#  define L10N_IO_URING_FAILURE_ERROR_MESSAGE \
+"IO URING FAILURE ERROR MESSAGE"
+
+#  define L10N_IO_URING_REGULAR_FILE_ONLY_ERROR_MESSAGE \
+"IO URING REGULAR FILE ONLY ERROR MESSAGE"
+
+#  define L10N_IO_URING_UNSUPPORTED_ERROR_MESSAGE \
+"IO URING UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_JOURNALD_FAILURE_ERROR_CODE_TYPE \
 "JOURNALD FAILURE ERROR CODE"
 
@@ -114,6 +135,9 @@
 #  define L10N_MESSAGE_TOO_BIG_FOR_DATAGRAM_ERROR_MESSAGE \
 "съобщението е твърде голямо, за да бъде изпратено в една дейтаграма"
 
+#  define L10N_MESSAGE_TOO_BIG_FOR_SEGMENT_ERROR_MESSAGE \
+"MESSAGE TOO BIG FOR SEGMENT ERROR MESSAGE"
+
 #  define L10N_MESSAGE_SIZE_ERROR_CODE_TYPE \
 "размер на съобщението, което беше опитано да се изпрати"
 
@@ -126,12 +150,21 @@
 #  define L10N_NULL_ARG_ERROR_MESSAGE( ARG_NAME ) \
 ARG_NAME " беше NULL"
 
+#  define L10N_OBJECT_FROZEN_ERROR_MESSAGE \
+"OBJECT FROZEN ERROR MESSAGE"
+
 #  define L10N_OPEN_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "опит да се отвори неподдържан целеви тип"
 
 #  define L10N_PARAM_NOT_FOUND_ERROR_MESSAGE \
 "не може да бъде намерен параметър с посочените характеристики"
 
+#  define L10N_SEGMENT_FAILURE_ERROR_MESSAGE \
+"SEGMENT FAILURE ERROR MESSAGE"
+
+#  define L10N_SEGMENT_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"SEGMENT FILES UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_SEND_ENTRY_TO_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "опит да се изпрати запис до неподдържан целеви тип"
 
@@ -156,6 +189,9 @@ ARG_NAME " беше NULL"
 #  define L10N_TARGET_ALWAYS_OPEN_ERROR_MESSAGE \
 "този целеви тип е винаги отворен"
 
+#  define L10N_THREAD_FAILURE_ERROR_MESSAGE \
+"THREAD FAILURE ERROR MESSAGE"
+
 #  define L10N_TRANSPORT_PORT_NETWORK_ONLY_ERROR_MESSAGE \
 "транспортните портове са валидни само за мрежови цели"
 
@@ -183,6 +219,9 @@ ARG_NAME " беше NULL"
 #  define L10N_WSAGETLASTERROR_ERROR_CODE_TYPE \
 "резултатът от WSAGetLastError след неуспешното извикване"
 
+#  define L10N_ZLIB_ERROR_CODE_TYPE \
+"ZLIB ERROR CODE TYPE"
+
 #  define L10N_STRING_TOO_LONG_ERROR_MESSAGE \
 "дължината на низа надвишава максималната граница"
 
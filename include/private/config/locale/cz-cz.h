@@ -49,9 +49,15 @@
 #  define L10N_FILE_OPEN_FAILURE_ERROR_MESSAGE \
 "chybové hlášení- nepodařilo se otevřít soubor"
 
+#  define L10N_FILE_ROTATION_FAILURE_ERROR_MESSAGE \
+"FILE ROTATION FAILURE ERROR MESSAGE"
+
 #  define L10N_FILE_WRITE_FAILURE_ERROR_MESSAGE \
 "chybové hlášení- nepodařilo se zapísat"
 
+#  define L10N_FORMAT_FAILURE_ERROR_MESSAGE \
+"FORMAT FAILURE ERROR MESSAGE"
+
 #  define L10N_FUNCTION_TARGET_FAILURE_CODE_TYPE \
 "návratový kód funkce obsluhy protokolu"
 
@@ -76,6 +82,12 @@
 #  define L10N_GETLASTERROR_ERROR_CODE_TYPE \
 "výsledek GetLastError po neúspěšném volání"
 
+#  define L10N_GZIP_FAILURE_ERROR_MESSAGE \
+"GZIP FAILURE ERROR MESSAGE"
+
+#  define L10N_GZIP_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"GZIP FILES UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_INDEX_OUT_OF_BOUNDS_ERROR_CODE_TYPE \
 "neplatný index - index je příliš velký na to aby byl reprezentován jako datový typ int"
 
@@ -97,6 +109,15 @@
 #  define L10N_INVALID_SEVERITY_ERROR_MESSAGE \
 "kód služby musí být definován v souladu s normou RFC 5424: hodnoty mezi 0 a 7 včetně"
 
+#  define L10N_IO_URING_FAILURE_ERROR_MESSAGE \
+"IO URING FAILURE ERROR MESSAGE"
+
+#  define L10N_IO_URING_REGULAR_FILE_ONLY_ERROR_MESSAGE \
+"IO URING REGULAR FILE ONLY ERROR MESSAGE"
+
+#  define L10N_IO_URING_UNSUPPORTED_ERROR_MESSAGE \
+"IO URING UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_JOURNALD_FAILURE_ERROR_CODE_TYPE \
 "návratový kód sd_journal_sendv"
 
@@ -112,6 +133,9 @@
 #  define L10N_MESSAGE_TOO_BIG_FOR_DATAGRAM_ERROR_MESSAGE \
 "zpráva je příliš velká na to, aby byla poslána v jednom datagramu"
 
+#  define L10N_MESSAGE_TOO_BIG_FOR_SEGMENT_ERROR_MESSAGE \
+"MESSAGE TOO BIG FOR SEGMENT ERROR MESSAGE"
+
 #  define L10N_MESSAGE_SIZE_ERROR_CODE_TYPE \
 "velikost zprávy, která se pokusila odeslat je "
 
@@ -124,12 +148,21 @@
 #  define L10N_NULL_ARG_ERROR_MESSAGE( ARG_NAME ) \
 ARG_NAME " měl hodnotu NULL"
 
+#  define L10N_OBJECT_FROZEN_ERROR_MESSAGE \
+"OBJECT FROZEN ERROR MESSAGE"
+
 #  define L10N_OPEN_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "pokus o otevření cíle nepodporovaného typu"
 
 #  define L10N_PARAM_NOT_FOUND_ERROR_MESSAGE \
 "specifikován parametr nebyl nalezen"
 
+#  define L10N_SEGMENT_FAILURE_ERROR_MESSAGE \
+"SEGMENT FAILURE ERROR MESSAGE"
+
+#  define L10N_SEGMENT_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"SEGMENT FILES UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_SEND_ENTRY_TO_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "pokus o poslání vstupu nepodporovaného typu na cíl"
 
@@ -154,6 +187,9 @@ ARG_NAME " měl hodnotu NULL"
 #  define L10N_TARGET_ALWAYS_OPEN_ERROR_MESSAGE \
 "cíl danného typu je stále otevřený"
 
+#  define L10N_THREAD_FAILURE_ERROR_MESSAGE \
+"THREAD FAILURE ERROR MESSAGE"
+
 #  define L10N_TRANSPORT_PORT_NETWORK_ONLY_ERROR_MESSAGE \
 "přenosové porty jsou platné pouze pro síťové cíle"
 
@@ -181,6 +217,9 @@ ARG_NAME " měl hodnotu NULL"
 #  define L10N_WSAGETLASTERROR_ERROR_CODE_TYPE \
 "výsledek WSAGetLastError po selhání volání"
 
+#  define L10N_ZLIB_ERROR_CODE_TYPE \
+"ZLIB ERROR CODE TYPE"
+
 #  define L10N_STRING_TOO_LONG_ERROR_MESSAGE \
 "délka řetězce přesáhla maximální limit"
 
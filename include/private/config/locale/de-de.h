@@ -49,9 +49,15 @@
 #  define L10N_FILE_OPEN_FAILURE_ERROR_MESSAGE \
 "FILE OPEN FAILURE MESSAGE"
 
+#  define L10N_FILE_ROTATION_FAILURE_ERROR_MESSAGE \
+"FILE ROTATION FAILURE ERROR MESSAGE"
+
 #  define L10N_FILE_WRITE_FAILURE_ERROR_MESSAGE \
 "FILE WRITE FAILURE MESSAGE"
 
+#  define L10N_FORMAT_FAILURE_ERROR_MESSAGE \
+"FORMAT FAILURE ERROR MESSAGE"
+
 #  define L10N_FUNCTION_TARGET_FAILURE_CODE_TYPE \
 "FUNCTION TARGET FAILURE CODE TYPE"
 
@@ -77,6 +83,12 @@
 #  define L10N_GETLASTERROR_ERROR_CODE_TYPE \
 "GETLASTERROR ERROR CODE TYPE"
 
+#  define L10N_GZIP_FAILURE_ERROR_MESSAGE \
+"GZIP FAILURE ERROR MESSAGE"
+
+#  define L10N_GZIP_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"GZIP FILES UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_INDEX_OUT_OF_BOUNDS_ERROR_CODE_TYPE \
 "Der ungültige Index, oder -1 davon ist zu groß, um ihn als int" \
 "darzustellen"
@@ -101,6 +113,15 @@
 "Schweregrad-Codes müssen in Übereinstimmung mit RFC 5424 definiert werden: " \
 "Werte zwischen 0 und einschließlich 7"
 
+#  define L10N_IO_URING_FAILURE_ERROR_MESSAGE \
+"IO URING FAILURE ERROR MESSAGE"
+
+#  define L10N_IO_URING_REGULAR_FILE_ONLY_ERROR_MESSAGE \
+"IO URING REGULAR FILE ONLY ERROR MESSAGE"
+
+#  define L10N_IO_URING_UNSUPPORTED_ERROR_MESSAGE \
+"IO URING UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_JOURNALD_FAILURE_ERROR_CODE_TYPE \
 "JOURNALD FAILURE ERROR CODE"
 
@@ -116,6 +137,9 @@
 #  define L10N_MESSAGE_TOO_BIG_FOR_DATAGRAM_ERROR_MESSAGE \
 "Die Nachricht ist zu groß um in einem einzigen Diagramm gesendet zu werden"
 
+#  define L10N_MESSAGE_TOO_BIG_FOR_SEGMENT_ERROR_MESSAGE \
+"MESSAGE TOO BIG FOR SEGMENT ERROR MESSAGE"
+
 #  define L10N_MESSAGE_SIZE_ERROR_CODE_TYPE \
 "Die Größe der Nachricht, die versucht wurde, gesendet zu werden"
 
@@ -128,12 +152,21 @@
 #  define L10N_NULL_ARG_ERROR_MESSAGE( ARG_NAME ) \
 ARG_NAME " war NULL"
 
+#  define L10N_OBJECT_FROZEN_ERROR_MESSAGE \
+"OBJECT FROZEN ERROR MESSAGE"
+
 #  define L10N_OPEN_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "Es wurde versucht einen nicht unterstützten Zieltyp zu öffen"
 
 #  define L10N_PARAM_NOT_FOUND_ERROR_MESSAGE \
 "Ein Parameter mit den angegebenen Eigenschaften konnte nicht gefunden werden"
 
+#  define L10N_SEGMENT_FAILURE_ERROR_MESSAGE \
+"SEGMENT FAILURE ERROR MESSAGE"
+
+#  define L10N_SEGMENT_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"SEGMENT FILES UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_SEND_ENTRY_TO_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "Es wurde versucht einen Eintrag an einen nicht unterstützten Zieltyp zu senden"
 
@@ -161,6 +194,9 @@ ARG_NAME " war NULL"
 #  define L10N_TRANSPORT_PROTOCOL_UNSUPPORTED_ERROR_MESSAGE \
 "TRANSPORT PROTOCOL UNSUPPORTED ERROR MESSAGE"
 
+#  define L10N_THREAD_FAILURE_ERROR_MESSAGE \
+"THREAD FAILURE ERROR MESSAGE"
+
 #  define L10N_TRANSPORT_PORT_NETWORK_ONLY_ERROR_MESSAGE \
 "Transportanschlüsse sind nur für Netzwerkziele gültig"
 
@@ -185,6 +221,9 @@ ARG_NAME " war NULL"
 #  define L10N_WSAGETLASTERROR_ERROR_CODE_TYPE \
 "Das Ergebnis von WSAGetLastError nach dem fehlgeschlagenen Aufruf"
 
+#  define L10N_ZLIB_ERROR_CODE_TYPE \
+"ZLIB ERROR CODE TYPE"
+
 #  define L10N_STRING_TOO_LONG_ERROR_MESSAGE \
 "STRING TOO LONG"
 
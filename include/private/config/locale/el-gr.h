@@ -49,9 +49,15 @@
 # define L10N_FILE_OPEN_FAILURE_ERROR_MESSAGE \
 "αδυναμία ανοίγματος του συγκεκριμένου αρχείου"
 
+# define L10N_FILE_ROTATION_FAILURE_ERROR_MESSAGE \
+"FILE ROTATION FAILURE ERROR MESSAGE"
+
 # define L10N_FILE_WRITE_FAILURE_ERROR_MESSAGE \
 "αδυναμία εγγραφής στο αρχείο"
 
+# define L10N_FORMAT_FAILURE_ERROR_MESSAGE \
+"FORMAT FAILURE ERROR MESSAGE"
+
 # define L10N_FUNCTION_TARGET_FAILURE_CODE_TYPE \
 "κωδικός της συνάρτησης χειριστής των καταγραφών"
 
@@ -76,6 +82,12 @@
 # define L10N_GETLASTERROR_ERROR_CODE_TYPE \
 "αποτέλεσμα του GetLastError εφόσον της αποτυχημένης κλήσης της συνάρτησης"
 
+# define L10N_GZIP_FAILURE_ERROR_MESSAGE \
+"GZIP FAILURE ERROR MESSAGE"
+
+# define L10N_GZIP_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"GZIP FILES UNSUPPORTED ERROR MESSAGE"
+
 # define L10N_INDEX_OUT_OF_BOUNDS_ERROR_CODE_TYPE \
 "μη έγκυρη δείκτης, ή το αποτέλεσμα της αφαίρεση του δείκτη κατά 1 είναι υπερβολικά μεγάλο για να αναπαρασταθεί ως int"
 
@@ -97,6 +109,15 @@
 # define L10N_INVALID_SEVERITY_ERROR_MESSAGE \
 "οι κωδικοί σοβαρότητας πρέπει να είναι καθορισμένοι με βάση το RFC 5424 και οι τιμές να είναι στο εύρος 0 έως 7"
 
+# define L10N_IO_URING_FAILURE_ERROR_MESSAGE \
+"IO URING FAILURE ERROR MESSAGE"
+
+# define L10N_IO_URING_REGULAR_FILE_ONLY_ERROR_MESSAGE \
+"IO URING REGULAR FILE ONLY ERROR MESSAGE"
+
+# define L10N_IO_URING_UNSUPPORTED_ERROR_MESSAGE \
+"IO URING UNSUPPORTED ERROR MESSAGE"
+
 # define L10N_JOURNALD_FAILURE_ERROR_CODE_TYPE \
 "κωδικός επιστροφής της sd_journal_sendv"
 
@@ -112,6 +133,9 @@
 # define L10N_MESSAGE_TOO_BIG_FOR_DATAGRAM_ERROR_MESSAGE \
 "το μέγεθος του μηνύματος είναι υπερβολικά μεγάλο για να σταλθεί σε ένα διάγραμμα"
 
+# define L10N_MESSAGE_TOO_BIG_FOR_SEGMENT_ERROR_MESSAGE \
+"MESSAGE TOO BIG FOR SEGMENT ERROR MESSAGE"
+
 # define L10N_MESSAGE_SIZE_ERROR_CODE_TYPE \
 "το μέγεθος του μηνύματος που επιχειρήθηκε να σταλθεί"
 
@@ -124,12 +148,21 @@
 # define L10N_NULL_ARG_ERROR_MESSAGE( ARG_NAME ) \
 ARG_NAME " κατέχει την τιμή NULL"
 
+# define L10N_OBJECT_FROZEN_ERROR_MESSAGE \
+"OBJECT FROZEN ERROR MESSAGE"
+
 # define L10N_OPEN_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "προσπάθεια ανοίγματος μη υποστηριζόμενου τύπου στόχου"
 
 # define L10N_PARAM_NOT_FOUND_ERROR_MESSAGE \
 "αδυναμία εύρεσης παράμετρος με τα καθορισμένα χαρακτηριστικά"
 
+# define L10N_SEGMENT_FAILURE_ERROR_MESSAGE \
+"SEGMENT FAILURE ERROR MESSAGE"
+
+# define L10N_SEGMENT_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"SEGMENT FILES UNSUPPORTED ERROR MESSAGE"
+
 # define L10N_SEND_ENTRY_TO_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "προσπάθεια αποστολής μίας εγγραφής σε μη υποστηριζόμενο τύπο στόχου"
 
@@ -154,6 +187,9 @@ ARG_NAME " κατέχει την τιμή NULL"
 # define L10N_TARGET_ALWAYS_OPEN_ERROR_MESSAGE \
 "ο στόχος είναι πάντα ανοικτός"
 
+# define L10N_THREAD_FAILURE_ERROR_MESSAGE \
+"THREAD FAILURE ERROR MESSAGE"
+
 # define L10N_TRANSPORT_PORT_NETWORK_ONLY_ERROR_MESSAGE \
 "οι θύρες μεταφοράς είναι έγκυρες μόνο για στόχους του δικτύου"
 
@@ -181,6 +217,9 @@ ARG_NAME " κατέχει την τιμή NULL"
 # define L10N_WSAGETLASTERROR_ERROR_CODE_TYPE \
 "το αποτέλεσμα της WSAGetLastError εφόσον απότυχε η κλήση της συνάρτησης"
 
+# define L10N_ZLIB_ERROR_CODE_TYPE \
+"ZLIB ERROR CODE TYPE"
+
 # define L10N_STRING_TOO_LONG_ERROR_MESSAGE \
 "το μήκος της συμβολοσειράς υπερβαίνει το ανώτερο μήκος"
 
@@ -49,9 +49,15 @@
 #  define L10N_FILE_OPEN_FAILURE_ERROR_MESSAGE \
 "could not open the specified file"
 
+#  define L10N_FILE_ROTATION_FAILURE_ERROR_MESSAGE \
+"could not rotate the file of the target"
+
 #  define L10N_FILE_WRITE_FAILURE_ERROR_MESSAGE \
 "could not write to the file"
 
+#  define L10N_FORMAT_FAILURE_ERROR_MESSAGE \
+"could not format the message"
+
 #  define L10N_FUNCTION_TARGET_FAILURE_CODE_TYPE \
 "return code of the log handler function"
 
@@ -76,6 +82,12 @@
 #  define L10N_GETLASTERROR_ERROR_CODE_TYPE \
 "the result of GetLastError after the failed call"
 
+#  define L10N_GZIP_FAILURE_ERROR_MESSAGE \
+"gzip compression failed"
+
+#  define L10N_GZIP_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"gzip file targets are not supported by this build"
+
 #  define L10N_INDEX_OUT_OF_BOUNDS_ERROR_CODE_TYPE \
 "the invalid index, or -1 of it is too large to represent as an int"
 
@@ -99,6 +111,15 @@
 "severity codes must be defined in accordance with RFC 5424: values between 0" \
 " and 7 inclusive"
 
+#  define L10N_IO_URING_FAILURE_ERROR_MESSAGE \
+"io_uring could not be set up for the target"
+
+#  define L10N_IO_URING_REGULAR_FILE_ONLY_ERROR_MESSAGE \
+"io_uring writes are only supported for regular files"
+
+#  define L10N_IO_URING_UNSUPPORTED_ERROR_MESSAGE \
+"io_uring is not supported by this build"
+
 #  define L10N_JOURNALD_FAILURE_ERROR_CODE_TYPE \
 "return code of sd_journal_sendv"
 
@@ -114,6 +135,9 @@
 #  define L10N_MESSAGE_TOO_BIG_FOR_DATAGRAM_ERROR_MESSAGE \
 "message is too large to be sent in a single datagram"
 
+#  define L10N_MESSAGE_TOO_BIG_FOR_SEGMENT_ERROR_MESSAGE \
+"message is larger than a segment of the target"
+
 #  define L10N_MESSAGE_SIZE_ERROR_CODE_TYPE \
 "the size of the message that was attempted to be sent"
 
@@ -126,12 +150,21 @@
 #  define L10N_NULL_ARG_ERROR_MESSAGE( ARG_NAME ) \
 ARG_NAME " was NULL"
 
+#  define L10N_OBJECT_FROZEN_ERROR_MESSAGE \
+"an entry, element, or param was modified after being frozen"
+
 #  define L10N_OPEN_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "tried to open an unsupported target type"
 
 #  define L10N_PARAM_NOT_FOUND_ERROR_MESSAGE \
 "a param with the specified characteristics could not be found"
 
+#  define L10N_SEGMENT_FAILURE_ERROR_MESSAGE \
+"a segment could not be allocated and mapped for the target"
+
+#  define L10N_SEGMENT_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"segment file targets are not supported by this build"
+
 #  define L10N_SEND_ENTRY_TO_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "attempted to send an entry to an unsupported target type"
 
@@ -156,6 +189,9 @@ ARG_NAME " was NULL"
 #  define L10N_TARGET_ALWAYS_OPEN_ERROR_MESSAGE \
 "this target type is always open"
 
+#  define L10N_THREAD_FAILURE_ERROR_MESSAGE \
+"could not create a thread"
+
 #  define L10N_TRANSPORT_PORT_NETWORK_ONLY_ERROR_MESSAGE \
 "transport ports are only valid for network targets"
 
@@ -183,6 +219,9 @@ ARG_NAME " was NULL"
 #  define L10N_WSAGETLASTERROR_ERROR_CODE_TYPE \
 "the result of WSAGetLastError after the failed call"
 
+#  define L10N_ZLIB_ERROR_CODE_TYPE \
+"return code of the zlib function"
+
 #  define L10N_STRING_TOO_LONG_ERROR_MESSAGE \
 "length of string exceeded maximum limit"
 
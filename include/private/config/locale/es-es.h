@@ -49,9 +49,15 @@
 #  define L10N_FILE_OPEN_FAILURE_ERROR_MESSAGE \
 "no se pudo abrir el archivo especificado"
 
+#  define L10N_FILE_ROTATION_FAILURE_ERROR_MESSAGE \
+"FILE ROTATION FAILURE ERROR MESSAGE"
+
 #  define L10N_FILE_WRITE_FAILURE_ERROR_MESSAGE \
 "no se pudo escribir en el archivo"
 
+#  define L10N_FORMAT_FAILURE_ERROR_MESSAGE \
+"FORMAT FAILURE ERROR MESSAGE"
+
 #  define L10N_FUNCTION_TARGET_FAILURE_CODE_TYPE \
 "código de retorno de la función manager log"
 
@@ -76,6 +82,12 @@
 #  define L10N_GETLASTERROR_ERROR_CODE_TYPE \
 "el resultado de GetLastError despues de la llamada fallida"
 
+#  define L10N_GZIP_FAILURE_ERROR_MESSAGE \
+"GZIP FAILURE ERROR MESSAGE"
+
+#  define L10N_GZIP_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"GZIP FILES UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_INDEX_OUT_OF_BOUNDS_ERROR_CODE_TYPE \
 "el índice no válido, o -1 por lo que es deamasiado largo para representarse como entero"
 
@@ -99,6 +111,15 @@
 "los códigos de severidad deben ser definidos de acuerdo al RFC 5424:" \
 " valores entre 0 y 7 inclusive"
 
+#  define L10N_IO_URING_FAILURE_ERROR_MESSAGE \
+"IO URING FAILURE ERROR MESSAGE"
+
+#  define L10N_IO_URING_REGULAR_FILE_ONLY_ERROR_MESSAGE \
+"IO URING REGULAR FILE ONLY ERROR MESSAGE"
+
+#  define L10N_IO_URING_UNSUPPORTED_ERROR_MESSAGE \
+"IO URING UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_JOURNALD_FAILURE_ERROR_CODE_TYPE \
 "JOURNALD FAILURE ERROR CODE"
 
@@ -114,6 +135,9 @@
 #  define L10N_MESSAGE_TOO_BIG_FOR_DATAGRAM_ERROR_MESSAGE \
 "el mensaje es demasiado largo para ser enviado en un datagrama simple"
 
+#  define L10N_MESSAGE_TOO_BIG_FOR_SEGMENT_ERROR_MESSAGE \
+"MESSAGE TOO BIG FOR SEGMENT ERROR MESSAGE"
+
 #  define L10N_MESSAGE_SIZE_ERROR_CODE_TYPE \
 "el tamaño del mensaje que se ha intentado enviar"
 
@@ -126,12 +150,21 @@
 #  define L10N_NULL_ARG_ERROR_MESSAGE( ARG_NAME ) \
 ARG_NAME " fue NULL"
 
+#  define L10N_OBJECT_FROZEN_ERROR_MESSAGE \
+"OBJECT FROZEN ERROR MESSAGE"
+
 #  define L10N_OPEN_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "se ha tratado de abrir un tipo de objetivo no soportado"
 
 #  define L10N_PARAM_NOT_FOUND_ERROR_MESSAGE \
 "un parámetro con las características especificadas no fue encontrado"
 
+#  define L10N_SEGMENT_FAILURE_ERROR_MESSAGE \
+"SEGMENT FAILURE ERROR MESSAGE"
+
+#  define L10N_SEGMENT_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"SEGMENT FILES UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_SEND_ENTRY_TO_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "se ha intentado enviar una entrada a un tipo de objetivo no soportado"
 
@@ -156,6 +189,9 @@ ARG_NAME " fue NULL"
 #  define L10N_TARGET_ALWAYS_OPEN_ERROR_MESSAGE \
 "este tipo de objetivo siempre permanece abierto"
 
+#  define L10N_THREAD_FAILURE_ERROR_MESSAGE \
+"THREAD FAILURE ERROR MESSAGE"
+
 #  define L10N_TRANSPORT_PORT_NETWORK_ONLY_ERROR_MESSAGE \
 "los puertos de transporte sólo son válidos para objetivos de red"
 
@@ -183,6 +219,9 @@ ARG_NAME " fue NULL"
 #  define L10N_WSAGETLASTERROR_ERROR_CODE_TYPE \
 "el resultado de WSAGetLastError despues que la llamada fallara"
 
+#  define L10N_ZLIB_ERROR_CODE_TYPE \
+"ZLIB ERROR CODE TYPE"
+
 #  define L10N_STRING_TOO_LONG_ERROR_MESSAGE \
 "el largo de la cadena ha excedido el límite máximo"
 
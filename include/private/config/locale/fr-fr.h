@@ -49,9 +49,15 @@
 #  define L10N_FILE_OPEN_FAILURE_ERROR_MESSAGE \
 "FILE OPEN FAILURE MESSAGE"
 
+#  define L10N_FILE_ROTATION_FAILURE_ERROR_MESSAGE \
+"FILE ROTATION FAILURE ERROR MESSAGE"
+
 #  define L10N_FILE_WRITE_FAILURE_ERROR_MESSAGE \
 "FILE WRITE FAILURE MESSAGE"
 
+#  define L10N_FORMAT_FAILURE_ERROR_MESSAGE \
+"FORMAT FAILURE ERROR MESSAGE"
+
 #  define L10N_FUNCTION_TARGET_FAILURE_CODE_TYPE \
 "FUNCTION TARGET FAILURE CODE TYPE"
 
@@ -76,6 +82,12 @@
 #  define L10N_GETLASTERROR_ERROR_CODE_TYPE \
 "GETLASTERROR ERROR CODE TYPE"
 
+#  define L10N_GZIP_FAILURE_ERROR_MESSAGE \
+"GZIP FAILURE ERROR MESSAGE"
+
+#  define L10N_GZIP_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"GZIP FILES UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_INDEX_OUT_OF_BOUNDS_ERROR_CODE_TYPE \
 "l'index invalide, ou son -1 est trop grand pour être représenté comme un int"
 
@@ -99,6 +111,15 @@
 "les codes de sévérité doivent être définis conformément au RFC 5424: valeurs entre 0" \
 " et 7 inclus"
 
+#  define L10N_IO_URING_FAILURE_ERROR_MESSAGE \
+"IO URING FAILURE ERROR MESSAGE"
+
+#  define L10N_IO_URING_REGULAR_FILE_ONLY_ERROR_MESSAGE \
+"IO URING REGULAR FILE ONLY ERROR MESSAGE"
+
+#  define L10N_IO_URING_UNSUPPORTED_ERROR_MESSAGE \
+"IO URING UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_JOURNALD_FAILURE_ERROR_CODE_TYPE \
 "JOURNALD FAILURE ERROR CODE"
 
@@ -114,6 +135,9 @@
 #  define L10N_MESSAGE_TOO_BIG_FOR_DATAGRAM_ERROR_MESSAGE \
 "message trop grand pour être envoyé en un seul datagramme"
 
+#  define L10N_MESSAGE_TOO_BIG_FOR_SEGMENT_ERROR_MESSAGE \
+"MESSAGE TOO BIG FOR SEGMENT ERROR MESSAGE"
+
 #  define L10N_MESSAGE_SIZE_ERROR_CODE_TYPE \
 "la taille du message qui a été tenté d'être envoyé"
 
@@ -126,12 +150,21 @@
 #  define L10N_NULL_ARG_ERROR_MESSAGE( ARG_NAME ) \
 ARG_NAME " a été NULL"
 
+#  define L10N_OBJECT_FROZEN_ERROR_MESSAGE \
+"OBJECT FROZEN ERROR MESSAGE"
+
 #  define L10N_OPEN_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "essai d'ouverture d'un type de cible non supporté"
 
 #  define L10N_PARAM_NOT_FOUND_ERROR_MESSAGE \
 "un paramètre avec les caractéristiques spécifiées est introuvable"
 
+#  define L10N_SEGMENT_FAILURE_ERROR_MESSAGE \
+"SEGMENT FAILURE ERROR MESSAGE"
+
+#  define L10N_SEGMENT_FILES_UNSUPPORTED_ERROR_MESSAGE \
+"SEGMENT FILES UNSUPPORTED ERROR MESSAGE"
+
 #  define L10N_SEND_ENTRY_TO_UNSUPPORTED_TARGET_ERROR_MESSAGE \
 "tentative d'envoi d'une entrée à un type de cible non supporté"
 
@@ -156,6 +189,9 @@ ARG_NAME " a été NULL"
 #  define L10N_TARGET_ALWAYS_OPEN_ERROR_MESSAGE \
 "ce type de cible est toujours ouvert"
 
+#  define L10N_THREAD_FAILURE_ERROR_MESSAGE \
+"THREAD FAILURE ERROR MESSAGE"
+
 #  define L10N_TRANSPORT_PORT_NETWORK_ONLY_ERROR_MESSAGE \
 "ports de transport valides uniquement pour les cibles réseaux"
 
@@ -183,6 +219,9 @@ ARG_NAME " a été NULL"
 #  define L10N_WSAGETLASTERROR_ERROR_CODE_TYPE \
 "le résultat de WSAGetLastError après l'échec de l'appel"
 
+#  define L10N_ZLIB_ERROR_CODE_TYPE \
+"ZLIB ERROR CODE TYPE"
+
 #  define L10N_STRING_TOO_LONG_ERROR_MESSAGE \
 "STRING TOO LONG"
 
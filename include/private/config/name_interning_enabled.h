@@ -0,0 +1,89 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * A global table of element and param names. Each distinct name is stored
+ * once and never changes or moves, so that names in the table can be compared
+ * by pointer. Lookups do not take any locks, and inserts are coordinated with
+ * atomic compare and exchange operations on the head of each bucket.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_CONFIG_NAME_INTERNING_ENABLED_H
+#  define __STUMPLESS_PRIVATE_CONFIG_NAME_INTERNING_ENABLED_H
+
+#  include <stddef.h>
+
+/**
+ * Finds a name in the table without adding it.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The table is read without locks, which is
+ * possible because names are never removed until name_interning_free_all is
+ * called.
+ *
+ * **Async Signal Safety: AS-Safe**
+ * This function is safe to call from signal handlers.
+ *
+ * **Async Cancel Safety: AC-Safe**
+ * This function is safe to call from threads that may be asynchronously
+ * cancelled.
+ *
+ * @param name The NULL-terminated name to look for.
+ *
+ * @return The interned copy of name, or NULL if the name is not in the table.
+ */
+const char *
+find_interned_name( const char *name );
+
+/**
+ * Gets the interned copy of a name, adding it to the table if needed. This has
+ * the same interface as copy_cstring_with_length, but the result must not be
+ * freed or modified.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. Inserts into the table use atomic compare
+ * and exchange operations, and a name inserted concurrently by two threads is
+ * only kept once.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory management functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of memory management functions.
+ *
+ * @param name The NULL-terminated name to intern.
+ *
+ * @param length Set to the length of the name, not including the NULL
+ * terminator.
+ *
+ * @return The interned copy of name, or NULL if an error is encountered.
+ */
+char *
+intern_name( const char *name, size_t *length );
+
+/**
+ * Frees every name in the table. This must only be called once no element or
+ * param refers to an interned name, which is the same restriction that
+ * stumpless_free_all has.
+ */
+void
+name_interning_free_all( void );
+
+#endif /* __STUMPLESS_PRIVATE_CONFIG_NAME_INTERNING_ENABLED_H */
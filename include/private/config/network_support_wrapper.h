@@ -93,6 +93,7 @@
 #    include "private/target/network.h"
 #    define config_close_network_target stumpless_close_network_target
 #    define config_network_free_all network_free_all
+#    define config_network_get_usage network_get_usage
 #    define config_network_target_is_open network_target_is_open
 #    define config_open_network_target open_network_target
 #    define config_sendto_network_target sendto_network_target
@@ -100,6 +101,7 @@
 #    include "private/target.h"
 #    define config_close_network_target close_unsupported_target
 #    define config_network_free_all() ( ( void ) 0 )
+#    define config_network_get_usage( USAGE ) ( ( void ) 0 )
 #    define config_network_target_is_open unsupported_target_is_open
 #    define config_open_network_target open_unsupported_target
 #    define config_sendto_network_target sendto_unsupported_target
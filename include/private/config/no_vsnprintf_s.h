@@ -25,4 +25,10 @@
 char *
 no_vsnprintf_s_format_string( const char *format, va_list subs, size_t *length );
 
+int
+no_vsnprintf_s_format_string_into( char *buffer,
+                                   size_t size,
+                                   const char *format,
+                                   va_list subs );
+
 #endif /* __STUMPLESS_PRIVATE_CONFIG_NO_VSNPRINTF_S_H */
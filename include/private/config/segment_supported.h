@@ -0,0 +1,195 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Writers that copy messages into preallocated files mapped into memory,
+ * called segments. Threads reserve space in the current segment with a single
+ * atomic addition, so that no lock or system call is needed for a message
+ * unless it fills the segment.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_CONFIG_SEGMENT_SUPPORTED_H
+#  define __STUMPLESS_PRIVATE_CONFIG_SEGMENT_SUPPORTED_H
+
+#  include <stdatomic.h>
+#  include <stddef.h>
+#  include <stumpless/config.h>
+#  include "private/config/wrapper/thread_safety.h"
+
+/**
+ * The number of low bits of the reservation state that hold the offset into
+ * the current segment. The remaining bits hold the generation of the segment.
+ */
+#  define SEGMENT_OFFSET_BITS 40
+
+/**
+ * The largest segment supported, leaving room in the offset bits for the
+ * reservations of threads that find the segment full before it is rolled.
+ */
+#  define SEGMENT_MAX_SIZE ( 1ULL << ( SEGMENT_OFFSET_BITS - 2 ) )
+
+/**
+ * A set of segment files that messages are written to. The two most recent
+ * segments are kept in alternating slots, indexed by the lowest bit of their
+ * generation, so that threads still copying messages into a full segment are
+ * not disturbed by the next one being mapped.
+ */
+struct segment_writer {
+/**
+ * The name of the segment files, followed by the number of the most recent
+ * one.
+ */
+  char *path;
+/** The number of bytes allocated for path. */
+  size_t path_size;
+/** The length of the name at the start of path. */
+  size_t name_length;
+/** The number of the most recently created segment file. */
+  unsigned long number;
+/** The size of each segment in bytes. */
+  size_t segment_size;
+/**
+ * The generation of the current segment in the high bits, and the offset of
+ * the next reservation in it in the low SEGMENT_OFFSET_BITS.
+ */
+  atomic_ullong state;
+/** The mappings of the segments in each slot. */
+  char *maps[2];
+/** The file descriptors of the segments in each slot. */
+  int fds[2];
+/** The number of bytes copied into the segment in each slot. */
+  atomic_size_t committed[2];
+/** True if a new segment could not be created, leaving the writer unusable. */
+  atomic_bool failed;
+#  ifdef STUMPLESS_THREAD_SAFETY_SUPPORTED
+/** Serializes the rolling, flushing, and destruction of segments. */
+  config_mutex_t roll_mutex;
+#  endif
+};
+
+/**
+ * Destroys a writer, syncing the current segment to disk and trimming it to
+ * the messages written to it.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe as it destroys resources that other threads
+ * would use if they tried to reference this writer.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the
+ * destruction of a lock that may be in use as well as the use of the memory
+ * deallocation function.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the cleanup of the lock may not be completed, and the memory
+ * deallocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param writer The writer to destroy.
+ */
+void
+destroy_segment_writer( struct segment_writer *writer );
+
+/**
+ * Syncs the current segment of the writer to disk.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex keeps the segment from being rolled
+ * while it is synced.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param writer The writer to flush.
+ *
+ * @return 0 if the segment was synced, or -1 if an error is encountered.
+ */
+int
+flush_segment_writer( struct segment_writer *writer );
+
+/**
+ * Creates a writer and its first segment. Segment files are named after the
+ * given name with a period and a number appended, starting from the first
+ * number that is not already in use.
+ *
+ * **Thread Safety: MT-Safe race:name**
+ * This function is thread safe, of course assuming that name is not modified
+ * by any other threads during execution.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory allocation functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory allocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param name The name of the segment files.
+ *
+ * @param segment_size The size of each segment in bytes.
+ *
+ * @return The new writer, or NULL if an error is encountered.
+ */
+struct segment_writer *
+new_segment_writer( const char *name, size_t segment_size );
+
+/**
+ * Copies a message into the current segment, rolling to a new segment if it
+ * does not fit.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. Space is reserved in the segment with an
+ * atomic addition, and a mutex is only used when rolling to a new segment.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock when rolling segments.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param writer The writer to copy the message into.
+ *
+ * @param msg The message to write.
+ *
+ * @param msg_length The length of the message in bytes.
+ *
+ * @return 0 if the message was written, or -1 if an error is encountered. If
+ * the full segment could not be synced or trimmed when it was rolled, -1 is
+ * returned even though the message was written to the next one.
+ */
+int
+send_to_segment_writer( struct segment_writer *writer,
+                        const char *msg,
+                        size_t msg_length );
+
+#endif /* __STUMPLESS_PRIVATE_CONFIG_SEGMENT_SUPPORTED_H */
@@ -19,8 +19,37 @@
 #ifndef __STUMPLESS_PRIVATE_CONFIG_THREAD_SAFETY_SUPPORTED_H
 #  define __STUMPLESS_PRIVATE_CONFIG_THREAD_SAFETY_SUPPORTED_H
 
+#  include <stumpless/arena.h>
+#  include <stumpless/memory.h>
 #  include "private/config/wrapper/thread_safety.h"
 
+/**
+ * Destroys a reader-writer lock created with thread_safety_new_arena_rwlock.
+ * If arena is NULL then this is the same as thread_safety_destroy_rwlock,
+ * otherwise the lock memory is left to be released with the arena.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe as it destroys resources that other threads
+ * would use if they tried to use the lock.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the destruction
+ * of a lock that may be in use.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the cleanup of the lock may not be completed.
+ *
+ * @since release v2.2.0
+ *
+ * @param rwlock The reader-writer lock to destroy.
+ *
+ * @param arena The arena the lock was created in, or NULL if it was not.
+ */
+void
+thread_safety_destroy_arena_rwlock( const config_rwlock_t *rwlock,
+                                    const struct stumpless_arena *arena );
+
 /**
  * Destroys the mutex and releases its memory.
  *
@@ -41,6 +70,28 @@
 void
 thread_safety_destroy_mutex( const config_mutex_t *mutex );
 
+/**
+ * Destroys the reader-writer lock and releases its memory.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe as it destroys resources that other threads
+ * would use if they tried to use the lock.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the destruction
+ * of a lock that may be in use.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the cleanup of the lock may not be completed.
+ *
+ * @since release v2.2.0
+ *
+ * @param rwlock The reader-writer lock to destroy.
+ */
+void
+thread_safety_destroy_rwlock( const config_rwlock_t *rwlock );
+
 /**
  * Frees all memory used for thread safety support.
  *
@@ -59,6 +110,59 @@ thread_safety_destroy_mutex( const config_mutex_t *mutex );
 void
 thread_safety_free_all( void );
 
+/**
+ * Adds the memory used by the mutex and reader-writer lock caches to usage,
+ * counting each lock that is currently allocated from them.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The mutex of each cache is used to coordinate
+ * access to it.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate access.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param usage The usage to add the memory of the lock caches to.
+ */
+void
+thread_safety_get_lock_cache_usage( struct stumpless_memory_usage *usage );
+
+/**
+ * Creates a new reader-writer lock in an arena and initializes it for usage.
+ * If arena is NULL then this is the same as thread_safety_new_rwlock.
+ *
+ * Locks in an arena do not come from the lock cache, so that they are released
+ * along with the arena even if the objects they protect are never destroyed.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate access to the arena and the possible use
+ * of memory management functions to create the new lock.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked and the
+ * possible use of memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param arena The arena to create the lock in, or NULL to use the cache.
+ *
+ * @return The created and initialized lock, or NULL if an error was
+ * encountered.
+ */
+config_rwlock_t *
+thread_safety_new_arena_rwlock( struct stumpless_arena *arena );
+
 /**
  * Creates a new mutex and initializes it for usage.
  *
@@ -79,4 +183,27 @@ thread_safety_free_all( void );
 config_mutex_t *
 thread_safety_new_mutex( void );
 
+/**
+ * Creates a new reader-writer lock and initializes it for usage. Any number of
+ * readers may hold the lock at once, but a writer holds it exclusively.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the possible
+ * use of memory management functions to create the new lock.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the possible use of memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @return The created and initialized lock, or NULL if an error was
+ * encountered.
+ */
+config_rwlock_t *
+thread_safety_new_rwlock( void );
+
 #endif /* __STUMPLESS_PRIVATE_CONFIG_THREAD_SAFETY_SUPPORTED_H */
@@ -74,20 +74,24 @@
 #  endif
 
 
-/* definition of config_format_string */
+/* definition of config_format_string and config_format_string_into */
 #  ifdef HAVE_VSNPRINTF_S
 #    include "private/config/have_vsnprintf_s.h"
 #    define config_format_string vsnprintf_s_format_string
+#    define config_format_string_into vsnprintf_s_format_string_into
 #  else
 #    include "private/config/no_vsnprintf_s.h"
 #    define config_format_string no_vsnprintf_s_format_string
+#    define config_format_string_into no_vsnprintf_s_format_string_into
 #  endif
 
 
 /* definition of config_get_now */
 #  ifdef HAVE_GMTIME_R
 #    include "private/config/have_gmtime_r.h"
+#    define config_format_time gmtime_r_format_time
 #    define config_get_now gmtime_r_get_now
+#    define config_get_time gmtime_r_get_time
 #  elif SUPPORT_WINDOWS_GET_NOW
 #    include "private/config/windows_get_now_supported.h"
 #    define config_get_now windows_get_now
@@ -123,6 +127,43 @@
 #  endif
 
 
+/* definitions of the low level file and clock functions */
+#  ifdef HAVE_UNISTD_H
+#    include "private/config/have_unistd.h"
+#    define CONFIG_ATOMIC_APPEND_SIZE UNISTD_ATOMIC_APPEND_SIZE
+#    define config_close_fd unistd_close_fd
+#    define config_get_monotonic_milliseconds unistd_get_monotonic_milliseconds
+#    define config_open_append_fd unistd_open_append_fd
+#    define config_reopen_append_fd unistd_reopen_append_fd
+#    define config_sync_fd unistd_sync_fd
+#    define config_sync_stream unistd_sync_stream
+#    define config_write_fd unistd_write_fd
+#    define config_write_stream unistd_write_stream
+#  elif HAVE_WINDOWS_H
+#    include "private/config/have_windows.h"
+#    define CONFIG_ATOMIC_APPEND_SIZE WINDOWS_ATOMIC_APPEND_SIZE
+#    define config_close_fd windows_close_fd
+#    define config_get_monotonic_milliseconds windows_get_monotonic_milliseconds
+#    define config_open_append_fd windows_open_append_fd
+#    define config_reopen_append_fd windows_reopen_append_fd
+#    define config_sync_fd windows_sync_fd
+#    define config_sync_stream windows_sync_stream
+#    define config_write_fd windows_write_fd
+#    define config_write_stream windows_write_stream
+#  else
+#    include "private/config/fallback.h"
+#    define CONFIG_ATOMIC_APPEND_SIZE FALLBACK_ATOMIC_APPEND_SIZE
+#    define config_close_fd fallback_close_fd
+#    define config_get_monotonic_milliseconds fallback_get_monotonic_milliseconds
+#    define config_open_append_fd fallback_open_append_fd
+#    define config_reopen_append_fd fallback_reopen_append_fd
+#    define config_sync_fd fallback_sync_fd
+#    define config_sync_stream fallback_sync_stream
+#    define config_write_fd fallback_write_fd
+#    define config_write_stream fallback_write_stream
+#  endif
+
+
 /* definition of config_getpid */
 #  ifdef HAVE_UNISTD_H
 #    include "private/config/have_unistd.h"
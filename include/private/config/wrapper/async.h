@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_CONFIG_WRAPPER_ASYNC_H
+#  define __STUMPLESS_PRIVATE_CONFIG_WRAPPER_ASYNC_H
+
+#  include <stumpless/config.h>
+
+#  ifdef STUMPLESS_ASYNC_TARGETS_SUPPORTED
+#    include <stumpless/target/async.h>
+#    include "private/target/async.h"
+#    define config_async_get_usage async_get_usage
+#    define config_close_async_target stumpless_close_async_target
+#    define config_flush_async_target flush_async_target
+#    define config_send_deferred_log_to_async_target \
+send_deferred_log_to_async_target
+#    define config_send_entry_to_async_target send_entry_to_async_target
+#  else
+#    include <stddef.h>
+#    include <stumpless/target.h>
+#    include "private/target.h"
+#    define config_async_get_usage( USAGE ) ( ( void ) 0 )
+#    define config_close_async_target close_unsupported_target
+#    define config_flush_async_target( TARGET ) \
+( ( struct stumpless_target * ) NULL )
+#    define config_send_deferred_log_to_async_target( TARGET,          \
+                                                      PRIORITY,        \
+                                                      MESSAGE,         \
+                                                      SUBS,            \
+                                                      RESULT ) false
+#    define config_send_entry_to_async_target send_entry_to_unsupported_target
+#  endif
+
+#endif /* __STUMPLESS_PRIVATE_CONFIG_WRAPPER_ASYNC_H */
@@ -0,0 +1,38 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_CONFIG_WRAPPER_GZIP_H
+#  define __STUMPLESS_PRIVATE_CONFIG_WRAPPER_GZIP_H
+
+#  include <stumpless/config.h>
+
+#  ifdef STUMPLESS_GZIP_FILES_SUPPORTED
+#    include "private/config/gzip_supported.h"
+#    define config_destroy_gzip_writer destroy_gzip_writer
+#    define config_flush_gzip_writer flush_gzip_writer
+#    define config_new_gzip_writer new_gzip_writer
+#    define config_send_to_gzip_writer send_to_gzip_writer
+#  else
+#    include "private/config/gzip_unsupported.h"
+#    define config_destroy_gzip_writer( WRITER ) ( ( void ) 0 )
+#    define config_flush_gzip_writer( WRITER ) 0
+#    define config_new_gzip_writer no_gzip_new_writer
+#    define config_send_to_gzip_writer( WRITER, MSG, MSG_LENGTH ) -1
+#  endif
+
+#endif /* __STUMPLESS_PRIVATE_CONFIG_WRAPPER_GZIP_H */
@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __STUMPLESS_PRIVATE_CONFIG_WRAPPER_IO_URING_H
+#  define __STUMPLESS_PRIVATE_CONFIG_WRAPPER_IO_URING_H
+
+#  include <stumpless/config.h>
+
+#  ifdef STUMPLESS_IO_URING_SUPPORTED
+#    include "private/config/io_uring_supported.h"
+#    define config_destroy_io_uring_writer destroy_io_uring_writer
+#    define config_flush_io_uring_writer flush_io_uring_writer
+#    define config_io_uring_get_usage io_uring_get_usage
+#    define config_new_io_uring_writer new_io_uring_writer
+#    define config_send_to_io_uring_writer send_to_io_uring_writer
+#  else
+#    include "private/config/io_uring_unsupported.h"
+#    define config_destroy_io_uring_writer( WRITER ) ( ( void ) 0 )
+#    define config_flush_io_uring_writer( WRITER ) 0
+#    define config_io_uring_get_usage( USAGE ) ( ( void ) 0 )
+#    define config_new_io_uring_writer no_io_uring_new_writer
+#    define config_send_to_io_uring_writer( WRITER, MSG, MSG_LENGTH ) -1
+#  endif
+
+#endif /* __STUMPLESS_PRIVATE_CONFIG_WRAPPER_IO_URING_H */
@@ -26,6 +26,7 @@
 #    include "private/config/journald_supported.h"
 #    include "private/target/journald.h"
 #    define config_close_journald_target stumpless_close_journald_target
+#    define config_journald_get_usage journald_get_usage
 #    define config_init_journald_element journald_init_journald_element
 #    define config_init_journald_param journald_init_journald_param
 #    define config_journald_free_thread journald_free_thread
@@ -33,6 +34,7 @@
 #  else
 #    include "private/target.h"
 #    define config_close_journald_target close_unsupported_target
+#    define config_journald_get_usage( USAGE ) ( ( void ) 0 )
 #    define config_init_journald_element( ELEMENT ) ( ( void ) 0 )
 #    define config_init_journald_param( PARAM ) ( ( void ) 0 )
 #    define config_journald_free_thread(  ) ( ( void ) 0 )
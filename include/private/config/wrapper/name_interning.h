@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_CONFIG_WRAPPER_NAME_INTERNING_H
+#  define __STUMPLESS_PRIVATE_CONFIG_WRAPPER_NAME_INTERNING_H
+
+#  include <stumpless/config.h>
+
+/*
+ * config_find_name prepares a name for comparison with config_names_equal.
+ * With interning, this is the interned copy of the name, or NULL if it has
+ * never been interned and therefore cannot match any element or param.
+ *
+ * Names of objects in an arena are copied into the arena unless they are
+ * interned, in which case they are kept in the global table like any other.
+ * The arguments that interning does not need are still evaluated so that
+ * callers do not get unused variable warnings in either configuration.
+ */
+
+#  ifdef STUMPLESS_NAME_INTERNING_ENABLED
+#    include "private/config/name_interning_enabled.h"
+#    define config_copy_name( ARENA, NAME, LENGTH ) \
+( ( void ) ( ARENA ), intern_name( ( NAME ), ( LENGTH ) ) )
+#    define config_destroy_name( ARENA, NAME, LENGTH ) \
+( ( void ) ( ARENA ), ( void ) ( NAME ), ( void ) ( LENGTH ) )
+#    define config_find_name find_interned_name
+#    define config_name_interning_free_all name_interning_free_all
+#    define config_names_equal( NAME, FOUND ) ( ( NAME ) == ( FOUND ) )
+#  else
+#    include <string.h>
+#    include "private/arena.h"
+#    define config_copy_name arena_copy_cstring_with_length
+#    define config_destroy_name( ARENA, NAME, LENGTH ) \
+( arena_free_mem( ( ARENA ), ( NAME ), ( LENGTH ) + 1 ) )
+#    define config_find_name( NAME ) ( NAME )
+#    define config_name_interning_free_all(  ) ( ( void ) 0 )
+#    define config_names_equal( NAME, FOUND ) \
+( strcmp( ( NAME ), ( FOUND ) ) == 0 )
+#  endif
+
+#endif /* __STUMPLESS_PRIVATE_CONFIG_WRAPPER_NAME_INTERNING_H */
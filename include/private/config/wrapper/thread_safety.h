@@ -24,88 +24,235 @@
 #  include <stumpless/config.h>
 #  include "private/config.h"
 
+/*
+ * The cached mutex and rwlock macros operate on the lock member of an entry,
+ * element, param, or target, rather than on a pointer to a lock. Depending on
+ * the build this member is either a pointer to a lock from a cache, or an
+ * inline futex lock word.
+ *
+ * The cond macros wait on and wake a config_cond_t, which is always used with
+ * a config_mutex_t. Timed waits take a deadline from
+ * config_get_monotonic_milliseconds rather than a duration, so that a thread
+ * woken early can wait again without extending its timeout.
+ *
+ * The flag macros read and write a plain bool, such as the frozen member of an
+ * entry, element, or param, atomically. Unlike config_atomic_bool_t this type
+ * can appear in public structures. The int macros do the same for a plain int.
+ */
+
 #  ifndef STUMPLESS_THREAD_SAFETY_SUPPORTED
 typedef bool config_atomic_bool_t;
 typedef void * config_atomic_ptr_t;
 #    define CONFIG_THREAD_LOCAL_STORAGE
 #    include "private/config/thread_safety_unsupported.h"
+#    define config_add_size( S, N ) ( *( S ) += ( N ) )
+#    define config_assign_arena_rwlock( RWLOCK, ARENA ) ( ( void ) 0 )
 #    define config_assign_cached_mutex( MUTEX ) ( ( void ) 0 )
+#    define config_assign_cached_rwlock( RWLOCK ) ( ( void ) 0 )
 #    define config_atomic_bool_false false
 #    define config_atomic_bool_true true
 #    define config_atomic_ptr_initializer NULL
+#    define config_broadcast_cond( COND ) ( ( void ) 0 )
 #    define config_check_mutex_valid( MUTEX ) ( true )
+#    define config_check_rwlock_valid( RWLOCK ) ( true )
 #    define config_compare_exchange_bool no_thread_safety_compare_exchange_bool
 #    define config_compare_exchange_ptr no_thread_safety_compare_exchange_ptr
+#    define config_decrement_size( S ) ( --( *( S ) ) )
+#    define config_destroy_arena_rwlock( RWLOCK, ARENA ) ( ( void ) 0 )
+#    define config_destroy_cond( COND ) ( ( void ) 0 )
 #    define config_destroy_mutex( MUTEX ) ( ( void ) 0 )
 #    define config_destroy_cached_mutex( MUTEX ) ( ( void ) 0 )
+#    define config_destroy_cached_rwlock( RWLOCK ) ( ( void ) 0 )
+#    define config_get_lock_cache_usage( USAGE ) ( ( void ) 0 )
+#    define config_increment_size( S ) ( ++( *( S ) ) )
+#    define config_init_cond( COND ) ( ( void ) 0 )
 #    define config_init_mutex( MUTEX ) ( ( void ) 0 )
+#    define config_lock_cached_mutex( MUTEX ) ( ( void ) 0 )
 #    define config_lock_mutex( MUTEX ) ( ( void ) 0 )
 #    define CONFIG_MUTEX_T_SIZE 0
 #    define config_read_bool( B ) *( B )
+#    define config_read_flag( F ) *( F )
+#    define config_read_int( I ) *( I )
+#    define config_read_lock_rwlock( RWLOCK ) ( ( void ) 0 )
 #    define config_read_ptr( P ) *( P )
+#    define config_read_size( S ) *( S )
+#    define config_read_unlock_rwlock( RWLOCK ) ( ( void ) 0 )
+#    define config_signal_cond( COND ) ( ( void ) 0 )
+#    define config_subtract_size( S, N ) ( *( S ) -= ( N ) )
 #    define config_thread_safety_free_all(  ) ( ( void ) 0 )
+#    define config_timed_wait_cond( COND, MUTEX, DEADLINE ) ( false )
+#    define config_unlock_cached_mutex( MUTEX ) ( ( void ) 0 )
 #    define config_unlock_mutex( MUTEX ) ( ( void ) 0 )
+#    define config_wait_cond( COND, MUTEX ) ( ( void ) 0 )
 #    define config_write_bool( B, REPLACEMENT ) *( B ) = ( REPLACEMENT )
+#    define config_write_flag( F, REPLACEMENT ) *( F ) = ( REPLACEMENT )
+#    define config_write_int( I, REPLACEMENT ) *( I ) = ( REPLACEMENT )
+#    define config_write_lock_rwlock( RWLOCK ) ( ( void ) 0 )
 #    define config_write_ptr( P, REPLACEMENT ) *( P ) = ( REPLACEMENT )
+#    define config_write_size( S, REPLACEMENT ) *( S ) = ( REPLACEMENT )
+#    define config_write_unlock_rwlock( RWLOCK ) ( ( void ) 0 )
 #  elif defined HAVE_PTHREAD_H && defined HAVE_STDATOMIC_H
 #    include <pthread.h>
 #    include <stdatomic.h>
 #    include <stdint.h>
 typedef atomic_bool config_atomic_bool_t;
 typedef atomic_uintptr_t config_atomic_ptr_t;
+typedef pthread_cond_t config_cond_t;
 typedef pthread_mutex_t config_mutex_t;
+typedef pthread_rwlock_t config_rwlock_t;
 #    define CONFIG_THREAD_LOCAL_STORAGE __thread
 #    include "private/config/have_pthread.h"
 #    include "private/config/have_stdatomic.h"
 #    include "private/config/thread_safety_supported.h"
-#    define config_assign_cached_mutex( MUTEX ) \
+#    ifdef STUMPLESS_FUTEX_LOCKS_SUPPORTED
+#      include "private/config/futex_locks_supported.h"
+#      define config_assign_arena_rwlock( RWLOCK, ARENA ) \
+( futex_init_lock( &( RWLOCK ) ) )
+#      define config_assign_cached_mutex( MUTEX ) \
+( futex_init_lock( &( MUTEX ) ) )
+#      define config_assign_cached_rwlock( RWLOCK ) \
+( futex_init_lock( &( RWLOCK ) ) )
+#      define config_check_mutex_valid( MUTEX ) ( true )
+#      define config_check_rwlock_valid( RWLOCK ) ( true )
+#      define config_destroy_arena_rwlock( RWLOCK, ARENA ) ( ( void ) 0 )
+#      define config_destroy_cached_mutex( MUTEX ) ( ( void ) 0 )
+#      define config_destroy_cached_rwlock( RWLOCK ) ( ( void ) 0 )
+#      define config_lock_cached_mutex( MUTEX ) \
+( futex_lock_mutex( &( MUTEX ) ) )
+#      define config_read_lock_rwlock( RWLOCK ) \
+( futex_read_lock_rwlock( &( RWLOCK ) ) )
+#      define config_read_unlock_rwlock( RWLOCK ) \
+( futex_read_unlock_rwlock( &( RWLOCK ) ) )
+#      define config_unlock_cached_mutex( MUTEX ) \
+( futex_unlock_mutex( &( MUTEX ) ) )
+#      define config_write_lock_rwlock( RWLOCK ) \
+( futex_write_lock_rwlock( &( RWLOCK ) ) )
+#      define config_write_unlock_rwlock( RWLOCK ) \
+( futex_write_unlock_rwlock( &( RWLOCK ) ) )
+#    else
+#      define config_assign_arena_rwlock( RWLOCK, ARENA ) \
+( RWLOCK = thread_safety_new_arena_rwlock( ARENA ) )
+#      define config_assign_cached_mutex( MUTEX ) \
 ( MUTEX = thread_safety_new_mutex(  ) )
+#      define config_assign_cached_rwlock( RWLOCK ) \
+( RWLOCK = thread_safety_new_rwlock(  ) )
+#      define config_check_mutex_valid( MUTEX ) ( MUTEX != NULL )
+#      define config_check_rwlock_valid( RWLOCK ) ( RWLOCK != NULL )
+#      define config_destroy_arena_rwlock( RWLOCK, ARENA ) \
+( thread_safety_destroy_arena_rwlock( RWLOCK, ARENA ) )
+#      define config_destroy_cached_mutex( MUTEX ) \
+( thread_safety_destroy_mutex( MUTEX ) )
+#      define config_destroy_cached_rwlock( RWLOCK ) \
+( thread_safety_destroy_rwlock( RWLOCK ) )
+#      define config_lock_cached_mutex pthread_lock_mutex
+#      define config_read_lock_rwlock pthread_read_lock_rwlock
+#      define config_read_unlock_rwlock pthread_unlock_rwlock
+#      define config_unlock_cached_mutex pthread_unlock_mutex
+#      define config_write_lock_rwlock pthread_write_lock_rwlock
+#      define config_write_unlock_rwlock pthread_unlock_rwlock
+#    endif
+#    define config_add_size stdatomic_add_size
 #    define config_atomic_bool_false false
 #    define config_atomic_bool_true true
 #    define config_atomic_ptr_initializer ( uintptr_t ) NULL
-#    define config_check_mutex_valid( MUTEX ) ( MUTEX != NULL )
+#    define config_broadcast_cond pthread_broadcast_cond
 #    define config_compare_exchange_bool stdatomic_compare_exchange_bool
 #    define config_compare_exchange_ptr stdatomic_compare_exchange_ptr
-#    define config_destroy_cached_mutex( MUTEX ) \
-( thread_safety_destroy_mutex( MUTEX ) )
+#    define config_decrement_size stdatomic_decrement_size
+#    define config_destroy_cond pthread_destroy_cond
 #    define config_destroy_mutex pthread_destroy_mutex
+#    define config_destroy_rwlock pthread_destroy_rwlock
+#    define config_get_lock_cache_usage thread_safety_get_lock_cache_usage
+#    define config_increment_size stdatomic_increment_size
+#    define config_init_cond pthread_init_cond
 #    define config_init_mutex pthread_init_mutex
+#    define config_init_rwlock pthread_init_rwlock
 #    define config_lock_mutex pthread_lock_mutex
 #    define CONFIG_MUTEX_T_SIZE sizeof( config_mutex_t )
 #    define config_read_bool stdatomic_read_bool
+#    define config_read_flag stdatomic_read_flag
+#    define config_read_int stdatomic_read_int
 #    define config_read_ptr stdatomic_read_ptr
+#    define config_read_size stdatomic_read_size
+#    define CONFIG_RWLOCK_T_SIZE sizeof( config_rwlock_t )
+#    define config_signal_cond pthread_signal_cond
+#    define config_subtract_size stdatomic_subtract_size
 #    define config_thread_safety_free_all thread_safety_free_all
+#    define config_timed_wait_cond pthread_timed_wait_cond
 #    define config_unlock_mutex pthread_unlock_mutex
+#    define config_wait_cond pthread_wait_cond
 #    define config_write_bool stdatomic_write_bool
+#    define config_write_flag stdatomic_write_flag
+#    define config_write_int stdatomic_write_int
 #    define config_write_ptr stdatomic_write_ptr
+#    define config_write_size stdatomic_write_size
 #  elif defined HAVE_WINDOWS_H
 #    include "private/config/have_windows.h"
 #    include "private/windows_wrapper.h"
 typedef LONG volatile config_atomic_bool_t;
 typedef PVOID volatile config_atomic_ptr_t;
+typedef CONDITION_VARIABLE config_cond_t;
 typedef CRITICAL_SECTION config_mutex_t;
+typedef SRWLOCK config_rwlock_t;
 #    include "private/config/thread_safety_supported.h"
 #    define CONFIG_THREAD_LOCAL_STORAGE __declspec( thread )
+#    define config_add_size windows_add_size
+#    define config_assign_arena_rwlock( RWLOCK, ARENA ) \
+( RWLOCK = thread_safety_new_arena_rwlock( ARENA ) )
 #    define config_assign_cached_mutex( MUTEX ) \
 ( MUTEX = thread_safety_new_mutex(  ) )
+#    define config_assign_cached_rwlock( RWLOCK ) \
+( RWLOCK = thread_safety_new_rwlock(  ) )
 #    define config_atomic_bool_false false
 #    define config_atomic_bool_true true
 #    define config_atomic_ptr_initializer NULL
+#    define config_broadcast_cond windows_broadcast_cond
 #    define config_check_mutex_valid( MUTEX ) ( MUTEX != NULL )
+#    define config_check_rwlock_valid( RWLOCK ) ( RWLOCK != NULL )
 #    define config_compare_exchange_bool windows_compare_exchange_bool
 #    define config_compare_exchange_ptr windows_compare_exchange_ptr
+#    define config_decrement_size windows_decrement_size
+#    define config_destroy_arena_rwlock( RWLOCK, ARENA ) \
+( thread_safety_destroy_arena_rwlock( RWLOCK, ARENA ) )
 #    define config_destroy_cached_mutex( MUTEX ) \
 ( thread_safety_destroy_mutex( MUTEX ) )
+#    define config_destroy_cached_rwlock( RWLOCK ) \
+( thread_safety_destroy_rwlock( RWLOCK ) )
+#    define config_destroy_cond( COND ) ( ( void ) 0 )
 #    define config_destroy_mutex windows_destroy_mutex
+#    define config_destroy_rwlock( RWLOCK ) ( ( void ) 0 )
+#    define config_get_lock_cache_usage thread_safety_get_lock_cache_usage
+#    define config_increment_size windows_increment_size
+#    define config_init_cond windows_init_cond
 #    define config_init_mutex windows_init_mutex
+#    define config_init_rwlock windows_init_rwlock
+#    define config_lock_cached_mutex windows_lock_mutex
 #    define config_lock_mutex windows_lock_mutex
 #    define CONFIG_MUTEX_T_SIZE sizeof( config_mutex_t )
 #    define config_read_bool( B ) *( B )
+#    define config_read_flag( F ) *( ( const volatile bool * ) ( F ) )
+#    define config_read_int( I ) *( ( const volatile int * ) ( I ) )
+#    define config_read_lock_rwlock windows_read_lock_rwlock
 #    define config_read_ptr( P ) *( P )
+#    define config_read_size( S ) *( S )
+#    define config_read_unlock_rwlock windows_read_unlock_rwlock
+#    define CONFIG_RWLOCK_T_SIZE sizeof( config_rwlock_t )
+#    define config_signal_cond windows_signal_cond
+#    define config_subtract_size windows_subtract_size
 #    define config_thread_safety_free_all thread_safety_free_all
+#    define config_timed_wait_cond windows_timed_wait_cond
+#    define config_unlock_cached_mutex windows_unlock_mutex
 #    define config_unlock_mutex windows_unlock_mutex
+#    define config_wait_cond windows_wait_cond
 #    define config_write_bool( B, REPLACEMENT ) *( B ) = ( REPLACEMENT )
+#    define config_write_flag( F, REPLACEMENT ) \
+( *( ( volatile bool * ) ( F ) ) = ( REPLACEMENT ) )
+#    define config_write_int( I, REPLACEMENT ) \
+( *( ( volatile int * ) ( I ) ) = ( REPLACEMENT ) )
+#    define config_write_lock_rwlock windows_write_lock_rwlock
 #    define config_write_ptr( P, REPLACEMENT ) *( P ) = ( REPLACEMENT )
+#    define config_write_size windows_write_size
+#    define config_write_unlock_rwlock windows_write_unlock_rwlock
 #  endif
 
 #endif /* __STUMPLESS_PRIVATE_CONFIG_WRAPPER_THREAD_SAFETY_H */
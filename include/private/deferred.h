@@ -0,0 +1,272 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_DEFERRED_H
+#  define __STUMPLESS_PRIVATE_DEFERRED_H
+
+#  include <stdarg.h>
+#  include <stdatomic.h>
+#  include <stdbool.h>
+#  include <stddef.h>
+#  include <time.h>
+#  include <stumpless/entry.h>
+#  include <stumpless/target.h>
+
+/**
+ * The longest conversion specification that can be deferred, including the
+ * leading percent sign.
+ */
+#  define DEFERRED_MAX_SPEC_LENGTH 31
+
+/**
+ * The number of bytes of arguments that a deferred log taken from a pool can
+ * hold. Logs with more than this are allocated on their own.
+ */
+#  define DEFERRED_POOL_ARGS_SIZE 256
+
+/**
+ * A log message whose format string has not been applied yet. The arguments
+ * are copied out of the variable argument list in their raw binary form so
+ * that the formatting can be done later by another thread.
+ *
+ * @since release v2.2.0
+ */
+struct deferred_log {
+/**
+ * The format string of the message. This is not copied, and so must remain
+ * valid until the log is formatted.
+ */
+  const char *format;
+/**
+ * The pool that this log was taken from and is returned to when it is
+ * destroyed, or NULL if it was allocated on its own.
+ */
+  struct deferred_pool *pool;
+/** The time that the message was logged at. */
+  struct timespec timestamp;
+/** The prival of the message. */
+  int prival;
+/** The app name of the target when the message was logged. */
+  char app_name[STUMPLESS_MAX_APP_NAME_LENGTH + 1];
+/** The length of app_name, without the NULL terminator. */
+  size_t app_name_length;
+/** The msgid of the target when the message was logged. */
+  char msgid[STUMPLESS_MAX_MSGID_LENGTH + 1];
+/** The length of msgid, without the NULL terminator. */
+  size_t msgid_length;
+/** The number of bytes in args. */
+  size_t args_size;
+/**
+ * The arguments of the message in the order that format uses them. Strings are
+ * stored as their length followed by their characters and a NULL terminator.
+ */
+  char args[];
+};
+
+/**
+ * A position in the ring of free records of a deferred pool.
+ *
+ * @since release v2.2.0
+ */
+struct deferred_pool_slot {
+/**
+ * The position in the ring that this slot is ready for, following the same
+ * scheme as the slots of an async target queue.
+ */
+  atomic_size_t sequence;
+/** The index of the free record held in this slot. */
+  size_t index;
+};
+
+/**
+ * A fixed set of deferred log records that can be taken and returned by any
+ * number of threads without locks or memory allocation. The indices of the free
+ * records are kept in a bounded ring, which can never overflow as there are
+ * only as many indices as slots.
+ *
+ * @since release v2.2.0
+ */
+struct deferred_pool {
+/** The number of records, which is always a power of two. */
+  size_t capacity;
+/** The size of each record, including room for DEFERRED_POOL_ARGS_SIZE. */
+  size_t record_size;
+/** The next position that a free record will be taken from. */
+  atomic_size_t take_position;
+/** The next position that a record will be returned to. */
+  atomic_size_t return_position;
+/** The ring of free record indices. */
+  struct deferred_pool_slot *slots;
+/** The records. */
+  char *records;
+};
+
+/**
+ * Destroys a deferred log, returning it to its pool if it was taken from one.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe, as long as the log is not used by any other
+ * threads.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of the
+ * memory deallocation function.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory deallocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ */
+void
+destroy_deferred_log( const struct deferred_log *deferred );
+
+/**
+ * Destroys a deferred pool. All of the logs taken from it must have been
+ * destroyed first.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe as it destroys resources that other
+ * threads would use if they tried to reference this pool.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of the
+ * memory deallocation function.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory deallocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param pool The pool to destroy. If this is NULL then nothing is done.
+ */
+void
+destroy_deferred_pool( struct deferred_pool *pool );
+
+/**
+ * Writes the message of a deferred log into a buffer, resizing the buffer if
+ * it is not large enough.
+ *
+ * **Thread Safety: MT-Safe race:buffer race:size**
+ * This function is thread safe, as long as the buffer is not used by any other
+ * threads.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory management functions to resize the buffer.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory management functions may not be AC-Safe themselves.
+ *
+ * @since release v2.2.0
+ *
+ * @param deferred The log to format.
+ *
+ * @param buffer The buffer to write to, which may be NULL if size is zero.
+ * This is updated if the buffer is resized.
+ *
+ * @param size The size of the buffer, which is updated if it is resized.
+ *
+ * @return The length of the message, or -1 if the buffer could not be resized
+ * or the message could not be formatted.
+ */
+int
+format_deferred_log( const struct deferred_log *deferred,
+                     char **buffer,
+                     size_t *size );
+
+/**
+ * Captures a log message without formatting it.
+ *
+ * Only the standard conversion specifiers are supported, without positional
+ * arguments. Wide characters and strings, %n, and any other extensions are not
+ * supported, and neither are specifications longer than
+ * DEFERRED_MAX_SPEC_LENGTH characters.
+ *
+ * The log is taken from the pool if there is one with a free record and the
+ * arguments fit in it, so that no memory is allocated. Otherwise it is
+ * allocated on its own.
+ *
+ * **Thread Safety: MT-Safe race:format**
+ * This function is thread safe, of course assuming that the format string and
+ * any strings in the arguments are not changed during the call.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory allocation functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory allocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param pool The pool to take the log from. This may be NULL, in which case
+ * the log is always allocated on its own.
+ *
+ * @param target The target whose default app name and msgid are used.
+ *
+ * @param prival The prival of the message.
+ *
+ * @param format The format string of the message.
+ *
+ * @param args The arguments of the message. These are only read from copies,
+ * so that the caller may still use them if the format string is not
+ * supported.
+ *
+ * @param supported Set to false if the format string cannot be deferred, and
+ * true otherwise.
+ *
+ * @return The new deferred log, or NULL if the format string is not supported
+ * or an error is encountered.
+ */
+struct deferred_log *
+new_deferred_log( struct deferred_pool *pool,
+                  const struct stumpless_target *target,
+                  int prival,
+                  const char *format,
+                  va_list args,
+                  bool *supported );
+
+/**
+ * Creates a new deferred pool.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory allocation functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory allocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param capacity The number of records in the pool, which must be a power of
+ * two.
+ *
+ * @return The new pool, or NULL if it could not be allocated.
+ */
+struct deferred_pool *
+new_deferred_pool( size_t capacity );
+
+#endif /* __STUMPLESS_PRIVATE_DEFERRED_H */
@@ -19,35 +19,157 @@
 #ifndef __STUMPLESS_PRIVATE_ELEMENT_H
 #  define __STUMPLESS_PRIVATE_ELEMENT_H
 
+#  include <stdbool.h>
 #  include <stddef.h>
 #  include <string.h>
+#  include <stumpless/arena.h>
 #  include <stumpless/element.h>
 #  include <stumpless/param.h>
+#  include "private/config/wrapper/name_interning.h"
 #  include "private/param.h"
 
-#  define FOR_EACH_PARAM_WITH_NAME( ELEMENT, NAME ) \
-for( i = 0; i < ( ELEMENT )->param_count; i++ ) {   \
-  param = element->params[i];                       \
-                                                    \
-  lock_param( param );                              \
-  cmp_result = strcmp( param->name, ( NAME ) );     \
-  unlock_param( param );                            \
-                                                    \
-  if( cmp_result != 0 ) {                           \
-    continue;                                       \
+#  define FOR_EACH_PARAM_WITH_NAME( ELEMENT, NAME )             \
+found_name = config_find_name( NAME );                        \
+for( i = 0; i < ( ELEMENT )->param_count; i++ ) {             \
+  bool param_locked;                                          \
+                                                              \
+  param = element->params[i];                                 \
+                                                              \
+  param_locked = lock_param( param );                         \
+  name_matches = config_names_equal( param->name, found_name ); \
+  unlock_param( param, param_locked );                        \
+                                                              \
+  if( !name_matches ) {                                       \
+    continue;                                                 \
   }
 
-void
+/**
+ * Locks an element for reading. Any number of readers may hold the lock at the
+ * same time. Frozen elements are not locked at all.
+ *
+ * @return true if the lock was taken, which must be passed to unlock_element.
+ */
+bool
 lock_element( const struct stumpless_element *element );
 
+/**
+ * Locks an element exclusively so that it can be modified. If the element is
+ * frozen then a STUMPLESS_OBJECT_FROZEN error is raised, false is returned,
+ * and the element is left unlocked.
+ *
+ * @since release v2.2.0
+ */
+bool
+lock_mutable_element( struct stumpless_element *element );
+
 struct stumpless_param *
 locked_get_param_by_index( const struct stumpless_element *element,
                            size_t index );
 
+/**
+ * Gets the param at the given index so that it can be modified. If the param
+ * is frozen, it is first replaced in this element with an unfrozen copy of its
+ * own, whether or not other elements still share it. The element must be
+ * locked with lock_mutable_element by the caller.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_param *
+locked_get_mutable_param_by_index( struct stumpless_element *element,
+                                   size_t index );
+
+struct stumpless_element *
+locked_reserve_params( struct stumpless_element *element, size_t count );
+
+/**
+ * Makes sure that each of the first value_count params of an element that is
+ * already locked with lock_mutable_element has room for the matching value,
+ * without changing any of the values. NULL values are skipped.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_element *
+locked_reserve_param_values( struct stumpless_element *element,
+                             const char * const *values,
+                             size_t value_count );
+
+/**
+ * Sets the values of the first value_count params of an element that is
+ * already locked with lock_mutable_element. NULL values leave the param at
+ * that index unchanged. The memory for every value is reserved before any of
+ * them is set, so if an error is encountered then no values are changed.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_element *
+locked_set_param_values( struct stumpless_element *element,
+                         const char * const *values,
+                         size_t value_count );
+
+/**
+ * Creates a new element in the given arena, or on the heap if arena is NULL.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_element *
+new_element( struct stumpless_arena *arena, const char *name );
+
+/**
+ * Releases one reference to an element. Returns true if the element is no
+ * longer referenced and must be destroyed, and false if it is still shared.
+ *
+ * @since release v2.2.0
+ */
+bool
+release_element( const struct stumpless_element *element );
+
+/**
+ * Clears the value of each param in an element, keeping the memory that the
+ * values were held in. Frozen elements and params are not changed.
+ *
+ * @since release v2.2.0
+ */
+void
+reset_param_values( struct stumpless_element *element );
+
+/**
+ * Takes a reference to an element that is being added to an entry, if it is
+ * frozen. Frozen elements may be added to any number of entries, each of which
+ * releases its own reference when it is destroyed or replaces the element
+ * with a copy, so this must be called whenever a new owner holds one.
+ *
+ * @since release v2.2.0
+ */
+void
+retain_element( struct stumpless_element *element );
+
+/**
+ * Gets an element that a new owner, such as a copied entry, can hold. A frozen
+ * element (and therefore all of its params) cannot change, so it is shared by
+ * adding a reference to it. Other elements, and elements in an arena which may
+ * be released before the new owner, are copied, sharing any frozen params they
+ * hold that are not in an arena.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_element *
+share_element( struct stumpless_element *element );
+
 void
 unchecked_destroy_element( const struct stumpless_element *element );
 
+/**
+ * Releases a lock taken with lock_element, if locked is true.
+ */
+void
+unlock_element( const struct stumpless_element *element, bool locked );
+
+/**
+ * Releases a lock taken with lock_mutable_element.
+ *
+ * @since release v2.2.0
+ */
 void
-unlock_element( const struct stumpless_element *element );
+unlock_mutable_element( struct stumpless_element *element );
 
 #endif /* __STUMPLESS_PRIVATE_ELEMENT_H */
@@ -19,28 +19,61 @@
 #ifndef __STUMPLESS_PRIVATE_ENTRY_H
 #  define __STUMPLESS_PRIVATE_ENTRY_H
 
+#  include <stdarg.h>
 #  include <stdbool.h>
 #  include <stddef.h>
+#  include <stumpless/arena.h>
 #  include <stumpless/element.h>
 #  include <stumpless/entry.h>
 #  include <stumpless/facility.h>
+#  include <stumpless/memory.h>
 #  include <stumpless/severity.h>
 #  include "private/strbuilder.h"
 
 void
 entry_free_all( void );
 
+void
+entry_get_cache_usage( struct stumpless_memory_usage *usage );
+
 int
 get_prival( enum stumpless_facility facility,
             enum stumpless_severity severity );
 
-void
+/**
+ * Locks an entry for reading. Any number of readers may hold the lock at the
+ * same time. Frozen entries are not locked at all.
+ *
+ * @return true if the lock was taken, which must be passed to unlock_entry.
+ */
+bool
 lock_entry( const struct stumpless_entry *entry );
 
+/**
+ * Locks an entry exclusively so that it can be modified. If the entry is
+ * frozen then a STUMPLESS_OBJECT_FROZEN error is raised, false is returned,
+ * and the entry is left unlocked.
+ *
+ * @since release v2.2.0
+ */
+bool
+lock_mutable_entry( struct stumpless_entry *entry );
+
 struct stumpless_entry *
 locked_add_element( struct stumpless_entry *entry,
                     struct stumpless_element *element );
 
+/**
+ * Formats a message into an entry that is locked with lock_mutable_entry,
+ * writing over the current message if there is room for it.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_entry *
+locked_format_message( struct stumpless_entry *entry,
+                       const char *format,
+                       va_list subs );
+
 struct stumpless_element *
 locked_get_element_by_index( const struct stumpless_entry *entry,
                              size_t index );
@@ -50,17 +83,67 @@ locked_get_element_by_name( const struct stumpless_entry *entry,
                             const char *name );
 
 /**
- * Creates a new entry with the given parameters.
+ * Makes sure that the elements array of the entry has room for at least count
+ * elements. The entry must be locked by the caller.
+ *
+ * @since release v2.2.0
+ */
+/**
+ * Gets the element at the given index so that it can be modified. If the
+ * element is frozen, it is first replaced in this entry with an unfrozen copy
+ * of its own, whether or not other entries still share it. The entry must be
+ * locked with lock_mutable_entry by the caller.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_element *
+locked_get_mutable_element_by_index( struct stumpless_entry *entry,
+                                     size_t index );
+
+/**
+ * Gets the element with the given name so that it can be modified, in the same
+ * way as locked_get_mutable_element_by_index. If there is no such element then
+ * a STUMPLESS_ELEMENT_NOT_FOUND error is raised.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_element *
+locked_get_mutable_element_by_name( struct stumpless_entry *entry,
+                                    const char *name );
+
+struct stumpless_entry *
+locked_reserve_elements( struct stumpless_entry *entry, size_t count );
+
+/**
+ * Sets the message of an entry that is locked with lock_mutable_entry. The
+ * message is written over the current one if there is room for it, and
+ * otherwise a new buffer is allocated with room for growth. A NULL message
+ * releases the current one.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_entry *
+locked_set_message( struct stumpless_entry *entry,
+                    const char *message,
+                    size_t message_length );
+
+/**
+ * Creates a new entry with the given parameters. The entry is created in the
+ * given arena, or on the heap if arena is NULL. The message must have been
+ * allocated from the same place, with message_capacity bytes or zero if the
+ * size of the allocation is not known.
  *
  * @since release v2.1.0.
  */
 struct stumpless_entry *
-new_entry( enum stumpless_facility facility,
+new_entry( struct stumpless_arena *arena,
+           enum stumpless_facility facility,
            enum stumpless_severity severity,
            const char *app_name,
            const char *msgid,
            char *message,
-           size_t message_length );
+           size_t message_length,
+           size_t message_capacity );
 
 struct strbuilder *
 strbuilder_append_app_name( struct strbuilder *builder,
@@ -91,7 +174,18 @@ bool
 unchecked_entry_has_element( const struct stumpless_entry *entry,
                              const char *name );
 
+/**
+ * Releases a lock taken with lock_entry, if locked is true.
+ */
+void
+unlock_entry( const struct stumpless_entry *entry, bool locked );
+
+/**
+ * Releases a lock taken with lock_mutable_entry.
+ *
+ * @since release v2.2.0
+ */
 void
-unlock_entry( const struct stumpless_entry *entry );
+unlock_mutable_entry( struct stumpless_entry *entry );
 
 #endif /* __STUMPLESS_PRIVATE_ENTRY_H */
@@ -70,10 +70,18 @@ COLD_FUNCTION
 void
 raise_file_open_failure( void );
 
+COLD_FUNCTION
+void
+raise_file_rotation_failure( void );
+
 COLD_FUNCTION
 void
 raise_file_write_failure( void );
 
+COLD_FUNCTION
+void
+raise_format_failure( int code );
+
 COLD_FUNCTION
 void
 raise_function_target_failure( int code );
@@ -84,6 +92,10 @@ raise_gethostname_failure( const char *message,
                            int code,
                            const char *code_type );
 
+COLD_FUNCTION
+void
+raise_gzip_failure( int code );
+
 COLD_FUNCTION
 void
 raise_index_out_of_bounds( const char *message, size_t index );
@@ -100,6 +112,10 @@ COLD_FUNCTION
 void
 raise_invalid_severity( int severity );
 
+COLD_FUNCTION
+void
+raise_io_uring_failure( int code );
+
 COLD_FUNCTION
 void
 raise_journald_failure( int code );
@@ -112,10 +128,18 @@ COLD_FUNCTION
 void
 raise_network_protocol_unsupported( void );
 
+COLD_FUNCTION
+void
+raise_object_frozen( void );
+
 COLD_FUNCTION
 void
 raise_param_not_found( void );
 
+COLD_FUNCTION
+void
+raise_segment_failure( int code );
+
 COLD_FUNCTION
 void
 raise_socket_bind_failure( const char *message,
@@ -150,6 +174,10 @@ COLD_FUNCTION
 void
 raise_target_unsupported( const char *message );
 
+COLD_FUNCTION
+void
+raise_thread_failure( int code );
+
 COLD_FUNCTION
 void
 raise_transport_protocol_unsupported( void );
@@ -19,6 +19,7 @@
 #ifndef __STUMPLESS_PRIVATE_FORMATTER_H
 #  define __STUMPLESS_PRIVATE_FORMATTER_H
 
+#  include <stddef.h>
 #  include <stumpless/entry.h>
 #  include <stumpless/target.h>
 #  include "private/strbuilder.h"
@@ -35,6 +36,52 @@
 
 #  define RFC_5424_NILVALUE '-'
 
+/**
+ * Appends the formatted message of an entry to an existing strbuilder, using
+ * the given timestamp.
+ *
+ * A newline is added to the end of the message, so that several entries
+ * appended to the same builder are separated by newlines.
+ *
+ * **Thread Safety: MT-Safe race:builder**
+ * This function is thread safe, as long as the builder is not used by any other
+ * threads. A mutex is used to ensure that the entry does not change while it is
+ * being read.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to prevent changes during the read and the use of memory
+ * management functions to grow the builder.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled due to the use of a lock that could be left locked and the use of
+ * memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param builder The builder to append to. If this is NULL, then nothing is
+ * done and NULL is returned.
+ *
+ * @param entry The entry to format.
+ *
+ * @param target The target the entry will be sent to.
+ *
+ * @param timestamp The RFC 5424 timestamp of the entry. This does not need to
+ * be NULL terminated.
+ *
+ * @param timestamp_size The number of characters in timestamp.
+ *
+ * @return The builder, or NULL if it could not be grown. The builder is still
+ * valid in this case, but may contain part of the entry.
+ */
+struct strbuilder *
+append_formatted_entry( struct strbuilder *builder,
+                        const struct stumpless_entry *entry,
+                        const struct stumpless_target *target,
+                        const char *timestamp,
+                        size_t timestamp_size );
+
 /**
  * Creates a new strbuilder with the formatted message.
  *
@@ -62,4 +109,40 @@ struct strbuilder *
 format_entry( const struct stumpless_entry *entry,
               const struct stumpless_target *target );
 
+/**
+ * Creates a new strbuilder with the formatted message, using the given
+ * timestamp instead of the current time.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to ensure that the entry does
+ * not change while it is being read.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to prevent changes during the read.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param entry The entry to format.
+ *
+ * @param target The target the entry will be sent to.
+ *
+ * @param timestamp The RFC 5424 timestamp of the entry. This does not need to
+ * be NULL terminated.
+ *
+ * @param timestamp_size The number of characters in timestamp.
+ *
+ * @return A strbuilder with the formatted version of the entry, with a newline
+ * character added to the end.
+ */
+struct strbuilder *
+format_entry_with_timestamp( const struct stumpless_entry *entry,
+                             const struct stumpless_target *target,
+                             const char *timestamp,
+                             size_t timestamp_size );
+
 #endif /* __STUMPLESS_PRIVATE_FORMATTER_H */
@@ -23,6 +23,9 @@
 
 void *alloc_mem( size_t size );
 void free_mem( const void *mem );
+void free_sized_mem( const void *mem, size_t size );
+size_t
+get_grown_capacity( size_t capacity, size_t required, size_t max_capacity );
 size_t get_paged_size( size_t size );
 void *realloc_mem( void *mem, size_t size );
 
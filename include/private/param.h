@@ -19,12 +19,107 @@
 #ifndef __STUMPLESS_PRIVATE_PARAM_H
 #  define __STUMPLESS_PRIVATE_PARAM_H
 
+#  include <stdbool.h>
+#  include <stddef.h>
+#  include <stumpless/arena.h>
 #  include <stumpless/param.h>
 
+/**
+ * Frees the value of a param, unless it is held in the value buffer of the
+ * param itself.
+ *
+ * @since release v2.2.0
+ */
 void
+destroy_param_value( const struct stumpless_param *param );
+
+/**
+ * Locks a param for reading. Any number of readers may hold the lock at the
+ * same time. Frozen params are not locked at all.
+ *
+ * @return true if the lock was taken, which must be passed to unlock_param.
+ */
+bool
 lock_param( const struct stumpless_param *param );
 
+/**
+ * Locks a param exclusively so that it can be modified. If the param is
+ * frozen then a STUMPLESS_OBJECT_FROZEN error is raised, false is returned,
+ * and the param is left unlocked.
+ *
+ * @since release v2.2.0
+ */
+bool
+lock_mutable_param( struct stumpless_param *param );
+
+/**
+ * Makes sure that a param which is already locked with lock_mutable_param has
+ * room for a value of the given size, including the terminating NUL
+ * character. The current value is moved to new memory if needed, but is not
+ * changed.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_param *
+locked_reserve_param_value( struct stumpless_param *param, size_t size );
+
+/**
+ * Sets the value of a param that is already locked with lock_mutable_param.
+ * The value is written over the current one if there is room for it, so that
+ * no memory is allocated.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_param *
+locked_set_param_value( struct stumpless_param *param, const char *value );
+
+/**
+ * Creates a new param in the given arena, or on the heap if arena is NULL.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_param *
+new_param( struct stumpless_arena *arena,
+           const char *name,
+           const char *value );
+
+/**
+ * Takes a reference to a param that is being added to an element, if it is
+ * frozen. Frozen params may be added to any number of elements, each of which
+ * releases its own reference when it is destroyed or replaces the param with
+ * a copy, so this must be called whenever a new owner holds one.
+ *
+ * @since release v2.2.0
+ */
+void
+retain_param( struct stumpless_param *param );
+
+/**
+ * Gets a param that a new owner, such as a copied element, can hold. A frozen
+ * param cannot change, so it is shared by adding a reference to it. Other
+ * params, and params in an arena which may be released before the new owner,
+ * are copied.
+ *
+ * The result must be released with stumpless_destroy_param, like any other
+ * param.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_param *
+share_param( struct stumpless_param *param );
+
+/**
+ * Releases a lock taken with lock_param, if locked is true.
+ */
+void
+unlock_param( const struct stumpless_param *param, bool locked );
+
+/**
+ * Releases a lock taken with lock_mutable_param.
+ *
+ * @since release v2.2.0
+ */
 void
-unlock_param( const struct stumpless_param *param );
+unlock_mutable_param( struct stumpless_param *param );
 
 #endif /* __STUMPLESS_PRIVATE_PARAM_H */
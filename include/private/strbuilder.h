@@ -20,6 +20,7 @@
 #  define __STUMPLESS_PRIVATE_STRBUILDER_H
 
 #  include <stddef.h>
+#  include <stumpless/memory.h>
 
 struct strbuilder {
   char *buffer;
@@ -67,6 +68,9 @@ strbuilder_append_string( struct strbuilder *builder,
 void
 strbuilder_free_all( void );
 
+void
+strbuilder_get_usage( struct stumpless_memory_usage *usage );
+
 char *
 strbuilder_get_buffer( struct strbuilder *builder, size_t *length );
 
@@ -19,13 +19,31 @@
 #ifndef __STUMPLESS_PRIVATE_TARGET_H
 #  define __STUMPLESS_PRIVATE_TARGET_H
 
+#  include <stdbool.h>
 #  include <stddef.h>
 #  include <stumpless/entry.h>
+#  include <stumpless/memory.h>
 #  include <stumpless/target.h>
 
 void
 destroy_target( const struct stumpless_target *target );
 
+/**
+ * Writes out any messages that the target is holding in a buffer, if a
+ * message with the given severity was just sent to it. This is done for
+ * STUMPLESS_SEVERITY_ERR and anything more severe, so that these are not left
+ * waiting in the buffer. File targets also synchronize their file with the
+ * disk here if their durability calls for it.
+ *
+ * @since release v2.2.0
+ *
+ * @return 0 if the target did not need to be flushed or was flushed without
+ * error, and -1 otherwise.
+ */
+int
+flush_target_for_severity( const struct stumpless_target *target,
+                           int severity );
+
 void
 lock_target( const struct stumpless_target *target );
 
@@ -35,10 +53,31 @@ new_target( enum stumpless_target_type type, const char *name );
 struct stumpless_target *
 open_unsupported_target( struct stumpless_target *target );
 
+/**
+ * Sends an entry to a target without checking the target's filter. This is
+ * everything that stumpless_add_entry does once an entry has passed the
+ * filter.
+ *
+ * @since release v2.2.0
+ */
+int
+send_entry_to_target( const struct stumpless_target *target,
+                      const struct stumpless_entry *entry );
+
 int
 send_entry_to_unsupported_target( const struct stumpless_target *target,
                                   const struct stumpless_entry *entry );
 
+/**
+ * Sends a message that has already been formatted to a target.
+ *
+ * @since release v2.2.0
+ */
+int
+sendto_target( const struct stumpless_target *target,
+               const char *msg,
+               size_t msg_length );
+
 int
 sendto_unsupported_target( const struct stumpless_target *target,
                            const char *msg,
@@ -47,9 +86,21 @@ sendto_unsupported_target( const struct stumpless_target *target,
 void
 target_free_global( void );
 
+/**
+ * True if entries are given to the target as they are, rather than being
+ * formatted into a message first.
+ *
+ * @since release v2.2.0
+ */
+bool
+target_is_unformatted( const struct stumpless_target *target );
+
 void
 target_free_thread( void );
 
+void
+target_get_usage( struct stumpless_memory_usage *usage );
+
 void
 unlock_target( const struct stumpless_target *target );
 
@@ -0,0 +1,216 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __STUMPLESS_PRIVATE_TARGET_ASYNC_H
+#  define __STUMPLESS_PRIVATE_TARGET_ASYNC_H
+
+#  include <pthread.h>
+#  include <stdarg.h>
+#  include <stdatomic.h>
+#  include <stdbool.h>
+#  include <stddef.h>
+#  include <stumpless/entry.h>
+#  include <stumpless/memory.h>
+#  include <stumpless/severity.h>
+#  include <stumpless/target.h>
+#  include "private/config/wrapper/thread_safety.h"
+#  include "private/deferred.h"
+#  include "private/strbuilder.h"
+
+/**
+ * The number of milliseconds that critical and more severe messages wait for
+ * room in the queue under the lowest severity overflow policy, if no block
+ * timeout has been set.
+ *
+ * @since release v2.2.0
+ */
+#  define ASYNC_SEVERE_BLOCK_TIMEOUT 1000
+
+/**
+ * A message waiting to be sent by an async target. Exactly one of entry,
+ * builder, and deferred is set.
+ *
+ * @since release v2.2.0
+ */
+struct async_message {
+/**
+ * A copy of the entry, if the wrapped target is sent entries rather than
+ * formatted messages.
+ */
+  struct stumpless_entry *entry;
+/** The formatted message. */
+  struct strbuilder *builder;
+/** A message that the writer thread must format before sending. */
+  struct deferred_log *deferred;
+/** The severity of the message, used to count it if it is dropped. */
+  int severity;
+};
+
+/**
+ * A single position in the queue of an async target.
+ *
+ * @since release v2.2.0
+ */
+struct async_slot {
+/**
+ * The position in the queue that this slot is ready for. A slot at index i is
+ * free for the producer claiming position p when this is p, and holds a
+ * message for the writer thread taking position p when this is p + 1.
+ */
+  atomic_size_t sequence;
+/** The message in this slot. */
+  struct async_message message;
+/**
+ * The severity of the message in this slot, which may be read by producers
+ * looking for a less severe message to drop before they have taken it.
+ */
+  atomic_int severity;
+};
+
+/**
+ * The internal state of an async target.
+ *
+ * The queue is a bounded ring in which any number of producers claim
+ * positions with an atomic compare and exchange, and messages are removed in
+ * order the same way. The writer thread is normally the only consumer, but
+ * producers also remove the oldest message from a full queue under the drop
+ * oldest and lowest severity overflow policies. The mutex and condition
+ * variables are only used when a thread needs to sleep: the writer thread when
+ * the queue is empty, producers when it is full, and flushing threads while
+ * messages are still being sent.
+ *
+ * @since release v2.2.0
+ */
+struct async_target {
+/** The target that the writer thread sends messages to. */
+  struct stumpless_target *wrapped;
+/** The slots of the queue. */
+  struct async_slot *slots;
+/** The number of slots in the queue, which is always a power of two. */
+  size_t capacity;
+/** The next position that a producer will claim. */
+  atomic_size_t enqueue_position;
+/** The next position that a message will be taken from. */
+  atomic_size_t dequeue_position;
+/**
+ * Every message at a position before this one has either been sent by the
+ * writer thread or dropped. Only the writer thread updates this.
+ */
+  atomic_size_t finished_position;
+/** The current enum stumpless_async_overflow_policy of the target. */
+  atomic_int overflow_policy;
+/** The block timeout in milliseconds, or zero to wait indefinitely. */
+  atomic_uint block_timeout;
+/** The number of messages of each severity that have been dropped. */
+  atomic_size_t drop_counts[STUMPLESS_SEVERITY_DEBUG_VALUE + 1];
+/** Set if messages logged with format specifiers are formatted later. */
+  atomic_bool deferred_formatting;
+/**
+ * The records that deferred messages are copied into. This is created under
+ * the mutex when deferred formatting is first turned on, before the flag is
+ * set, and is kept until the target is destroyed.
+ */
+  struct deferred_pool *deferred_pool;
+/**
+ * The entry that the writer thread formats deferred messages into. This is
+ * only used by the writer thread, and is created when it is first needed.
+ */
+  struct stumpless_entry *writer_entry;
+/** The buffer that the writer thread formats deferred messages in. */
+  char *writer_buffer;
+/** The size of writer_buffer. */
+  size_t writer_buffer_size;
+/** Set when the target is closed, to tell the writer thread to finish. */
+  atomic_bool stopping;
+/** Set while the writer thread is waiting for new messages. */
+  atomic_bool writer_sleeping;
+/** The number of producers waiting for room in the queue. */
+  atomic_size_t waiting_producers;
+/** The number of threads waiting in stumpless_flush_target. */
+  atomic_size_t waiting_flushers;
+/** Protects the condition variables. */
+  config_mutex_t mutex;
+/** Signalled when a message is added while the writer thread is asleep. */
+  config_cond_t message_added;
+/** Signalled when the writer thread removes a message from the queue. */
+  config_cond_t space_available;
+/** Signalled when the finished position of the queue moves forward. */
+  config_cond_t message_sent;
+/** The writer thread. */
+  pthread_t writer;
+};
+
+void
+async_get_usage( struct stumpless_memory_usage *usage );
+
+/**
+ * Waits until every message queued before the call has been sent to the
+ * wrapped target or dropped.
+ *
+ * @since release v2.2.0
+ *
+ * @return The wrapped target, which may still be holding the messages in a
+ * buffer of its own.
+ */
+struct stumpless_target *
+flush_async_target( const struct stumpless_target *target );
+
+/**
+ * Queues a log message for the writer thread of an async target without
+ * formatting it, if the target has deferred formatting turned on and the
+ * message can be deferred.
+ *
+ * Messages cannot be deferred if the format string uses a conversion that is
+ * not supported by new_deferred_log, or if either the async target or the
+ * wrapped target has a filter other than the default mask filter, as custom
+ * filters need the formatted entry.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The async target to log to.
+ *
+ * @param priority The prival of the message.
+ *
+ * @param message The format string of the message.
+ *
+ * @param subs The substitutions for the format string. These are only read
+ * from copies, so that they may still be used if the message is not deferred.
+ *
+ * @param result Set to the result of the log call if it was deferred.
+ *
+ * @return true if the message was handled, and false if it must be logged
+ * normally instead.
+ */
+bool
+send_deferred_log_to_async_target( struct stumpless_target *target,
+                                   int priority,
+                                   const char *message,
+                                   va_list subs,
+                                   int *result );
+
+/**
+ * Queues an entry for the writer thread of an async target. The filter of the
+ * async target itself must already have been checked.
+ *
+ * @since release v2.2.0
+ */
+int
+send_entry_to_async_target( const struct stumpless_target *target,
+                            const struct stumpless_entry *entry );
+
+#endif /* __STUMPLESS_PRIVATE_TARGET_ASYNC_H */
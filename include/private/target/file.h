@@ -22,21 +22,180 @@
 #  include <stddef.h>
 #  include <stdio.h>
 #  include <stumpless/config.h>
+#  include <stumpless/memory.h>
 #  include <stumpless/target.h>
+#  include "private/config/wrapper/gzip.h"
+#  include "private/config/wrapper/segment.h"
 #  include "private/config/wrapper/thread_safety.h"
 
+/**
+ * The room needed after the name of a sharded file target for the suffix of
+ * a shard file: ".shard", the number of the shard, and a terminating NULL.
+ */
+#  define SHARD_SUFFIX_SIZE 18
+
+/**
+ * The size of the buffer on the stack that a record is built in before it is
+ * written to a shard. Longer records are built in a buffer on the heap.
+ */
+#  define SHARD_RECORD_BUFFER_SIZE 4096
+
+/**
+ * The room needed for the header of a shard record: a sequence number and a
+ * message length of up to 20 digits each, a space after each, and the
+ * terminating NULL that snprintf writes.
+ */
+#  define SHARD_RECORD_HEADER_SIZE 43
+
+/**
+ * A single shard file of a sharded file target.
+ */
+struct file_shard {
+/** The file descriptor of the shard, opened for appending. */
+  int fd;
+#ifdef STUMPLESS_THREAD_SAFETY_SUPPORTED
+/**
+ * Held while a record is numbered and written to the shard, so that the
+ * records in each shard are in sequence order even when threads share it.
+ * Only threads sharing the shard ever wait for this.
+ */
+  config_mutex_t mutex;
+#endif
+};
+
 /**
  * Internal representation of a file target.
  */
 struct file_target {
-/** A stream for the file this target writes to. */
+/**
+ * A stream for the file this target writes to, or NULL if this is a raw or
+ * segment file target.
+ */
   FILE *stream;
+/**
+ * The file descriptor that a raw or gzip file target writes to, opened for
+ * appending. This is -1 if the target uses a stream, segments, or shards.
+ */
+  int fd;
+/**
+ * The writer that a segment file target copies its messages into, or NULL if
+ * this is not a segment file target.
+ */
+  struct segment_writer *segments;
+/**
+ * The writer that a gzip file target compresses its messages with before they
+ * are written to fd, or NULL if this is not a gzip file target.
+ */
+  struct gzip_writer *gzip;
+/**
+ * The shards of a sharded file target, or NULL if this is not a sharded file
+ * target.
+ */
+  struct file_shard *shards;
+/** The number of shards in shards. */
+  unsigned int shard_count;
+/** The sequence number of the last record written, updated atomically. */
+  size_t shard_sequence;
+/**
+ * Messages that have not been written to the file yet, or NULL if each message
+ * is written to the stream as it is sent.
+ */
+  char *buffer;
+/** The number of bytes allocated for buffer. */
+  size_t buffer_size;
+/**
+ * The number of bytes in buffer waiting to be written, or for gzip file
+ * targets the number of bytes compressed into the current member.
+ */
+  size_t buffer_used;
+/**
+ * The longest time in milliseconds that a message may wait in buffer or in
+ * the current member of a gzip file target, or zero if there is no limit.
+ */
+  unsigned int flush_interval;
+/** The monotonic time in milliseconds that the oldest message was buffered. */
+  unsigned long long buffer_start;
+/**
+ * The io_uring writer that a raw file target queues its messages on, or NULL
+ * if each message is written as it is sent. This is only changed while holding
+ * stream_mutex, and must be checked again once it is held.
+ */
+  config_atomic_ptr_t uring;
+/**
+ * The size in bytes at which the file is rotated, or zero if it is not rotated
+ * based on its size. This is read atomically, and only changed while holding
+ * stream_mutex.
+ */
+  size_t rotate_size;
+/**
+ * The monotonic time in seconds at which the file is next rotated, or zero if
+ * it is not rotated based on its age. This is read atomically, and only
+ * changed while holding stream_mutex.
+ */
+  size_t rotate_deadline;
+/** The number of bytes written to the file, updated atomically. */
+  size_t rotate_written;
+/** The number of seconds between rotations based on age. */
+  unsigned int rotate_age;
+/** The number of rotated files to keep. */
+  unsigned int rotate_keep;
+/**
+ * Two buffers of rotate_path_size bytes each, both starting with the name of
+ * the file, that the names of rotated files are built in. This is NULL if the
+ * file is not rotated.
+ */
+  char *rotate_paths;
+/** The size of each buffer in rotate_paths. */
+  size_t rotate_path_size;
+/** The length of the file name at the start of each rotate_paths buffer. */
+  size_t rotate_name_length;
+/**
+ * The enum stumpless_file_durability of the target. This is read atomically,
+ * and only changed while holding sync_mutex.
+ */
+  int durability;
+/**
+ * The least severe message that causes a synchronization with a severity
+ * durability. This is read atomically, and only changed while holding
+ * sync_mutex.
+ */
+  int sync_severity;
+/**
+ * The number of milliseconds between synchronizations with a periodic
+ * durability. This is read atomically, and only changed while holding
+ * sync_mutex.
+ */
+  size_t sync_period;
+/**
+ * The monotonic time in milliseconds at which the file is next synchronized
+ * with a periodic durability. This is read atomically, and only changed while
+ * holding sync_mutex.
+ */
+  size_t sync_deadline;
+/**
+ * The number of messages that have asked for the file to be synchronized,
+ * incremented atomically once each message has been written.
+ */
+  size_t sync_requested;
+/**
+ * The value of sync_requested that the last synchronization of the file was
+ * started at, so that every message up to it is known to be on disk. This is
+ * only used while holding sync_mutex.
+ */
+  size_t synced;
 #ifdef STUMPLESS_THREAD_SAFETY_SUPPORTED
 /**
- * Protects stream. This mutex must be locked by a thread before it can write
- * to the stream.
+ * Protects stream, buffer, and the rotation of the file. This mutex must be
+ * locked by a thread before it can write to either. Raw file targets only lock
+ * it for messages too large to be appended atomically and for rotations.
  */
   config_mutex_t stream_mutex;
+/**
+ * Serializes synchronizations of the file with the disk. Threads waiting on it
+ * find out whether the synchronization that was running when they got there
+ * already covers their message once they hold it.
+ */
+  config_mutex_t sync_mutex;
 #endif
 };
 
@@ -46,10 +205,104 @@ destroy_file_target( struct file_target *target );
 struct stumpless_target *
 file_open_default_target( void );
 
+void
+file_get_usage( struct stumpless_memory_usage *usage );
+
+/**
+ * Writes any messages waiting in the buffer of the target to the file, and
+ * flushes the stream.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The stream_mutex is used to coordinate updates
+ * to the logged file.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate file writes.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @return 0 if the messages were written, or -1 if an error is encountered.
+ */
+int
+flush_file_target( struct file_target *target );
+
+/**
+ * Does what a file target needs to once a message with the given severity has
+ * been sent to it: flushing it if the severity is STUMPLESS_SEVERITY_ERR or
+ * more severe, and synchronizing the file with the disk if its durability
+ * calls for it.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The stream_mutex and sync_mutex are used to
+ * coordinate writes to and synchronizations of the file.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate file writes.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @return 0 if the target was flushed and synchronized as needed, or -1 if an
+ * error is encountered.
+ */
+int
+flush_file_target_for_severity( struct file_target *target, int severity );
+
 struct file_target *
 new_file_target( const char *filename );
 
 /**
+ * Creates a file target that writes to a file descriptor opened with O_APPEND
+ * instead of a stream.
+ *
+ * **Thread Safety: MT-Safe race:filename**
+ * This function is thread safe, of course assuming that filename is not
+ * modified by any other threads during execution.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory allocation functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory allocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param filename The name of the file to open.
+ *
+ * @return The new file target, or NULL if an error is encountered.
+ */
+struct file_target *
+new_raw_file_target( const char *filename );
+
+/**
+ * Sharded file targets write the message to the shard of the current thread
+ * after the next sequence number and the length of the message, holding only
+ * the mutex of that shard. Segment file targets copy the message into their current
+ * segment without taking any lock. Gzip file targets compress the message
+ * while holding the stream_mutex, finishing the current member once the flush
+ * interval has passed.
+ *
+ * If the target has a buffer, the message is added to it, and the buffer is
+ * written to the file once it is full or the flush interval has passed.
+ * Raw file targets write the message to their file descriptor, only locking
+ * the stream_mutex if it is longer than CONFIG_ATOMIC_APPEND_SIZE, unless it
+ * has an io_uring writer, in which case the message is queued on it while the
+ * lock is held. Otherwise, the message is written to the stream directly.
+ *
+ * Once the message is written, the file is rotated if it has reached the size
+ * or age limit set for it, while the stream_mutex is held.
+ *
  * **Thread Safety: MT-Safe**
  * This function is thread safe. The stream_mutex is used to coordinate updates
  * to the logged file.
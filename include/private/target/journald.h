@@ -21,6 +21,7 @@
 
 #  include <stddef.h>
 #  include <stumpless/entry.h>
+#  include <stumpless/memory.h>
 #  include <stumpless/target.h>
 
 /**
@@ -112,6 +113,27 @@ init_fixed_fields( void );
 void
 journald_free_thread( void );
 
+/**
+ * Adds the memory used by the per-thread journald buffers of all threads to
+ * usage.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe as the totals are read atomically.
+ *
+ * **Async Signal Safety: AS-Safe**
+ * This function is safe to call from signal handlers.
+ *
+ * **Async Cancel Safety: AC-Safe**
+ * This function is safe to call from threads that may be asynchronously
+ * cancelled.
+ *
+ * @since v2.2.0
+ *
+ * @param usage The usage to add the memory of the journald buffers to.
+ */
+void
+journald_get_usage( struct stumpless_memory_usage *usage );
+
 /**
  * Loads the facility field according to an entry's facility.
  *
@@ -22,6 +22,7 @@
 
 #  include <stddef.h>
 #  include <stumpless/config.h>
+#  include <stumpless/memory.h>
 #  include <stumpless/target.h>
 #  include <stumpless/target/network.h>
 #  include "private/config/network_support_wrapper.h"
@@ -59,6 +60,9 @@ lock_network_target( const struct network_target *target );
 void
 network_free_all( void );
 
+void
+network_get_usage( struct stumpless_memory_usage *usage );
+
 int
 network_target_is_open( const struct stumpless_target *target );
 
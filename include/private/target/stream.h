@@ -19,9 +19,12 @@
 #ifndef __STUMPLESS_PRIVATE_TARGET_STREAM_H
 #  define __STUMPLESS_PRIVATE_TARGET_STREAM_H
 
+#  include <stdbool.h>
 #  include <stddef.h>
 #  include <stdio.h>
 #  include <stumpless/config.h>
+#  include <stumpless/memory.h>
+#  include <stumpless/target/stream.h>
 #  include "private/config/wrapper/thread_safety.h"
 
 /**
@@ -30,22 +33,104 @@
 struct stream_target {
 /** The stream this target writes to. */
   FILE *stream;
+/** How the target buffers messages. */
+  enum stumpless_stream_buffering buffering;
+/**
+ * Messages that have not been written to the stream yet, or NULL unless the
+ * buffering is STUMPLESS_STREAM_BUFFERING_FULL.
+ */
+  char *buffer;
+/** The number of bytes allocated for buffer. */
+  size_t buffer_size;
+/** The number of bytes in buffer waiting to be written. */
+  size_t buffer_used;
+/**
+ * True if messages have been written to the stream since it was last flushed
+ * by the target.
+ */
+  bool unflushed;
+/**
+ * The longest time in milliseconds that a message may wait in buffer or the
+ * stream before it is flushed, or zero if there is no limit.
+ */
+  unsigned int flush_interval;
+/** The monotonic time in milliseconds that the oldest message was held. */
+  unsigned long long flush_start;
 #  ifdef STUMPLESS_THREAD_SAFETY_SUPPORTED
 /**
- * Protects stream. This mutex must be locked by a thread before it can write
- * to the stream.
+ * Protects stream and buffer. This mutex must be locked by a thread before it
+ * can write to either.
  */
   config_mutex_t stream_mutex;
 #  endif
 };
 
 void
-destroy_stream_target( const struct stream_target *target );
+destroy_stream_target( struct stream_target *target );
+
+/**
+ * Writes any messages waiting in the buffer of the target to the stream, and
+ * flushes the stream.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The stream_mutex is used to coordinate updates
+ * to the stream.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate writes.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @return 0 if the messages were written, or -1 if an error is encountered.
+ */
+int
+flush_stream_target( struct stream_target *target );
+
+/**
+ * Writes any messages waiting in the buffer of the target if a message with
+ * the given severity was just sent to it, which is done for
+ * STUMPLESS_SEVERITY_ERR and anything more severe. Targets without a buffer of
+ * their own are left alone.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The stream_mutex is used to coordinate updates
+ * to the stream.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate writes.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @return 0 if the target did not need to be flushed or was flushed without
+ * error, and -1 otherwise.
+ */
+int
+flush_stream_target_for_severity( struct stream_target *target,
+                                  int severity );
 
 struct stream_target *
 new_stream_target( FILE *stream );
 
+void
+stream_get_usage( struct stumpless_memory_usage *usage );
+
 /**
+ * With STUMPLESS_STREAM_BUFFERING_FULL, the message is added to the buffer of
+ * the target, and the buffer is written to the stream once it is full or the
+ * flush interval has passed. Otherwise the message is written to the stream
+ * directly, and the stream is flushed for STUMPLESS_STREAM_BUFFERING_LINE or
+ * once the flush interval has passed.
+ *
  * **Thread Safety: MT-Safe**
  * This function is thread safe. The stream_mutex is used to coordinate updates
  * to the stream.
@@ -31,6 +31,7 @@
 #ifndef __STUMPLESS_H
 #  define __STUMPLESS_H
 
+#  include <stumpless/arena.h>
 #  include <stumpless/config.h>
 #  include <stumpless/element.h>
 #  include <stumpless/entry.h>
@@ -60,6 +61,10 @@
 #  include <stumpless/target/stream.h>
 #  include <stumpless/version.h>
 
+#  ifdef STUMPLESS_ASYNC_TARGETS_SUPPORTED
+#    include <stumpless/target/async.h>
+#  endif
+
 #  ifdef STUMPLESS_JOURNALD_TARGETS_SUPPORTED
 #    include <stumpless/config/journald_supported.h>
 #    include <stumpless/target/journald.h>
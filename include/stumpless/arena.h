@@ -0,0 +1,189 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * Types and functions for creating and releasing arenas, regions of memory
+ * that entries, elements, and params can be created in and then released all
+ * at once.
+ *
+ * Objects created in an arena are allocated one after the other from large
+ * blocks, rather than with a separate call to the memory allocation function
+ * for each object, name, and value. Resetting or destroying the arena releases
+ * every object created in it in a single step, without the need to destroy each
+ * of them individually. This is well suited to entries that only live for the
+ * duration of a single event or request.
+ *
+ * Objects created in an arena may still be passed to the normal destruction
+ * functions such as stumpless_destroy_entry_and_contents, but doing so does not
+ * release their memory. Objects that were not created in the arena, for
+ * example a param created with stumpless_new_param and added to an arena
+ * element, are not released when the arena is reset and must be destroyed as
+ * usual.
+ *
+ * @since release v2.2.0
+ */
+
+#ifndef __STUMPLESS_ARENA_H
+#  define __STUMPLESS_ARENA_H
+
+#  include <stddef.h>
+#  include <stumpless/config.h>
+
+#  ifdef __cplusplus
+extern "C" {
+#  endif
+
+/**
+ * The size of the first block of an arena when a size of zero is requested.
+ *
+ * @since release v2.2.0
+ */
+#  define STUMPLESS_DEFAULT_ARENA_SIZE 4096
+
+/**
+ * A region of memory that entries, elements, and params can be created in.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_arena {
+/** The first block of the arena, which allocations start from after a reset. */
+  void *first_block;
+/** The block that allocations are currently made from. */
+  void *current_block;
+/** The offset of the first free byte in the current block. */
+  size_t position;
+/** The minimum size of blocks added to the arena when it runs out of room. */
+  size_t block_size;
+#  ifdef STUMPLESS_THREAD_SAFETY_SUPPORTED
+#    ifdef STUMPLESS_FUTEX_LOCKS_SUPPORTED
+/**
+ * A mutex which protects all arena fields, stored directly in the structure
+ * as a futex word.
+ */
+  unsigned int mutex;
+#    else
+/**
+ * A pointer to a mutex which protects all arena fields. The exact type of
+ * this mutex depends on the build.
+ */
+  void *mutex;
+#    endif
+#  endif
+};
+
+/**
+ * Destroys an arena, releasing all of its memory along with every entry,
+ * element, and param that was created in it.
+ *
+ * None of the objects created in the arena may be used after this call.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe as it destroys resources that other threads
+ * would use if they tried to reference this arena or its objects.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the destruction
+ * of a lock that may be in use as well as the use of the memory deallocation
+ * function to release memory.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the cleanup of the lock may not be completed, and the memory
+ * deallocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param arena The arena to destroy.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+void
+stumpless_destroy_arena( const struct stumpless_arena *arena );
+
+/**
+ * Creates a new arena.
+ *
+ * The arena starts with a single block of the given size, and grows by adding
+ * more blocks of at least this size as needed. Choosing a size large enough to
+ * hold all of the objects created for a typical event means that creating them
+ * requires no further memory allocation.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory management functions to create the new arena.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param size The size of the first block of the arena in bytes, and the
+ * minimum size of any blocks added later. If this is zero, then
+ * STUMPLESS_DEFAULT_ARENA_SIZE is used.
+ *
+ * @return The created arena, if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_arena *
+stumpless_new_arena( size_t size );
+
+/**
+ * Releases every entry, element, and param created in an arena, so that its
+ * memory can be used for new objects.
+ *
+ * This takes the same time regardless of the number of objects in the arena.
+ * The blocks of the arena are kept for reuse rather than returned to the
+ * memory allocator, so an arena that is reset after each event will stop
+ * allocating memory once it has grown to fit the largest one.
+ *
+ * None of the objects created in the arena before the reset may be used after
+ * this call.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to coordinate the reset with
+ * other accesses to the arena. Of course, other threads must not be using
+ * objects from the arena when it is reset.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate access.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param arena The arena to reset.
+ *
+ * @return The reset arena, if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_arena *
+stumpless_reset_arena( struct stumpless_arena *arena );
+
+#  ifdef __cplusplus
+}                               /* extern "C" */
+#  endif
+
+#endif /* __STUMPLESS_ARENA_H */
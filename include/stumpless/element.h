@@ -25,6 +25,7 @@
 
 #  include <stdbool.h>
 #  include <stddef.h>
+#  include <stumpless/arena.h>
 #  include <stumpless/config.h>
 #  include <stumpless/entry.h>
 #  include <stumpless/param.h>
@@ -122,6 +123,36 @@ struct stumpless_element {
   struct stumpless_param **params;
 /** The number of params in the array. */
   size_t param_count;
+/**
+ * The number of param pointers that the params array has room for. This is
+ * always at least param_count, and grows geometrically as params are added.
+ *
+ * @since release v2.2.0
+ */
+  size_t param_capacity;
+/**
+ * True if this element has been frozen with stumpless_freeze_element. A frozen
+ * element may not be modified, and is read without locking.
+ *
+ * @since release v2.2.0
+ */
+  bool frozen;
+/**
+ * The number of owners of this element. This is only ever more than one for a
+ * frozen element, which copies of a containing entry share rather than
+ * duplicate. The element is only destroyed once the last owner releases it.
+ *
+ * @since release v2.2.0
+ */
+  size_t reference_count;
+/**
+ * The arena that this element was created in, or NULL if it was created on the
+ * heap. Memory for an element in an arena, including its name, is
+ * allocated from the arena and released when the arena is reset or destroyed.
+ *
+ * @since release v2.2.0
+ */
+  struct stumpless_arena *arena;
 #ifdef STUMPLESS_JOURNALD_TARGETS_SUPPORTED
 /**
  * Gets the name to use for the journald field corresponding to this element.
@@ -129,11 +160,23 @@ struct stumpless_element {
   stumpless_element_namer_func_t get_journald_name;
 #endif
 #ifdef STUMPLESS_THREAD_SAFETY_SUPPORTED
+#  ifdef STUMPLESS_FUTEX_LOCKS_SUPPORTED
+/**
+ * A reader-writer lock which protects all element fields, stored directly in
+ * the structure as a futex word.
+ *
+ * @since release v2.2.0
+ */
+  unsigned int mutex;
+#  else
 /**
- * A pointer to a mutex which protects all element fields. The exact type of
- * this mutex depends on the build.
+ * A pointer to a reader-writer lock which protects all element fields. Readers
+ * share the lock, while modifications hold it exclusively. The exact type of
+ * this lock depends on the build. Despite the name of this field, it has not
+ * been a plain mutex since release v2.2.0.
  */
   void *mutex;
+#  endif
 #endif
 };
 
@@ -178,6 +221,11 @@ stumpless_add_new_param( struct stumpless_element *element,
 /**
  * Adds a param to an element.
  *
+ * A frozen param may be added to any number of elements. Each element takes
+ * its own reference to it, so the caller keeps theirs and must still release
+ * it with stumpless_destroy_param once it is no longer needed. The param is
+ * only destroyed once every reference has been released.
+ *
  * **Thread Safety: MT-Safe**
  * This function is thread safe. A mutex is used to coordinate updates to the
  * element with other accesses and modifications.
@@ -212,6 +260,11 @@ stumpless_add_param( struct stumpless_element *element,
  * the original element are destroyed, the equivalent ones in this element will
  * still be valid.
  *
+ * Frozen params are the exception, as they are shared between the original
+ * and the copy rather than copied. If a shared param is modified through one
+ * of the element functions such as stumpless_set_param_value_by_name, the
+ * element first receives its own unfrozen copy of the param.
+ *
  * **Thread Safety: MT-Safe**
  * This function is thread safe. A mutex is used to coordinate the read of the
  * element with other accesses and modifications.
@@ -344,6 +397,42 @@ bool
 stumpless_element_has_param( const struct stumpless_element *element,
                              const char *name );
 
+/**
+ * Freezes an element, making it read-only for the rest of its lifetime.
+ * All of the params in the element are frozen as well.
+ *
+ * Once frozen, attempts to modify the element will fail with a
+ * STUMPLESS_OBJECT_FROZEN error. In exchange, reads of a frozen element,
+ * including formatting it for a target, no longer need to lock it. This makes
+ * freezing a good fit for elements that are built once and then shared
+ * between many threads.
+ *
+ * Freezing an element that is already frozen has no effect. There is no way to
+ * unfreeze an element, but copies made of it are not frozen.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to wait for any modifications
+ * in progress to finish before the element is frozen.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate changes.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param element The element to freeze.
+ *
+ * @return The frozen element if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_element *
+stumpless_freeze_element( struct stumpless_element *element );
+
 /**
  * Returns the name of the given element. The character buffer must be freed by
  * the caller when it is no longer needed to avoid memory leaks.
@@ -663,6 +752,44 @@ const char *
 stumpless_get_param_value_by_name( const struct stumpless_element *element,
                                    const char *name );
 
+/**
+ * Creates a new element with the given name in an arena. This is the same as
+ * stumpless_new_element, except that the element is allocated from the given
+ * arena. Params added to the element with stumpless_add_new_param are created
+ * in the same arena.
+ *
+ * The element is released when the arena is reset or destroyed, and so does
+ * not need to be destroyed on its own.
+ *
+ * **Thread Safety: MT-Safe race:name**
+ * This function is thread safe, of course assuming that name is not changed
+ * by other threads during execution. A mutex is used to coordinate
+ * allocations from the arena.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate access to the arena and the possible use of
+ * memory management functions to grow it.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked as well as
+ * memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param arena The arena to create the element in.
+ *
+ * @param name The name of the new element, under the same restrictions as
+ * names given to stumpless_new_element.
+ *
+ * @return The created element, if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_element *
+stumpless_new_arena_element( struct stumpless_arena *arena, const char *name );
+
 /**
  * Creates a new element with the given name.
  *
@@ -688,6 +815,43 @@ STUMPLESS_PUBLIC_FUNCTION
 struct stumpless_element *
 stumpless_new_element( const char *name );
 
+/**
+ * Ensures that the given element has room for at least count params without
+ * needing to grow its param array. Callers that know the number of params an
+ * element will hold can use this to avoid repeated reallocations as the params
+ * are added.
+ *
+ * If the element already has room for count params, then it is not modified.
+ * This function never shrinks the param array.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to coordinate changes to the
+ * element while it is being modified.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate changes and the use of memory management
+ * functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked as well as
+ * memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param element The element to reserve space in.
+ *
+ * @param count The total number of params that the element should be able to
+ * hold.
+ *
+ * @return The modified element if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_element *
+stumpless_reserve_params( struct stumpless_element *element, size_t count );
+
 /**
  * Sets the name of the given element.
  *
@@ -725,7 +889,8 @@ stumpless_set_element_name( struct stumpless_element *element,
  *
  * The parameter previously at this position will be removed from the element,
  * but it is NOT destroyed by this call. Callers must clean up this param
- * separately.
+ * separately. If the new param is frozen, the element takes its own reference
+ * to it, as it does in stumpless_add_param.
  *
  * A param cannot be set at an index position that does not already hold a
  * param. If this is attempted, then a STUMPLESS_INDEX_OUT_OF_BOUNDS error
@@ -838,6 +1003,53 @@ stumpless_set_param_value_by_name( struct stumpless_element *element,
                                    const char *name,
                                    const char *value );
 
+/**
+ * Sets the values of the first params of an element at once.
+ *
+ * The value at each position is assigned to the param at the same index in the
+ * element. A NULL value leaves the param at that index unchanged. This is
+ * equivalent to calling stumpless_set_param_value_by_index for each value, but
+ * the element is only locked once.
+ *
+ * If there are more values than params in the element, then a
+ * STUMPLESS_INDEX_OUT_OF_BOUNDS error is raised and no params are changed.
+ * The memory for all of the values is allocated before any of them are set,
+ * so no params are changed if a memory allocation fails either. For this
+ * reason, the values must not point into the current value of any param.
+ *
+ * **Thread Safety: MT-Safe race:values**
+ * This function is thread safe, of course assuming that the values are not
+ * changed by any other threads during execution. A mutex is used to coordinate
+ * changes to the element while it is being modified.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate changes and the use of memory management
+ * functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked as well as
+ * memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param element The element to set the param values on.
+ *
+ * @param values The new values of the params, in order. Any of these may be
+ * NULL to leave the param at that index unchanged.
+ *
+ * @param value_count The number of values in values.
+ *
+ * @return The modified element, if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_element *
+stumpless_set_param_values( struct stumpless_element *element,
+                            const char * const *values,
+                            size_t value_count );
+
 /**
  * Returns name and params from element as a formatted string.
  * The character buffer should be freed when no longer is needed by the caller.
@@ -26,6 +26,7 @@
 #  include <stdarg.h>
 #  include <stdbool.h>
 #  include <stddef.h>
+#  include <stumpless/arena.h>
 #  include <stumpless/config.h>
 #  include <stumpless/element.h>
 #  include <stumpless/facility.h>
@@ -73,6 +74,15 @@ struct stumpless_entry {
   char *message;
 /** The length of the message in bytes, without the NULL terminator. */
   size_t message_length;
+/**
+ * The number of bytes available at message, including the NULL terminator.
+ * New messages that fit in this space are written over the current one rather
+ * than allocated separately. This is zero if the size of the message buffer
+ * is not known, for example when it was formatted by stumpless_new_entry.
+ *
+ * @since release v2.2.0
+ */
+  size_t message_capacity;
 /** The message id of this entry, as a NULL-terminated string. */
   char msgid[STUMPLESS_MAX_MSGID_LENGTH + 1];
 /** The length of the message id, without the NULL terminator. */
@@ -81,16 +91,51 @@ struct stumpless_entry {
   struct stumpless_element **elements;
 /** The number of elements in this entry. */
   size_t element_count;
+/**
+ * The number of element pointers that the elements array has room for. This
+ * is always at least element_count, and grows geometrically as elements are
+ * added so that building an entry does not reallocate on every addition.
+ *
+ * @since release v2.2.0
+ */
+  size_t element_capacity;
+/**
+ * True if this entry has been frozen with stumpless_freeze_entry. A frozen
+ * entry may not be modified, and is read without locking.
+ *
+ * @since release v2.2.0
+ */
+  bool frozen;
+/**
+ * The arena that this entry was created in, or NULL if it was created on the
+ * heap. Memory for an entry in an arena, including its message, is
+ * allocated from the arena and released when the arena is reset or destroyed.
+ *
+ * @since release v2.2.0
+ */
+  struct stumpless_arena *arena;
 #  ifdef STUMPLESS_WINDOWS_EVENT_LOG_TARGETS_SUPPORTED
 /** A pointer to a wel_fields structure. */
   void *wel_data;
 #  endif
 #  ifdef STUMPLESS_THREAD_SAFETY_SUPPORTED
+#    ifdef STUMPLESS_FUTEX_LOCKS_SUPPORTED
 /**
- * A pointer to a mutex which protects all entry fields. The exact type of
- * this mutex depends on the build.
+ * A reader-writer lock which protects all entry fields, stored directly in
+ * the structure as a futex word.
+ *
+ * @since release v2.2.0
+ */
+  unsigned int mutex;
+#    else
+/**
+ * A pointer to a reader-writer lock which protects all entry fields. Readers
+ * share the lock, while modifications hold it exclusively. The exact type of
+ * this lock depends on the build. Despite the name of this field, it has not
+ * been a plain mutex since release v2.2.0.
  */
   void *mutex;
+#    endif
 #  endif
 };
 
@@ -102,6 +147,11 @@ struct stumpless_entry {
  * attempts to add an element to an entry already having one with the same name
  * will result in a STUMPLESS_DUPLICATE_ELEMENT error.
  *
+ * A frozen element may be added to any number of entries. Each entry takes its
+ * own reference to it, so the caller keeps theirs and must still release it
+ * with stumpless_destroy_element_and_contents once it is no longer needed. The
+ * element is only destroyed once every reference has been released.
+ *
  * **Thread Safety: MT-Safe**
  * This function is thread safe. A mutex is used to coordinate changes to the
  * entry while it is being modified.
@@ -213,6 +263,15 @@ stumpless_add_new_param_to_entry( struct stumpless_entry *entry,
  * elements or params of the original entry are destroyed, the equivalent ones
  * in this entry will still be valid.
  *
+ * The exception to this is frozen elements, which cannot change and are
+ * therefore shared between the original and the copy instead of copied. A
+ * shared element stays valid until every entry holding it is destroyed. If a
+ * shared element of the copy is later modified through one of the entry
+ * functions such as stumpless_set_entry_param_value_by_name, the copy first
+ * receives its own unfrozen copy of the element, leaving the original as it
+ * was. This makes copying a frozen entry much cheaper than copying one that
+ * is not frozen.
+ *
  * **Thread Safety: MT-Safe**
  * This function is thread safe. A mutex is used to coordinate the read of the
  * entry with other accesses and modifications.
@@ -343,6 +402,43 @@ bool
 stumpless_entry_has_element( const struct stumpless_entry *entry,
                              const char *name );
 
+/**
+ * Freezes an entry, making it read-only for the rest of its lifetime.
+ * All of the elements in the entry, and the params within them, are frozen as
+ * well.
+ *
+ * Once frozen, attempts to modify the entry will fail with a
+ * STUMPLESS_OBJECT_FROZEN error. In exchange, reads of a frozen entry,
+ * including formatting it for a target, no longer need to lock it. This makes
+ * freezing a good fit for entrys that are built once and then shared
+ * between many threads.
+ *
+ * Freezing an entry that is already frozen has no effect. There is no way to
+ * unfreeze an entry, but copies made of it are not frozen.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to wait for any modifications
+ * in progress to finish before the entry is frozen.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate changes.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param entry The entry to freeze.
+ *
+ * @return The frozen entry if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_entry *
+stumpless_freeze_entry( struct stumpless_entry *entry );
+
 /**
  * Returns the element at the given index in this Entry.
  *
@@ -810,6 +906,75 @@ STUMPLESS_PUBLIC_FUNCTION
 enum stumpless_severity
 stumpless_get_entry_severity( const struct stumpless_entry *entry );
 
+/**
+ * Creates a new entry in an arena. This is the same as stumpless_new_entry,
+ * except that the entry and its message are allocated from the given arena.
+ * Elements and params added to the entry with stumpless_add_new_element,
+ * stumpless_add_new_param_to_entry, and similar functions are created in the
+ * same arena.
+ *
+ * The entry is released when the arena is reset or destroyed, and so does not
+ * need to be destroyed on its own. The exception to this is in builds with
+ * Windows Event Log target support, where the event log fields of the entry
+ * are kept outside of the arena and are only released when the entry is
+ * destroyed.
+ *
+ * The message must be a valid format specifier string provided along with the
+ * appropriate number of variable arguments afterwards. This means that it
+ * should not be a user-controlled value under any circumstances.
+ *
+ * **Thread Safety: MT-Safe race:app_name race:msgid race:message**
+ * This function is thread safe, of course assuming that the string arguments
+ * are not changed by other threads during execution. A mutex is used to
+ * coordinate allocations from the arena.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate access to the arena and the possible use of
+ * memory management functions to grow it.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked as well as
+ * memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param arena The arena to create the entry in.
+ *
+ * @param facility The facility code of the event this entry describes. This
+ * should be a \c STUMPLESS_FACILITY value.
+ *
+ * @param severity The severity code of the event this entry describes. This
+ * should be a \c STUMPLESS_SEVERITY value.
+ *
+ * @param app_name The app_name of the entry. If this is NULL, then it will be
+ * blank in the entry (a single '-' character).
+ *
+ * @param msgid The message id of the entry. If this is NULL, then it will be
+ * blank in the entry (a single '-' character).
+ *
+ * @param message The message in the entry. This message may contain any format
+ * specifiers valid in \c printf. If this is NULL, then it will be blank in the
+ * entry (no characters).
+ *
+ * @param ... Substitutions for any format specifiers provided in message. The
+ * number of substitutions provided must exactly match the number of specifiers
+ * given.
+ *
+ * @return The created entry if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_entry *
+stumpless_new_arena_entry( struct stumpless_arena *arena,
+                           enum stumpless_facility facility,
+                           enum stumpless_severity severity,
+                           const char *app_name,
+                           const char *msgid,
+                           const char *message,
+                           ... );
+
 /**
  * Creates a new entry with the given characteristics.
  *
@@ -912,12 +1077,87 @@ stumpless_new_entry_str( enum stumpless_facility facility,
                          const char *msgid,
                          const char *message );
 
+/**
+ * Ensures that the given entry has room for at least count elements without
+ * needing to grow its element array. Callers that know the number of elements
+ * an entry will hold can use this to avoid repeated reallocations as the
+ * elements are added.
+ *
+ * If the entry already has room for count elements, then it is not modified.
+ * This function never shrinks the element array.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to coordinate changes to the
+ * entry while it is being modified.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate changes and the use of memory management
+ * functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked as well as
+ * memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param entry The entry to reserve space in.
+ *
+ * @param count The total number of elements that the entry should be able to
+ * hold.
+ *
+ * @return The modified entry if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_entry *
+stumpless_reserve_elements( struct stumpless_entry *entry, size_t count );
+
+/**
+ * Clears the message and the value of each param in an entry, so that it can
+ * be filled in again and logged without building a new entry.
+ *
+ * The elements and params of the entry are kept, along with the memory used
+ * to hold the message and param values. Setting a new message or value that
+ * fits in this memory does not allocate any more, so an entry that is reset
+ * and reused for each event stops allocating memory once it has held the
+ * largest one. The values can be filled in again with
+ * stumpless_set_entry_param_values.
+ *
+ * Frozen elements and params are shared with other entries, so their values
+ * are left as they are.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to coordinate changes to the
+ * entry with other accesses and modifications.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate access.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param entry The entry to reset.
+ *
+ * @return The reset entry, if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_entry *
+stumpless_reset_entry( struct stumpless_entry *entry );
+
 /**
  * Puts the element at the given index in the given entry.
  *
  * The element previously at this position will be removed from the entry,
  * but it is NOT destroyed by this call. Callers must clean up this element
- * separately.
+ * separately. If the new element is frozen, the entry takes its own reference
+ * to it, as it does in stumpless_add_element.
  *
  * An element cannot be set at an index position that does not already hold
  * one. If this is attempted, then a STUMPLESS_INDEX_OUT_OF_BOUNDS error
@@ -1107,6 +1347,11 @@ stumpless_set_entry_message( struct stumpless_entry *entry,
 /**
  * Sets the message of a given entry.
  *
+ * If the new message fits in the memory holding the current one, then it is
+ * written over it without allocating any more. Otherwise, a new buffer is
+ * allocated with extra room, so that an entry reused for many messages only
+ * needs to grow a few times.
+ *
  * **Thread Safety: MT-Safe**
  * This function is thread safe. A mutex is used to coordinate changes to the
  * entry while it is being modified.
@@ -1269,6 +1514,54 @@ stumpless_set_entry_param_value_by_name( struct stumpless_entry *entry,
                                          const char *param_name,
                                          const char *value );
 
+/**
+ * Sets the values of several params in an entry at once.
+ *
+ * The values are assigned in order to the params of the entry, starting with
+ * the first param of the first element and continuing through each element in
+ * turn. A NULL value leaves the param at that position unchanged. This is
+ * equivalent to calling stumpless_set_entry_param_value_by_index for each
+ * value, but the entry is only locked once.
+ *
+ * If there are more values than params in the entry, then a
+ * STUMPLESS_INDEX_OUT_OF_BOUNDS error is raised and no params are changed.
+ * The memory for all of the values is allocated before any of them are set,
+ * so no params are changed if a memory allocation fails either. For this
+ * reason, the values must not point into the current value of any param.
+ *
+ * **Thread Safety: MT-Safe race:values**
+ * This function is thread safe, of course assuming that the values are not
+ * changed by any other threads during execution. A mutex is used to coordinate
+ * changes to the entry while it is being modified.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate changes and the use of memory management
+ * functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked as well as
+ * memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param entry The entry to set the param values on.
+ *
+ * @param values The new values of the params, in order. Any of these may be
+ * NULL to leave the param at that position unchanged.
+ *
+ * @param value_count The number of values in values.
+ *
+ * @return The modified entry, if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_entry *
+stumpless_set_entry_param_values( struct stumpless_entry *entry,
+                                  const char * const *values,
+                                  size_t value_count );
+
 /**
  * Sets the facility and severity of an entry.
  *
@@ -1370,6 +1663,64 @@ struct stumpless_entry *
 stumpless_set_entry_severity( struct stumpless_entry *entry,
                               enum stumpless_severity severity );
 
+/**
+ * Creates a new entry in an arena, using a va_list for the message
+ * substitutions. See stumpless_new_arena_entry for details.
+ *
+ * **Thread Safety: MT-Safe race:app_name race:msgid race:message**
+ * This function is thread safe, of course assuming that the string arguments
+ * are not changed by other threads during execution. A mutex is used to
+ * coordinate allocations from the arena.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate access to the arena and the possible use of
+ * memory management functions to grow it.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked as well as
+ * memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param arena The arena to create the entry in.
+ *
+ * @param facility The facility code of the entry. This should be a
+ * \c STUMPLESS_FACILITY value.
+ *
+ * @param severity The severity code of the entry. This should be a
+ * \c STUMPLESS_SEVERITY value.
+ *
+ * @param app_name The app_name of the entry. If this is NULL, then it will be
+ * blank in the entry (a single '-' character).
+ *
+ * @param msgid The message id of the entry. If this is NULL, then it will be
+ * blank in the entry (a single '-' character).
+ *
+ * @param message The message in the entry. This message may contain any format
+ * specifiers valid in \c printf. If this is NULL, then it will be blank in the
+ * entry (no characters).
+ *
+ * @param subs Substitutions for any format specifiers provided in message. The
+ * number of substitutions provided must exactly match the number of
+ * specifiers given. This list must be started via \c va_start before being
+ * used, and \c va_end should be called afterwards, as this function does not
+ * call them.
+ *
+ * @return The created entry if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_entry *
+vstumpless_new_arena_entry( struct stumpless_arena *arena,
+                            enum stumpless_facility facility,
+                            enum stumpless_severity severity,
+                            const char *app_name,
+                            const char *msgid,
+                            const char *message,
+                            va_list subs );
+
 /**
  * Creates a new entry with the given parameters.
  *
@@ -1428,6 +1779,11 @@ vstumpless_new_entry( enum stumpless_facility facility,
 /**
  * Sets the message of a given entry.
  *
+ * If the new message fits in the memory holding the current one, then it is
+ * written over it without allocating any more. Otherwise, a new buffer is
+ * allocated with extra room, so that an entry reused for many messages only
+ * needs to grow a few times.
+ *
  * **Thread Safety: MT-Safe**
  * This function is thread safe. A mutex is used to coordinate changes to the
  * entry while it is being modified.
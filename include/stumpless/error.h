@@ -119,7 +119,25 @@ extern "C" {
  *
  * @since release v2.1.0
  */\
-  ERROR( STUMPLESS_JOURNALD_FAILURE, 27 )
+  ERROR( STUMPLESS_JOURNALD_FAILURE, 27 ) \
+/**
+ * An attempt was made to modify a frozen entry, element, or param.
+ *
+ * @since release v2.2.0
+ */\
+  ERROR( STUMPLESS_OBJECT_FROZEN, 28 ) \
+/**
+ * A thread could not be created.
+ *
+ * @since release v2.2.0
+ */\
+  ERROR( STUMPLESS_THREAD_FAILURE, 29 ) \
+/**
+ * A message could not be built from a format string and its substitutions.
+ *
+ * @since release v2.2.0
+ */\
+  ERROR( STUMPLESS_FORMAT_FAILURE, 30 )
 
 
 /**
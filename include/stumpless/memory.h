@@ -25,6 +25,12 @@
  * this capability is used extensively to test for error handling in memory
  * allocation failure scenarios, as well as to ensure that the same amount of
  * memory is freed as is allocated.
+ *
+ * An allocator set with stumpless_set_allocator or
+ * stumpless_set_thread_allocator also receives a context pointer with each
+ * call, and the size of the memory being released when this is known. This
+ * allows allocations to be routed to a specific pool without any global state
+ * in the allocator itself.
  */
 
 #ifndef __STUMPLESS_MEMORY_H
@@ -37,6 +43,115 @@
 extern "C" {
 #  endif
 
+/**
+ * A set of memory management functions along with a context pointer that is
+ * passed to each of them.
+ *
+ * Memory may be released by a different allocator than the one that allocated
+ * it, for example if it was allocated in one thread and freed in another, or
+ * if it was allocated before a call to stumpless_set_allocator. If several
+ * allocators are used at once, then they must all be able to release memory
+ * from any of the others, for example by drawing from the same underlying
+ * heap.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_allocator {
+/**
+ * Allocates size bytes of memory, in the same way as the standard library
+ * \c malloc function.
+ */
+  void *( *malloc_func )( size_t size, void *context );
+/**
+ * Resizes memory to size bytes, in the same way as the standard library
+ * \c realloc function.
+ */
+  void *( *realloc_func )( void *mem, size_t size, void *context );
+/**
+ * Releases memory, in the same way as the standard library \c free function.
+ *
+ * The size is the number of bytes that were requested when the memory was
+ * allocated or last resized, or zero if the library does not know the size.
+ * Memory passed to this function is never NULL.
+ * This allows a sized deallocation function to be used when it is available.
+ */
+  void ( *free_func )( void *mem, size_t size, void *context );
+/** A pointer passed to each of the functions as their context argument. */
+  void *context;
+};
+
+/**
+ * The amount of memory used by one kind of internal structure.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_memory_usage {
+/** The number of bytes allocated. */
+  size_t bytes;
+/** The number of structures in use. */
+  size_t count;
+};
+
+/**
+ * A snapshot of the memory held internally by the library, as returned by
+ * stumpless_get_memory_stats.
+ *
+ * Only memory that the library holds on to between calls is reported here.
+ * Memory owned by the caller, such as entries, elements, and params that have
+ * not been destroyed, is not included apart from the cache space used by
+ * entries.
+ *
+ * @since release v2.2.0
+ */
+struct stumpless_memory_stats {
+/**
+ * The pages of the entry cache. The count is the number of entries currently
+ * allocated from it.
+ */
+  struct stumpless_memory_usage entry_cache;
+/**
+ * The string builders used to format messages, including both the cache they
+ * are allocated from and their buffers. The count is the number of builders
+ * currently in use.
+ */
+  struct stumpless_memory_usage strbuilders;
+/**
+ * The caches that mutexes and reader-writer locks are allocated from, if locks
+ * are not stored directly in the structures they protect. The count is the
+ * number of locks currently allocated from them.
+ */
+  struct stumpless_memory_usage lock_cache;
+/**
+ * The per-thread buffers used to send messages to TCP network targets. The
+ * count is the number of threads that have one.
+ */
+  struct stumpless_memory_usage tcp_send_buffers;
+/**
+ * The per-thread buffers used to build messages for journald targets. The
+ * count is the number of buffers allocated across all threads.
+ */
+  struct stumpless_memory_usage journald_buffers;
+/**
+ * The target structures and names common to all open targets. The count is
+ * the number of open targets.
+ */
+  struct stumpless_memory_usage targets;
+/**
+ * The queues of open async targets. The count is the number of queues.
+ */
+  struct stumpless_memory_usage async_queues;
+/**
+ * The buffers that file targets combine messages in. The count is the number
+ * of file targets that have one.
+ */
+  struct stumpless_memory_usage file_buffers;
+/**
+ * The buffers that fully buffered stream targets combine messages in. The
+ * count is the number of stream targets that have one.
+ */
+  struct stumpless_memory_usage stream_buffers;
+};
+
 /**
  * Closes the default target if it has been opened, frees all memory allocated
  * internally, and performs any other necessary cleanup.
@@ -94,6 +209,75 @@ STUMPLESS_PUBLIC_FUNCTION
 void
 stumpless_free_thread( void );
 
+/**
+ * Gets the amount of memory currently held internally by the library.
+ *
+ * The values are gathered from counters that are kept up to date as memory is
+ * allocated and released, and from the caches themselves, so this function
+ * does not need to allocate any memory and is cheap enough to call
+ * periodically in order to track memory growth.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. Each value is read atomically or while holding
+ * the lock of the cache it describes, although values may be from slightly
+ * different points in time if other threads are logging concurrently. It
+ * must not be called at the same time as stumpless_free_all.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of
+ * locks to read the caches.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of locks that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param stats The structure to write the memory usage into.
+ *
+ * @return The stats structure that was passed in, if no error is encountered.
+ * If an error is encountered, then NULL is returned and an error code is set
+ * appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_memory_stats *
+stumpless_get_memory_stats( struct stumpless_memory_stats *stats );
+
+/**
+ * Sets the allocator used by the library to manage memory in all threads that
+ * do not have their own allocator set with stumpless_set_thread_allocator.
+ *
+ * The allocator is copied, so the structure passed in does not need to remain
+ * valid after this call. Later calls to stumpless_set_malloc,
+ * stumpless_set_realloc, or stumpless_set_free replace the corresponding
+ * function of this allocator.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe as it changes the memory allocation
+ * scheme, which could cause an operation to use the old functions for some
+ * allocation and the new functions for others. If you need to set any of the
+ * memory management functions, it should be done before starting multiple
+ * threads with access to shared resources.
+ *
+ * **Async Signal Safety: AS-Unsafe**
+ * This function is not safe to call from signal handlers for the same reason
+ * as it is not thread safe.
+ *
+ * **Async Cancel Safety: AC-Unsafe**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the assignment is not guaranteed to be atomic.
+ *
+ * @since release v2.2.0
+ *
+ * @param allocator The allocator to use. None of its functions may be NULL.
+ *
+ * @return The new global allocator, if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+const struct stumpless_allocator *
+stumpless_set_allocator( const struct stumpless_allocator *allocator );
+
 /**
  * Sets the function used by the library to allocate memory.
  *
@@ -181,6 +365,45 @@ void *
 ( *stumpless_set_realloc( void * ( *realloc_func ) ( void *, size_t) ) )
 ( void *, size_t );
 
+/**
+ * Sets the allocator used by the library to manage memory in the current
+ * thread, in place of the global allocator.
+ *
+ * The allocator is copied, so the structure passed in does not need to remain
+ * valid after this call. Passing NULL removes the allocator for the current
+ * thread, so that the global allocator is used once again.
+ *
+ * Memory allocated by a thread is not always released by the same thread, as
+ * objects such as entries and targets may be shared between threads and some
+ * structures are cached for use by any thread. The allocators in use must
+ * therefore be able to release memory from each other, as described in
+ * struct stumpless_allocator.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe as it only changes thread-local state.
+ *
+ * **Async Signal Safety: AS-Unsafe**
+ * This function is not safe to call from signal handlers, as an operation in
+ * the interrupted code could use the old functions for some allocations and
+ * the new functions for others.
+ *
+ * **Async Cancel Safety: AC-Unsafe**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the assignment is not guaranteed to be atomic.
+ *
+ * @since release v2.2.0
+ *
+ * @param allocator The allocator to use in the current thread, or NULL to use
+ * the global allocator. None of its functions may be NULL.
+ *
+ * @return The allocator now in use for the current thread, which is the global
+ * allocator if NULL was passed, if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+const struct stumpless_allocator *
+stumpless_set_thread_allocator( const struct stumpless_allocator *allocator );
+
 #  ifdef __cplusplus
 }                               /* extern "C" */
 #  endif
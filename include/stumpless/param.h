@@ -23,7 +23,9 @@
 #ifndef __STUMPLESS_PARAM_H
 #  define __STUMPLESS_PARAM_H
 
+#  include <stdbool.h>
 #  include <stddef.h>
+#  include <stumpless/arena.h>
 #  include <stumpless/config.h>
 #  include <stumpless/entry.h>
 
@@ -82,6 +84,15 @@ size_t
                                    size_t size );
 #endif
 
+/**
+ * The size of the buffer within each param that holds short values, including
+ * the NULL terminating character. Values that fit in this buffer are stored
+ * without a separate memory allocation.
+ *
+ * @since release v2.2.0
+ */
+#  define STUMPLESS_PARAM_VALUE_BUFFER_SIZE 40
+
 /**
  * A parameter within a structured data element.
  *
@@ -118,20 +129,73 @@ struct stumpless_param {
  * If you need to access the value, use the stumpless_(g|s)et_param_value
  * functions. These will protect you from changes in the struct in future
  * versions.
+ *
+ * Values shorter than STUMPLESS_PARAM_VALUE_BUFFER_SIZE point to value_buffer
+ * within this param, rather than to separately allocated memory. Longer values
+ * are written over the previous value if it was allocated with enough space,
+ * and values cleared by stumpless_reset_entry keep their existing memory.
  */
   char *value;
 /** The number of characters in value (not including the NULL character). */
   size_t value_length;
+/**
+ * The number of bytes available at value, including the NULL character.
+ *
+ * @since release v2.2.0
+ */
+  size_t value_capacity;
+/**
+ * Storage for values short enough to be held within the param itself. This
+ * should not be accessed directly, but only through the value field.
+ *
+ * @since release v2.2.0
+ */
+  char value_buffer[STUMPLESS_PARAM_VALUE_BUFFER_SIZE];
+/**
+ * True if this param has been frozen with stumpless_freeze_param. A frozen
+ * param may not be modified, and is read without locking.
+ *
+ * @since release v2.2.0
+ */
+  bool frozen;
+/**
+ * The number of owners of this param. This is only ever more than one for a
+ * frozen param, which copies of a containing element share rather than
+ * duplicate. The param is only destroyed once the last owner releases it.
+ *
+ * @since release v2.2.0
+ */
+  size_t reference_count;
+/**
+ * The arena that this param was created in, or NULL if it was created on the
+ * heap. Memory for a param in an arena, including its name and value, is
+ * allocated from the arena and released when the arena is reset or destroyed.
+ *
+ * @since release v2.2.0
+ */
+  struct stumpless_arena *arena;
 #  ifdef STUMPLESS_JOURNALD_TARGETS_SUPPORTED
 /** Gets the name to use for the journald field corresponding to this param. */
   stumpless_param_namer_func_t get_journald_name;
 #  endif
 #  ifdef STUMPLESS_THREAD_SAFETY_SUPPORTED
+#    ifdef STUMPLESS_FUTEX_LOCKS_SUPPORTED
+/**
+ * A reader-writer lock which protects all param fields, stored directly in
+ * the structure as a futex word.
+ *
+ * @since release v2.2.0
+ */
+  unsigned int mutex;
+#    else
 /**
- * A pointer to a mutex which protects all target fields. The exact type of
- * this mutex depends on the build.
+ * A pointer to a reader-writer lock which protects all param fields. Readers
+ * share the lock, while modifications hold it exclusively. The exact type of
+ * this lock depends on the build. Despite the name of this field, it has not
+ * been a plain mutex since release v2.2.0.
  */
   void *mutex;
+#    endif
 #  endif
 };
 
@@ -184,6 +248,41 @@ STUMPLESS_PUBLIC_FUNCTION
 void
 stumpless_destroy_param( const struct stumpless_param *param );
 
+/**
+ * Freezes a param, making it read-only for the rest of its lifetime.
+ *
+ * Once frozen, attempts to modify the param will fail with a
+ * STUMPLESS_OBJECT_FROZEN error. In exchange, reads of a frozen param,
+ * including formatting it for a target, no longer need to lock it. This makes
+ * freezing a good fit for params that are built once and then shared
+ * between many threads.
+ *
+ * Freezing a param that is already frozen has no effect. There is no way to
+ * unfreeze a param, but copies made of it are not frozen.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to wait for any modifications
+ * in progress to finish before the param is frozen.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate changes.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param param The param to freeze.
+ *
+ * @return The frozen param if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_param *
+stumpless_freeze_param( struct stumpless_param *param );
+
 /**
  * Returns the name of the given param. The character buffer must be freed by
  * the caller when it is no longer needed to avoid memory leaks.
@@ -250,6 +349,47 @@ STUMPLESS_PUBLIC_FUNCTION
 const char *
 stumpless_get_param_value( const struct stumpless_param *param );
 
+/**
+ * Creates a new param with the given name and value in an arena. This is the
+ * same as stumpless_new_param, except that the param and any copies of its
+ * name and value are allocated from the given arena.
+ *
+ * The param is released when the arena is reset or destroyed, and so does not
+ * need to be destroyed on its own.
+ *
+ * **Thread Safety: MT-Safe race:name race:value**
+ * This function is thread safe, of course assuming that name and value are not
+ * changed by other threads during execution. A mutex is used to coordinate
+ * allocations from the arena.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock to coordinate access to the arena and the possible use of
+ * memory management functions to grow it.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked as well as
+ * memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param arena The arena to create the param in.
+ *
+ * @param name The name of the new param, under the same restrictions as names
+ * given to stumpless_new_param.
+ *
+ * @param value The value of the new param.
+ *
+ * @return The created param, if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_param *
+stumpless_new_arena_param( struct stumpless_arena *arena,
+                           const char *name,
+                           const char *value );
+
 /**
  * Creates a new param with the given name and value.
  *
@@ -54,7 +54,8 @@ enum stumpless_target_type {
   STUMPLESS_NETWORK_TARGET, /**< send to a network endpoint */
   STUMPLESS_SOCKET_TARGET, /**< write to a Unix socket */
   STUMPLESS_STREAM_TARGET, /**< write to a FILE stream */
-  STUMPLESS_WINDOWS_EVENT_LOG_TARGET /**< add to the Windows Event Log */
+  STUMPLESS_WINDOWS_EVENT_LOG_TARGET, /**< add to the Windows Event Log */
+  STUMPLESS_ASYNC_TARGET /**< send to another target from a background thread */
 };
 
 // needed so that we can define the filter function type before targets
@@ -143,14 +144,83 @@ struct stumpless_target {
  */
   stumpless_filter_func_t filter;
 #  ifdef STUMPLESS_THREAD_SAFETY_SUPPORTED
+#    ifdef STUMPLESS_FUTEX_LOCKS_SUPPORTED
+/**
+ * A mutex which protects all target fields, stored directly in the structure
+ * as a futex word.
+ *
+ * @since release v2.2.0
+ */
+  unsigned int mutex;
+#    else
 /**
  * A pointer to a mutex which protects all target fields. The exact type of
  * this mutex depends on the build.
  */
   void *mutex;
+#    endif
 #  endif
 };
 
+/**
+ * Adds a group of entries to a given target at once.
+ *
+ * Each entry is checked against the target's filter just as it would be by
+ * stumpless_add_entry. For file and stream targets, the accepted entries are
+ * formatted into a single buffer that is written with one call, which avoids
+ * the cost of locking and writing to the underlying stream for each entry.
+ * All of the entries in a batch written this way share a single timestamp,
+ * taken when this function is called, rather than each getting its own as
+ * they would from separate calls to stumpless_add_entry. Other target types
+ * send each accepted entry individually, as their messages must be delivered
+ * separately, and each of these entries gets its own timestamp.
+ *
+ * A batch written with a single call is all or nothing: if it cannot be
+ * formatted or written, then -1 is returned and none of its entries are
+ * counted as sent. When entries are sent individually and one of them fails,
+ * the entries before it have already been sent and are not taken back. In
+ * this case the number of entries sent so far is returned with the error
+ * left set, so stumpless_has_error must be checked to tell a partial batch
+ * apart from a complete one. The entries that were not sent are the ones
+ * after the last sent entry that passed the filter.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. Different target types handle thread safety
+ * differently, as some require per-target locks and others can rely on system
+ * libraries to log safely, but all targets support thread safe logging in some
+ * manner. Entries in a single write will not be interleaved with those from
+ * other threads.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers as some targets make
+ * use of non-reentrant locks to coordinate access. It also uses memory
+ * management functions to build the batch, which may not be signal safe.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of locks in some targets that could be left locked
+ * and the use of memory management functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The target to send the entries to.
+ *
+ * @param entries An array of the entries to send to the target. The entries
+ * themselves are not modified.
+ *
+ * @param count The number of entries in the array.
+ *
+ * @return The number of entries that were accepted by the target's filter and
+ * sent. If an error is encountered, then an error code is set appropriately
+ * and either the number of entries sent before it is returned, or a negative
+ * value if none were.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+int
+stumpless_add_entries( struct stumpless_target *target,
+                       struct stumpless_entry * const *entries,
+                       size_t count );
+
 /**
  * Adds an entry into a given target. This is the primary logging function of
  * stumpless; all other logging functions call this one after performing any
@@ -400,6 +470,41 @@ STUMPLESS_PUBLIC_FUNCTION
 void
 stumpless_close_target( struct stumpless_target *target );
 
+/**
+ * Waits until every entry sent to a target before this call has been written
+ * to its destination.
+ *
+ * Most targets write each entry before stumpless_add_entry returns, so this
+ * returns immediately. For async targets, this waits until the writer thread
+ * has sent every message that was in the queue when the call was made, and
+ * then flushes the wrapped target. Entries that are added by other threads
+ * during the call may or may not have been sent when it returns. For file
+ * targets, any messages held in the buffer of the target are written to the
+ * file, and the file stream is flushed.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. Any number of threads may flush the same
+ * target at once.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * lock to wait for the writer thread of async targets.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The target to flush.
+ *
+ * @return The flushed target if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_flush_target( struct stumpless_target *target );
+
 /*
  * Gets the current console stream where logs are written to.
  *
@@ -0,0 +1,396 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * Async targets hand entries off to a background thread, which sends them on
+ * to another target. This keeps slow destinations such as a full disk or a
+ * blocked network connection from stalling the threads that log.
+ *
+ * Entries are formatted for the wrapped target in the thread that logs them,
+ * and the result is placed in a bounded queue. Messages logged with format
+ * specifiers, for example with stumpless_add_message, may instead be queued
+ * unformatted and formatted by the writer thread if deferred formatting is
+ * turned on with stumpless_set_async_deferred_formatting. Targets that are sent entries
+ * rather than formatted messages, such as function and journald targets, are
+ * given a copy of the entry instead. A single writer thread created when the
+ * target is opened removes messages from the queue in the order that they
+ * were added and sends them to the wrapped target.
+ *
+ * What happens when the queue is full is decided by the overflow policy of the
+ * target, which may be changed with stumpless_set_async_overflow_policy. By
+ * default logging calls wait until the writer thread makes room for the new
+ * message. The other policies drop messages instead so that logging threads
+ * are never stalled by a slow destination, and keep a count of every message
+ * dropped which can be retrieved with stumpless_get_async_drop_count. Dropping
+ * a message is not an error, and the logging call that it was made by returns
+ * as though it had been queued.
+ *
+ * Errors encountered by the writer thread when sending to the wrapped target
+ * are not reported to the thread that logged the entry, as it has already
+ * moved on by that point. A successful call to stumpless_add_entry on an async
+ * target only means that the entry was queued.
+ *
+ * **Thread Safety: MT-Safe**
+ * Logging to async targets is thread safe. Any number of threads may add
+ * entries to the queue at the same time without blocking one another unless
+ * it is full.
+ *
+ * **Async Signal Safety: AS-Unsafe heap lock**
+ * Logging to async targets is not signal safe, as entries are formatted using
+ * memory management functions and the writer thread is woken using a lock.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap lock**
+ * Logging to async targets is not safe to call from threads that may be
+ * asynchronously cancelled, due to the use of memory management functions and
+ * a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ */
+
+#ifndef __STUMPLESS_TARGET_ASYNC_H
+#  define __STUMPLESS_TARGET_ASYNC_H
+
+#  include <stdbool.h>
+#  include <stddef.h>
+#  include <stumpless/config.h>
+#  include <stumpless/severity.h>
+#  include <stumpless/target.h>
+
+#  ifdef __cplusplus
+extern "C" {
+#  endif
+
+/**
+ * The number of messages that an async target can hold if a queue size of zero
+ * is requested.
+ *
+ * @since release v2.2.0
+ */
+#  define STUMPLESS_DEFAULT_ASYNC_QUEUE_SIZE 1024
+
+/**
+ * What an async target does with a new message when its queue is full.
+ *
+ * @since release v2.2.0
+ */
+enum stumpless_async_overflow_policy {
+/**
+ * Wait for the writer thread to make room in the queue. If a block timeout has
+ * been set with stumpless_set_async_block_timeout, then the message is dropped
+ * if there is still no room once it expires. This is the default policy.
+ */
+  STUMPLESS_ASYNC_OVERFLOW_BLOCK,
+/** Drop the new message, leaving the queue as it is. */
+  STUMPLESS_ASYNC_OVERFLOW_DROP_NEWEST,
+/** Drop the oldest message in the queue to make room for the new one. */
+  STUMPLESS_ASYNC_OVERFLOW_DROP_OLDEST,
+/**
+ * Drop the oldest messages in the queue to make room for the new one, as long
+ * as they are less severe than it. If the oldest message is as severe as the
+ * new one or more, then the new message is dropped instead, unless it is an
+ * emergency, alert, or critical message. These wait for room in the queue for
+ * up to the block timeout set with stumpless_set_async_block_timeout, or one
+ * second if none has been set, and are dropped if there is still no room.
+ */
+  STUMPLESS_ASYNC_OVERFLOW_DROP_LOWEST_SEVERITY
+};
+
+/**
+ * Closes an async target.
+ *
+ * All messages in the queue are sent to the wrapped target before this
+ * function returns, and the writer thread is then stopped. The wrapped target
+ * is not closed, and must be closed separately once it is no longer needed.
+ *
+ * **Thread Safety: MT-Unsafe**
+ * This function is not thread safe as it destroys resources that other threads
+ * would use if they tried to reference this target.
+ *
+ * **Async Signal Safety: AS-Unsafe heap lock**
+ * This function is not safe to call from signal handlers due to the use of
+ * the memory deallocation function to release memory and the waits on the
+ * writer thread.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory deallocation function may not be AC-Safe itself and
+ * a lock used to wait for the writer thread could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The async target to close.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+void
+stumpless_close_async_target( const struct stumpless_target *target );
+
+/**
+ * Gets the number of messages of a given severity that an async target has
+ * dropped because its queue was full.
+ *
+ * The count includes new messages that were never queued as well as queued
+ * messages that were removed to make room for new ones, depending on the
+ * overflow policy in use at the time.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The counts are read atomically.
+ *
+ * **Async Signal Safety: AS-Safe**
+ * This function is safe to call from signal handlers.
+ *
+ * **Async Cancel Safety: AC-Safe**
+ * This function is safe to call from threads that may be asynchronously
+ * cancelled.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The async target to check.
+ *
+ * @param severity The severity of the messages to count.
+ *
+ * @return The number of messages of the given severity that have been dropped.
+ * If an error is encountered, then zero is returned and an error code is set
+ * appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+size_t
+stumpless_get_async_drop_count( const struct stumpless_target *target,
+                                enum stumpless_severity severity );
+
+/**
+ * Gets the number of messages waiting in the queue of an async target.
+ *
+ * This does not include a message that the writer thread has already taken
+ * from the queue and is in the process of sending. As other threads may be
+ * adding messages while the writer thread removes them, the result is only a
+ * snapshot of the queue at some point during the call.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The queue positions are read atomically.
+ *
+ * **Async Signal Safety: AS-Safe**
+ * This function is safe to call from signal handlers.
+ *
+ * **Async Cancel Safety: AC-Safe**
+ * This function is safe to call from threads that may be asynchronously
+ * cancelled.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The async target to check.
+ *
+ * @return The number of messages in the queue. If an error is encountered,
+ * then zero is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+size_t
+stumpless_get_async_queue_depth( const struct stumpless_target *target );
+
+/**
+ * Gets the number of messages of any severity that an async target has dropped
+ * because its queue was full.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The counts are read atomically, though as
+ * each severity is read separately the total may not reflect a single point in
+ * time if messages are being dropped during the call.
+ *
+ * **Async Signal Safety: AS-Safe**
+ * This function is safe to call from signal handlers.
+ *
+ * **Async Cancel Safety: AC-Safe**
+ * This function is safe to call from threads that may be asynchronously
+ * cancelled.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The async target to check.
+ *
+ * @return The number of messages that have been dropped. If an error is
+ * encountered, then zero is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+size_t
+stumpless_get_async_total_drop_count( const struct stumpless_target *target );
+
+/**
+ * Opens an async target that sends entries to another target from a separate
+ * thread.
+ *
+ * The wrapped target must remain open for as long as the async target is open.
+ * Entries that are sent directly to the wrapped target while the async target
+ * is open are not coordinated with those sent through the queue, and so may
+ * appear in a different order than they were logged in.
+ *
+ * The filter and mask of both the async target and the wrapped target are
+ * checked in the logging thread, so that entries that will not be sent are
+ * never queued.
+ *
+ * **Thread Safety: MT-Safe race:name**
+ * This function is thread safe, of course assuming that name is not modified by
+ * any other threads during execution.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory allocation functions and the creation of a thread.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory allocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param name The name of the logging target.
+ *
+ * @param wrapped The target that entries will be sent to by the writer thread.
+ *
+ * @param queue_size The maximum number of messages that may be waiting to be
+ * sent at any given time. This is rounded up to the next power of two, and is
+ * at least two. If this is zero, then STUMPLESS_DEFAULT_ASYNC_QUEUE_SIZE is
+ * used.
+ *
+ * @return The opened target if no error is encountered. In the event of an
+ * error, NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_open_async_target( const char *name,
+                             struct stumpless_target *wrapped,
+                             size_t queue_size );
+
+/**
+ * Sets the longest time that logging calls to an async target will wait for
+ * room in the queue under the STUMPLESS_ASYNC_OVERFLOW_BLOCK policy, and that
+ * critical messages will wait under the
+ * STUMPLESS_ASYNC_OVERFLOW_DROP_LOWEST_SEVERITY policy. Messages that still do
+ * not fit once this time has passed are dropped.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The timeout is updated atomically, and takes
+ * effect for logging calls that begin waiting after it is set.
+ *
+ * **Async Signal Safety: AS-Safe**
+ * This function is safe to call from signal handlers.
+ *
+ * **Async Cancel Safety: AC-Safe**
+ * This function is safe to call from threads that may be asynchronously
+ * cancelled.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The async target to modify.
+ *
+ * @param milliseconds The number of milliseconds to wait. If this is zero, then
+ * logging calls wait until there is room no matter how long it takes, which is
+ * the default.
+ *
+ * @return The modified target if no error is encountered. In the event of an
+ * error, NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_set_async_block_timeout( struct stumpless_target *target,
+                                   unsigned int milliseconds );
+
+/**
+ * Sets whether an async target formats messages logged with format specifiers
+ * in the writer thread rather than the logging thread.
+ *
+ * When this is turned on, stumpless_add_message, stumpless_add_log, and their
+ * variants record the format string, the time, the prival, and the raw bytes
+ * of each argument, and leave all formatting of the message and the entry to
+ * the writer thread. This removes the cost of formatting from the threads that
+ * log, at the expense of a small amount of work to copy the arguments.
+ *
+ * The first time this is turned on, the target sets aside one record for each
+ * position in its queue, so that the arguments of most messages can be copied
+ * without allocating memory. Messages with more arguments than fit in a record,
+ * or logged while every record is in use, are allocated on their own.
+ *
+ * As the format string is not copied, it must remain valid and unchanged until
+ * the message has been sent, for example by being a string literal. Strings
+ * given as arguments are copied, and so do not have this restriction.
+ *
+ * Messages are still formatted in the logging thread if the format string uses
+ * positional arguments, wide characters or strings, %n, or any conversion that
+ * is not part of the C standard. They are also formatted as usual if either the
+ * async target or the wrapped target has a filter other than the default mask
+ * filter, since other filters need to see the complete entry.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The setting is updated atomically, and takes
+ * effect for logging calls that begin after it is set. A mutex is used to
+ * coordinate setting aside the records.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock and memory allocation functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked as well as
+ * memory allocation functions.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The async target to modify.
+ *
+ * @param deferred true to defer formatting to the writer thread, false to
+ * format messages in the logging thread. The default is false.
+ *
+ * @return The modified target if no error is encountered. In the event of an
+ * error, NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_set_async_deferred_formatting( struct stumpless_target *target,
+                                         bool deferred );
+
+/**
+ * Sets what an async target does with new messages when its queue is full.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The policy is updated atomically, and takes
+ * effect for logging calls that begin after it is set.
+ *
+ * **Async Signal Safety: AS-Safe**
+ * This function is safe to call from signal handlers.
+ *
+ * **Async Cancel Safety: AC-Safe**
+ * This function is safe to call from threads that may be asynchronously
+ * cancelled.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The async target to modify.
+ *
+ * @param policy The overflow policy to use.
+ *
+ * @return The modified target if no error is encountered. In the event of an
+ * error, NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_set_async_overflow_policy( struct stumpless_target *target,
+                                     enum stumpless_async_overflow_policy
+                                     policy );
+
+#  ifdef __cplusplus
+}                               /* extern "C" */
+#  endif
+#endif                          /* __STUMPLESS_TARGET_ASYNC_H */
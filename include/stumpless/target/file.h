@@ -20,9 +20,58 @@
  * File targets allow logs to be sent to a specified file. Files are created
  * as needed, and logs are appended to any existing contents.
  *
+ * By default each message is written to the file's stream as it is logged,
+ * leaving any buffering to the standard library. A file target may instead be
+ * given a buffer of its own with stumpless_set_file_buffer_size, in which case
+ * messages are combined in it and written to the file with a single write
+ * call when it is full. The buffer is also written when a message with a
+ * severity of STUMPLESS_SEVERITY_ERR or more severe is logged, when the target
+ * is flushed with stumpless_flush_target, when it is closed, and optionally
+ * once a message has waited longer than the interval set with
+ * stumpless_set_file_flush_interval.
+ *
+ * Raw file targets, opened with stumpless_open_raw_file_target, skip the
+ * stream altogether and write each message to a file descriptor opened in
+ * append mode. Where the system guarantees that appends of a certain size are
+ * atomic, as POSIX systems do for writes up to PIPE_BUF bytes, messages within
+ * that size are written without taking any lock, so that threads and even
+ * separate processes logging to the same file do not wait on each other.
+ *
+ * Segment file targets, opened with stumpless_open_segment_file_target, write
+ * to a series of preallocated files of a fixed size that are mapped into
+ * memory. Each message is copied straight into the mapping of the current
+ * segment, with space for it reserved by a single atomic operation, so that
+ * neither a lock nor a system call is needed until the segment is full.
+ *
+ * Gzip file targets, opened with stumpless_open_gzip_file_target, compress
+ * their messages before writing them to the file, ending the compressed data
+ * each time the target is flushed so that the file can always be read up to
+ * that point.
+ *
+ * Sharded file targets, opened with stumpless_open_sharded_file_target, give
+ * each thread a file of its own to append to, so that threads logging to the
+ * same target neither wait for each other nor write to the same file. Each
+ * message is stamped with a sequence number shared by all of the shards,
+ * which stumpless_merge_file_shards uses to merge the shards back into a
+ * single file in the order that the messages were logged.
+ *
+ * Stream, raw, and gzip file targets can also rotate their file once it grows
+ * past a given size or has been open for a given time, using
+ * stumpless_set_file_rotation. The file is renamed with a numbered suffix and
+ * a new one opened in its place, keeping a set number of older files.
+ *
+ * Messages written to a file are normally left for the operating system to
+ * save to disk in its own time, and so may be lost if the system crashes. The
+ * durability of a file target can be raised with stumpless_set_file_durability
+ * to synchronize the file with the disk periodically, after messages of a given
+ * severity, or after every message. In the last case threads that log at the
+ * same time share a single synchronization of the file, so that throughput
+ * does not fall to one message per synchronization.
+ *
  * **Thread Safety: MT-Safe**
  * Logging to file targets is thread safe. A mutex is used to coordinate
- * writes to the file.
+ * writes to the file, except for small messages sent to raw file targets and
+ * messages that fit in the current segment of a segment file target.
  *
  * **Async Signal Safety: AS-Unsafe lock**
  * Logging to file targets is not signal safe, as a non-reentrant lock is used
@@ -36,13 +85,68 @@
 #ifndef __STUMPLESS_TARGET_FILE_H
 #  define __STUMPLESS_TARGET_FILE_H
 
+#  include <stddef.h>
 #  include <stumpless/config.h>
 #  include <stumpless/target.h>
 
+/**
+ * The compression level of a gzip file target if none is given when it is
+ * opened.
+ *
+ * @since release v2.2.0
+ */
+#  define STUMPLESS_DEFAULT_GZIP_LEVEL 6
+
+/**
+ * The size of the segments of a segment file target if none is given when it
+ * is opened.
+ *
+ * @since release v2.2.0
+ */
+#  define STUMPLESS_DEFAULT_SEGMENT_SIZE ( 64 * 1024 * 1024 )
+
+/**
+ * The number of shards of a sharded file target if none is given when it is
+ * opened or merged.
+ *
+ * @since release v2.2.0
+ */
+#  define STUMPLESS_DEFAULT_SHARD_COUNT 16
+
 #  ifdef __cplusplus
 extern "C" {
 #  endif
 
+/**
+ * When a file target synchronizes its file with the disk, so that messages
+ * written to it survive a crash of the system.
+ *
+ * @since release v2.2.0
+ */
+enum stumpless_file_durability {
+/**
+ * Leave the file for the operating system to write to disk in its own time.
+ * This is the default.
+ */
+  STUMPLESS_FILE_DURABILITY_NONE,
+/**
+ * Synchronize the file after a message is logged if the given number of
+ * milliseconds has passed since it was last synchronized.
+ */
+  STUMPLESS_FILE_DURABILITY_PERIODIC,
+/**
+ * Synchronize the file after each message with the given severity or one that
+ * is more severe.
+ */
+  STUMPLESS_FILE_DURABILITY_SEVERITY,
+/**
+ * Synchronize the file after every message. Threads that log to the target at
+ * the same time wait for a single synchronization that covers all of their
+ * messages, instead of each doing their own.
+ */
+  STUMPLESS_FILE_DURABILITY_GROUP_COMMIT
+};
+
 /**
  * Closes a file target.
  *
@@ -69,6 +173,58 @@ STUMPLESS_PUBLIC_FUNCTION
 void
 stumpless_close_file_target( struct stumpless_target *target );
 
+/**
+ * Merges the shard files of a sharded file target into a single file, in the
+ * order given by the sequence numbers of their messages. The sequence numbers
+ * and lengths are removed, leaving each message as it would have been written
+ * to a stream file target, and the result is appended to the output file.
+ *
+ * Each shard is read from start to end, taking the message with the lowest
+ * sequence number at the head of any shard next. The messages in each shard
+ * are always in sequence order, even if more threads logged to the target than
+ * it had shards, and so this puts all of them in the order they were logged.
+ *
+ * A message that was only partly written to the end of a shard, for example
+ * because the program crashed while writing it, is left out along with
+ * anything after it.
+ *
+ * This is meant to be used once the target has been closed. Messages logged
+ * while the shards are being merged may or may not be included.
+ *
+ * **Thread Safety: MT-Safe race:name race:output**
+ * This function is thread safe, of course assuming that name and output are
+ * not modified by any other threads during execution.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory management functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory management functions may not be AC-Safe
+ * themselves, and the opened files would not be closed.
+ *
+ * @since release v2.2.0
+ *
+ * @param name The name that the sharded file target was opened with.
+ *
+ * @param shard_count The number of shards that the target was opened with. If
+ * this is zero, then STUMPLESS_DEFAULT_SHARD_COUNT is used.
+ *
+ * @param output The name of the file to write the merged messages to. It is
+ * created if it does not exist.
+ *
+ * @return The number of messages merged if no error is encountered. If an
+ * error is encountered, then -1 is returned and an error code is set
+ * appropriately. If any of the shards cannot be opened, then nothing is merged
+ * and a STUMPLESS_FILE_OPEN_FAILURE error is raised.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+int
+stumpless_merge_file_shards( const char *name,
+                             unsigned int shard_count,
+                             const char *output );
+
 /**
  * Opens a file target.
  *
@@ -99,6 +255,464 @@ STUMPLESS_PUBLIC_FUNCTION
 struct stumpless_target *
 stumpless_open_file_target( const char *name );
 
+/**
+ * Opens a gzip file target.
+ *
+ * Gzip file targets compress messages with zlib before appending them to the
+ * file. Compressed output is collected in a buffer and written once it is
+ * full, so that writes to the disk are both smaller and less frequent than
+ * they would be for an uncompressed file.
+ *
+ * The file is written as a series of gzip members, which standard tools such
+ * as gunzip and zcat read as a single stream. The current member is finished
+ * and written out when a message with a severity of STUMPLESS_SEVERITY_ERR or
+ * more severe is logged, when the target is flushed with stumpless_flush_target,
+ * when it is closed, and once a message has waited longer than the interval
+ * set with stumpless_set_file_flush_interval. Until one of these happens,
+ * recent messages are held by the compressor and cannot be read from the file.
+ * Existing files are appended to with a new member, although anything left
+ * unfinished by a process that did not close its target will keep tools from
+ * reading past that point.
+ *
+ * Messages are compressed by the thread that logs them while holding the lock
+ * of the target. To move the compression off of logging threads entirely, wrap
+ * the target in an async target.
+ *
+ * Gzip file targets cannot be given a buffer or an io_uring depth, but can be
+ * rotated with stumpless_set_file_rotation. They are closed with
+ * stumpless_close_file_target.
+ *
+ * **Thread Safety: MT-Safe race:name**
+ * This function is thread safe, of course assuming that name is not modified by
+ * any other threads during execution.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory allocation functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory allocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param name The name of the logging target, as well as the name of the file
+ * to open.
+ *
+ * @param level The compression level, from 1 for the fastest compression to 9
+ * for the smallest output. Levels above 9 are treated as 9. If this is zero,
+ * then STUMPLESS_DEFAULT_GZIP_LEVEL is used.
+ *
+ * @return The opened target if no error is encountered. In the event of an
+ * error, NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_open_gzip_file_target( const char *name, unsigned int level );
+
+/**
+ * Opens a raw file target.
+ *
+ * Raw file targets log to a file like other file targets, but write to a file
+ * descriptor opened in append mode instead of a stream. Each message is
+ * written with a single write call as it is logged, with no buffering in the
+ * library or the standard library. On systems where appends up to a certain
+ * size are atomic, such as those up to PIPE_BUF bytes on POSIX systems,
+ * messages within this size are written without locking, relying on the
+ * operating system to keep them from interleaving with writes from other
+ * threads or processes. Larger messages are written while holding the lock of
+ * the target, which only keeps them intact with respect to other threads using
+ * the same target.
+ *
+ * Raw file targets cannot be given a buffer with
+ * stumpless_set_file_buffer_size, but on Linux may instead queue their writes
+ * on an io_uring instance with stumpless_set_file_io_uring_depth. They are
+ * closed with stumpless_close_file_target.
+ *
+ * **Thread Safety: MT-Safe race:name**
+ * This function is thread safe, of course assuming that name is not modified by
+ * any other threads during execution.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory allocation functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory allocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param name The name of the logging target, as well as the name of the file
+ * to open.
+ *
+ * @return The opened target if no error is encountered. In the event of an
+ * error, NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_open_raw_file_target( const char *name );
+
+/**
+ * Opens a segment file target.
+ *
+ * Segment file targets write to a series of files of a fixed size, named after
+ * the target with a period and a number appended, such as `app.log.1` and
+ * `app.log.2`. Numbering starts from the first number that is not already in
+ * use, so that existing segments are never overwritten. Each segment is
+ * allocated on disk in full when it is created and mapped into memory, and
+ * messages are copied directly into the mapping. Threads reserve space for
+ * their message with a single atomic operation, so that logging to the target
+ * takes neither a lock nor a system call as long as the message fits into the
+ * current segment.
+ *
+ * When a message does not fit, the thread that reached the end of the segment
+ * creates the next one, and other threads logging at the same time wait for
+ * it to be ready. The full segment is then synced to disk and trimmed down to
+ * the messages it holds, after the other threads have moved on to the new
+ * one. The current segment is synced when a message with a severity of
+ * STUMPLESS_SEVERITY_ERR or more severe is logged, when the target is flushed
+ * with stumpless_flush_target, and when it is closed, at which point it is
+ * also trimmed. Until then, the unused end of the current segment is filled
+ * with zero bytes.
+ *
+ * Messages larger than a segment cannot be logged to the target. If a new
+ * segment cannot be created, for example because the disk is full, then all
+ * later messages sent to the target fail.
+ *
+ * Segment file targets cannot be given a buffer or an io_uring depth. They are
+ * closed with stumpless_close_file_target.
+ *
+ * **Thread Safety: MT-Safe race:name**
+ * This function is thread safe, of course assuming that name is not modified by
+ * any other threads during execution.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory allocation functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory allocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param name The name of the logging target, as well as the name of the
+ * segment files without their number.
+ *
+ * @param segment_size The size of each segment in bytes. If this is zero, then
+ * STUMPLESS_DEFAULT_SEGMENT_SIZE is used.
+ *
+ * @return The opened target if no error is encountered. In the event of an
+ * error, NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_open_segment_file_target( const char *name, size_t segment_size );
+
+/**
+ * Opens a sharded file target, which writes the messages logged by each thread
+ * to a separate shard file.
+ *
+ * The shards are named after the target, followed by ".shard" and their
+ * number, starting from zero. All of them are opened in append mode when the
+ * target is opened. Each thread that logs to a sharded file target is given
+ * the next number the first time that it does so, and writes to the shard
+ * with that number modulo the number of shards from then on. Threads only
+ * share a shard once there are more of them than there are shards.
+ *
+ * Messages are written to the shard with a single write call. Each one is
+ * preceded by a sequence number that counts up across all of the shards of the
+ * target, and the length of the message, separated by spaces. The sequence
+ * number is taken and the message written while holding a mutex belonging to
+ * the shard, so that the messages in a shard are always in sequence order.
+ * Only threads that share a shard ever wait for each other on this mutex. Use stumpless_merge_file_shards to combine the shards into a
+ * single file in the order that the messages were logged.
+ *
+ * Sharded file targets cannot be given a buffer, an io_uring depth, or a
+ * rotation. They are closed with stumpless_close_file_target.
+ *
+ * **Thread Safety: MT-Safe race:name**
+ * This function is thread safe, of course assuming that name is not modified by
+ * any other threads during execution.
+ *
+ * **Async Signal Safety: AS-Unsafe heap**
+ * This function is not safe to call from signal handlers due to the use of
+ * memory allocation functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, as the memory allocation function may not be AC-Safe itself.
+ *
+ * @since release v2.2.0
+ *
+ * @param name The name of the logging target, as well as the name of the
+ * shard files without their suffix.
+ *
+ * @param shard_count The number of shards to write to. If this is zero, then
+ * STUMPLESS_DEFAULT_SHARD_COUNT is used.
+ *
+ * @return The opened target if no error is encountered. In the event of an
+ * error, NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_open_sharded_file_target( const char *name,
+                                    unsigned int shard_count );
+
+/**
+ * Sets the size of the buffer that a file target combines messages in before
+ * writing them to the file.
+ *
+ * Messages are added to the buffer until the next one does not fit, at which
+ * point the buffer is written to the file with a single write call, bypassing
+ * the stream of the target. Messages larger than the buffer are written
+ * directly. The buffer is also written when a message with a severity of
+ * STUMPLESS_SEVERITY_ERR or more severe is logged to the target, when the
+ * target is flushed or closed, and when the flush interval has passed.
+ *
+ * Any messages in the current buffer are written before it is replaced. A size
+ * of zero removes the buffer, so that messages are written to the stream as
+ * they are logged, which is the default. Raw file targets cannot have a
+ * buffer, and a STUMPLESS_TARGET_INCOMPATIBLE error is raised for them.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The same mutex that coordinates writes to the
+ * file is used to replace the buffer.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock and memory management functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked and memory
+ * management functions that may not be AC-Safe themselves.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The file target to set the buffer size of.
+ *
+ * @param size The size of the buffer in bytes, or zero to remove it.
+ *
+ * @return The modified target if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_set_file_buffer_size( struct stumpless_target *target,
+                                size_t size );
+
+/**
+ * Sets the number of writes that a raw file target may have in progress on an
+ * io_uring instance, or turns its use of io_uring off.
+ *
+ * With a nonzero depth, messages logged to the target are copied into buffers
+ * registered with a new io_uring instance and queued as write requests instead
+ * of being written with a system call each. Queued requests are submitted to
+ * the kernel together once a quarter of the depth has built up, and completed
+ * requests are collected as later messages are logged, so that under load
+ * there are far fewer system calls than messages. Messages longer than 4096
+ * bytes are written directly, after the queued ones.
+ *
+ * Queued messages are submitted and waited on when a message with a severity
+ * of STUMPLESS_SEVERITY_ERR or more severe is logged to the target, when the
+ * target is flushed with stumpless_flush_target, when the depth is changed,
+ * and when the target is closed. A write that fails in the background is
+ * reported by the next call that logs to or flushes the target.
+ *
+ * Messages queued this way are written in order. Because the target lock is
+ * held to queue each message, messages small enough to be appended atomically
+ * are no longer written without locking while io_uring is in use.
+ *
+ * This is only available on Linux builds with io_uring support, as indicated
+ * by STUMPLESS_IO_URING_SUPPORTED, and only for raw file targets writing to a
+ * regular file. Other builds raise a STUMPLESS_TARGET_UNSUPPORTED error, as
+ * they do if the kernel does not allow an io_uring instance to be created.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. The same mutex that coordinates writes to the
+ * file is used to replace the io_uring instance.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock and memory management functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked and memory
+ * management functions that may not be AC-Safe themselves.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The raw file target to set the io_uring depth of.
+ *
+ * @param depth The number of messages that may be queued or in progress at
+ * once, or zero to write each message as it is logged.
+ *
+ * @return The modified target if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_set_file_io_uring_depth( struct stumpless_target *target,
+                                   unsigned int depth );
+
+/**
+ * Sets the limits at which a file target rotates its file.
+ *
+ * When a file is rotated, it is renamed to its name followed by ".1", after
+ * any older files have been moved along by one to make room, so that the
+ * file with the suffix ".N" is the Nth most recent one. At most keep rotated
+ * files are kept: the one that would be moved past that suffix is deleted
+ * instead. A new file is then opened with the original name.
+ *
+ * A rotation is started by the thread that logs the message that takes the
+ * file past max_size, or the first message logged after the file has been
+ * open for max_age seconds. The rotation itself is done while holding the
+ * same lock as other writes to a stream file target. A raw file target
+ * replaces its file descriptor with the new file in a single step, so that
+ * messages written to it without a lock are never delayed: they are appended
+ * either to the old file or to the new one. Because of this, a message logged
+ * during a rotation may end up at the end of the file that was just rotated,
+ * and files may grow slightly past max_size.
+ *
+ * The size of the file when this is called counts towards max_size, and the
+ * age of the file is counted from when this is called.
+ *
+ * Segment and sharded file targets already split their output into separate
+ * files, and cannot be rotated.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to coordinate the change with
+ * writes to the file.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock and memory management functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked and memory
+ * management functions that may not be AC-Safe themselves.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The stream, raw, or gzip file target to set the rotation of.
+ *
+ * @param max_size The size in bytes that the file may reach before it is
+ * rotated, or zero to not rotate the file based on its size.
+ *
+ * @param max_age The number of seconds that a file may be written to before it
+ * is rotated, or zero to not rotate the file based on its age. If both
+ * max_size and max_age are zero, then rotation is turned off.
+ *
+ * @param keep The number of rotated files to keep. If this is zero, then the
+ * file is deleted when it is rotated.
+ *
+ * @return The modified target if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_set_file_rotation( struct stumpless_target *target,
+                             size_t max_size,
+                             unsigned int max_age,
+                             unsigned int keep );
+
+/**
+ * Sets the longest time that a message may wait in the buffer of a file target
+ * before it is written to the file.
+ *
+ * The time is checked whenever a message is logged to the target, and so a
+ * message may wait longer than this if no others follow it. Use
+ * stumpless_flush_target to make sure that buffered messages are written at a
+ * particular point.
+ *
+ * This has no effect unless the target has a buffer set with
+ * stumpless_set_file_buffer_size.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to coordinate the change with
+ * writes to the file.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The file target to set the flush interval of.
+ *
+ * @param milliseconds The longest time a message may wait in the buffer, or
+ * zero to only write the buffer when it is full or flushed.
+ *
+ * @return The modified target if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_set_file_flush_interval( struct stumpless_target *target,
+                                   unsigned int milliseconds );
+
+/**
+ * Sets when a file target synchronizes its file with the disk.
+ *
+ * The file is synchronized by the thread that logged the message, once the
+ * message has been written, and the logging call does not return until it is
+ * done. Anything that the target is holding back, such as the contents of its
+ * buffer or the current member of a gzip file target, is written to the file
+ * first. Where fdatasync is available it is used instead of fsync, as metadata
+ * such as the modification time of the file is not needed to read it back.
+ *
+ * The period of STUMPLESS_FILE_DURABILITY_PERIODIC is checked whenever a
+ * message is logged to the target, rather than on a timer, and so the messages
+ * logged before a pause are not synchronized until another message follows
+ * them, however long the pause is. Use stumpless_close_file_target to make
+ * sure that everything is synchronized when logging is finished, which is done
+ * for any durability other than STUMPLESS_FILE_DURABILITY_NONE.
+ *
+ * If a synchronization fails, the logging call that started it fails with a
+ * STUMPLESS_FILE_WRITE_FAILURE error, even though the message itself may have
+ * been written to the file.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to coordinate the change with
+ * synchronizations of the file.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The file target to set the durability of.
+ *
+ * @param durability When the file is synchronized with the disk.
+ *
+ * @param setting For STUMPLESS_FILE_DURABILITY_PERIODIC, the number of
+ * milliseconds between synchronizations, where zero synchronizes after every
+ * message. For STUMPLESS_FILE_DURABILITY_SEVERITY, the least severe
+ * STUMPLESS_SEVERITY value that causes a synchronization, such as
+ * STUMPLESS_SEVERITY_ERR. This is ignored for other durabilities.
+ *
+ * @return The modified target if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_set_file_durability( struct stumpless_target *target,
+                               enum stumpless_file_durability durability,
+                               unsigned int setting );
+
 #  ifdef __cplusplus
 }                               /* extern "C" */
 #  endif
@@ -19,6 +19,17 @@
 /** @file
  * Functions for working with stream targets (that is, FILE pointers).
  *
+ * By default each message is written to the stream as it is logged, leaving
+ * any buffering to the stream itself, which is often not what is wanted: stdout
+ * is fully buffered by the standard library when it is a pipe, and there is no
+ * portable way to change the buffering of a stream once it has been used. The
+ * buffering of a stream target can instead be set with
+ * stumpless_set_stream_buffering, either flushing the stream after each
+ * message, or combining messages in a buffer of the target's own and writing
+ * them to the stream together. A flush interval may also be set with
+ * stumpless_set_stream_flush_interval, so that messages do not wait too long
+ * in either buffer.
+ *
  * **Thread Safety: MT-Safe**
  * Logging to stream targets is thread safe. A mutex is used to coordinate
  * writes to the stream.
@@ -35,14 +46,44 @@
 #ifndef __STUMPLESS_TARGET_STREAM_H
 #  define __STUMPLESS_TARGET_STREAM_H
 
+#  include <stddef.h>
 #  include <stdio.h>
 #  include <stumpless/config.h>
 #  include <stumpless/target.h>
 
+/**
+ * The size of the buffer of a stream target that combines messages if none is
+ * given. This is small enough for the combined messages to be written to a
+ * pipe as a single unit on common systems.
+ *
+ * @since release v2.2.0
+ */
+#  define STUMPLESS_DEFAULT_STREAM_BUFFER_SIZE 4096
+
 #  ifdef __cplusplus
 extern "C" {
 #  endif
 
+/**
+ * How a stream target buffers the messages logged to it.
+ *
+ * @since release v2.2.0
+ */
+enum stumpless_stream_buffering {
+/**
+ * Write each message to the stream as it is logged, leaving any buffering to
+ * the stream. This is the default.
+ */
+  STUMPLESS_STREAM_BUFFERING_DEFAULT,
+/** Write each message to the stream and flush it as the message is logged. */
+  STUMPLESS_STREAM_BUFFERING_LINE,
+/**
+ * Combine messages in a buffer of the target, and write them to the stream and
+ * flush it once the buffer is full.
+ */
+  STUMPLESS_STREAM_BUFFERING_FULL
+};
+
 /**
  * Closes a stream target.
  *
@@ -154,6 +195,92 @@ STUMPLESS_PUBLIC_FUNCTION
 struct stumpless_target *
 stumpless_open_stream_target( const char *name, FILE *stream );
 
+/**
+ * Sets how a stream target buffers the messages logged to it.
+ *
+ * With STUMPLESS_STREAM_BUFFERING_FULL, messages are added to a buffer of the
+ * given size until the next one does not fit, at which point the buffer is
+ * written to the stream with a single call and the stream is flushed, so that
+ * all of the messages go out in one underlying write. Messages larger than the
+ * buffer are written and flushed directly. The buffer is also written when a
+ * message with a severity of STUMPLESS_SEVERITY_ERR or more severe is logged
+ * to the target, when the target is flushed with stumpless_flush_target or
+ * closed, and when the flush interval has passed.
+ *
+ * Anything held in the buffer of the target or the stream is written before
+ * the buffering is changed.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to coordinate the change with
+ * writes to the stream.
+ *
+ * **Async Signal Safety: AS-Unsafe lock heap**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock and memory management functions.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock heap**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked and memory
+ * management functions that may not be AC-Safe themselves.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The stream target to set the buffering of.
+ *
+ * @param buffering How the target buffers messages.
+ *
+ * @param size The size of the buffer in bytes for
+ * STUMPLESS_STREAM_BUFFERING_FULL. If this is zero, then
+ * STUMPLESS_DEFAULT_STREAM_BUFFER_SIZE is used. This is ignored for other
+ * buffering.
+ *
+ * @return The modified target if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_set_stream_buffering( struct stumpless_target *target,
+                                enum stumpless_stream_buffering buffering,
+                                size_t size );
+
+/**
+ * Sets the longest time that a message logged to a stream target may wait in
+ * a buffer before the stream is flushed.
+ *
+ * This applies to the buffer of the target with
+ * STUMPLESS_STREAM_BUFFERING_FULL, and to the buffer of the stream itself with
+ * STUMPLESS_STREAM_BUFFERING_DEFAULT. The time is checked whenever a message
+ * is logged to the target, and so a message may wait longer than this if no
+ * others follow it. Use stumpless_flush_target to make sure that messages are
+ * written at a particular point.
+ *
+ * **Thread Safety: MT-Safe**
+ * This function is thread safe. A mutex is used to coordinate the change with
+ * writes to the stream.
+ *
+ * **Async Signal Safety: AS-Unsafe lock**
+ * This function is not safe to call from signal handlers due to the use of a
+ * non-reentrant lock.
+ *
+ * **Async Cancel Safety: AC-Unsafe lock**
+ * This function is not safe to call from threads that may be asynchronously
+ * cancelled, due to the use of a lock that could be left locked.
+ *
+ * @since release v2.2.0
+ *
+ * @param target The stream target to set the flush interval of.
+ *
+ * @param milliseconds The longest time a message may wait in a buffer, or zero
+ * to only flush the stream when the buffer is full or the target is flushed.
+ *
+ * @return The modified target if no error is encountered. If an error is
+ * encountered, then NULL is returned and an error code is set appropriately.
+ */
+STUMPLESS_PUBLIC_FUNCTION
+struct stumpless_target *
+stumpless_set_stream_flush_interval( struct stumpless_target *target,
+                                     unsigned int milliseconds );
+
 #  ifdef __cplusplus
 }                               /* extern "C" */
 #  endif
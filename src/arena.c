@@ -0,0 +1,320 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+#include <stumpless/arena.h>
+#include "private/arena.h"
+#include "private/config/wrapper.h"
+#include "private/config/wrapper/thread_safety.h"
+#include "private/error.h"
+#include "private/memory.h"
+#include "private/strhelper.h"
+#include "private/validate.h"
+
+/*
+ * Allocations are rounded up to a multiple of this so that every object in an
+ * arena is suitably aligned for any of the structures placed in it.
+ */
+#define ARENA_ALIGNMENT ( 2 * sizeof( void * ) )
+
+static size_t
+get_aligned_size( size_t size ) {
+  return ( size + ARENA_ALIGNMENT - 1 ) & ~( ARENA_ALIGNMENT - 1 );
+}
+
+static char *
+get_block_data( const struct arena_block *block ) {
+  return ( char * ) block + get_aligned_size( sizeof( *block ) );
+}
+
+static struct arena_block *
+new_arena_block( size_t size ) {
+  struct arena_block *block;
+
+  block = alloc_mem( get_aligned_size( sizeof( *block ) ) + size );
+  if( !block ) {
+    return NULL;
+  }
+
+  block->next = NULL;
+  block->size = size;
+
+  return block;
+}
+
+/*
+ * Allocates size bytes from the arena, moving on to the next block (or adding
+ * a new one) if the current block does not have enough room. The size must
+ * already be aligned, and the arena must be locked by the caller.
+ */
+static void *
+locked_alloc_mem( struct stumpless_arena *arena, size_t size ) {
+  struct arena_block *block;
+  struct arena_block *next;
+  void *mem;
+
+  block = arena->current_block;
+  if( block->size - arena->position < size ) {
+    next = block->next;
+
+    // blocks left over from before a reset are reused if they are big enough
+    if( !next || next->size < size ) {
+      next = new_arena_block( size > arena->block_size ?
+                                size :
+                                arena->block_size );
+      if( !next ) {
+        return NULL;
+      }
+
+      next->next = block->next;
+      block->next = next;
+    }
+
+    block = next;
+    arena->current_block = block;
+    arena->position = 0;
+  }
+
+  mem = get_block_data( block ) + arena->position;
+  arena->position += size;
+
+  return mem;
+}
+
+void
+stumpless_destroy_arena( const struct stumpless_arena *arena ) {
+  const struct arena_block *block;
+  const struct arena_block *next;
+
+  if( !arena ) {
+    return;
+  }
+
+  // the first block is part of the same allocation as the arena itself
+  block = ( ( const struct arena_block * ) arena->first_block )->next;
+  while( block ) {
+    next = block->next;
+    free_sized_mem( block, get_aligned_size( sizeof( *block ) ) + block->size );
+    block = next;
+  }
+
+  config_destroy_cached_mutex( arena->mutex );
+  free_sized_mem( arena,
+                  get_aligned_size( sizeof( *arena ) ) +
+                    get_aligned_size( sizeof( *block ) ) +
+                    arena->block_size );
+}
+
+struct stumpless_arena *
+stumpless_new_arena( size_t size ) {
+  struct stumpless_arena *arena;
+  struct arena_block *first_block;
+  size_t arena_size;
+
+  size = get_aligned_size( size == 0 ? STUMPLESS_DEFAULT_ARENA_SIZE : size );
+  arena_size = get_aligned_size( sizeof( *arena ) );
+
+  arena = alloc_mem( arena_size + get_aligned_size( sizeof( *first_block ) ) +
+                     size );
+  if( !arena ) {
+    goto fail;
+  }
+
+  first_block = ( struct arena_block * ) ( ( char * ) arena + arena_size );
+  first_block->next = NULL;
+  first_block->size = size;
+
+  arena->first_block = first_block;
+  arena->current_block = first_block;
+  arena->position = 0;
+  arena->block_size = size;
+
+  config_assign_cached_mutex( arena->mutex );
+  if( !config_check_mutex_valid( arena->mutex ) ) {
+    goto fail_mutex;
+  }
+
+  clear_error(  );
+  return arena;
+
+fail_mutex:
+  free_sized_mem( arena,
+                  arena_size + get_aligned_size( sizeof( *first_block ) ) +
+                    size );
+fail:
+  return NULL;
+}
+
+struct stumpless_arena *
+stumpless_reset_arena( struct stumpless_arena *arena ) {
+  VALIDATE_ARG_NOT_NULL( arena );
+
+  config_lock_cached_mutex( arena->mutex );
+  arena->current_block = arena->first_block;
+  arena->position = 0;
+  config_unlock_cached_mutex( arena->mutex );
+
+  clear_error(  );
+  return arena;
+}
+
+/* private functions */
+
+void *
+arena_alloc_mem( struct stumpless_arena *arena, size_t size ) {
+  void *mem;
+
+  if( !arena ) {
+    return alloc_mem( size );
+  }
+
+  size = get_aligned_size( size );
+
+  config_lock_cached_mutex( arena->mutex );
+  mem = locked_alloc_mem( arena, size );
+  config_unlock_cached_mutex( arena->mutex );
+
+  return mem;
+}
+
+char *
+arena_copy_cstring_with_length( struct stumpless_arena *arena,
+                                const char *str,
+                                size_t *length ) {
+  char *new_string;
+
+  if( !arena ) {
+    return copy_cstring_with_length( str, length );
+  }
+
+  *length = strlen( str );
+
+  new_string = arena_alloc_mem( arena, *length + 1 );
+  if( !new_string ) {
+    return NULL;
+  }
+
+  memcpy( new_string, str, *length );
+  new_string[*length] = '\0';
+
+  return new_string;
+}
+
+char *
+arena_format_string( struct stumpless_arena *arena,
+                     const char *format,
+                     va_list subs,
+                     size_t *length ) {
+  char first_try[128];
+  va_list subs_copy;
+  int result;
+  size_t message_length;
+  char *buffer;
+
+  if( !arena ) {
+    return config_format_string( format, subs, length );
+  }
+
+  // most messages fit on the stack, so they only need to be formatted once
+  va_copy( subs_copy, subs );
+  result = config_format_string_into( first_try,
+                                      sizeof( first_try ),
+                                      format,
+                                      subs_copy );
+  va_end( subs_copy );
+  if( result < 0 ) {
+    raise_format_failure( errno );
+    return NULL;
+  }
+
+  message_length = ( size_t ) result;
+  buffer = arena_alloc_mem( arena, message_length + 1 );
+  if( !buffer ) {
+    return NULL;
+  }
+
+  if( message_length < sizeof( first_try ) ) {
+    memcpy( buffer, first_try, message_length + 1 );
+
+  } else {
+    result = config_format_string_into( buffer,
+                                        message_length + 1,
+                                        format,
+                                        subs );
+    if( result < 0 || ( size_t ) result != message_length ) {
+      arena_free_mem( arena, buffer, message_length + 1 );
+      raise_format_failure( errno );
+      return NULL;
+    }
+  }
+
+  *length = message_length;
+  return buffer;
+}
+
+void
+arena_free_mem( const struct stumpless_arena *arena,
+                const void *mem,
+                size_t size ) {
+  if( !arena ) {
+    free_sized_mem( mem, size );
+  }
+}
+
+void *
+arena_realloc_mem( struct stumpless_arena *arena,
+                   void *mem,
+                   size_t old_size,
+                   size_t size ) {
+  struct arena_block *block;
+  size_t aligned_old_size;
+  size_t aligned_size;
+  char *new_mem;
+
+  if( !arena ) {
+    return realloc_mem( mem, size );
+  }
+
+  aligned_old_size = get_aligned_size( old_size );
+  aligned_size = get_aligned_size( size );
+
+  config_lock_cached_mutex( arena->mutex );
+
+  // the most recent allocation can grow into the rest of its block
+  block = arena->current_block;
+  if( mem &&
+      ( char * ) mem + aligned_old_size ==
+        get_block_data( block ) + arena->position &&
+      arena->position - aligned_old_size + aligned_size <= block->size ) {
+    arena->position = arena->position - aligned_old_size + aligned_size;
+    config_unlock_cached_mutex( arena->mutex );
+    return mem;
+  }
+
+  new_mem = locked_alloc_mem( arena, aligned_size );
+  config_unlock_cached_mutex( arena->mutex );
+
+  if( new_mem && mem ) {
+    memcpy( new_mem, mem, old_size < size ? old_size : size );
+  }
+
+  return new_mem;
+}
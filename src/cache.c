@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stumpless/memory.h>
 #include "private/cache.h"
 #include "private/config/wrapper/thread_safety.h"
 #include "private/memory.h"
@@ -135,12 +136,12 @@ cache_destroy( const struct cache *c ) {
 
   for( i = 0; i < c->page_count; i++ ) {
     teardown_page( c, i );
-    free_mem( c->pages[i] );
+    free_sized_mem( c->pages[i], c->page_size );
   }
 
   config_destroy_mutex( &c->mutex );
   free_mem( c->pages );
-  free_mem( c );
+  free_sized_mem( c, sizeof( *c ) );
 }
 
 void
@@ -177,6 +178,39 @@ cache_free( const struct cache *c, const void *entry ) {
   config_unlock_mutex( &c->mutex );
 }
 
+/*
+ * Adds the memory used by the cache to usage, counting each entry that is
+ * currently allocated from it. A NULL cache uses no memory.
+ */
+void
+cache_get_usage( const struct cache *c, struct stumpless_memory_usage *usage ) {
+  size_t entries_per_page;
+  size_t i;
+  size_t j;
+  const char *locks;
+
+  if( !c ) {
+    return;
+  }
+
+  config_lock_mutex( &c->mutex );
+
+  entries_per_page = c->page_size / ( c->entry_size + sizeof( char ) );
+  usage->bytes += sizeof( *c ) + ( sizeof( char * ) * c->page_count ) +
+                  ( c->page_size * c->page_count );
+
+  for( i = 0; i < ( size_t ) c->page_count; i++ ) {
+    locks = c->pages[i] + ( entries_per_page * c->entry_size );
+    for( j = 0; j < entries_per_page; j++ ) {
+      if( locks[j] ) {
+        usage->count++;
+      }
+    }
+  }
+
+  config_unlock_mutex( &c->mutex );
+}
+
 struct cache *
 cache_new( size_t size,
            void ( *entry_init ) ( void * ),
@@ -16,10 +16,24 @@
  * limitations under the License.
  */
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
+#include <time.h>
 #include <stumpless/config.h>
 #include "private/config/fallback.h"
 
+int
+fallback_close_fd( int fd ) {
+  ( void ) fd;
+  return -1;
+}
+
+unsigned long long
+fallback_get_monotonic_milliseconds( void ) {
+  return ( unsigned long long ) time( NULL ) * 1000;
+}
+
 int
 fallback_gethostname( char *buffer, size_t namelen ) {
   if( namelen < 2 ) {
@@ -40,3 +54,42 @@ int
 fallback_getpid( void ) {
   return 0;
 }
+
+int
+fallback_open_append_fd( const char *filename ) {
+  ( void ) filename;
+  return -1;
+}
+
+int
+fallback_reopen_append_fd( int fd, const char *filename ) {
+  ( void ) fd;
+  ( void ) filename;
+  return -1;
+}
+
+int
+fallback_sync_fd( int fd ) {
+  ( void ) fd;
+  return -1;
+}
+
+int
+fallback_sync_stream( FILE *stream ) {
+  ( void ) stream;
+  return -1;
+}
+
+bool
+fallback_write_fd( int fd, const char *buffer, size_t size ) {
+  ( void ) fd;
+  ( void ) buffer;
+  ( void ) size;
+  return false;
+}
+
+bool
+fallback_write_stream( FILE *stream, const char *buffer, size_t size ) {
+  return fwrite( buffer, sizeof( char ), size, stream ) == size &&
+         fflush( stream ) == 0;
+}
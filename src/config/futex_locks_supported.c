@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "private/config/futex_locks_supported.h"
+
+/*
+ * The lock word used for reader-writer locks is laid out as follows:
+ *
+ *  - the low 29 bits hold the number of readers holding the lock
+ *  - FUTEX_RWLOCK_WRITER_WAITING is set while a writer is waiting for the lock,
+ *    and keeps new readers out so that a steady stream of them cannot starve
+ *    writers; it is cleared by the next writer to take the lock
+ *  - FUTEX_RWLOCK_WRITER is set while a writer holds the lock
+ *  - FUTEX_RWLOCK_WAITERS is set when at least one thread may be sleeping on
+ *    the lock word, and must be woken when the lock is released
+ *
+ * Mutexes use the classic three states: unlocked, locked without waiters, and
+ * locked with possible waiters.
+ */
+#define FUTEX_RWLOCK_READERS 0x1fffffffu
+#define FUTEX_RWLOCK_WRITER_WAITING 0x20000000u
+#define FUTEX_RWLOCK_WRITER 0x40000000u
+#define FUTEX_RWLOCK_WAITERS 0x80000000u
+
+#define FUTEX_MUTEX_UNLOCKED 0u
+#define FUTEX_MUTEX_LOCKED 1u
+#define FUTEX_MUTEX_CONTENDED 2u
+
+static
+atomic_uint *
+get_word( const unsigned int *lock ) {
+  return ( atomic_uint * ) lock;
+}
+
+static
+void
+futex_wait( atomic_uint *word, unsigned int expected ) {
+  syscall( SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0 );
+}
+
+static
+void
+futex_wake_all( atomic_uint *word ) {
+  syscall( SYS_futex, word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0 );
+}
+
+static
+void
+futex_wake_one( atomic_uint *word ) {
+  syscall( SYS_futex, word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0 );
+}
+
+/*
+ * Sets the given waiting bits in the lock word and sleeps until it changes. If
+ * the lock word changes before the bits can be set, then this returns right
+ * away so that the caller can check the new state.
+ */
+static
+void
+wait_on_rwlock( atomic_uint *word, unsigned int state, unsigned int bits ) {
+  unsigned int waiting_state = state | bits;
+
+  if( state == waiting_state ||
+      atomic_compare_exchange_weak( word, &state, waiting_state ) ) {
+    futex_wait( word, waiting_state );
+  }
+}
+
+void
+futex_init_lock( unsigned int *lock ) {
+  atomic_init( get_word( lock ), 0 );
+}
+
+void
+futex_lock_mutex( const unsigned int *mutex ) {
+  atomic_uint *word = get_word( mutex );
+  unsigned int state = FUTEX_MUTEX_UNLOCKED;
+
+  if( atomic_compare_exchange_strong( word, &state, FUTEX_MUTEX_LOCKED ) ) {
+    return;
+  }
+
+  if( state != FUTEX_MUTEX_CONTENDED ) {
+    state = atomic_exchange( word, FUTEX_MUTEX_CONTENDED );
+  }
+
+  while( state != FUTEX_MUTEX_UNLOCKED ) {
+    futex_wait( word, FUTEX_MUTEX_CONTENDED );
+    state = atomic_exchange( word, FUTEX_MUTEX_CONTENDED );
+  }
+}
+
+void
+futex_read_lock_rwlock( const unsigned int *rwlock ) {
+  atomic_uint *word = get_word( rwlock );
+  unsigned int state;
+
+  state = atomic_load_explicit( word, memory_order_relaxed );
+  while( true ) {
+    if( !( state & ( FUTEX_RWLOCK_WRITER | FUTEX_RWLOCK_WRITER_WAITING ) ) ) {
+      if( atomic_compare_exchange_weak( word, &state, state + 1 ) ) {
+        return;
+      }
+
+    } else {
+      wait_on_rwlock( word, state, FUTEX_RWLOCK_WAITERS );
+      state = atomic_load_explicit( word, memory_order_relaxed );
+    }
+  }
+}
+
+void
+futex_read_unlock_rwlock( const unsigned int *rwlock ) {
+  atomic_uint *word = get_word( rwlock );
+  unsigned int state;
+
+  state = atomic_fetch_sub( word, 1 ) - 1;
+
+  // the last reader out wakes any waiting writers, leaving new readers blocked
+  if( !( state & FUTEX_RWLOCK_READERS ) &&
+      state & FUTEX_RWLOCK_WAITERS &&
+      atomic_compare_exchange_strong( word,
+                                      &state,
+                                      state & ~FUTEX_RWLOCK_WAITERS ) ) {
+    futex_wake_all( word );
+  }
+}
+
+void
+futex_unlock_mutex( const unsigned int *mutex ) {
+  atomic_uint *word = get_word( mutex );
+
+  if( atomic_exchange( word, FUTEX_MUTEX_UNLOCKED ) == FUTEX_MUTEX_CONTENDED ) {
+    futex_wake_one( word );
+  }
+}
+
+void
+futex_write_lock_rwlock( const unsigned int *rwlock ) {
+  atomic_uint *word = get_word( rwlock );
+  unsigned int state;
+
+  state = atomic_load_explicit( word, memory_order_relaxed );
+  while( true ) {
+    if( !( state & ( FUTEX_RWLOCK_READERS | FUTEX_RWLOCK_WRITER ) ) ) {
+      // the waiters bit is kept so that the unlock wakes the other sleepers,
+      // which includes any other writers that will mark themselves again
+      if( atomic_compare_exchange_weak( word,
+                                        &state,
+                                        ( state & FUTEX_RWLOCK_WAITERS ) |
+                                          FUTEX_RWLOCK_WRITER ) ) {
+        return;
+      }
+
+    } else {
+      wait_on_rwlock( word,
+                      state,
+                      FUTEX_RWLOCK_WAITERS | FUTEX_RWLOCK_WRITER_WAITING );
+      state = atomic_load_explicit( word, memory_order_relaxed );
+    }
+  }
+}
+
+void
+futex_write_unlock_rwlock( const unsigned int *rwlock ) {
+  atomic_uint *word = get_word( rwlock );
+
+  if( atomic_exchange( word, 0 ) & FUTEX_RWLOCK_WAITERS ) {
+    futex_wake_all( word );
+  }
+}
@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <zlib.h>
+#include "private/config/gzip_supported.h"
+#include "private/config/wrapper.h"
+#include "private/error.h"
+#include "private/memory.h"
+
+/*
+ * Allocates memory for zlib with the memory functions of the library, so that
+ * any custom allocator is used for the compression state as well.
+ */
+static
+voidpf
+gzip_alloc( voidpf opaque, uInt items, uInt size ) {
+  ( void ) opaque;
+
+  return alloc_mem( ( size_t ) items * size );
+}
+
+static
+void
+gzip_free( voidpf opaque, voidpf address ) {
+  ( void ) opaque;
+
+  free_mem( address );
+}
+
+/*
+ * Writes everything in the output buffer to the file and empties it.
+ */
+static
+int
+write_output( struct gzip_writer *writer ) {
+  size_t used;
+
+  used = GZIP_OUTPUT_SIZE - writer->stream.avail_out;
+  writer->stream.next_out = ( Bytef * ) writer->output;
+  writer->stream.avail_out = GZIP_OUTPUT_SIZE;
+
+  if( used > 0 && !config_write_fd( writer->fd, writer->output, used ) ) {
+    raise_file_write_failure(  );
+    return -1;
+  }
+
+  return 0;
+}
+
+/*
+ * Runs deflate until all of the input has been taken, or until the member is
+ * complete if flush is Z_FINISH, writing the output buffer each time it fills.
+ */
+static
+int
+run_deflate( struct gzip_writer *writer, int flush ) {
+  int result;
+
+  for( ;; ) {
+    result = deflate( &writer->stream, flush );
+    if( result == Z_STREAM_ERROR ) {
+      raise_gzip_failure( result );
+      return -1;
+    }
+
+    if( flush == Z_FINISH ? result == Z_STREAM_END :
+                            writer->stream.avail_in == 0 ) {
+      return 0;
+    }
+
+    // otherwise deflate only stops early once the output buffer is full
+    if( write_output( writer ) != 0 ) {
+      return -1;
+    }
+  }
+}
+
+void
+destroy_gzip_writer( struct gzip_writer *writer ) {
+  flush_gzip_writer( writer );
+  deflateEnd( &writer->stream );
+  free_mem( writer->output );
+  free_mem( writer );
+}
+
+int
+flush_gzip_writer( struct gzip_writer *writer ) {
+  int result;
+
+  if( !writer->pending ) {
+    return 0;
+  }
+
+  result = run_deflate( writer, Z_FINISH );
+  if( result == 0 ) {
+    result = write_output( writer );
+  }
+
+  // the member is started over even if it could not be written, as there is
+  // no way to know how much of it reached the file
+  deflateReset( &writer->stream );
+  writer->stream.next_out = ( Bytef * ) writer->output;
+  writer->stream.avail_out = GZIP_OUTPUT_SIZE;
+  writer->pending = false;
+
+  return result;
+}
+
+struct gzip_writer *
+new_gzip_writer( int fd, int level ) {
+  struct gzip_writer *writer;
+  int result;
+
+  writer = alloc_mem( sizeof( *writer ) );
+  if( !writer ) {
+    goto fail;
+  }
+
+  writer->output = alloc_mem( GZIP_OUTPUT_SIZE );
+  if( !writer->output ) {
+    goto fail_output;
+  }
+
+  writer->stream.zalloc = gzip_alloc;
+  writer->stream.zfree = gzip_free;
+  writer->stream.opaque = Z_NULL;
+  writer->stream.next_in = Z_NULL;
+  writer->stream.avail_in = 0;
+
+  // a window size offset by 16 makes zlib write a gzip header and trailer
+  result = deflateInit2( &writer->stream,
+                         level,
+                         Z_DEFLATED,
+                         15 + 16,
+                         8,
+                         Z_DEFAULT_STRATEGY );
+  if( result != Z_OK ) {
+    if( result != Z_MEM_ERROR ) {
+      raise_gzip_failure( result );
+    }
+    goto fail_init;
+  }
+
+  writer->stream.next_out = ( Bytef * ) writer->output;
+  writer->stream.avail_out = GZIP_OUTPUT_SIZE;
+  writer->fd = fd;
+  writer->pending = false;
+
+  return writer;
+
+fail_init:
+  free_mem( writer->output );
+fail_output:
+  free_mem( writer );
+fail:
+  return NULL;
+}
+
+int
+send_to_gzip_writer( struct gzip_writer *writer,
+                     const char *msg,
+                     size_t msg_length ) {
+  uInt chunk_size;
+
+  writer->pending = true;
+
+  while( msg_length > 0 ) {
+    chunk_size = msg_length > UINT_MAX ? UINT_MAX : ( uInt ) msg_length;
+    writer->stream.next_in = ( Bytef * ) msg;
+    writer->stream.avail_in = chunk_size;
+
+    if( run_deflate( writer, Z_NO_FLUSH ) != 0 ) {
+      writer->stream.avail_in = 0;
+      return -1;
+    }
+
+    msg += chunk_size;
+    msg_length -= chunk_size;
+  }
+
+  return 0;
+}
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stddef.h>
+#include "private/config/gzip_unsupported.h"
+#include "private/config/locale/wrapper.h"
+#include "private/error.h"
+
+struct gzip_writer *
+no_gzip_new_writer( int fd, int level ) {
+  ( void ) fd;
+  ( void ) level;
+
+  raise_target_unsupported( L10N_GZIP_FILES_UNSUPPORTED_ERROR_MESSAGE );
+  return NULL;
+}
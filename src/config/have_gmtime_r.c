@@ -16,6 +16,7 @@
  * limitations under the License.
  */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <time.h>
@@ -23,19 +24,12 @@
 #include "private/formatter.h"
 
 size_t
-gmtime_r_get_now( char *buffer ) {
-  int gettime_result;
-  struct tm now_tm;
-  struct timespec now_ts;
+gmtime_r_format_time( char *buffer, const struct timespec *time ) {
+  struct tm time_tm;
   const struct tm *gmtime_result;
   size_t written;
 
-  gettime_result = clock_gettime( CLOCK_REALTIME, &now_ts );
-  if( gettime_result != 0 ) {
-    return 0;
-  }
-
-  gmtime_result = gmtime_r( &(now_ts.tv_sec), &now_tm );
+  gmtime_result = gmtime_r( &( time->tv_sec ), &time_tm );
   if( !gmtime_result ) {
     return 0;
   }
@@ -43,11 +37,27 @@ gmtime_r_get_now( char *buffer ) {
   written = strftime( buffer,
                       RFC_5424_WHOLE_TIME_BUFFER_SIZE,
                       "%FT%T",
-                      &now_tm );
+                      &time_tm );
   written += snprintf( buffer + written,
                        RFC_5424_TIME_SECFRAC_BUFFER_SIZE + 2,
                        ".%06ldZ",
-                       ( now_ts.tv_nsec / 1000 ) % 1000000 );
+                       ( time->tv_nsec / 1000 ) % 1000000 );
 
   return written;
 }
+
+size_t
+gmtime_r_get_now( char *buffer ) {
+  struct timespec now_ts;
+
+  if( !gmtime_r_get_time( &now_ts ) ) {
+    return 0;
+  }
+
+  return gmtime_r_format_time( buffer, &now_ts );
+}
+
+bool
+gmtime_r_get_time( struct timespec *time ) {
+  return clock_gettime( CLOCK_REALTIME, time ) == 0;
+}
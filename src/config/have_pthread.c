@@ -16,26 +16,101 @@
  * limitations under the License.
  */
 
+#include <errno.h>
 #include <pthread.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <time.h>
 #include "private/config/have_pthread.h"
 
+void
+pthread_broadcast_cond( pthread_cond_t *cond ) {
+  pthread_cond_broadcast( cond );
+}
+
+void
+pthread_destroy_cond( pthread_cond_t *cond ) {
+  pthread_cond_destroy( cond );
+}
+
 void
 pthread_destroy_mutex( const pthread_mutex_t *mutex ) {
   pthread_mutex_destroy( ( pthread_mutex_t * ) mutex );
 }
 
+void
+pthread_destroy_rwlock( const pthread_rwlock_t *rwlock ) {
+  pthread_rwlock_destroy( ( pthread_rwlock_t * ) rwlock );
+}
+
+void
+pthread_init_cond( pthread_cond_t *cond ) {
+  pthread_condattr_t attr;
+
+  // timed waits are measured against a clock that cannot jump
+  pthread_condattr_init( &attr );
+  pthread_condattr_setclock( &attr, CLOCK_MONOTONIC );
+  pthread_cond_init( cond, &attr );
+  pthread_condattr_destroy( &attr );
+}
+
 void
 pthread_init_mutex( pthread_mutex_t *mutex ) {
   pthread_mutex_init( mutex, NULL );
 }
 
+void
+pthread_init_rwlock( pthread_rwlock_t *rwlock ) {
+  pthread_rwlock_init( rwlock, NULL );
+}
+
 void
 pthread_lock_mutex( const pthread_mutex_t *mutex ) {
   pthread_mutex_lock( ( pthread_mutex_t * ) mutex );
 }
 
+void
+pthread_read_lock_rwlock( const pthread_rwlock_t *rwlock ) {
+  pthread_rwlock_rdlock( ( pthread_rwlock_t * ) rwlock );
+}
+
+void
+pthread_signal_cond( pthread_cond_t *cond ) {
+  pthread_cond_signal( cond );
+}
+
+bool
+pthread_timed_wait_cond( pthread_cond_t *cond,
+                         const pthread_mutex_t *mutex,
+                         unsigned long long deadline ) {
+  struct timespec abstime;
+  int result;
+
+  abstime.tv_sec = ( time_t ) ( deadline / 1000 );
+  abstime.tv_nsec = ( long ) ( deadline % 1000 ) * 1000000L;
+
+  result = pthread_cond_timedwait( cond,
+                                   ( pthread_mutex_t * ) mutex,
+                                   &abstime );
+  return result != ETIMEDOUT;
+}
+
 void
 pthread_unlock_mutex( const pthread_mutex_t *mutex ) {
   pthread_mutex_unlock( ( pthread_mutex_t * ) mutex );
 }
+
+void
+pthread_unlock_rwlock( const pthread_rwlock_t *rwlock ) {
+  pthread_rwlock_unlock( ( pthread_rwlock_t * ) rwlock );
+}
+
+void
+pthread_wait_cond( pthread_cond_t *cond, const pthread_mutex_t *mutex ) {
+  pthread_cond_wait( cond, ( pthread_mutex_t * ) mutex );
+}
+
+void
+pthread_write_lock_rwlock( const pthread_rwlock_t *rwlock ) {
+  pthread_rwlock_wrlock( ( pthread_rwlock_t * ) rwlock );
+}
@@ -18,9 +18,15 @@
 
 #include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "private/config/have_stdatomic.h"
 
+size_t
+stdatomic_add_size( size_t *s, size_t n ) {
+  return atomic_fetch_add( ( atomic_size_t * ) s, n ) + n;
+}
+
 bool
 stdatomic_compare_exchange_bool( atomic_bool *b,
                                  bool expected,
@@ -39,22 +45,67 @@ stdatomic_compare_exchange_ptr( atomic_uintptr_t *p,
                                          ( uintptr_t ) replacement );
 }
 
+size_t
+stdatomic_decrement_size( size_t *s ) {
+  return atomic_fetch_sub( ( atomic_size_t * ) s, 1 ) - 1;
+}
+
+size_t
+stdatomic_increment_size( size_t *s ) {
+  return atomic_fetch_add( ( atomic_size_t * ) s, 1 ) + 1;
+}
+
 bool
 stdatomic_read_bool( atomic_bool *b ) {
   return ( bool ) atomic_load( b );
 }
 
+bool
+stdatomic_read_flag( const bool *flag ) {
+  return atomic_load( ( const atomic_bool * ) flag );
+}
+
+int
+stdatomic_read_int( const int *i ) {
+  return atomic_load( ( const atomic_int * ) i );
+}
+
 void *
 stdatomic_read_ptr( atomic_uintptr_t *p ) {
   return ( void * ) atomic_load( p );
 }
 
+size_t
+stdatomic_read_size( size_t *s ) {
+  return atomic_load( ( atomic_size_t * ) s );
+}
+
+size_t
+stdatomic_subtract_size( size_t *s, size_t n ) {
+  return atomic_fetch_sub( ( atomic_size_t * ) s, n ) - n;
+}
+
 void
 stdatomic_write_bool( atomic_bool *b, bool replacement ) {
   atomic_store( b, replacement );
 }
 
+void
+stdatomic_write_flag( bool *flag, bool replacement ) {
+  atomic_store( ( atomic_bool * ) flag, replacement );
+}
+
+void
+stdatomic_write_int( int *i, int replacement ) {
+  atomic_store( ( atomic_int * ) i, replacement );
+}
+
 void
 stdatomic_write_ptr( atomic_uintptr_t *p, void *replacement ) {
   atomic_store( p, ( uintptr_t ) replacement );
 }
+
+void
+stdatomic_write_size( size_t *s, size_t replacement ) {
+  atomic_store( ( atomic_size_t * ) s, replacement );
+}
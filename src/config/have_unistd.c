@@ -16,10 +16,98 @@
  * limitations under the License.
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
+#include "private/config.h"
 #include "private/config/have_unistd.h"
 
+int
+unistd_close_fd( int fd ) {
+  return close( fd );
+}
+
+unsigned long long
+unistd_get_monotonic_milliseconds( void ) {
+  struct timespec now;
+
+  clock_gettime( CLOCK_MONOTONIC, &now );
+
+  return ( ( unsigned long long ) now.tv_sec * 1000 ) +
+         ( ( unsigned long long ) now.tv_nsec / 1000000 );
+}
+
 int
 unistd_getpid( void ) {
   return ( int ) ( getpid(  ) );
 }
+
+int
+unistd_open_append_fd( const char *filename ) {
+  return open( filename,
+               O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+               S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH );
+}
+
+int
+unistd_reopen_append_fd( int fd, const char *filename ) {
+  int new_fd;
+  int result;
+
+  new_fd = unistd_open_append_fd( filename );
+  if( new_fd == -1 ) {
+    return -1;
+  }
+
+  // dup2 replaces fd atomically, so writes in other threads use either file
+  result = dup2( new_fd, fd ) == -1 ? -1 : 0;
+  close( new_fd );
+  return result;
+}
+
+int
+unistd_sync_fd( int fd ) {
+#ifdef HAVE_FDATASYNC
+  // metadata such as the modification time is not needed to read the log back
+  return fdatasync( fd );
+#else
+  return fsync( fd );
+#endif
+}
+
+int
+unistd_sync_stream( FILE *stream ) {
+  return unistd_sync_fd( fileno( stream ) );
+}
+
+bool
+unistd_write_fd( int fd, const char *buffer, size_t size ) {
+  ssize_t result;
+
+  while( size > 0 ) {
+    result = write( fd, buffer, size );
+    if( result < 0 ) {
+      if( errno == EINTR ) {
+        continue;
+      }
+
+      return false;
+    }
+
+    buffer += result;
+    size -= ( size_t ) result;
+  }
+
+  return true;
+}
+
+bool
+unistd_write_stream( FILE *stream, const char *buffer, size_t size ) {
+  return unistd_write_fd( fileno( stream ), buffer, size );
+}
@@ -47,3 +47,22 @@ fail:
   free_mem( buffer );
   return NULL;
 }
+
+int
+vsnprintf_s_format_string_into( char *buffer,
+                                size_t size,
+                                const char *format,
+                                va_list subs ) {
+  va_list subs_copy;
+  int result;
+
+  // vsnprintf_s does not give the full length of output that is truncated
+  va_copy( subs_copy, subs );
+  result = _vscprintf( format, subs_copy );
+  va_end( subs_copy );
+  if( result < 0 || ( size_t ) result >= size ) {
+    return result;
+  }
+
+  return vsnprintf_s( buffer, size, _TRUNCATE, format, subs );
+}
@@ -16,14 +16,35 @@
  * limitations under the License.
  */
 
+#include <fcntl.h>
+#include <io.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
+#include <sys/stat.h>
 #include "private/config/have_windows.h"
 #include "private/config/locale/wrapper.h"
 #include "private/error.h"
 #include "private/inthelper.h"
 #include "private/windows_wrapper.h"
 
+size_t
+windows_add_size( size_t *s, size_t n ) {
+#ifdef _WIN64
+  return ( size_t ) InterlockedExchangeAdd64( ( LONG64 volatile * ) s,
+                                              ( LONG64 ) n ) + n;
+#else
+  return ( size_t ) InterlockedExchangeAdd( ( LONG volatile * ) s,
+                                            ( LONG ) n ) + n;
+#endif
+}
+
+void
+windows_broadcast_cond( PCONDITION_VARIABLE cond ) {
+  WakeAllConditionVariable( cond );
+}
+
 bool
 windows_compare_exchange_bool( LONG volatile *b,
                                LONG expected,
@@ -46,11 +67,30 @@ windows_compare_exchange_ptr( PVOID volatile *p,
   return initial == expected;
 }
 
+int
+windows_close_fd( int fd ) {
+  return _close( fd );
+}
+
+size_t
+windows_decrement_size( size_t *s ) {
+#ifdef _WIN64
+  return ( size_t ) InterlockedDecrement64( ( LONG64 volatile * ) s );
+#else
+  return ( size_t ) InterlockedDecrement( ( LONG volatile * ) s );
+#endif
+}
+
 void
 windows_destroy_mutex( const CRITICAL_SECTION *mutex ){
   DeleteCriticalSection( ( LPCRITICAL_SECTION ) mutex );
 }
 
+unsigned long long
+windows_get_monotonic_milliseconds( void ) {
+  return ( unsigned long long ) GetTickCount64(  );
+}
+
 int
 windows_gethostname( char *buffer, size_t namelen ) {
   DWORD capped_namelen;
@@ -85,17 +125,163 @@ windows_getpid( void ) {
   return ( int ) ( GetCurrentProcessId(  ) );
 }
 
+size_t
+windows_increment_size( size_t *s ) {
+#ifdef _WIN64
+  return ( size_t ) InterlockedIncrement64( ( LONG64 volatile * ) s );
+#else
+  return ( size_t ) InterlockedIncrement( ( LONG volatile * ) s );
+#endif
+}
+
+void
+windows_init_cond( PCONDITION_VARIABLE cond ) {
+  InitializeConditionVariable( cond );
+}
+
 void
 windows_init_mutex( LPCRITICAL_SECTION mutex ) {
   InitializeCriticalSection( mutex );
 }
 
+void
+windows_init_rwlock( PSRWLOCK rwlock ) {
+  InitializeSRWLock( rwlock );
+}
+
 void
 windows_lock_mutex( const CRITICAL_SECTION *mutex ) {
   EnterCriticalSection( ( LPCRITICAL_SECTION ) mutex );
 }
 
+int
+windows_open_append_fd( const char *filename ) {
+  return _open( filename,
+                _O_WRONLY | _O_CREAT | _O_APPEND | _O_NOINHERIT,
+                _S_IREAD | _S_IWRITE );
+}
+
+void
+windows_read_lock_rwlock( const SRWLOCK *rwlock ) {
+  AcquireSRWLockShared( ( PSRWLOCK ) rwlock );
+}
+
+int
+windows_reopen_append_fd( int fd, const char *filename ) {
+  int new_fd;
+  int result;
+
+  new_fd = windows_open_append_fd( filename );
+  if( new_fd == -1 ) {
+    return -1;
+  }
+
+  result = _dup2( new_fd, fd );
+  _close( new_fd );
+  return result;
+}
+
+void
+windows_read_unlock_rwlock( const SRWLOCK *rwlock ) {
+  ReleaseSRWLockShared( ( PSRWLOCK ) rwlock );
+}
+
+void
+windows_signal_cond( PCONDITION_VARIABLE cond ) {
+  WakeConditionVariable( cond );
+}
+
+size_t
+windows_subtract_size( size_t *s, size_t n ) {
+  return windows_add_size( s, ( size_t ) 0 - n );
+}
+
+int
+windows_sync_fd( int fd ) {
+  return _commit( fd );
+}
+
+int
+windows_sync_stream( FILE *stream ) {
+  return windows_sync_fd( _fileno( stream ) );
+}
+
+bool
+windows_timed_wait_cond( PCONDITION_VARIABLE cond,
+                         const CRITICAL_SECTION *mutex,
+                         unsigned long long deadline ) {
+  unsigned long long now;
+  DWORD remaining;
+
+  now = windows_get_monotonic_milliseconds(  );
+  if( now >= deadline ) {
+    return false;
+  }
+
+  if( deadline - now >= INFINITE ) {
+    remaining = INFINITE - 1;
+  } else {
+    remaining = ( DWORD ) ( deadline - now );
+  }
+
+  if( !SleepConditionVariableCS( cond,
+                                 ( LPCRITICAL_SECTION ) mutex,
+                                 remaining ) ) {
+    return GetLastError(  ) != ERROR_TIMEOUT;
+  }
+
+  return true;
+}
+
 void
 windows_unlock_mutex( const CRITICAL_SECTION *mutex ) {
   LeaveCriticalSection( ( LPCRITICAL_SECTION ) mutex );
 }
+
+void
+windows_wait_cond( PCONDITION_VARIABLE cond, const CRITICAL_SECTION *mutex ) {
+  SleepConditionVariableCS( cond, ( LPCRITICAL_SECTION ) mutex, INFINITE );
+}
+
+void
+windows_write_lock_rwlock( const SRWLOCK *rwlock ) {
+  AcquireSRWLockExclusive( ( PSRWLOCK ) rwlock );
+}
+
+bool
+windows_write_fd( int fd, const char *buffer, size_t size ) {
+  unsigned int chunk_size;
+  int result;
+
+  while( size > 0 ) {
+    chunk_size = size > INT_MAX ? INT_MAX : ( unsigned int ) size;
+    result = _write( fd, buffer, chunk_size );
+    if( result < 0 ) {
+      return false;
+    }
+
+    buffer += result;
+    size -= ( size_t ) result;
+  }
+
+  return true;
+}
+
+bool
+windows_write_stream( FILE *stream, const char *buffer, size_t size ) {
+  return windows_write_fd( _fileno( stream ), buffer, size );
+}
+
+void
+windows_write_size( size_t *s, size_t replacement ) {
+#ifdef _WIN64
+  InterlockedExchange64( ( LONG64 volatile * ) s, ( LONG64 ) replacement );
+#else
+  InterlockedExchange( ( LONG volatile * ) s, ( LONG ) replacement );
+#endif
+}
+
+void
+windows_write_unlock_rwlock( const SRWLOCK *rwlock ) {
+  ReleaseSRWLockExclusive( ( PSRWLOCK ) rwlock );
+}
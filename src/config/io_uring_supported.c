@@ -0,0 +1,512 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stumpless/memory.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "private/config/io_uring_supported.h"
+#include "private/config/locale/wrapper.h"
+#include "private/config/wrapper.h"
+#include "private/config/wrapper/thread_safety.h"
+#include "private/error.h"
+#include "private/memory.h"
+
+static size_t writer_bytes = 0;
+static size_t writer_count = 0;
+
+static
+size_t
+get_allocation_size( unsigned int depth ) {
+  return sizeof( struct io_uring_writer ) +
+         ( ( size_t ) depth * IO_URING_SLOT_SIZE ) +
+         ( ( size_t ) depth * sizeof( size_t ) ) +
+         ( ( size_t ) depth * sizeof( unsigned int ) );
+}
+
+static
+unsigned int
+load_acquire( const unsigned int *p ) {
+  return atomic_load_explicit( ( const atomic_uint * ) p,
+                               memory_order_acquire );
+}
+
+static
+void
+store_release( unsigned int *p, unsigned int value ) {
+  atomic_store_explicit( ( atomic_uint * ) p, value, memory_order_release );
+}
+
+static
+int
+ring_enter( const struct io_uring_writer *writer,
+            unsigned int to_submit,
+            unsigned int min_complete ) {
+  unsigned int flags;
+  long result;
+
+  flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+  do {
+    result = syscall( __NR_io_uring_enter,
+                      writer->ring_fd,
+                      to_submit,
+                      min_complete,
+                      flags,
+                      NULL,
+                      0 );
+  } while( result < 0 && errno == EINTR );
+
+  return ( int ) result;
+}
+
+/*
+ * Takes all available completions off of the completion queue, returning
+ * their slots to the free list. The first write error seen is kept until it
+ * is reported.
+ */
+static
+void
+reap_completions( struct io_uring_writer *writer ) {
+  unsigned int head;
+  unsigned int tail;
+  const struct io_uring_cqe *cqe;
+  unsigned int slot;
+  size_t written;
+  size_t length;
+
+  head = *writer->cq_head;
+  tail = load_acquire( writer->cq_tail );
+
+  while( head != tail ) {
+    cqe = &writer->cqes[head & writer->cq_mask];
+    slot = ( unsigned int ) cqe->user_data;
+    length = writer->lengths[slot];
+
+    if( cqe->res == -ECANCELED ) {
+      // an earlier write in the same batch failed or was short, breaking the
+      // link, so this one is written synchronously after it to stay in order
+      if( !config_write_fd( writer->fd,
+                            writer->buffers +
+                              ( ( size_t ) slot * IO_URING_SLOT_SIZE ),
+                            length ) &&
+          writer->write_error == 0 ) {
+        writer->write_error = errno;
+      }
+
+    } else if( cqe->res < 0 ) {
+      if( writer->write_error == 0 ) {
+        writer->write_error = -cqe->res;
+      }
+
+    } else {
+      written = ( size_t ) cqe->res;
+
+      // short writes are rare enough on regular files that the rest is simply
+      // written synchronously, even though it may land after later messages
+      if( written < length &&
+          !config_write_fd( writer->fd,
+                            writer->buffers +
+                              ( ( size_t ) slot * IO_URING_SLOT_SIZE ) +
+                              written,
+                            length - written ) &&
+          writer->write_error == 0 ) {
+        writer->write_error = errno;
+      }
+    }
+
+    writer->lengths[slot] = 0;
+    writer->free_slots[writer->free_count] = slot;
+    writer->free_count++;
+    writer->in_flight--;
+    head++;
+  }
+
+  store_release( writer->cq_head, head );
+}
+
+/*
+ * Submits any queued writes, and then waits until at least min_complete
+ * writes in progress have finished.
+ */
+static
+int
+submit_and_wait( struct io_uring_writer *writer, unsigned int min_complete ) {
+  int result;
+
+  if( min_complete > writer->in_flight + writer->unsubmitted ) {
+    min_complete = writer->in_flight + writer->unsubmitted;
+  }
+
+  if( writer->unsubmitted == 0 && min_complete == 0 ) {
+    return 0;
+  }
+
+  if( writer->unsubmitted > 0 ) {
+    // the last write of the batch ends its link chain
+    writer->sqes[( *writer->sq_tail - 1 ) & writer->sq_mask].flags &=
+      ( unsigned char ) ~IOSQE_IO_LINK;
+  }
+
+  result = ring_enter( writer, writer->unsubmitted, min_complete );
+  if( result < 0 ) {
+    return -1;
+  }
+
+  writer->in_flight += ( unsigned int ) result;
+  writer->unsubmitted -= ( unsigned int ) result;
+  reap_completions( writer );
+  return 0;
+}
+
+/*
+ * Raises an error for the first failed write since the last one was reported,
+ * if there was one.
+ */
+static
+int
+report_write_error( struct io_uring_writer *writer ) {
+  if( writer->write_error == 0 ) {
+    return 0;
+  }
+
+  writer->write_error = 0;
+  raise_file_write_failure(  );
+  return -1;
+}
+
+static
+void
+unmap_rings( const struct io_uring_writer *writer ) {
+  if( writer->sqes ) {
+    munmap( writer->sqes, writer->sqes_size );
+  }
+
+  if( writer->cq_ring && writer->cq_ring != writer->sq_ring ) {
+    munmap( writer->cq_ring, writer->cq_ring_size );
+  }
+
+  if( writer->sq_ring ) {
+    munmap( writer->sq_ring, writer->sq_ring_size );
+  }
+}
+
+static
+bool
+map_rings( struct io_uring_writer *writer,
+           const struct io_uring_params *params ) {
+  char *sq;
+  char *cq;
+
+  writer->sq_ring_size = params->sq_off.array +
+                         ( params->sq_entries * sizeof( unsigned int ) );
+  writer->cq_ring_size = params->cq_off.cqes +
+                         ( params->cq_entries *
+                           sizeof( struct io_uring_cqe ) );
+
+  if( params->features & IORING_FEAT_SINGLE_MMAP ) {
+    if( writer->cq_ring_size > writer->sq_ring_size ) {
+      writer->sq_ring_size = writer->cq_ring_size;
+    }
+    writer->cq_ring_size = writer->sq_ring_size;
+  }
+
+  sq = mmap( NULL,
+             writer->sq_ring_size,
+             PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE,
+             writer->ring_fd,
+             IORING_OFF_SQ_RING );
+  if( sq == MAP_FAILED ) {
+    return false;
+  }
+  writer->sq_ring = sq;
+
+  if( params->features & IORING_FEAT_SINGLE_MMAP ) {
+    cq = sq;
+  } else {
+    cq = mmap( NULL,
+               writer->cq_ring_size,
+               PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE,
+               writer->ring_fd,
+               IORING_OFF_CQ_RING );
+    if( cq == MAP_FAILED ) {
+      return false;
+    }
+  }
+  writer->cq_ring = cq;
+
+  writer->sqes_size = params->sq_entries * sizeof( struct io_uring_sqe );
+  writer->sqes = mmap( NULL,
+                       writer->sqes_size,
+                       PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE,
+                       writer->ring_fd,
+                       IORING_OFF_SQES );
+  if( writer->sqes == MAP_FAILED ) {
+    writer->sqes = NULL;
+    return false;
+  }
+
+  writer->sq_head = ( unsigned int * ) ( sq + params->sq_off.head );
+  writer->sq_tail = ( unsigned int * ) ( sq + params->sq_off.tail );
+  writer->sq_mask = *( unsigned int * ) ( sq + params->sq_off.ring_mask );
+  writer->sq_array = ( unsigned int * ) ( sq + params->sq_off.array );
+  writer->cq_head = ( unsigned int * ) ( cq + params->cq_off.head );
+  writer->cq_tail = ( unsigned int * ) ( cq + params->cq_off.tail );
+  writer->cq_mask = *( unsigned int * ) ( cq + params->cq_off.ring_mask );
+  writer->cqes = ( struct io_uring_cqe * ) ( cq + params->cq_off.cqes );
+
+  return true;
+}
+
+/*
+ * Registers the buffer slots with the ring so that the kernel does not need
+ * to map them for each write. Failure is not an error, as plain writes can be
+ * used instead.
+ */
+static
+void
+register_buffers( struct io_uring_writer *writer ) {
+  struct iovec *iovecs;
+  unsigned int i;
+  long result;
+
+  iovecs = alloc_mem( writer->depth * sizeof( *iovecs ) );
+  if( !iovecs ) {
+    writer->registered = false;
+    return;
+  }
+
+  for( i = 0; i < writer->depth; i++ ) {
+    iovecs[i].iov_base = writer->buffers + ( ( size_t ) i * IO_URING_SLOT_SIZE );
+    iovecs[i].iov_len = IO_URING_SLOT_SIZE;
+  }
+
+  result = syscall( __NR_io_uring_register,
+                    writer->ring_fd,
+                    IORING_REGISTER_BUFFERS,
+                    iovecs,
+                    writer->depth );
+  writer->registered = result == 0;
+
+  free_sized_mem( iovecs, writer->depth * sizeof( *iovecs ) );
+}
+
+/* private definitions */
+
+void
+destroy_io_uring_writer( struct io_uring_writer *writer ) {
+  flush_io_uring_writer( writer );
+
+  unmap_rings( writer );
+  close( writer->ring_fd );
+
+  config_subtract_size( &writer_bytes, get_allocation_size( writer->depth ) );
+  config_decrement_size( &writer_count );
+  free_sized_mem( writer->free_slots,
+                  writer->depth * sizeof( *writer->free_slots ) );
+  free_sized_mem( writer->lengths, writer->depth * sizeof( *writer->lengths ) );
+  free_sized_mem( writer->buffers, ( size_t ) writer->depth * IO_URING_SLOT_SIZE );
+  free_sized_mem( writer, sizeof( *writer ) );
+}
+
+int
+flush_io_uring_writer( struct io_uring_writer *writer ) {
+  while( writer->unsubmitted > 0 || writer->in_flight > 0 ) {
+    if( submit_and_wait( writer, writer->in_flight + writer->unsubmitted ) ) {
+      raise_file_write_failure(  );
+      return -1;
+    }
+  }
+
+  return report_write_error( writer );
+}
+
+void
+io_uring_get_usage( struct stumpless_memory_usage *usage ) {
+  usage->bytes += config_read_size( &writer_bytes );
+  usage->count += config_read_size( &writer_count );
+}
+
+struct io_uring_writer *
+new_io_uring_writer( int fd, unsigned int depth ) {
+  struct io_uring_writer *writer;
+  struct io_uring_params params;
+  struct stat file_stat;
+  unsigned int i;
+
+  // writes are only kept in order when the kernel serializes them per file
+  if( fstat( fd, &file_stat ) != 0 || !S_ISREG( file_stat.st_mode ) ) {
+    raise_target_incompatible( L10N_IO_URING_REGULAR_FILE_ONLY_ERROR_MESSAGE );
+    goto fail;
+  }
+
+  writer = alloc_mem( sizeof( *writer ) );
+  if( !writer ) {
+    goto fail;
+  }
+
+  writer->buffers = alloc_mem( ( size_t ) depth * IO_URING_SLOT_SIZE );
+  if( !writer->buffers ) {
+    goto fail_buffers;
+  }
+
+  writer->lengths = alloc_mem( depth * sizeof( *writer->lengths ) );
+  if( !writer->lengths ) {
+    goto fail_lengths;
+  }
+
+  writer->free_slots = alloc_mem( depth * sizeof( *writer->free_slots ) );
+  if( !writer->free_slots ) {
+    goto fail_free_slots;
+  }
+
+  memset( &params, 0, sizeof( params ) );
+  writer->ring_fd = ( int ) syscall( __NR_io_uring_setup, depth, &params );
+  if( writer->ring_fd < 0 ) {
+    raise_io_uring_failure( errno );
+    goto fail_setup;
+  }
+
+  writer->sq_ring = NULL;
+  writer->cq_ring = NULL;
+  writer->sqes = NULL;
+  if( !map_rings( writer, &params ) ) {
+    raise_io_uring_failure( errno );
+    goto fail_map;
+  }
+
+  writer->fd = fd;
+  writer->depth = depth;
+  writer->batch_size = depth / 4 == 0 ? 1 : depth / 4;
+  writer->unsubmitted = 0;
+  writer->in_flight = 0;
+  writer->write_error = 0;
+
+  for( i = 0; i < depth; i++ ) {
+    writer->lengths[i] = 0;
+    writer->free_slots[i] = depth - 1 - i;
+  }
+  writer->free_count = depth;
+
+  register_buffers( writer );
+
+  config_add_size( &writer_bytes, get_allocation_size( depth ) );
+  config_increment_size( &writer_count );
+
+  return writer;
+
+fail_map:
+  unmap_rings( writer );
+  close( writer->ring_fd );
+fail_setup:
+  free_sized_mem( writer->free_slots, depth * sizeof( *writer->free_slots ) );
+fail_free_slots:
+  free_sized_mem( writer->lengths, depth * sizeof( *writer->lengths ) );
+fail_lengths:
+  free_sized_mem( writer->buffers, ( size_t ) depth * IO_URING_SLOT_SIZE );
+fail_buffers:
+  free_sized_mem( writer, sizeof( *writer ) );
+fail:
+  return NULL;
+}
+
+int
+send_to_io_uring_writer( struct io_uring_writer *writer,
+                         const char *msg,
+                         size_t msg_length ) {
+  unsigned int slot;
+  unsigned int tail;
+  unsigned int index;
+  struct io_uring_sqe *sqe;
+  char *buffer;
+
+  reap_completions( writer );
+  if( report_write_error( writer ) != 0 ) {
+    return -1;
+  }
+
+  if( msg_length > IO_URING_SLOT_SIZE ) {
+    // everything queued must be written first to keep the messages in order
+    if( flush_io_uring_writer( writer ) != 0 ) {
+      return -1;
+    }
+
+    if( !config_write_fd( writer->fd, msg, msg_length ) ) {
+      raise_file_write_failure(  );
+      return -1;
+    }
+
+    return 0;
+  }
+
+  while( writer->free_count == 0 ) {
+    if( submit_and_wait( writer, 1 ) != 0 ) {
+      raise_file_write_failure(  );
+      return -1;
+    }
+  }
+
+  writer->free_count--;
+  slot = writer->free_slots[writer->free_count];
+  buffer = writer->buffers + ( ( size_t ) slot * IO_URING_SLOT_SIZE );
+  memcpy( buffer, msg, msg_length );
+  writer->lengths[slot] = msg_length;
+
+  tail = *writer->sq_tail;
+  index = tail & writer->sq_mask;
+  sqe = &writer->sqes[index];
+  memset( sqe, 0, sizeof( *sqe ) );
+  sqe->opcode = writer->registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+  // the writes of a batch are linked so that each starts once the one before
+  // it is done, and a batch started while an earlier one is still in flight
+  // waits for it to drain, as appends in progress at the same time may
+  // otherwise land in the file in any order
+  sqe->flags = IOSQE_ASYNC | IOSQE_IO_LINK;
+  if( writer->unsubmitted == 0 && writer->in_flight > 0 ) {
+    sqe->flags |= IOSQE_IO_DRAIN;
+  }
+  sqe->fd = writer->fd;
+  sqe->addr = ( unsigned long long ) ( uintptr_t ) buffer;
+  sqe->len = ( unsigned int ) msg_length;
+  sqe->off = ( unsigned long long ) -1;
+  sqe->buf_index = writer->registered ? ( unsigned short ) slot : 0;
+  sqe->user_data = slot;
+  writer->sq_array[index] = index;
+  store_release( writer->sq_tail, tail + 1 );
+  writer->unsubmitted++;
+
+  if( writer->unsubmitted >= writer->batch_size &&
+      submit_and_wait( writer, 0 ) != 0 ) {
+    raise_file_write_failure(  );
+    return -1;
+  }
+
+  return 0;
+}
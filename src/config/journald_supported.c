@@ -16,6 +16,7 @@
  * limitations under the License.
  */
 
+#include <stdbool.h>
 #include <stumpless/config/journald_supported.h>
 #include <stumpless/element.h>
 #include <stumpless/param.h>
@@ -28,12 +29,13 @@
 stumpless_element_namer_func_t
 stumpless_get_element_journald_namer( const struct stumpless_element *e ) {
   stumpless_element_namer_func_t result;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( e );
 
-  lock_element( e );
+  locked = lock_element( e );
   result = e->get_journald_name;
-  unlock_element( e );
+  unlock_element( e, locked );
 
   return result;
 }
@@ -41,12 +43,13 @@ stumpless_get_element_journald_namer( const struct stumpless_element *e ) {
 stumpless_param_namer_func_t
 stumpless_get_param_journald_namer( const struct stumpless_param *param ) {
   stumpless_param_namer_func_t result;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( param );
 
-  lock_param( param );
+  locked = lock_param( param );
   result = param->get_journald_name;
-  unlock_param( param );
+  unlock_param( param, locked );
 
   return result;
 }
@@ -57,9 +60,12 @@ stumpless_set_element_journald_namer( struct stumpless_element *element,
   VALIDATE_ARG_NOT_NULL( element );
   VALIDATE_ARG_NOT_NULL( namer );
 
-  lock_element( element );
+  if( !lock_mutable_element( element ) ) {
+    return NULL;
+  }
+
   element->get_journald_name = namer;
-  unlock_element( element );
+  unlock_mutable_element( element );
 
   return element;
 }
@@ -70,9 +76,12 @@ stumpless_set_param_journald_namer( struct stumpless_param *param,
   VALIDATE_ARG_NOT_NULL( param );
   VALIDATE_ARG_NOT_NULL( namer );
 
-  lock_param( param );
+  if( !lock_mutable_param( param ) ) {
+    return NULL;
+  }
+
   param->get_journald_name = namer;
-  unlock_param( param );
+  unlock_mutable_param( param );
 
   return param;
 }
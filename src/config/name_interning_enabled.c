@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "private/config/name_interning_enabled.h"
+#include "private/config/wrapper/thread_safety.h"
+#include "private/memory.h"
+#include "private/strhelper.h"
+
+/*
+ * The number of buckets in the table. This is a fixed power of two so that
+ * the table never needs to be resized, which would not be possible without
+ * locking readers. Element and param names are expected to come from a small
+ * set, so the chains stay short even with a modest number of buckets.
+ */
+#define NAME_BUCKET_COUNT 1024
+
+struct interned_name {
+  struct interned_name *next;
+  size_t length;
+  char *name;
+};
+
+static config_atomic_ptr_t name_buckets[NAME_BUCKET_COUNT];
+
+static
+size_t
+hash_name( const char *name, size_t length ) {
+  uint32_t hash = 2166136261u;
+  size_t i;
+
+  // FNV-1a
+  for( i = 0; i < length; i++ ) {
+    hash ^= ( unsigned char ) name[i];
+    hash *= 16777619u;
+  }
+
+  return hash & ( NAME_BUCKET_COUNT - 1 );
+}
+
+static
+struct interned_name *
+find_in_chain( struct interned_name *current,
+               const struct interned_name *stop,
+               const char *name,
+               size_t length ) {
+  while( current != stop ) {
+    if( current->length == length &&
+        memcmp( current->name, name, length ) == 0 ) {
+      return current;
+    }
+
+    current = current->next;
+  }
+
+  return NULL;
+}
+
+const char *
+find_interned_name( const char *name ) {
+  size_t length;
+  const struct interned_name *found;
+  struct interned_name *head;
+
+  length = strlen( name );
+  head = config_read_ptr( &name_buckets[hash_name( name, length )] );
+  found = find_in_chain( head, NULL, name, length );
+
+  return found ? found->name : NULL;
+}
+
+char *
+intern_name( const char *name, size_t *length ) {
+  size_t name_length;
+  config_atomic_ptr_t *bucket;
+  struct interned_name *head;
+  struct interned_name *new_head;
+  struct interned_name *found;
+  struct interned_name *node;
+
+  name_length = strlen( name );
+  bucket = &name_buckets[hash_name( name, name_length )];
+
+  head = config_read_ptr( bucket );
+  found = find_in_chain( head, NULL, name, name_length );
+  if( found ) {
+    *length = name_length;
+    return found->name;
+  }
+
+  node = alloc_mem( sizeof( *node ) );
+  if( !node ) {
+    return NULL;
+  }
+
+  node->name = copy_cstring_with_length( name, &node->length );
+  if( !node->name ) {
+    free_mem( node );
+    return NULL;
+  }
+
+  node->next = head;
+  while( !config_compare_exchange_ptr( bucket, head, node ) ) {
+    // only the names added since the last check need to be searched
+    new_head = config_read_ptr( bucket );
+    found = find_in_chain( new_head, head, name, name_length );
+    if( found ) {
+      free_mem( node->name );
+      free_mem( node );
+      *length = name_length;
+      return found->name;
+    }
+
+    head = new_head;
+    node->next = head;
+  }
+
+  *length = name_length;
+  return node->name;
+}
+
+void
+name_interning_free_all( void ) {
+  size_t i;
+  struct interned_name *current;
+  struct interned_name *next;
+
+  for( i = 0; i < NAME_BUCKET_COUNT; i++ ) {
+    current = config_read_ptr( &name_buckets[i] );
+    config_write_ptr( &name_buckets[i], NULL );
+
+    while( current ) {
+      next = current->next;
+      free_mem( current->name );
+      free_mem( current );
+      current = next;
+    }
+  }
+}
@@ -30,20 +30,25 @@ no_vsnprintf_s_format_string( const char *format,
   size_t buffer_size = 128;
   int result;
   char *new_buffer;
+  va_list subs_copy;
 
   buffer = alloc_mem( buffer_size );
   if( !buffer ) {
     goto fail;
   }
 
-  result = vsnprintf( buffer, buffer_size, format, subs );
+  // the arguments are needed again if the buffer is too small
+  va_copy( subs_copy, subs );
+  result = vsnprintf( buffer, buffer_size, format, subs_copy );
+  va_end( subs_copy );
   if( result < 0 ) {
     goto fail_buffer;
   }
 
-  if( result > buffer_size ) {
+  if( ( size_t ) result >= buffer_size ) {
+    buffer_size = ( size_t ) result + 1;
 
-    new_buffer = realloc_mem( buffer, result );
+    new_buffer = realloc_mem( buffer, buffer_size );
     if( !new_buffer ) {
       goto fail_buffer;
     }
@@ -64,3 +69,11 @@ fail_buffer:
 fail:
   return NULL;
 }
+
+int
+no_vsnprintf_s_format_string_into( char *buffer,
+                                   size_t size,
+                                   const char *format,
+                                   va_list subs ) {
+  return vsnprintf( buffer, size, format, subs );
+}
@@ -0,0 +1,325 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "private/config/locale/wrapper.h"
+#include "private/config/segment_supported.h"
+#include "private/config/wrapper/thread_safety.h"
+#include "private/error.h"
+#include "private/memory.h"
+
+#define SEGMENT_OFFSET_MASK ( ( 1ULL << SEGMENT_OFFSET_BITS ) - 1 )
+
+/*
+ * Syncs and unmaps the segment in the given slot, trimming its file down to the
+ * bytes that were written to it before closing it.
+ */
+static
+int
+close_segment( struct segment_writer *writer, size_t slot, size_t used ) {
+  int result = 0;
+
+  if( msync( writer->maps[slot], writer->segment_size, MS_SYNC ) != 0 ) {
+    result = -1;
+  }
+
+  munmap( writer->maps[slot], writer->segment_size );
+
+  if( ftruncate( writer->fds[slot], ( off_t ) used ) != 0 ) {
+    result = -1;
+  }
+
+  close( writer->fds[slot] );
+
+  if( result != 0 ) {
+    raise_file_write_failure(  );
+  }
+
+  return result;
+}
+
+/*
+ * Creates the next segment file, preallocating its full size so that copying
+ * into the mapping can never fail for a lack of disk space, and maps it into
+ * the given slot.
+ */
+static
+int
+open_segment( struct segment_writer *writer, size_t slot ) {
+  int fd;
+  int error;
+  char *map;
+
+  do {
+    writer->number++;
+    snprintf( writer->path + writer->name_length,
+              writer->path_size - writer->name_length,
+              ".%lu",
+              writer->number );
+    fd = open( writer->path, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0666 );
+  } while( fd == -1 && errno == EEXIST );
+
+  if( fd == -1 ) {
+    raise_file_open_failure(  );
+    goto fail;
+  }
+
+  error = posix_fallocate( fd, 0, ( off_t ) writer->segment_size );
+  if( error != 0 ) {
+    raise_segment_failure( error );
+    goto fail_map;
+  }
+
+  map = mmap( NULL,
+              writer->segment_size,
+              PROT_READ | PROT_WRITE,
+              MAP_SHARED,
+              fd,
+              0 );
+  if( map == MAP_FAILED ) {
+    raise_segment_failure( errno );
+    goto fail_map;
+  }
+
+  writer->maps[slot] = map;
+  writer->fds[slot] = fd;
+  return 0;
+
+fail_map:
+  close( fd );
+  unlink( writer->path );
+fail:
+  return -1;
+}
+
+/*
+ * Replaces the full segment of the given generation with a new one. This is
+ * done by the thread whose reservation crossed the end of the segment, which
+ * knows how much of it was used.
+ *
+ * If the new segment cannot be created the writer is marked as failed. A
+ * failure to sync or trim the old segment is raised, but the new segment is
+ * still used.
+ */
+static
+int
+roll_segment( struct segment_writer *writer,
+              unsigned long long generation,
+              size_t used ) {
+  size_t old_slot;
+  size_t new_slot;
+  int result;
+
+  old_slot = generation & 1;
+  new_slot = old_slot ^ 1;
+
+  config_lock_mutex( &writer->roll_mutex );
+
+  if( open_segment( writer, new_slot ) != 0 ) {
+    atomic_store( &writer->failed, true );
+    config_unlock_mutex( &writer->roll_mutex );
+    return -1;
+  }
+
+  atomic_store_explicit( &writer->committed[new_slot],
+                         0,
+                         memory_order_relaxed );
+  atomic_store_explicit( &writer->state,
+                         ( generation + 1 ) << SEGMENT_OFFSET_BITS,
+                         memory_order_release );
+
+  // threads still copying into the old segment must finish before it is
+  // unmapped, but other threads may already use the new one
+  while( atomic_load_explicit( &writer->committed[old_slot],
+                               memory_order_acquire ) != used ) {
+    sched_yield(  );
+  }
+
+  result = close_segment( writer, old_slot, used );
+
+  config_unlock_mutex( &writer->roll_mutex );
+
+  return result;
+}
+
+/*
+ * Waits until the segment of the given generation has been replaced.
+ */
+static
+int
+wait_for_roll( struct segment_writer *writer,
+               unsigned long long generation ) {
+  unsigned long long state;
+
+  for( ;; ) {
+    state = atomic_load_explicit( &writer->state, memory_order_acquire );
+    if( state >> SEGMENT_OFFSET_BITS != generation ) {
+      return 0;
+    }
+
+    if( atomic_load( &writer->failed ) ) {
+      raise_file_write_failure(  );
+      return -1;
+    }
+
+    sched_yield(  );
+  }
+}
+
+/* private definitions */
+
+void
+destroy_segment_writer( struct segment_writer *writer ) {
+  size_t slot;
+
+  slot = ( atomic_load( &writer->state ) >> SEGMENT_OFFSET_BITS ) & 1;
+  close_segment( writer, slot, atomic_load( &writer->committed[slot] ) );
+
+  config_destroy_mutex( &writer->roll_mutex );
+  free_sized_mem( writer->path, writer->path_size );
+  free_sized_mem( writer, sizeof( *writer ) );
+}
+
+int
+flush_segment_writer( struct segment_writer *writer ) {
+  size_t slot;
+  int result = 0;
+
+  config_lock_mutex( &writer->roll_mutex );
+
+  slot = ( atomic_load( &writer->state ) >> SEGMENT_OFFSET_BITS ) & 1;
+  if( msync( writer->maps[slot], writer->segment_size, MS_SYNC ) != 0 ) {
+    raise_file_write_failure(  );
+    result = -1;
+  }
+
+  config_unlock_mutex( &writer->roll_mutex );
+
+  return result;
+}
+
+struct segment_writer *
+new_segment_writer( const char *name, size_t segment_size ) {
+  struct segment_writer *writer;
+
+  if( segment_size > SEGMENT_MAX_SIZE ) {
+    raise_segment_failure( EFBIG );
+    goto fail;
+  }
+
+  writer = alloc_mem( sizeof( *writer ) );
+  if( !writer ) {
+    goto fail;
+  }
+
+  // room for a period, the digits of the largest number, and a terminator
+  writer->name_length = strlen( name );
+  writer->path_size = writer->name_length + 22;
+  writer->path = alloc_mem( writer->path_size );
+  if( !writer->path ) {
+    goto fail_path;
+  }
+  memcpy( writer->path, name, writer->name_length );
+
+  writer->number = 0;
+  writer->segment_size = segment_size;
+  atomic_init( &writer->state, 0 );
+  atomic_init( &writer->committed[0], 0 );
+  atomic_init( &writer->committed[1], 0 );
+  atomic_init( &writer->failed, false );
+
+  if( open_segment( writer, 0 ) != 0 ) {
+    goto fail_segment;
+  }
+
+  config_init_mutex( &writer->roll_mutex );
+
+  return writer;
+
+fail_segment:
+  free_sized_mem( writer->path, writer->path_size );
+fail_path:
+  free_sized_mem( writer, sizeof( *writer ) );
+fail:
+  return NULL;
+}
+
+int
+send_to_segment_writer( struct segment_writer *writer,
+                        const char *msg,
+                        size_t msg_length ) {
+  unsigned long long state;
+  unsigned long long generation;
+  unsigned long long offset;
+  size_t slot;
+  int result = 0;
+
+  if( msg_length > writer->segment_size ) {
+    raise_argument_too_big( L10N_MESSAGE_TOO_BIG_FOR_SEGMENT_ERROR_MESSAGE,
+                            msg_length,
+                            L10N_MESSAGE_SIZE_ERROR_CODE_TYPE );
+    return -1;
+  }
+
+  for( ;; ) {
+    // checked first so that failed reservations can never overflow the offset
+    if( atomic_load_explicit( &writer->failed, memory_order_relaxed ) ) {
+      raise_file_write_failure(  );
+      return -1;
+    }
+
+    state = atomic_fetch_add_explicit( &writer->state,
+                                       msg_length,
+                                       memory_order_acquire );
+    generation = state >> SEGMENT_OFFSET_BITS;
+    offset = state & SEGMENT_OFFSET_MASK;
+    slot = generation & 1;
+
+    if( offset + msg_length <= writer->segment_size ) {
+      memcpy( writer->maps[slot] + offset, msg, msg_length );
+      atomic_fetch_add_explicit( &writer->committed[slot],
+                                 msg_length,
+                                 memory_order_release );
+      return result;
+    }
+
+    if( offset <= writer->segment_size ) {
+      // this reservation crossed the end, so everything before it is in use
+      if( roll_segment( writer, generation, offset ) != 0 ) {
+        if( atomic_load( &writer->failed ) ) {
+          return -1;
+        }
+
+        result = -1;
+      }
+
+    } else if( wait_for_roll( writer, generation ) != 0 ) {
+      return -1;
+    }
+  }
+}
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stddef.h>
+#include "private/config/locale/wrapper.h"
+#include "private/config/segment_unsupported.h"
+#include "private/error.h"
+
+struct segment_writer *
+no_segment_new_writer( const char *name, size_t segment_size ) {
+  ( void ) name;
+  ( void ) segment_size;
+
+  raise_target_unsupported( L10N_SEGMENT_FILES_UNSUPPORTED_ERROR_MESSAGE );
+  return NULL;
+}
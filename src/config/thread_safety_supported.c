@@ -17,11 +17,26 @@
  */
 
 #include <stddef.h>
+#include <stumpless/arena.h>
+#include <stumpless/memory.h>
+#include "private/arena.h"
 #include "private/cache.h"
 #include "private/config/thread_safety_supported.h"
 #include "private/config/wrapper/thread_safety.h"
 
 static struct cache *mutex_cache = NULL;
+static struct cache *rwlock_cache = NULL;
+
+void
+thread_safety_destroy_arena_rwlock( const config_rwlock_t *rwlock,
+                                    const struct stumpless_arena *arena ) {
+  if( !arena ) {
+    thread_safety_destroy_rwlock( rwlock );
+    return;
+  }
+
+  config_destroy_rwlock( rwlock );
+}
 
 void
 thread_safety_destroy_mutex( const config_mutex_t *mutex ) {
@@ -29,10 +44,41 @@ thread_safety_destroy_mutex( const config_mutex_t *mutex ) {
   cache_free( mutex_cache, mutex );
 }
 
+void
+thread_safety_destroy_rwlock( const config_rwlock_t *rwlock ) {
+  config_destroy_rwlock( rwlock );
+  cache_free( rwlock_cache, rwlock );
+}
+
 void
 thread_safety_free_all( void ) {
   cache_destroy( mutex_cache );
   mutex_cache = NULL;
+  cache_destroy( rwlock_cache );
+  rwlock_cache = NULL;
+}
+
+void
+thread_safety_get_lock_cache_usage( struct stumpless_memory_usage *usage ) {
+  cache_get_usage( mutex_cache, usage );
+  cache_get_usage( rwlock_cache, usage );
+}
+
+config_rwlock_t *
+thread_safety_new_arena_rwlock( struct stumpless_arena *arena ) {
+  config_rwlock_t *rwlock;
+
+  if( !arena ) {
+    return thread_safety_new_rwlock(  );
+  }
+
+  rwlock = arena_alloc_mem( arena, CONFIG_RWLOCK_T_SIZE );
+  if( !rwlock ) {
+    return NULL;
+  }
+
+  config_init_rwlock( rwlock );
+  return rwlock;
 }
 
 config_mutex_t *
@@ -54,3 +100,23 @@ thread_safety_new_mutex( void ) {
   config_init_mutex( mutex );
   return mutex;
 }
+
+config_rwlock_t *
+thread_safety_new_rwlock( void ) {
+  config_rwlock_t *rwlock;
+
+  if( !rwlock_cache ) {
+    rwlock_cache = cache_new( CONFIG_RWLOCK_T_SIZE, NULL, NULL );
+    if( !rwlock_cache ) {
+      return NULL;
+    }
+  }
+
+  rwlock = cache_alloc( rwlock_cache );
+  if( !rwlock ) {
+    return NULL;
+  }
+
+  config_init_rwlock( rwlock );
+  return rwlock;
+}
@@ -0,0 +1,754 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stumpless/target.h>
+#include "private/config/wrapper.h"
+#include "private/deferred.h"
+#include "private/memory.h"
+
+/* the types that an argument may be read from a va_list as */
+enum deferred_arg_type {
+  DEFERRED_ARG_NONE,
+  DEFERRED_ARG_INT,
+  DEFERRED_ARG_LONG,
+  DEFERRED_ARG_LONG_LONG,
+  DEFERRED_ARG_INTMAX,
+  DEFERRED_ARG_SIZE,
+  DEFERRED_ARG_PTRDIFF,
+  DEFERRED_ARG_DOUBLE,
+  DEFERRED_ARG_LONG_DOUBLE,
+  DEFERRED_ARG_POINTER,
+  DEFERRED_ARG_STRING
+};
+
+/* a single conversion specification in a format string */
+struct deferred_spec {
+  size_t length;
+  int star_count;
+  bool has_precision;
+  bool precision_is_star;
+  int precision;
+  enum deferred_arg_type type;
+};
+
+/* a single argument, read from either a va_list or a deferred log */
+union deferred_value {
+  int i;
+  long l;
+  long long ll;
+  intmax_t j;
+  size_t z;
+  ptrdiff_t t;
+  double d;
+  long double ld;
+  void *p;
+  const char *s;
+};
+
+static const char null_string[] = "(null)";
+
+/*
+ * Parses the conversion specification starting at the percent sign at spec,
+ * returning false if it is not one that can be deferred.
+ */
+static bool
+parse_spec( const char *spec, struct deferred_spec *result ) {
+  const char *current = spec + 1;
+  int length_modifier = 0;
+  char conversion;
+
+  result->star_count = 0;
+  result->has_precision = false;
+  result->precision_is_star = false;
+  result->precision = 0;
+
+  if( *current == '%' ) {
+    result->length = 2;
+    result->type = DEFERRED_ARG_NONE;
+    return true;
+  }
+
+  while( strchr( "-+ #0", *current ) && *current != '\0' ) {
+    current++;
+  }
+
+  if( *current == '*' ) {
+    result->star_count++;
+    current++;
+  } else {
+    while( *current >= '0' && *current <= '9' ) {
+      current++;
+    }
+
+    // positional arguments cannot be read in a single pass
+    if( *current == '$' ) {
+      return false;
+    }
+  }
+
+  if( *current == '.' ) {
+    current++;
+    result->has_precision = true;
+
+    if( *current == '*' ) {
+      result->star_count++;
+      result->precision_is_star = true;
+      current++;
+    } else {
+      while( *current >= '0' && *current <= '9' ) {
+        result->precision = ( result->precision * 10 ) + ( *current - '0' );
+        current++;
+      }
+    }
+  }
+
+  switch( *current ) {
+    case 'h':
+      current++;
+      length_modifier = 'h';
+      if( *current == 'h' ) {
+        current++;
+        length_modifier = 'H';
+      }
+      break;
+
+    case 'l':
+      current++;
+      length_modifier = 'l';
+      if( *current == 'l' ) {
+        current++;
+        length_modifier = 'q';
+      }
+      break;
+
+    case 'j':
+    case 'z':
+    case 't':
+    case 'L':
+      length_modifier = *current;
+      current++;
+      break;
+
+    default:
+      break;
+  }
+
+  conversion = *current;
+  result->length = ( size_t ) ( current - spec ) + 1;
+  if( result->length > DEFERRED_MAX_SPEC_LENGTH ) {
+    return false;
+  }
+
+  switch( conversion ) {
+    case 'd':
+    case 'i':
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+      switch( length_modifier ) {
+        case 0:
+        case 'h':
+        case 'H':
+          result->type = DEFERRED_ARG_INT;
+          return true;
+        case 'l':
+          result->type = DEFERRED_ARG_LONG;
+          return true;
+        case 'q':
+          result->type = DEFERRED_ARG_LONG_LONG;
+          return true;
+        case 'j':
+          result->type = DEFERRED_ARG_INTMAX;
+          return true;
+        case 'z':
+          result->type = DEFERRED_ARG_SIZE;
+          return true;
+        case 't':
+          result->type = DEFERRED_ARG_PTRDIFF;
+          return true;
+        default:
+          return false;
+      }
+
+    case 'c':
+      result->type = DEFERRED_ARG_INT;
+      return length_modifier == 0;
+
+    case 'a':
+    case 'A':
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+      if( length_modifier == 'L' ) {
+        result->type = DEFERRED_ARG_LONG_DOUBLE;
+        return true;
+      }
+      result->type = DEFERRED_ARG_DOUBLE;
+      return length_modifier == 0 || length_modifier == 'l';
+
+    case 'p':
+      result->type = DEFERRED_ARG_POINTER;
+      return length_modifier == 0;
+
+    case 's':
+      result->type = DEFERRED_ARG_STRING;
+      return length_modifier == 0;
+
+    default:
+      return false;
+  }
+}
+
+static size_t
+get_value_size( enum deferred_arg_type type ) {
+  switch( type ) {
+    case DEFERRED_ARG_INT:
+      return sizeof( int );
+    case DEFERRED_ARG_LONG:
+      return sizeof( long );
+    case DEFERRED_ARG_LONG_LONG:
+      return sizeof( long long );
+    case DEFERRED_ARG_INTMAX:
+      return sizeof( intmax_t );
+    case DEFERRED_ARG_SIZE:
+      return sizeof( size_t );
+    case DEFERRED_ARG_PTRDIFF:
+      return sizeof( ptrdiff_t );
+    case DEFERRED_ARG_DOUBLE:
+      return sizeof( double );
+    case DEFERRED_ARG_LONG_DOUBLE:
+      return sizeof( long double );
+    case DEFERRED_ARG_POINTER:
+      return sizeof( void * );
+    default:
+      return 0;
+  }
+}
+
+static void
+read_value( va_list *args,
+            enum deferred_arg_type type,
+            union deferred_value *value ) {
+  switch( type ) {
+    case DEFERRED_ARG_INT:
+      value->i = va_arg( *args, int );
+      break;
+    case DEFERRED_ARG_LONG:
+      value->l = va_arg( *args, long );
+      break;
+    case DEFERRED_ARG_LONG_LONG:
+      value->ll = va_arg( *args, long long );
+      break;
+    case DEFERRED_ARG_INTMAX:
+      value->j = va_arg( *args, intmax_t );
+      break;
+    case DEFERRED_ARG_SIZE:
+      value->z = va_arg( *args, size_t );
+      break;
+    case DEFERRED_ARG_PTRDIFF:
+      value->t = va_arg( *args, ptrdiff_t );
+      break;
+    case DEFERRED_ARG_DOUBLE:
+      value->d = va_arg( *args, double );
+      break;
+    case DEFERRED_ARG_LONG_DOUBLE:
+      value->ld = va_arg( *args, long double );
+      break;
+    case DEFERRED_ARG_POINTER:
+      value->p = va_arg( *args, void * );
+      break;
+    case DEFERRED_ARG_STRING:
+      value->s = va_arg( *args, const char * );
+      break;
+    default:
+      break;
+  }
+}
+
+/*
+ * Walks the arguments of a format string, copying them into buffer if it is
+ * not NULL. Returns false if the format string cannot be deferred, in which
+ * case some of the arguments may have been read already. Otherwise size is set
+ * to the number of bytes needed to hold the arguments.
+ */
+static bool
+copy_args( const char *format,
+           va_list *args,
+           char *buffer,
+           size_t *size ) {
+  const char *current;
+  struct deferred_spec spec;
+  union deferred_value value;
+  int stars[2];
+  int precision;
+  size_t string_length;
+  size_t value_size;
+  size_t written = 0;
+  int i;
+
+  for( current = strchr( format, '%' );
+       current;
+       current = strchr( current, '%' ) ) {
+    if( !parse_spec( current, &spec ) ) {
+      return false;
+    }
+    current += spec.length;
+
+    for( i = 0; i < spec.star_count; i++ ) {
+      stars[i] = va_arg( *args, int );
+      if( buffer ) {
+        memcpy( buffer + written, &stars[i], sizeof( int ) );
+      }
+      written += sizeof( int );
+    }
+
+    if( spec.type == DEFERRED_ARG_NONE ) {
+      continue;
+    }
+
+    read_value( args, spec.type, &value );
+
+    if( spec.type != DEFERRED_ARG_STRING ) {
+      value_size = get_value_size( spec.type );
+      if( buffer ) {
+        memcpy( buffer + written, &value, value_size );
+      }
+      written += value_size;
+      continue;
+    }
+
+    if( !value.s ) {
+      string_length = SIZE_MAX;
+      if( buffer ) {
+        memcpy( buffer + written, &string_length, sizeof( string_length ) );
+      }
+      written += sizeof( string_length );
+      continue;
+    }
+
+    // strings with a precision do not need to be NULL terminated
+    precision = spec.precision_is_star ? stars[spec.star_count - 1] :
+                                         spec.precision;
+    if( spec.has_precision && precision >= 0 ) {
+      string_length = strnlen( value.s, ( size_t ) precision );
+    } else {
+      string_length = strlen( value.s );
+    }
+
+    if( buffer ) {
+      memcpy( buffer + written, &string_length, sizeof( string_length ) );
+      memcpy( buffer + written + sizeof( string_length ),
+              value.s,
+              string_length );
+      buffer[written + sizeof( string_length ) + string_length] = '\0';
+    }
+    written += sizeof( string_length ) + string_length + 1;
+  }
+
+  *size = written;
+  return true;
+}
+
+/*
+ * Formats a single value with the given specification. Any width and
+ * precision given with stars are passed before the value as printf expects.
+ */
+static int
+format_value( char *buffer,
+              size_t size,
+              const char *spec,
+              int star_count,
+              const int *stars,
+              enum deferred_arg_type type,
+              const union deferred_value *value ) {
+#define FORMAT_VALUE( VALUE )                                            \
+  ( star_count == 0 ? snprintf( buffer, size, spec, ( VALUE ) ) :        \
+    star_count == 1 ? snprintf( buffer, size, spec, stars[0],            \
+                                ( VALUE ) ) :                            \
+                      snprintf( buffer, size, spec, stars[0], stars[1],  \
+                                ( VALUE ) ) )
+
+  switch( type ) {
+    case DEFERRED_ARG_INT:
+      return FORMAT_VALUE( value->i );
+    case DEFERRED_ARG_LONG:
+      return FORMAT_VALUE( value->l );
+    case DEFERRED_ARG_LONG_LONG:
+      return FORMAT_VALUE( value->ll );
+    case DEFERRED_ARG_INTMAX:
+      return FORMAT_VALUE( value->j );
+    case DEFERRED_ARG_SIZE:
+      return FORMAT_VALUE( value->z );
+    case DEFERRED_ARG_PTRDIFF:
+      return FORMAT_VALUE( value->t );
+    case DEFERRED_ARG_DOUBLE:
+      return FORMAT_VALUE( value->d );
+    case DEFERRED_ARG_LONG_DOUBLE:
+      return FORMAT_VALUE( value->ld );
+    case DEFERRED_ARG_POINTER:
+      return FORMAT_VALUE( value->p );
+    case DEFERRED_ARG_STRING:
+      return FORMAT_VALUE( value->s );
+    default:
+      return snprintf( buffer, size, "%%" );
+  }
+
+#undef FORMAT_VALUE
+}
+
+/*
+ * Makes sure that the buffer has room for needed more bytes after length,
+ * returning false if it could not be resized.
+ */
+static bool
+reserve( char **buffer, size_t *size, size_t length, size_t needed ) {
+  size_t new_size;
+  char *new_buffer;
+
+  if( length + needed <= *size ) {
+    return true;
+  }
+
+  new_size = *size == 0 ? 128 : *size;
+  while( new_size < length + needed ) {
+    new_size *= 2;
+  }
+
+  new_buffer = realloc_mem( *buffer, new_size );
+  if( !new_buffer ) {
+    return false;
+  }
+
+  *buffer = new_buffer;
+  *size = new_size;
+  return true;
+}
+
+/*
+ * Takes a free record from the pool, returning NULL if there are none left.
+ */
+static struct deferred_log *
+take_record( struct deferred_pool *pool ) {
+  struct deferred_pool_slot *slot;
+  size_t current;
+  intptr_t difference;
+  size_t index;
+
+  current = atomic_load_explicit( &pool->take_position, memory_order_relaxed );
+  for( ;; ) {
+    slot = &pool->slots[current & ( pool->capacity - 1 )];
+    difference = ( intptr_t ) ( atomic_load_explicit( &slot->sequence,
+                                                      memory_order_acquire ) -
+                                ( current + 1 ) );
+
+    if( difference == 0 ) {
+      if( atomic_compare_exchange_weak_explicit( &pool->take_position,
+                                                 &current,
+                                                 current + 1,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed ) ) {
+        break;
+      }
+
+    } else if( difference < 0 ) {
+      return NULL;
+
+    } else {
+      current = atomic_load_explicit( &pool->take_position,
+                                      memory_order_relaxed );
+    }
+  }
+
+  index = slot->index;
+  atomic_store_explicit( &slot->sequence,
+                         current + pool->capacity,
+                         memory_order_release );
+
+  return ( struct deferred_log * ) ( pool->records +
+                                     ( index * pool->record_size ) );
+}
+
+/*
+ * Returns a record to the pool. There is always room for it, as the ring has a
+ * slot for every record.
+ */
+static void
+return_record( struct deferred_pool *pool,
+               const struct deferred_log *deferred ) {
+  struct deferred_pool_slot *slot;
+  size_t current;
+
+  current = atomic_load_explicit( &pool->return_position,
+                                  memory_order_relaxed );
+  for( ;; ) {
+    slot = &pool->slots[current & ( pool->capacity - 1 )];
+    if( atomic_load_explicit( &slot->sequence, memory_order_acquire ) ==
+          current ) {
+      if( atomic_compare_exchange_weak_explicit( &pool->return_position,
+                                                 &current,
+                                                 current + 1,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed ) ) {
+        break;
+      }
+
+    } else {
+      current = atomic_load_explicit( &pool->return_position,
+                                      memory_order_relaxed );
+    }
+  }
+
+  slot->index = ( size_t ) ( ( const char * ) deferred - pool->records ) /
+                pool->record_size;
+  atomic_store_explicit( &slot->sequence, current + 1, memory_order_release );
+}
+
+void
+destroy_deferred_log( const struct deferred_log *deferred ) {
+  if( deferred->pool ) {
+    return_record( deferred->pool, deferred );
+    return;
+  }
+
+  free_sized_mem( deferred, sizeof( *deferred ) + deferred->args_size );
+}
+
+void
+destroy_deferred_pool( struct deferred_pool *pool ) {
+  if( !pool ) {
+    return;
+  }
+
+  free_sized_mem( pool->records, pool->record_size * pool->capacity );
+  free_sized_mem( pool->slots, sizeof( *pool->slots ) * pool->capacity );
+  free_sized_mem( pool, sizeof( *pool ) );
+}
+
+int
+format_deferred_log( const struct deferred_log *deferred,
+                     char **buffer,
+                     size_t *size ) {
+  const char *current = deferred->format;
+  const char *next;
+  const char *args = deferred->args;
+  struct deferred_spec spec;
+  char spec_buffer[DEFERRED_MAX_SPEC_LENGTH + 1];
+  union deferred_value value;
+  int stars[2];
+  size_t string_length;
+  size_t value_size;
+  size_t length = 0;
+  size_t literal_length;
+  int result;
+  int i;
+
+  for( ;; ) {
+    next = strchr( current, '%' );
+    literal_length = next ? ( size_t ) ( next - current ) : strlen( current );
+
+    if( !reserve( buffer, size, length, literal_length + 1 ) ) {
+      return -1;
+    }
+    memcpy( *buffer + length, current, literal_length );
+    length += literal_length;
+    ( *buffer )[length] = '\0';
+
+    if( !next ) {
+      break;
+    }
+
+    parse_spec( next, &spec );
+    memcpy( spec_buffer, next, spec.length );
+    spec_buffer[spec.length] = '\0';
+    current = next + spec.length;
+
+    for( i = 0; i < spec.star_count; i++ ) {
+      memcpy( &stars[i], args, sizeof( int ) );
+      args += sizeof( int );
+    }
+
+    if( spec.type == DEFERRED_ARG_STRING ) {
+      memcpy( &string_length, args, sizeof( string_length ) );
+      args += sizeof( string_length );
+      if( string_length == SIZE_MAX ) {
+        value.s = null_string;
+      } else {
+        value.s = args;
+        args += string_length + 1;
+      }
+
+    } else {
+      value_size = get_value_size( spec.type );
+      memcpy( &value, args, value_size );
+      args += value_size;
+    }
+
+    result = format_value( *buffer + length,
+                           *size - length,
+                           spec_buffer,
+                           spec.star_count,
+                           stars,
+                           spec.type,
+                           &value );
+    if( result < 0 ) {
+      return -1;
+    }
+
+    if( ( size_t ) result >= *size - length ) {
+      if( !reserve( buffer, size, length, ( size_t ) result + 1 ) ) {
+        return -1;
+      }
+
+      format_value( *buffer + length,
+                    *size - length,
+                    spec_buffer,
+                    spec.star_count,
+                    stars,
+                    spec.type,
+                    &value );
+    }
+
+    length += ( size_t ) result;
+  }
+
+  return ( int ) length;
+}
+
+struct deferred_log *
+new_deferred_log( struct deferred_pool *pool,
+                  const struct stumpless_target *target,
+                  int prival,
+                  const char *format,
+                  va_list args,
+                  bool *supported ) {
+  struct deferred_log *deferred;
+  va_list args_copy;
+  size_t args_size;
+
+  // the arguments are only read from copies so that the caller can still use
+  // them if the format is not supported
+  va_copy( args_copy, args );
+  *supported = copy_args( format, &args_copy, NULL, &args_size );
+  va_end( args_copy );
+
+  if( !*supported ) {
+    return NULL;
+  }
+
+  deferred = NULL;
+  if( pool && args_size <= DEFERRED_POOL_ARGS_SIZE ) {
+    deferred = take_record( pool );
+  }
+
+  if( deferred ) {
+    deferred->pool = pool;
+
+  } else {
+    deferred = alloc_mem( sizeof( *deferred ) + args_size );
+    if( !deferred ) {
+      return NULL;
+    }
+
+    deferred->pool = NULL;
+  }
+
+  // do this as soon as possible to be closer to invocation
+  if( !config_get_time( &deferred->timestamp ) ) {
+    deferred->timestamp.tv_sec = 0;
+    deferred->timestamp.tv_nsec = 0;
+  }
+
+  va_copy( args_copy, args );
+  copy_args( format, &args_copy, deferred->args, &args_size );
+  va_end( args_copy );
+
+  deferred->format = format;
+  deferred->prival = prival;
+  memcpy( deferred->app_name,
+          target->default_app_name,
+          target->default_app_name_length );
+  deferred->app_name[target->default_app_name_length] = '\0';
+  deferred->app_name_length = target->default_app_name_length;
+  memcpy( deferred->msgid,
+          target->default_msgid,
+          target->default_msgid_length );
+  deferred->msgid[target->default_msgid_length] = '\0';
+  deferred->msgid_length = target->default_msgid_length;
+  deferred->args_size = args_size;
+
+  return deferred;
+}
+
+struct deferred_pool *
+new_deferred_pool( size_t capacity ) {
+  struct deferred_pool *pool;
+  size_t record_size;
+  size_t alignment;
+  size_t i;
+
+  pool = alloc_mem( sizeof( *pool ) );
+  if( !pool ) {
+    goto fail;
+  }
+
+  pool->slots = alloc_mem( sizeof( *pool->slots ) * capacity );
+  if( !pool->slots ) {
+    goto fail_slots;
+  }
+
+  // each record must be aligned for the log at the start of the next one
+  alignment = _Alignof( struct deferred_log );
+  record_size = sizeof( struct deferred_log ) + DEFERRED_POOL_ARGS_SIZE;
+  record_size = ( ( record_size + alignment - 1 ) / alignment ) * alignment;
+
+  pool->records = alloc_mem( record_size * capacity );
+  if( !pool->records ) {
+    goto fail_records;
+  }
+
+  // every record starts out free
+  for( i = 0; i < capacity; i++ ) {
+    atomic_init( &pool->slots[i].sequence, i + 1 );
+    pool->slots[i].index = i;
+  }
+
+  pool->capacity = capacity;
+  pool->record_size = record_size;
+  atomic_init( &pool->take_position, 0 );
+  atomic_init( &pool->return_position, capacity );
+
+  return pool;
+
+fail_records:
+  free_sized_mem( pool->slots, sizeof( *pool->slots ) * capacity );
+fail_slots:
+  free_sized_mem( pool, sizeof( *pool ) );
+fail:
+  return NULL;
+}
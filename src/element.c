@@ -18,11 +18,15 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
+#include <stumpless/arena.h>
 #include <stumpless/element.h>
 #include <stumpless/param.h>
+#include "private/arena.h"
 #include "private/config/locale/wrapper.h"
 #include "private/config/wrapper/journald.h"
+#include "private/config/wrapper/name_interning.h"
 #include "private/config/wrapper/thread_safety.h"
 #include "private/deprecate.h"
 #include "private/element.h"
@@ -35,18 +39,20 @@ struct stumpless_element *
 stumpless_add_new_param( struct stumpless_element *element,
                          const char *param_name,
                          const char *param_value ) {
-  struct stumpless_param *new_param;
+  struct stumpless_param *param;
   struct stumpless_element *result;
 
-  new_param = stumpless_new_param( param_name, param_value );
-  if( !new_param ) {
+  VALIDATE_ARG_NOT_NULL( element );
+
+  param = new_param( element->arena, param_name, param_value );
+  if( !param ) {
     return NULL;
   }
 
-  result = stumpless_add_param( element, new_param );
+  result = stumpless_add_param( element, param );
 
   if( !result ) {
-    stumpless_destroy_param( new_param );
+    stumpless_destroy_param( param );
   }
 
   return result;
@@ -55,28 +61,29 @@ stumpless_add_new_param( struct stumpless_element *element,
 struct stumpless_element *
 stumpless_add_param( struct stumpless_element *element,
                      struct stumpless_param *param ) {
-  struct stumpless_param **new_params;
-  size_t old_params_size;
-  size_t new_params_size;
+  size_t new_capacity;
 
   VALIDATE_ARG_NOT_NULL( element );
   VALIDATE_ARG_NOT_NULL( param );
 
-  lock_element( element );
-
-  old_params_size = sizeof( param ) * element->param_count;
-  new_params_size = old_params_size + sizeof( param );
-
-  new_params = realloc_mem( element->params, new_params_size );
-  if( !new_params ) {
-    unlock_element( element );
+  if( !lock_mutable_element( element ) ) {
     return NULL;
   }
 
-  new_params[element->param_count] = param;
+  if( element->param_count == element->param_capacity ) {
+    new_capacity = get_grown_capacity( element->param_capacity,
+                                       element->param_count + 1,
+                                       SIZE_MAX / sizeof( *element->params ) );
+    if( !locked_reserve_params( element, new_capacity ) ) {
+      unlock_mutable_element( element );
+      return NULL;
+    }
+  }
+
+  element->params[element->param_count] = param;
   element->param_count++;
-  element->params = new_params;
-  unlock_element( element );
+  retain_param( param );
+  unlock_mutable_element( element );
 
   clear_error(  );
   return element;
@@ -87,8 +94,9 @@ stumpless_copy_element( const struct stumpless_element *element ) {
   struct stumpless_element *copy;
   size_t i;
   struct stumpless_param *param_copy;
+  bool locked;
 
-  lock_element( element );
+  locked = lock_element( element );
   copy = stumpless_new_element( element->name );
   if( !copy ) {
     goto fail;
@@ -98,9 +106,10 @@ stumpless_copy_element( const struct stumpless_element *element ) {
   if( !copy->params ) {
     goto fail_param_copy;
   }
+  copy->param_capacity = element->param_count;
 
   for( i = 0; i < element->param_count; i++ ) {
-    param_copy = stumpless_copy_param( element->params[i] );
+    param_copy = share_param( element->params[i] );
     if( !param_copy ) {
       goto fail_param_copy;
     }
@@ -109,13 +118,13 @@ stumpless_copy_element( const struct stumpless_element *element ) {
     copy->param_count++;
   }
 
-  unlock_element( element );
+  unlock_element( element, locked );
   return copy;
 
 fail_param_copy:
   stumpless_destroy_element_and_contents( copy );
 fail:
-  unlock_element( element );
+  unlock_element( element, locked );
   return NULL;
 }
 
@@ -135,7 +144,7 @@ void
 stumpless_destroy_element_and_contents( const struct stumpless_element *e ) {
   size_t i;
 
-  if( !e ) {
+  if( !e || !release_element( e ) ) {
     return;
   }
 
@@ -148,7 +157,7 @@ stumpless_destroy_element_and_contents( const struct stumpless_element *e ) {
 
 void
 stumpless_destroy_element_only( const struct stumpless_element *element ) {
-  if( !element ) {
+  if( !element || !release_element( element ) ) {
     return;
   }
 
@@ -160,7 +169,9 @@ stumpless_element_has_param( const struct stumpless_element *element,
                              const char *name ) {
   size_t i;
   const struct stumpless_param *param;
-  int cmp_result;
+  const char *found_name;
+  bool name_matches;
+  bool locked;
 
   if( !element ) {
     raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "element" ) );
@@ -177,23 +188,43 @@ stumpless_element_has_param( const struct stumpless_element *element,
   }
 
   clear_error(  );
-  lock_element( element );
+  locked = lock_element( element );
   FOR_EACH_PARAM_WITH_NAME( element, name )
-    unlock_element( element );
+    unlock_element( element, locked );
     return true;
   }
 
-  unlock_element( element );
+  unlock_element( element, locked );
   return false;
 }
 
+struct stumpless_element *
+stumpless_freeze_element( struct stumpless_element *element ) {
+  size_t i;
+
+  VALIDATE_ARG_NOT_NULL( element );
+
+  if( lock_mutable_element( element ) ) {
+    for( i = 0; i < element->param_count; i++ ) {
+      stumpless_freeze_param( element->params[i] );
+    }
+
+    config_write_flag( &element->frozen, true );
+    unlock_mutable_element( element );
+  }
+
+  clear_error(  );
+  return element;
+}
+
 const char *
 stumpless_get_element_name( const struct stumpless_element *element ) {
   char *name_copy;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( element );
 
-  lock_element( element );
+  locked = lock_element( element );
   name_copy = alloc_mem( element->name_length + 1 );
   if( !name_copy ) {
     goto cleanup_and_return;
@@ -202,7 +233,7 @@ stumpless_get_element_name( const struct stumpless_element *element ) {
   clear_error(  );
 
 cleanup_and_return:
-  unlock_element( element );
+  unlock_element( element, locked );
   return name_copy;
 }
 
@@ -210,6 +241,7 @@ struct stumpless_param *
 stumpless_get_param_by_index( const struct stumpless_element *element,
                               size_t index ) {
   struct stumpless_param *result = NULL;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( element );
 
@@ -221,9 +253,9 @@ stumpless_get_param_by_index( const struct stumpless_element *element,
 
   clear_error(  );
 
-  lock_element( element );
+  locked = lock_element( element );
   result = locked_get_param_by_index( element, index );
-  unlock_element( element );
+  unlock_element( element, locked );
 
   return result;
 }
@@ -233,7 +265,9 @@ stumpless_get_param_by_name( const struct stumpless_element *element,
                              const char *name ) {
   size_t i;
   struct stumpless_param *param;
-  int cmp_result;
+  const char *found_name;
+  bool name_matches;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( element );
   VALIDATE_ARG_NOT_NULL( name );
@@ -242,7 +276,7 @@ stumpless_get_param_by_name( const struct stumpless_element *element,
     return NULL;
   }
 
-  lock_element( element );
+  locked = lock_element( element );
   FOR_EACH_PARAM_WITH_NAME( element, name )
     clear_error(  );
     goto cleanup_and_return;
@@ -252,22 +286,23 @@ stumpless_get_param_by_name( const struct stumpless_element *element,
   raise_param_not_found(  );
 
 cleanup_and_return:
-  unlock_element( element );
+  unlock_element( element, locked );
   return param;
 }
 
 size_t
 stumpless_get_param_count( const struct stumpless_element *element ) {
   size_t result;
+  bool locked;
 
   if( !element ) {
     raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "element" ) );
     return 0;
   }
 
-  lock_element( element );
+  locked = lock_element( element );
   result = element->param_count;
-  unlock_element( element );
+  unlock_element( element, locked );
 
   clear_error(  );
   return result;
@@ -278,7 +313,9 @@ stumpless_get_param_index( const struct stumpless_element *element,
                            const char *name ) {
   size_t i;
   const struct stumpless_param *param;
-  int cmp_result;
+  const char *found_name;
+  bool name_matches;
+  bool locked;
 
   if( !element ) {
     raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "element" ) );
@@ -294,7 +331,7 @@ stumpless_get_param_index( const struct stumpless_element *element,
     return 0;
   }
 
-  lock_element( element );
+  locked = lock_element( element );
   FOR_EACH_PARAM_WITH_NAME( element, name )
     clear_error(  );
     goto cleanup_and_return;
@@ -304,7 +341,7 @@ stumpless_get_param_index( const struct stumpless_element *element,
   raise_param_not_found(  );
 
 cleanup_and_return:
-  unlock_element( element );
+  unlock_element( element, locked );
   return i;
 }
 
@@ -327,7 +364,9 @@ stumpless_get_param_name_count( const struct stumpless_element *element,
   size_t i;
   size_t count = 0;
   const struct stumpless_param *param;
-  int cmp_result;
+  const char *found_name;
+  bool name_matches;
+  bool locked;
 
   if( !element ) {
     raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "element" ) );
@@ -343,11 +382,11 @@ stumpless_get_param_name_count( const struct stumpless_element *element,
     return 0;
   }
 
-  lock_element( element );
+  locked = lock_element( element );
   FOR_EACH_PARAM_WITH_NAME( element, name )
     count++;
   }
-  unlock_element( element );
+  unlock_element( element, locked );
 
   clear_error(  );
   return count;
@@ -384,47 +423,35 @@ stumpless_get_param_value_by_name( const struct stumpless_element *element,
 }
 
 struct stumpless_element *
-stumpless_new_element( const char *name ) {
-  struct stumpless_element *element;
+stumpless_new_arena_element( struct stumpless_arena *arena, const char *name ) {
+  VALIDATE_ARG_NOT_NULL( arena );
 
-  VALIDATE_ARG_NOT_NULL( name );
-
-  if ( !validate_element_name( name ) ||
-       !validate_element_name_length( name )) {
-    goto fail;
-  }
+  return new_element( arena, name );
+}
 
-  element = alloc_mem( sizeof( *element ) );
-  if( !element ) {
-    goto fail;
-  }
+struct stumpless_element *
+stumpless_new_element( const char *name ) {
+  return new_element( NULL, name );
+}
 
-  element->name = copy_cstring_with_length( name, &( element->name_length ) );
-  if( !element->name ) {
-    goto fail_name;
-  }
+struct stumpless_element *
+stumpless_reserve_params( struct stumpless_element *element, size_t count ) {
+  struct stumpless_element *result;
 
-  element->params = NULL;
-  element->param_count = 0;
+  VALIDATE_ARG_NOT_NULL( element );
 
-  config_assign_cached_mutex( element->mutex );
-  if( !config_check_mutex_valid( element->mutex ) ) {
-    goto fail_mutex;
+  if( !lock_mutable_element( element ) ) {
+    return NULL;
   }
 
-  config_init_journald_element( element );
-
-  clear_error(  );
-  return element;
+  result = locked_reserve_params( element, count );
+  unlock_mutable_element( element );
 
-fail_mutex:
-  free_mem( element->name );
-
-fail_name:
-  free_mem( element );
+  if( result ) {
+    clear_error(  );
+  }
 
-fail:
-  return NULL;
+  return result;
 }
 
 struct stumpless_element *
@@ -433,6 +460,7 @@ stumpless_set_element_name( struct stumpless_element *element,
   char *new_name;
   size_t new_size;
   const char *old_name;
+  size_t old_size;
 
   VALIDATE_ARG_NOT_NULL( element );
   VALIDATE_ARG_NOT_NULL( name );
@@ -442,19 +470,23 @@ stumpless_set_element_name( struct stumpless_element *element,
     goto fail;
   }
 
-  new_name = copy_cstring_with_length( name, &new_size );
+  new_name = config_copy_name( element->arena, name, &new_size );
   if( !new_name ) {
     goto fail;
   }
 
+  if( !lock_mutable_element( element ) ) {
+    config_destroy_name( element->arena, new_name, new_size );
+    goto fail;
+  }
 
-  lock_element( element );
   old_name = element->name;
+  old_size = element->name_length;
   element->name = new_name;
   element->name_length = new_size;
-  unlock_element( element );
+  unlock_mutable_element( element );
 
-  free_mem( old_name );
+  config_destroy_name( element->arena, old_name, old_size );
   clear_error(  );
   return element;
 
@@ -469,17 +501,20 @@ stumpless_set_param( struct stumpless_element *element,
   VALIDATE_ARG_NOT_NULL( element );
   VALIDATE_ARG_NOT_NULL( param );
 
-  lock_element( element );
+  if( !lock_mutable_element( element ) ) {
+    return NULL;
+  }
 
   if( index >= element->param_count ) {
-    unlock_element( element );
+    unlock_mutable_element( element );
     raise_index_out_of_bounds( L10N_INVALID_INDEX_ERROR_MESSAGE( "param" ),
                                index );
     return NULL;
   }
 
   element->params[index] = param;
-  unlock_element( element );
+  retain_param( param );
+  unlock_mutable_element( element );
 
   clear_error(  );
   return element;
@@ -497,8 +532,11 @@ stumpless_set_param_value_by_index( struct stumpless_element *element,
     return NULL;
   }
 
-  lock_element( element );
-  param = locked_get_param_by_index( element, index );
+  if( !lock_mutable_element( element ) ) {
+    return NULL;
+  }
+
+  param = locked_get_mutable_param_by_index( element, index );
   if( !param ) {
     goto fail;
   }
@@ -508,11 +546,11 @@ stumpless_set_param_value_by_index( struct stumpless_element *element,
     goto fail;
   }
 
-  unlock_element( element );
+  unlock_mutable_element( element );
   return element;
 
 fail:
-  unlock_element( element );
+  unlock_mutable_element( element );
   return NULL;
 }
 
@@ -520,19 +558,34 @@ struct stumpless_element *
 stumpless_set_param_value_by_name( struct stumpless_element *element,
                                    const char *name,
                                    const char *value ) {
+  size_t i;
   struct stumpless_param *param;
+  const char *found_name;
+  bool name_matches;
   const void *result;
 
   VALIDATE_ARG_NOT_NULL( element );
   VALIDATE_ARG_NOT_NULL( name );
 
-  param = stumpless_get_param_by_name( element, name );
-  if( param ) {
-    result = stumpless_set_param_value( param, value );
-  } else {
-    result = stumpless_add_new_param( element, name, value );
+  if( !lock_mutable_element( element ) ) {
+    return NULL;
   }
 
+  FOR_EACH_PARAM_WITH_NAME( element, name )
+    param = locked_get_mutable_param_by_index( element, i );
+    if( param ) {
+      result = stumpless_set_param_value( param, value );
+    } else {
+      result = NULL;
+    }
+
+    unlock_mutable_element( element );
+    return result ? element : NULL;
+  }
+
+  unlock_mutable_element( element );
+
+  result = stumpless_add_new_param( element, name, value );
   if( !result ) {
     return NULL;
   }
@@ -540,6 +593,29 @@ stumpless_set_param_value_by_name( struct stumpless_element *element,
   return element;
 }
 
+struct stumpless_element *
+stumpless_set_param_values( struct stumpless_element *element,
+                            const char * const *values,
+                            size_t value_count ) {
+  struct stumpless_element *result;
+
+  VALIDATE_ARG_NOT_NULL( element );
+  VALIDATE_ARG_NOT_NULL( values );
+
+  if( !lock_mutable_element( element ) ) {
+    return NULL;
+  }
+
+  result = locked_set_param_values( element, values, value_count );
+  unlock_mutable_element( element );
+
+  if( result ) {
+    clear_error(  );
+  }
+
+  return result;
+}
+
 const char *
 stumpless_element_to_string( const struct stumpless_element *element ) {
     char *format;
@@ -548,10 +624,11 @@ stumpless_element_to_string( const struct stumpless_element *element ) {
     size_t format_len;
     size_t param_count;
     struct stumpless_param **params;
+    bool locked;
 
     VALIDATE_ARG_NOT_NULL( element );
 
-    lock_element( element );
+    locked = lock_element( element );
 
     name = element->name;
     name_len = element->name_length;
@@ -596,7 +673,7 @@ stumpless_element_to_string( const struct stumpless_element *element ) {
     }
     free_mem(params_format);
 
-    unlock_element( element );
+    unlock_element( element, locked );
 
     format[0] = '<';
     format[name_len + 1] = '>';
@@ -617,15 +694,41 @@ stumpless_element_to_string( const struct stumpless_element *element ) {
     clear_error( );
     return format;
 fail:
-    unlock_element( element );
+    unlock_element( element, locked );
     return NULL;
 }
 
 /* private functions */
 
-void
+bool
 lock_element( const struct stumpless_element *element ) {
-  config_lock_mutex( element->mutex );
+  // frozen is read once, so that the caller unlocks exactly what was locked
+  if( config_read_flag( &element->frozen ) ) {
+    return false;
+  }
+
+  config_read_lock_rwlock( element->mutex );
+  return true;
+}
+
+bool
+lock_mutable_element( struct stumpless_element *element ) {
+  // once frozen a element stays frozen, so there is no need to lock it to check
+  if( config_read_flag( &element->frozen ) ) {
+    raise_object_frozen(  );
+    return false;
+  }
+
+  config_write_lock_rwlock( element->mutex );
+
+  // the element may have been frozen while waiting for the lock
+  if( config_read_flag( &element->frozen ) ) {
+    config_write_unlock_rwlock( element->mutex );
+    raise_object_frozen(  );
+    return false;
+  }
+
+  return true;
 }
 
 struct stumpless_param *
@@ -639,15 +742,243 @@ locked_get_param_by_index( const struct stumpless_element *element,
   return element->params[index];
 }
 
+struct stumpless_param *
+locked_get_mutable_param_by_index( struct stumpless_element *element,
+                                   size_t index ) {
+  struct stumpless_param *param;
+  struct stumpless_param *param_copy;
+
+  param = locked_get_param_by_index( element, index );
+  if( !param || !config_read_flag( &param->frozen ) ) {
+    return param;
+  }
+
+  // the param may be shared with other elements, so this one gets its own
+  // copy even if it is currently the only owner
+  param_copy = stumpless_copy_param( param );
+  if( !param_copy ) {
+    return NULL;
+  }
+
+  element->params[index] = param_copy;
+  stumpless_destroy_param( param );
+
+  return param_copy;
+}
+
+struct stumpless_element *
+locked_reserve_params( struct stumpless_element *element, size_t count ) {
+  struct stumpless_param **new_params;
+
+  if( count <= element->param_capacity ) {
+    return element;
+  }
+
+  if( count > SIZE_MAX / sizeof( *new_params ) ) {
+    raise_memory_allocation_failure(  );
+    return NULL;
+  }
+
+  new_params = arena_realloc_mem( element->arena,
+                                  element->params,
+                                  sizeof( *new_params ) *
+                                    element->param_capacity,
+                                  sizeof( *new_params ) * count );
+  if( !new_params ) {
+    return NULL;
+  }
+
+  element->params = new_params;
+  element->param_capacity = count;
+
+  return element;
+}
+
+struct stumpless_element *
+locked_reserve_param_values( struct stumpless_element *element,
+                             const char * const *values,
+                             size_t value_count ) {
+  size_t i;
+  struct stumpless_param *param;
+  const struct stumpless_param *result;
+
+  if( value_count > element->param_count ) {
+    raise_index_out_of_bounds( L10N_INVALID_INDEX_ERROR_MESSAGE( "param" ),
+                               value_count - 1 );
+    return NULL;
+  }
+
+  for( i = 0; i < value_count; i++ ) {
+    if( !values[i] ) {
+      continue;
+    }
+
+    param = locked_get_mutable_param_by_index( element, i );
+    if( !param || !lock_mutable_param( param ) ) {
+      return NULL;
+    }
+
+    result = locked_reserve_param_value( param, strlen( values[i] ) + 1 );
+    unlock_mutable_param( param );
+
+    if( !result ) {
+      return NULL;
+    }
+  }
+
+  return element;
+}
+
+struct stumpless_element *
+locked_set_param_values( struct stumpless_element *element,
+                         const char * const *values,
+                         size_t value_count ) {
+  size_t i;
+  struct stumpless_param *param;
+  const struct stumpless_param *result;
+
+  // all of the memory is reserved first so that a failure changes no values
+  if( !locked_reserve_param_values( element, values, value_count ) ) {
+    return NULL;
+  }
+
+  for( i = 0; i < value_count; i++ ) {
+    if( !values[i] ) {
+      continue;
+    }
+
+    param = locked_get_mutable_param_by_index( element, i );
+    if( !param || !lock_mutable_param( param ) ) {
+      return NULL;
+    }
+
+    result = locked_set_param_value( param, values[i] );
+    unlock_mutable_param( param );
+
+    if( !result ) {
+      return NULL;
+    }
+  }
+
+  return element;
+}
+
+struct stumpless_element *
+new_element( struct stumpless_arena *arena, const char *name ) {
+  struct stumpless_element *element;
+
+  VALIDATE_ARG_NOT_NULL( name );
+
+  if ( !validate_element_name( name ) ||
+       !validate_element_name_length( name )) {
+    goto fail;
+  }
+
+  element = arena_alloc_mem( arena, sizeof( *element ) );
+  if( !element ) {
+    goto fail;
+  }
+
+  element->arena = arena;
+  element->name = config_copy_name( arena, name, &( element->name_length ) );
+  if( !element->name ) {
+    goto fail_name;
+  }
+
+  element->params = NULL;
+  element->param_count = 0;
+  element->param_capacity = 0;
+  element->frozen = false;
+  element->reference_count = 1;
+
+  config_assign_arena_rwlock( element->mutex, arena );
+  if( !config_check_rwlock_valid( element->mutex ) ) {
+    goto fail_mutex;
+  }
+
+  config_init_journald_element( element );
+
+  clear_error(  );
+  return element;
+
+fail_mutex:
+  config_destroy_name( arena, element->name, element->name_length );
+
+fail_name:
+  arena_free_mem( arena, element, sizeof( *element ) );
+
+fail:
+  return NULL;
+}
+
+bool
+release_element( const struct stumpless_element *element ) {
+  return !config_read_flag( &element->frozen ) ||
+         config_decrement_size( ( size_t * ) &element->reference_count ) == 0;
+}
+
+void
+reset_param_values( struct stumpless_element *element ) {
+  size_t i;
+  struct stumpless_param *param;
+
+  // frozen elements are shared templates, so their values are left alone
+  if( config_read_flag( &element->frozen ) ||
+      !lock_mutable_element( element ) ) {
+    return;
+  }
+
+  for( i = 0; i < element->param_count; i++ ) {
+    param = element->params[i];
+    if( config_read_flag( &param->frozen ) ||
+        !lock_mutable_param( param ) ) {
+      continue;
+    }
+
+    // the storage is kept so that the next value can be written over it
+    param->value[0] = '\0';
+    param->value_length = 0;
+    unlock_mutable_param( param );
+  }
+
+  unlock_mutable_element( element );
+}
+
+void
+retain_element( struct stumpless_element *element ) {
+  if( config_read_flag( &element->frozen ) ) {
+    config_increment_size( &element->reference_count );
+  }
+}
+
+struct stumpless_element *
+share_element( struct stumpless_element *element ) {
+  if( config_read_flag( &element->frozen ) && !element->arena ) {
+    config_increment_size( &element->reference_count );
+    return element;
+  }
+
+  return stumpless_copy_element( element );
+}
+
 void
 unchecked_destroy_element( const struct stumpless_element *element ) {
-  config_destroy_cached_mutex( element->mutex );
-  free_mem( element->params );
-  free_mem( element->name );
-  free_mem( element );
+  config_destroy_arena_rwlock( element->mutex, element->arena );
+  arena_free_mem( element->arena,
+                  element->params,
+                  sizeof( *element->params ) * element->param_capacity );
+  config_destroy_name( element->arena, element->name, element->name_length );
+  arena_free_mem( element->arena, element, sizeof( *element ) );
+}
+
+void
+unlock_element( const struct stumpless_element *element, bool locked ) {
+  if( locked ) {
+    config_read_unlock_rwlock( element->mutex );
+  }
 }
 
 void
-unlock_element( const struct stumpless_element *element ) {
-  config_unlock_mutex( element->mutex );
+unlock_mutable_element( struct stumpless_element *element ) {
+  config_write_unlock_rwlock( element->mutex );
 }
@@ -16,18 +16,23 @@
  * limitations under the License.
  */
 
+#include <errno.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
+#include <stumpless/arena.h>
 #include <stumpless/element.h>
 #include <stumpless/entry.h>
 #include <stumpless/facility.h>
 #include <stumpless/param.h>
 #include <stumpless/severity.h>
+#include "private/arena.h"
 #include "private/cache.h"
 #include "private/config/locale/wrapper.h"
 #include "private/config/wrapper.h"
+#include "private/config/wrapper/name_interning.h"
 #include "private/config/wrapper/thread_safety.h"
 #include "private/deprecate.h"
 #include "private/element.h"
@@ -41,8 +46,86 @@
 #include "private/memory.h"
 #include "private/validate.h"
 
+typedef struct stumpless_element *
+( *param_values_func_t )( struct stumpless_element *element,
+                          const char * const *values,
+                          size_t value_count );
+
 static struct cache *entry_cache = NULL;
 
+/*
+ * Gets the size of the buffer to allocate for a new message of the given
+ * length. The first message of an entry is given exactly the space it needs,
+ * while replacements grow geometrically so that an entry which is reused for
+ * messages of increasing length is only reallocated a few times.
+ */
+static size_t
+get_message_capacity( const struct stumpless_entry *entry,
+                      size_t message_length ) {
+  if( !entry->message ) {
+    return message_length + 1;
+  }
+
+  return get_grown_capacity( entry->message_capacity,
+                             message_length + 1,
+                             SIZE_MAX );
+}
+
+/*
+ * Calls apply on each element of an entry locked with lock_mutable_entry that
+ * has at least one non-NULL value, with the values that belong to its params.
+ * The element is locked with lock_mutable_element during the call.
+ */
+static struct stumpless_entry *
+locked_apply_param_values( struct stumpless_entry *entry,
+                           const char * const *values,
+                           size_t value_count,
+                           param_values_func_t apply ) {
+  size_t i;
+  size_t j;
+  size_t param_count;
+  size_t offset;
+  struct stumpless_element *element;
+  const struct stumpless_element *result;
+  bool locked;
+
+  offset = 0;
+  for( i = 0; i < entry->element_count && offset < value_count; i++ ) {
+    element = entry->elements[i];
+    locked = lock_element( element );
+    param_count = element->param_count;
+    unlock_element( element, locked );
+
+    if( param_count > value_count - offset ) {
+      param_count = value_count - offset;
+    }
+
+    // elements without any new values are not copied or locked
+    j = 0;
+    while( j < param_count && !values[offset + j] ) {
+      j++;
+    }
+
+    if( j < param_count ) {
+      element = locked_get_mutable_element_by_index( entry, i );
+      if( !element || !lock_mutable_element( element ) ) {
+        return NULL;
+      }
+
+      result = apply( element, values + offset, param_count );
+      unlock_mutable_element( element );
+
+      if( !result ) {
+        return NULL;
+      }
+    }
+
+    offset += param_count;
+  }
+
+  return entry;
+}
+
 struct stumpless_entry *
 stumpless_add_element( struct stumpless_entry *entry,
                        struct stumpless_element *element ) {
@@ -51,11 +134,13 @@ stumpless_add_element( struct stumpless_entry *entry,
   VALIDATE_ARG_NOT_NULL( entry );
   VALIDATE_ARG_NOT_NULL( element );
 
-  clear_error(  );
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
 
-  lock_entry( entry );
+  clear_error(  );
   result = locked_add_element( entry, element );
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
 
   return result;
 }
@@ -63,18 +148,20 @@ stumpless_add_element( struct stumpless_entry *entry,
 struct stumpless_entry *
 stumpless_add_new_element( struct stumpless_entry *entry,
                            const char *name ) {
-  struct stumpless_element *new_element;
+  struct stumpless_element *element;
   struct stumpless_entry *result;
 
-  new_element = stumpless_new_element( name );
-  if( !new_element ) {
+  VALIDATE_ARG_NOT_NULL( entry );
+
+  element = new_element( entry->arena, name );
+  if( !element ) {
     return NULL;
   }
 
-  result = stumpless_add_element( entry, new_element );
+  result = stumpless_add_element( entry, element );
 
   if( !result ) {
-    stumpless_destroy_element_only( new_element );
+    stumpless_destroy_element_only( element );
   }
 
   return result;
@@ -104,11 +191,18 @@ stumpless_add_new_param_to_entry( struct stumpless_entry *entry,
     goto fail;
   }
 
-  lock_entry( entry );
+  if( !lock_mutable_entry( entry ) ) {
+    goto fail;
+  }
 
-  element = locked_get_element_by_name( entry, element_name );
-  if( !element ) {
-    element = stumpless_new_element( element_name );
+  if( unchecked_entry_has_element( entry, element_name ) ) {
+    element = locked_get_mutable_element_by_name( entry, element_name );
+    if( !element ) {
+      goto fail_locked;
+    }
+
+  } else {
+    element = new_element( entry->arena, element_name );
     if( !element ) {
       goto fail_locked;
     }
@@ -128,11 +222,11 @@ stumpless_add_new_param_to_entry( struct stumpless_entry *entry,
     }
   }
 
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
   return entry;
 
 fail_locked:
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
   if( element_created ) {
     stumpless_destroy_element_and_contents( element );
   }
@@ -146,15 +240,16 @@ stumpless_copy_entry( const struct stumpless_entry *entry ) {
   size_t i;
   struct stumpless_element *element_copy;
   const struct stumpless_entry *result;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( entry );
 
-  lock_entry( entry );
-  copy = stumpless_new_entry( get_facility( entry->prival ),
-                              get_severity( entry->prival ),
-                              entry->app_name,
-                              entry->msgid,
-                              entry->message );
+  locked = lock_entry( entry );
+  copy = stumpless_new_entry_str( get_facility( entry->prival ),
+                                  get_severity( entry->prival ),
+                                  entry->app_name,
+                                  entry->msgid,
+                                  entry->message );
   if( !copy ) {
     goto cleanup_and_fail;
   }
@@ -163,9 +258,10 @@ stumpless_copy_entry( const struct stumpless_entry *entry ) {
   if( !copy->elements ) {
     goto fail_elements;
   }
+  copy->element_capacity = entry->element_count;
 
   for( i = 0; i < entry->element_count; i++ ){
-    element_copy = stumpless_copy_element( entry->elements[i] );
+    element_copy = share_element( entry->elements[i] );
     if( !element_copy ) {
       goto fail_elements;
     }
@@ -179,14 +275,14 @@ stumpless_copy_entry( const struct stumpless_entry *entry ) {
     goto fail_elements;
   }
 
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
   clear_error(  );
   return copy;
 
 fail_elements:
   stumpless_destroy_entry_and_contents( copy );
 cleanup_and_fail:
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
   return NULL;
 }
 
@@ -230,6 +326,7 @@ bool
 stumpless_entry_has_element( const struct stumpless_entry *entry,
                              const char *name ) {
   bool result;
+  bool locked;
 
   if( !entry ) {
     raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "entry" ) );
@@ -245,18 +342,38 @@ stumpless_entry_has_element( const struct stumpless_entry *entry,
     return false;
   }
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   result = unchecked_entry_has_element( entry, name );
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   clear_error(  );
   return result;
 }
 
+struct stumpless_entry *
+stumpless_freeze_entry( struct stumpless_entry *entry ) {
+  size_t i;
+
+  VALIDATE_ARG_NOT_NULL( entry );
+
+  if( lock_mutable_entry( entry ) ) {
+    for( i = 0; i < entry->element_count; i++ ) {
+      stumpless_freeze_element( entry->elements[i] );
+    }
+
+    config_write_flag( &entry->frozen, true );
+    unlock_mutable_entry( entry );
+  }
+
+  clear_error(  );
+  return entry;
+}
+
 struct stumpless_element *
 stumpless_get_element_by_index( const struct stumpless_entry *entry,
                                 size_t index ) {
   struct stumpless_element *result;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( entry );
 
@@ -268,9 +385,9 @@ stumpless_get_element_by_index( const struct stumpless_entry *entry,
 
   clear_error(  );
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   result = locked_get_element_by_index( entry, index );
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   return result;
 }
@@ -279,6 +396,7 @@ struct stumpless_element *
 stumpless_get_element_by_name( const struct stumpless_entry *entry,
                                const char *name ) {
   struct stumpless_element *result;
+  bool locked;
 
   if( !entry ) {
     raise_argument_empty( "entry is NULL" );
@@ -296,9 +414,9 @@ stumpless_get_element_by_name( const struct stumpless_entry *entry,
 
   clear_error(  );
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   result = locked_get_element_by_name( entry, name );
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   return result;
 }
@@ -306,15 +424,16 @@ stumpless_get_element_by_name( const struct stumpless_entry *entry,
 size_t
 stumpless_get_element_count( const struct stumpless_entry *entry ) {
   size_t count;
+  bool locked;
 
   if( !entry ) {
     raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "entry" ) );
     return 0;
   }
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   count = entry->element_count;
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   return count;
 }
@@ -324,7 +443,10 @@ stumpless_get_element_index( const struct stumpless_entry *entry,
                              const char *name ) {
   size_t i;
   const struct stumpless_element *element;
-  int cmp_result;
+  const char *found_name;
+  bool name_matches;
+  bool entry_locked;
+  bool element_locked;
 
   if( !entry ) {
     raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "entry" ) );
@@ -340,15 +462,16 @@ stumpless_get_element_index( const struct stumpless_entry *entry,
     return 0;
   }
 
-  lock_entry( entry );
+  entry_locked = lock_entry( entry );
+  found_name = config_find_name( name );
   for( i = 0; i < entry->element_count; i++ ) {
     element = entry->elements[i];
 
-    lock_element( element );
-    cmp_result = strcmp( element->name, name );
-    unlock_element( element );
+    element_locked = lock_element( element );
+    name_matches = config_names_equal( element->name, found_name );
+    unlock_element( element, element_locked );
 
-    if( cmp_result == 0 ) {
+    if( name_matches ) {
       clear_error(  );
       goto cleanup_and_return;
     }
@@ -358,17 +481,18 @@ stumpless_get_element_index( const struct stumpless_entry *entry,
   raise_element_not_found(  );
 
 cleanup_and_return:
-  unlock_entry( entry );
+  unlock_entry( entry, entry_locked );
   return i;
 }
 
 const char *
 stumpless_get_entry_app_name( const struct stumpless_entry *entry ) {
   char *app_name_copy;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( entry );
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   app_name_copy = alloc_mem( entry->app_name_length + 1 );
   if( !app_name_copy ) {
     goto cleanup_and_return;
@@ -377,22 +501,23 @@ stumpless_get_entry_app_name( const struct stumpless_entry *entry ) {
   clear_error(  );
 
 cleanup_and_return:
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
   return app_name_copy;
 }
 
 enum stumpless_facility
 stumpless_get_entry_facility( const struct stumpless_entry *entry ) {
   int prival;
+  bool locked;
 
   if( !entry ) {
     raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "entry" ) );
     return -1;
   }
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   prival = entry->prival;
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   clear_error(  );
   return get_facility( prival );
@@ -401,10 +526,11 @@ stumpless_get_entry_facility( const struct stumpless_entry *entry ) {
 const char *
 stumpless_get_entry_message( const struct stumpless_entry *entry ) {
   char *message_copy;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( entry );
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   message_copy = alloc_mem( entry->message_length + 1 );
   if( !message_copy ) {
     goto cleanup_and_return;
@@ -413,17 +539,18 @@ stumpless_get_entry_message( const struct stumpless_entry *entry ) {
   clear_error(  );
 
 cleanup_and_return:
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
   return message_copy;
 }
 
 const char *
 stumpless_get_entry_msgid( const struct stumpless_entry *entry ) {
   char *msgid_copy;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( entry );
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   msgid_copy = alloc_mem( entry->msgid_length + 1 );
   if( !msgid_copy ) {
     goto cleanup_and_return;
@@ -432,7 +559,7 @@ stumpless_get_entry_msgid( const struct stumpless_entry *entry ) {
   clear_error(  );
 
 cleanup_and_return:
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
   return msgid_copy;
 }
 
@@ -441,12 +568,13 @@ stumpless_get_entry_param_by_index( const struct stumpless_entry *entry,
                                     size_t element_index,
                                     size_t param_index ) {
   const struct stumpless_element *element;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( entry );
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   element = locked_get_element_by_index( entry, element_index );
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   if( !element ) {
     return NULL;
@@ -460,6 +588,7 @@ stumpless_get_entry_param_by_name( const struct stumpless_entry *entry,
                                    const char *element_name,
                                    const char *param_name ) {
   const struct stumpless_element *element;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( entry );
   VALIDATE_ARG_NOT_NULL( element_name );
@@ -473,9 +602,9 @@ stumpless_get_entry_param_by_name( const struct stumpless_entry *entry,
     return NULL;
   }
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   element = locked_get_element_by_name( entry, element_name );
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   if( !element ) {
     return NULL;
@@ -489,12 +618,13 @@ stumpless_get_entry_param_value_by_index( const struct stumpless_entry *entry,
                                           size_t element_index,
                                           size_t param_index ) {
   const struct stumpless_element *element;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( entry );
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   element = locked_get_element_by_index( entry, element_index );
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   if( !element ) {
     return NULL;
@@ -508,6 +638,7 @@ stumpless_get_entry_param_value_by_name( const struct stumpless_entry *entry,
                                          const char *element_name,
                                          const char *param_name ) {
   const struct stumpless_element *element;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( entry );
   VALIDATE_ARG_NOT_NULL( element_name );
@@ -521,9 +652,9 @@ stumpless_get_entry_param_value_by_name( const struct stumpless_entry *entry,
     return NULL;
   }
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   element = locked_get_element_by_name( entry, element_name );
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   if( !element ) {
     return NULL;
@@ -535,15 +666,16 @@ stumpless_get_entry_param_value_by_name( const struct stumpless_entry *entry,
 int
 stumpless_get_entry_prival( const struct stumpless_entry *entry ) {
   int prival;
+  bool locked;
 
   if( !entry ) {
     raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "entry" ) );
     return -1;
   }
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   prival = entry->prival;
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   clear_error(  );
   return prival;
@@ -552,20 +684,45 @@ stumpless_get_entry_prival( const struct stumpless_entry *entry ) {
 enum stumpless_severity
 stumpless_get_entry_severity( const struct stumpless_entry *entry ) {
   int prival;
+  bool locked;
 
   if( !entry ) {
     raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "entry" ) );
     return -1;
   }
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
   prival = entry->prival;
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   clear_error(  );
   return get_severity( prival );
 }
 
+struct stumpless_entry *
+stumpless_new_arena_entry( struct stumpless_arena *arena,
+                           enum stumpless_facility facility,
+                           enum stumpless_severity severity,
+                           const char *app_name,
+                           const char *msgid,
+                           const char *message,
+                           ... ) {
+  va_list subs;
+  struct stumpless_entry *entry;
+
+  va_start( subs, message );
+  entry = vstumpless_new_arena_entry( arena,
+                                      facility,
+                                      severity,
+                                      app_name,
+                                      msgid,
+                                      message,
+                                      subs );
+  va_end( subs );
+
+  return entry;
+}
+
 struct stumpless_entry *
 stumpless_new_entry( enum stumpless_facility facility,
                      enum stumpless_severity severity,
@@ -609,12 +766,65 @@ stumpless_new_entry_str( enum stumpless_facility facility,
     msg_length = 0;
   }
 
-  entry = new_entry( facility, severity, app_name, msgid, msg, msg_length );
+  entry = new_entry( NULL,
+                     facility,
+                     severity,
+                     app_name,
+                     msgid,
+                     msg,
+                     msg_length,
+                     msg ? msg_length + 1 : 0 );
 
   if( !entry ) {
-    free_mem( msg );
+    free_sized_mem( msg, msg_length + 1 );
+  }
+
+  return entry;
+}
+
+struct stumpless_entry *
+stumpless_reserve_elements( struct stumpless_entry *entry, size_t count ) {
+  struct stumpless_entry *result;
+
+  VALIDATE_ARG_NOT_NULL( entry );
+
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
+
+  result = locked_reserve_elements( entry, count );
+  unlock_mutable_entry( entry );
+
+  if( result ) {
+    clear_error(  );
+  }
+
+  return result;
+}
+
+struct stumpless_entry *
+stumpless_reset_entry( struct stumpless_entry *entry ) {
+  size_t i;
+
+  VALIDATE_ARG_NOT_NULL( entry );
+
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
+
+  // the message buffer is kept so that the next message can be written over it
+  if( entry->message ) {
+    entry->message[0] = '\0';
+  }
+  entry->message_length = 0;
+
+  for( i = 0; i < entry->element_count; i++ ) {
+    reset_param_values( entry->elements[i] );
   }
 
+  unlock_mutable_entry( entry );
+
+  clear_error(  );
   return entry;
 }
 
@@ -627,7 +837,9 @@ stumpless_set_element( struct stumpless_entry *entry,
   VALIDATE_ARG_NOT_NULL( entry );
   VALIDATE_ARG_NOT_NULL( element );
 
-  lock_entry( entry );
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
 
   if( index >= entry->element_count ) {
     raise_index_out_of_bounds( L10N_INVALID_INDEX_ERROR_MESSAGE( "element" ),
@@ -641,12 +853,13 @@ stumpless_set_element( struct stumpless_entry *entry,
   }
 
   entry->elements[index] = element;
+  retain_element( element );
 
   result = entry;
   clear_error(  );
 
 cleanup_and_return:
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
   return result;
 }
 
@@ -666,11 +879,14 @@ stumpless_set_entry_app_name( struct stumpless_entry *entry,
 
   new_name_length = strlen( effective_name );
 
-  lock_entry( entry );
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
+
   entry->app_name_length = new_name_length;
   memcpy( entry->app_name, effective_name, new_name_length );
   entry->app_name[new_name_length] = '\0';
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
 
   clear_error(  );
   return entry;
@@ -686,9 +902,12 @@ stumpless_set_entry_facility( struct stumpless_entry *entry,
     return NULL;
   }
 
-  lock_entry( entry );
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
+
   entry->prival = get_prival( facility, get_severity( entry->prival ) );
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
 
   clear_error(  );
   return entry;
@@ -710,11 +929,14 @@ stumpless_set_entry_msgid( struct stumpless_entry *entry,
 
   new_msgid_length = strlen( effective_msgid );
 
-  lock_entry( entry );
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
+
   entry->msgid_length = new_msgid_length;
   memcpy( entry->msgid, effective_msgid, new_msgid_length );
   entry->msgid[new_msgid_length] = '\0';
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
 
   clear_error(  );
   return entry;
@@ -737,32 +959,27 @@ stumpless_set_entry_message( struct stumpless_entry *entry,
 struct stumpless_entry *
 stumpless_set_entry_message_str( struct stumpless_entry *entry,
                                  const char *message ) {
-  char *new_message;
-  size_t new_message_length;
-  const char *old_message;
+  struct stumpless_entry *result;
 
   VALIDATE_ARG_NOT_NULL( entry );
 
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
+
   if( message ) {
-    new_message = copy_cstring_with_length( message, &new_message_length );
-    if( !new_message ) {
-      return NULL;
-    }
+    result = locked_set_message( entry, message, strlen( message ) );
   } else {
-    new_message = NULL;
-    new_message_length = 0;
+    result = locked_set_message( entry, NULL, 0 );
   }
 
-  lock_entry( entry );
-  old_message = entry->message;
-  entry->message = new_message;
-  entry->message_length = new_message_length;
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
 
-  free_mem( old_message );
-  clear_error(  );
+  if( result ) {
+    clear_error(  );
+  }
 
-  return entry;
+  return result;
 }
 
 struct stumpless_entry *
@@ -771,19 +988,21 @@ stumpless_set_entry_param_by_index( struct stumpless_entry *entry,
                                     size_t param_index,
                                     struct stumpless_param *param ) {
   struct stumpless_element *element;
-  const struct stumpless_element *set_result;
+  const struct stumpless_element *set_result = NULL;
 
   VALIDATE_ARG_NOT_NULL( entry );
 
-  lock_entry( entry );
-  element = locked_get_element_by_index( entry, element_index );
-  unlock_entry( entry );
-
-  if( !element ) {
+  if( !lock_mutable_entry( entry ) ) {
     return NULL;
   }
 
-  set_result = stumpless_set_param( element, param_index, param );
+  element = locked_get_mutable_element_by_index( entry, element_index );
+  if( element ) {
+    set_result = stumpless_set_param( element, param_index, param );
+  }
+
+  unlock_mutable_entry( entry );
+
   if( !set_result ) {
     return NULL;
   }
@@ -797,21 +1016,23 @@ stumpless_set_entry_param_value_by_index( struct stumpless_entry *entry,
                                           size_t param_index,
                                           const char *value ) {
   struct stumpless_element *element;
-  const struct stumpless_element *set_result;
+  const struct stumpless_element *set_result = NULL;
 
   VALIDATE_ARG_NOT_NULL( entry );
 
-  lock_entry( entry );
-  element = locked_get_element_by_index( entry, element_index );
-  unlock_entry( entry );
-
-  if( !element ) {
+  if( !lock_mutable_entry( entry ) ) {
     return NULL;
   }
 
-  set_result = stumpless_set_param_value_by_index( element,
-                                                   param_index,
-                                                   value );
+  element = locked_get_mutable_element_by_index( entry, element_index );
+  if( element ) {
+    set_result = stumpless_set_param_value_by_index( element,
+                                                     param_index,
+                                                     value );
+  }
+
+  unlock_mutable_entry( entry );
+
   if( !set_result ) {
     return NULL;
   }
@@ -831,11 +1052,18 @@ stumpless_set_entry_param_value_by_name( struct stumpless_entry *entry,
   VALIDATE_ARG_NOT_NULL( entry );
   VALIDATE_ARG_NOT_NULL( element_name );
 
-  lock_entry( entry );
-  element = locked_get_element_by_name( entry, element_name );
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
 
-  if( !element ) {
-    element = stumpless_new_element( element_name );
+  if( unchecked_entry_has_element( entry, element_name ) ) {
+    element = locked_get_mutable_element_by_name( entry, element_name );
+    if( !element ) {
+      goto cleanup_and_fail;
+    }
+
+  } else {
+    element = new_element( entry->arena, element_name );
     if( !element ) {
       goto cleanup_and_fail;
     }
@@ -855,7 +1083,7 @@ stumpless_set_entry_param_value_by_name( struct stumpless_entry *entry,
     }
   }
 
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
   clear_error(  );
   return entry;
 
@@ -864,7 +1092,58 @@ fail_set:
     stumpless_destroy_element_and_contents( element );
   }
 cleanup_and_fail:
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
+  return NULL;
+}
+
+struct stumpless_entry *
+stumpless_set_entry_param_values( struct stumpless_entry *entry,
+                                  const char * const *values,
+                                  size_t value_count ) {
+  size_t i;
+  size_t total_count = 0;
+  struct stumpless_element *element;
+  bool locked;
+
+  VALIDATE_ARG_NOT_NULL( entry );
+  VALIDATE_ARG_NOT_NULL( values );
+
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
+
+  // nothing is changed if there are more values than params
+  for( i = 0; i < entry->element_count; i++ ) {
+    element = entry->elements[i];
+    locked = lock_element( element );
+    total_count += element->param_count;
+    unlock_element( element, locked );
+  }
+
+  if( value_count > total_count ) {
+    raise_index_out_of_bounds( L10N_INVALID_INDEX_ERROR_MESSAGE( "param" ),
+                               value_count - 1 );
+    goto fail;
+  }
+
+  // all of the memory is reserved first so that a failure changes no values
+  if( !locked_apply_param_values( entry,
+                                  values,
+                                  value_count,
+                                  locked_reserve_param_values ) ||
+      !locked_apply_param_values( entry,
+                                  values,
+                                  value_count,
+                                  locked_set_param_values ) ) {
+    goto fail;
+  }
+
+  unlock_mutable_entry( entry );
+  clear_error(  );
+  return entry;
+
+fail:
+  unlock_mutable_entry( entry );
   return NULL;
 }
 
@@ -884,9 +1163,12 @@ stumpless_set_entry_priority( struct stumpless_entry *entry,
     return NULL;
   }
 
-  lock_entry( entry );
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
+
   entry->prival = get_prival( facility, severity );
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
 
   clear_error(  );
   return entry;
@@ -910,14 +1192,58 @@ stumpless_set_entry_severity( struct stumpless_entry *entry,
     return NULL;
   }
 
-  lock_entry( entry );
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
+
   entry->prival = get_prival( get_facility( entry->prival ), severity );
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
 
   clear_error(  );
   return entry;
 }
 
+struct stumpless_entry *
+vstumpless_new_arena_entry( struct stumpless_arena *arena,
+                            enum stumpless_facility facility,
+                            enum stumpless_severity severity,
+                            const char *app_name,
+                            const char *msgid,
+                            const char *message,
+                            va_list subs ) {
+  char *msg;
+  size_t msg_length;
+  struct stumpless_entry *entry;
+
+  VALIDATE_ARG_NOT_NULL( arena );
+
+  if( message ) {
+    msg = arena_format_string( arena, message, subs, &msg_length );
+    if( !msg ) {
+      return NULL;
+    }
+
+  } else {
+    msg = NULL;
+    msg_length = 0;
+  }
+
+  entry = new_entry( arena,
+                     facility,
+                     severity,
+                     app_name,
+                     msgid,
+                     msg,
+                     msg_length,
+                     msg ? msg_length + 1 : 0 );
+
+  if( !entry ) {
+    arena_free_mem( arena, msg, 0 );
+  }
+
+  return entry;
+}
+
 struct stumpless_entry *
 vstumpless_new_entry( enum stumpless_facility facility,
                       enum stumpless_severity severity,
@@ -940,7 +1266,15 @@ vstumpless_new_entry( enum stumpless_facility facility,
     msg_length = 0;
   }
 
-  entry = new_entry( facility, severity, app_name, msgid, msg, msg_length );
+  // formatted messages may be allocated with more space than they use
+  entry = new_entry( NULL,
+                     facility,
+                     severity,
+                     app_name,
+                     msgid,
+                     msg,
+                     msg_length,
+                     0 );
 
   if( !entry ) {
     free_mem( msg );
@@ -953,32 +1287,27 @@ struct stumpless_entry *
 vstumpless_set_entry_message( struct stumpless_entry *entry,
                               const char *message,
                               va_list subs ) {
-  const char *old_message;
-  char *new_message;
-  size_t message_length;
+  struct stumpless_entry *result;
 
   VALIDATE_ARG_NOT_NULL( entry );
 
-  if( !message ) {
-    new_message = NULL;
-    message_length = 0;
+  if( !lock_mutable_entry( entry ) ) {
+    return NULL;
+  }
 
+  if( message ) {
+    result = locked_format_message( entry, message, subs );
   } else {
-    new_message = config_format_string( message, subs, &message_length );
-    if( !new_message ) {
-      return NULL;
-    }
+    result = locked_set_message( entry, NULL, 0 );
   }
 
-  lock_entry( entry );
-  old_message = entry->message;
-  entry->message = new_message;
-  entry->message_length = message_length;
-  unlock_entry( entry );
+  unlock_mutable_entry( entry );
 
-  free_mem( old_message );
-  clear_error(  );
-  return entry;
+  if( result ) {
+    clear_error(  );
+  }
+
+  return result;
 }
 
 /* private functions */
@@ -989,41 +1318,138 @@ entry_free_all( void ) {
   entry_cache = NULL;
 }
 
+void
+entry_get_cache_usage( struct stumpless_memory_usage *usage ) {
+  cache_get_usage( entry_cache, usage );
+}
+
 int
 get_prival( enum stumpless_facility facility,
             enum stumpless_severity severity ) {
   return facility | severity;
 }
 
-void
+bool
 lock_entry( const struct stumpless_entry *entry ) {
-  config_lock_mutex( entry->mutex );
+  // frozen is read once, so that the caller unlocks exactly what was locked
+  if( config_read_flag( &entry->frozen ) ) {
+    return false;
+  }
+
+  config_read_lock_rwlock( entry->mutex );
+  return true;
+}
+
+bool
+lock_mutable_entry( struct stumpless_entry *entry ) {
+  // once frozen a entry stays frozen, so there is no need to lock it to check
+  if( config_read_flag( &entry->frozen ) ) {
+    raise_object_frozen(  );
+    return false;
+  }
+
+  config_write_lock_rwlock( entry->mutex );
+
+  // the entry may have been frozen while waiting for the lock
+  if( config_read_flag( &entry->frozen ) ) {
+    config_write_unlock_rwlock( entry->mutex );
+    raise_object_frozen(  );
+    return false;
+  }
+
+  return true;
 }
 
 struct stumpless_entry *
 locked_add_element( struct stumpless_entry *entry,
                     struct stumpless_element *element ) {
-  struct stumpless_element **new_elements;
-  size_t old_elements_size;
-  size_t new_elements_size;
+  size_t new_capacity;
 
   if( unchecked_entry_has_element( entry, element->name ) ) {
     raise_duplicate_element(  );
     return NULL;
   }
 
-  old_elements_size = sizeof( element ) * entry->element_count;
-  new_elements_size = old_elements_size + sizeof( element );
+  if( entry->element_count == entry->element_capacity ) {
+    new_capacity = get_grown_capacity( entry->element_capacity,
+                                       entry->element_count + 1,
+                                       SIZE_MAX / sizeof( *entry->elements ) );
+    if( !locked_reserve_elements( entry, new_capacity ) ) {
+      return NULL;
+    }
+  }
 
-  new_elements = realloc_mem( entry->elements, new_elements_size );
-  if( !new_elements ) {
+  entry->elements[entry->element_count] = element;
+  entry->element_count++;
+  retain_element( element );
+
+  return entry;
+}
+
+struct stumpless_entry *
+locked_format_message( struct stumpless_entry *entry,
+                       const char *format,
+                       va_list subs ) {
+  char first_try[128];
+  va_list subs_copy;
+  int result;
+  size_t message_length;
+  char *new_message;
+  size_t new_capacity;
+
+  // most messages fit on the stack, so they only need to be formatted once
+  va_copy( subs_copy, subs );
+  result = config_format_string_into( first_try,
+                                      sizeof( first_try ),
+                                      format,
+                                      subs_copy );
+  va_end( subs_copy );
+  if( result < 0 ) {
+    raise_format_failure( errno );
     return NULL;
   }
 
-  new_elements[entry->element_count] = element;
-  entry->elements = new_elements;
-  entry->element_count++;
+  message_length = ( size_t ) result;
+  if( message_length < sizeof( first_try ) ) {
+    return locked_set_message( entry, first_try, message_length );
+  }
+
+  if( message_length < entry->message_capacity ) {
+    result = config_format_string_into( entry->message,
+                                        entry->message_capacity,
+                                        format,
+                                        subs );
+    if( result < 0 || ( size_t ) result != message_length ) {
+      // the old message may already have been written over
+      entry->message[0] = '\0';
+      entry->message_length = 0;
+      raise_format_failure( errno );
+      return NULL;
+    }
 
+  } else {
+    new_capacity = get_message_capacity( entry, message_length );
+    new_message = arena_alloc_mem( entry->arena, new_capacity );
+    if( !new_message ) {
+      return NULL;
+    }
+
+    result = config_format_string_into( new_message,
+                                        new_capacity,
+                                        format,
+                                        subs );
+    if( result < 0 || ( size_t ) result != message_length ) {
+      arena_free_mem( entry->arena, new_message, new_capacity );
+      raise_format_failure( errno );
+      return NULL;
+    }
+
+    arena_free_mem( entry->arena, entry->message, entry->message_capacity );
+    entry->message = new_message;
+    entry->message_capacity = new_capacity;
+  }
+
+  entry->message_length = message_length;
   return entry;
 }
 
@@ -1044,16 +1470,19 @@ locked_get_element_by_name( const struct stumpless_entry *entry,
                             const char *name ) {
   int i;
   struct stumpless_element *element;
-  int cmp_result;
+  const char *found_name;
+  bool name_matches;
+  bool locked;
 
+  found_name = config_find_name( name );
   for( i = 0; i < entry->element_count; i++ ) {
     element = entry->elements[i];
 
-    lock_element( element );
-    cmp_result = strcmp( element->name, name );
-    unlock_element( element );
+    locked = lock_element( element );
+    name_matches = config_names_equal( element->name, found_name );
+    unlock_element( element, locked );
 
-    if( cmp_result == 0 ) {
+    if( name_matches ) {
       return element;
     }
   }
@@ -1062,28 +1491,155 @@ locked_get_element_by_name( const struct stumpless_entry *entry,
   return NULL;
 }
 
+struct stumpless_element *
+locked_get_mutable_element_by_index( struct stumpless_entry *entry,
+                                     size_t index ) {
+  struct stumpless_element *element;
+  struct stumpless_element *element_copy;
+
+  element = locked_get_element_by_index( entry, index );
+  if( !element || !config_read_flag( &element->frozen ) ) {
+    return element;
+  }
+
+  // the element may be shared with other entries, so this one gets its own
+  // copy even if it is currently the only owner
+  element_copy = stumpless_copy_element( element );
+  if( !element_copy ) {
+    return NULL;
+  }
+
+  entry->elements[index] = element_copy;
+  stumpless_destroy_element_and_contents( element );
+
+  return element_copy;
+}
+
+struct stumpless_element *
+locked_get_mutable_element_by_name( struct stumpless_entry *entry,
+                                    const char *name ) {
+  size_t i;
+  const struct stumpless_element *element;
+  const char *found_name;
+  bool name_matches;
+  bool locked;
+
+  found_name = config_find_name( name );
+  for( i = 0; i < entry->element_count; i++ ) {
+    element = entry->elements[i];
+
+    locked = lock_element( element );
+    name_matches = config_names_equal( element->name, found_name );
+    unlock_element( element, locked );
+
+    if( name_matches ) {
+      return locked_get_mutable_element_by_index( entry, i );
+    }
+  }
+
+  raise_element_not_found(  );
+  return NULL;
+}
+
 struct stumpless_entry *
-new_entry( enum stumpless_facility facility,
+locked_set_message( struct stumpless_entry *entry,
+                    const char *message,
+                    size_t message_length ) {
+  char *new_message;
+  size_t new_capacity;
+
+  if( !message ) {
+    arena_free_mem( entry->arena, entry->message, entry->message_capacity );
+    entry->message = NULL;
+    entry->message_length = 0;
+    entry->message_capacity = 0;
+    return entry;
+  }
+
+  // the new message may be part of the current one, so memmove is needed
+  if( message_length < entry->message_capacity ) {
+    memmove( entry->message, message, message_length );
+
+  } else {
+    new_capacity = get_message_capacity( entry, message_length );
+    new_message = arena_alloc_mem( entry->arena, new_capacity );
+    if( !new_message ) {
+      return NULL;
+    }
+
+    memcpy( new_message, message, message_length );
+    arena_free_mem( entry->arena, entry->message, entry->message_capacity );
+    entry->message = new_message;
+    entry->message_capacity = new_capacity;
+  }
+
+  entry->message[message_length] = '\0';
+  entry->message_length = message_length;
+  return entry;
+}
+
+struct stumpless_entry *
+locked_reserve_elements( struct stumpless_entry *entry, size_t count ) {
+  struct stumpless_element **new_elements;
+
+  if( count <= entry->element_capacity ) {
+    return entry;
+  }
+
+  if( count > SIZE_MAX / sizeof( *new_elements ) ) {
+    raise_memory_allocation_failure(  );
+    return NULL;
+  }
+
+  new_elements = arena_realloc_mem( entry->arena,
+                                    entry->elements,
+                                    sizeof( *new_elements ) *
+                                      entry->element_capacity,
+                                    sizeof( *new_elements ) * count );
+  if( !new_elements ) {
+    return NULL;
+  }
+
+  entry->elements = new_elements;
+  entry->element_capacity = count;
+
+  return entry;
+}
+
+struct stumpless_entry *
+new_entry( struct stumpless_arena *arena,
+           enum stumpless_facility facility,
            enum stumpless_severity severity,
            const char *app_name,
            const char *msgid,
            char *message,
-           size_t message_length ) {
+           size_t message_length,
+           size_t message_capacity ) {
   struct stumpless_entry *entry;
   const char *effective_app_name;
   const char *effective_msgid;
 
-  if( !entry_cache ) {
-    entry_cache = cache_new( sizeof( *entry ), NULL, NULL );
+  if( arena ) {
+    entry = arena_alloc_mem( arena, sizeof( *entry ) );
+    if( !entry ) {
+      goto fail;
+    }
+
+  } else {
     if( !entry_cache ) {
+      entry_cache = cache_new( sizeof( *entry ), NULL, NULL );
+      if( !entry_cache ) {
+        goto fail;
+      }
+    }
+
+    entry = cache_alloc( entry_cache );
+    if( !entry ) {
       goto fail;
     }
   }
 
-  entry = cache_alloc( entry_cache );
-  if( !entry ) {
-    goto fail;
-  }
+  entry->arena = arena;
 
   effective_app_name = app_name ? app_name : "-";
   if ( !validate_app_name_length ( effective_app_name ) ||
@@ -1110,22 +1666,27 @@ new_entry( enum stumpless_facility facility,
   }
   config_set_entry_wel_type( entry, severity );
 
-  config_assign_cached_mutex( entry->mutex );
-  if( !config_check_mutex_valid( entry->mutex ) ) {
+  config_assign_arena_rwlock( entry->mutex, arena );
+  if( !config_check_rwlock_valid( entry->mutex ) ) {
     goto fail_after_cache;
   }
 
   entry->message = message;
   entry->message_length = message_length;
+  entry->message_capacity = message_capacity;
   entry->prival = get_prival( facility, severity );
   entry->elements = NULL;
   entry->element_count = 0;
+  entry->element_capacity = 0;
+  entry->frozen = false;
 
   clear_error(  );
   return entry;
 
 fail_after_cache:
-  cache_free( entry_cache, entry );
+  if( !arena ) {
+    cache_free( entry_cache, entry );
+  }
 fail:
   return NULL;
 
@@ -1214,23 +1775,30 @@ strbuilder_append_structured_data( struct strbuilder *builder,
 
 void
 unchecked_destroy_entry( const struct stumpless_entry *entry ) {
-  config_destroy_cached_mutex( entry->mutex );
+  config_destroy_arena_rwlock( entry->mutex, entry->arena );
 
   config_destroy_wel_data( entry );
 
-  free_mem( entry->elements );
-  free_mem( entry->message );
+  arena_free_mem( entry->arena,
+                  entry->elements,
+                  sizeof( *entry->elements ) * entry->element_capacity );
+
+  arena_free_mem( entry->arena, entry->message, entry->message_capacity );
 
-  cache_free( entry_cache, entry );
+  if( !entry->arena ) {
+    cache_free( entry_cache, entry );
+  }
 }
 
 bool
 unchecked_entry_has_element( const struct stumpless_entry *entry,
                              const char *name ) {
   size_t i;
+  const char *found_name;
 
+  found_name = config_find_name( name );
   for( i = 0; i < entry->element_count; i++ ) {
-    if( strcmp( entry->elements[i]->name, name ) == 0 ) {
+    if( config_names_equal( entry->elements[i]->name, found_name ) ) {
       return true;
     }
   }
@@ -1239,6 +1807,13 @@ unchecked_entry_has_element( const struct stumpless_entry *entry,
 }
 
 void
-unlock_entry( const struct stumpless_entry *entry ) {
-  config_unlock_mutex( entry->mutex );
+unlock_entry( const struct stumpless_entry *entry, bool locked ) {
+  if( locked ) {
+    config_read_unlock_rwlock( entry->mutex );
+  }
+}
+
+void
+unlock_mutable_entry( struct stumpless_entry *entry ) {
+  config_write_unlock_rwlock( entry->mutex );
 }
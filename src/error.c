@@ -180,6 +180,14 @@ raise_file_open_failure( void ) {
                NULL );
 }
 
+void
+raise_file_rotation_failure( void ) {
+  raise_error( STUMPLESS_FILE_OPEN_FAILURE,
+               L10N_FILE_ROTATION_FAILURE_ERROR_MESSAGE,
+               0,
+               NULL );
+}
+
 void
 raise_file_write_failure( void ) {
   raise_error( STUMPLESS_FILE_WRITE_FAILURE,
@@ -188,6 +196,14 @@ raise_file_write_failure( void ) {
                NULL );
 }
 
+void
+raise_format_failure( int code ) {
+  raise_error( STUMPLESS_FORMAT_FAILURE,
+               L10N_FORMAT_FAILURE_ERROR_MESSAGE,
+               code,
+               L10N_ERRNO_ERROR_CODE_TYPE );
+}
+
 void
 raise_function_target_failure( int code ) {
   raise_error( STUMPLESS_FUNCTION_TARGET_FAILURE,
@@ -203,6 +219,14 @@ raise_gethostname_failure( const char *message,
   raise_error( STUMPLESS_GETHOSTNAME_FAILURE, message, code, code_type );
 }
 
+void
+raise_gzip_failure( int code ) {
+  raise_error( STUMPLESS_FILE_WRITE_FAILURE,
+               L10N_GZIP_FAILURE_ERROR_MESSAGE,
+               code,
+               L10N_ZLIB_ERROR_CODE_TYPE );
+}
+
 void
 raise_index_out_of_bounds( const char *message, size_t index ) {
   raise_error( STUMPLESS_INDEX_OUT_OF_BOUNDS,
@@ -235,6 +259,14 @@ raise_invalid_severity( int severity ) {
                L10N_INVALID_SEVERITY_ERROR_CODE_TYPE );
 }
 
+void
+raise_io_uring_failure( int code ) {
+  raise_error( STUMPLESS_TARGET_UNSUPPORTED,
+               L10N_IO_URING_FAILURE_ERROR_MESSAGE,
+               code,
+               L10N_ERRNO_ERROR_CODE_TYPE );
+}
+
 void
 raise_journald_failure( int code ) {
   raise_error( STUMPLESS_JOURNALD_FAILURE,
@@ -259,6 +291,14 @@ raise_network_protocol_unsupported( void ) {
                NULL );
 }
 
+void
+raise_object_frozen( void ) {
+  raise_error( STUMPLESS_OBJECT_FROZEN,
+               L10N_OBJECT_FROZEN_ERROR_MESSAGE,
+               0,
+               NULL );
+}
+
 void
 raise_param_not_found( void ) {
   raise_error( STUMPLESS_PARAM_NOT_FOUND,
@@ -267,6 +307,14 @@ raise_param_not_found( void ) {
                NULL );
 }
 
+void
+raise_segment_failure( int code ) {
+  raise_error( STUMPLESS_FILE_OPEN_FAILURE,
+               L10N_SEGMENT_FAILURE_ERROR_MESSAGE,
+               code,
+               L10N_ERRNO_ERROR_CODE_TYPE );
+}
+
 void
 raise_socket_bind_failure( const char *message,
                            int code,
@@ -311,6 +359,14 @@ raise_target_unsupported( const char *message ) {
   raise_error( STUMPLESS_TARGET_UNSUPPORTED, message, 0, NULL );
 }
 
+void
+raise_thread_failure( int code ) {
+  raise_error( STUMPLESS_THREAD_FAILURE,
+               L10N_THREAD_FAILURE_ERROR_MESSAGE,
+               code,
+               L10N_ERRNO_ERROR_CODE_TYPE );
+}
+
 void
 raise_transport_protocol_unsupported( void ) {
   raise_error( STUMPLESS_TRANSPORT_PROTOCOL_UNSUPPORTED,
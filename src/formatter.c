@@ -16,6 +16,7 @@
  * limitations under the License.
  */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stumpless/entry.h>
 #include <stumpless/option.h>
@@ -26,18 +27,19 @@
 #include "private/formatter.h"
 
 struct strbuilder *
-format_entry( const struct stumpless_entry *entry,
-              const struct stumpless_target *target ) {
-  char timestamp[RFC_5424_TIMESTAMP_BUFFER_SIZE];
-  struct strbuilder *builder;
-  size_t timestamp_size;
+append_formatted_entry( struct strbuilder *builder,
+                        const struct stumpless_entry *entry,
+                        const struct stumpless_target *target,
+                        const char *timestamp,
+                        size_t timestamp_size ) {
+  bool locked;
 
-  // do this as soon as possible to be closer to invocation
-  timestamp_size = config_get_now( timestamp );
+  if( !builder ) {
+    return NULL;
+  }
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
 
-  builder = strbuilder_new(  );
   builder = strbuilder_append_char( builder, '<' );
   builder = strbuilder_append_positive_int( builder, entry->prival );
   builder = strbuilder_append_string( builder, ">1 " );
@@ -64,7 +66,34 @@ format_entry( const struct stumpless_entry *entry,
 
   builder = strbuilder_append_char( builder, '\n' );
 
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   return builder;
 }
+
+struct strbuilder *
+format_entry( const struct stumpless_entry *entry,
+              const struct stumpless_target *target ) {
+  char timestamp[RFC_5424_TIMESTAMP_BUFFER_SIZE];
+  size_t timestamp_size;
+
+  // do this as soon as possible to be closer to invocation
+  timestamp_size = config_get_now( timestamp );
+
+  return format_entry_with_timestamp( entry,
+                                      target,
+                                      timestamp,
+                                      timestamp_size );
+}
+
+struct strbuilder *
+format_entry_with_timestamp( const struct stumpless_entry *entry,
+                             const struct stumpless_target *target,
+                             const char *timestamp,
+                             size_t timestamp_size ) {
+  return append_formatted_entry( strbuilder_new(  ),
+                                 entry,
+                                 target,
+                                 timestamp,
+                                 timestamp_size );
+}
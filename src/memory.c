@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 /*
- * Copyright 2018-2021 Joel E. Anderson
+ * Copyright 2018-2022 Joel E. Anderson
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -16,17 +16,24 @@
  * limitations under the License.
  */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stumpless/memory.h>
+#include "private/config/locale/wrapper.h"
 #include "private/config/network_support_wrapper.h"
 #include "private/config/wrapper.h"
+#include "private/config/wrapper/async.h"
 #include "private/config/wrapper/journald.h"
+#include "private/config/wrapper/name_interning.h"
 #include "private/config/wrapper/thread_safety.h"
 #include "private/entry.h"
 #include "private/error.h"
 #include "private/memory.h"
 #include "private/target.h"
+#include "private/target/file.h"
+#include "private/target/stream.h"
 #include "private/strbuilder.h"
 #include "private/validate.h"
 
@@ -38,6 +45,71 @@ static free_func_t stumpless_free = free;
 static malloc_func_t stumpless_malloc = malloc;
 static realloc_func_t stumpless_realloc = realloc;
 
+/*
+ * The default allocator functions forward to the bare function pointers above
+ * so that stumpless_set_malloc and friends keep working as they always have.
+ */
+
+static void
+default_free( void *mem, size_t size, void *context ) {
+  ( void ) size;
+  ( void ) context;
+  stumpless_free( mem );
+}
+
+static void *
+default_malloc( size_t size, void *context ) {
+  ( void ) context;
+  return stumpless_malloc( size );
+}
+
+static void *
+default_realloc( void *mem, size_t size, void *context ) {
+  ( void ) context;
+  return stumpless_realloc( mem, size );
+}
+
+/* global static variables */
+static struct stumpless_allocator global_allocator = {
+  default_malloc,
+  default_realloc,
+  default_free,
+  NULL
+};
+
+/* per-thread static variables */
+static CONFIG_THREAD_LOCAL_STORAGE struct stumpless_allocator thread_allocator;
+static CONFIG_THREAD_LOCAL_STORAGE bool thread_allocator_valid = false;
+
+static const struct stumpless_allocator *
+get_allocator( void ) {
+  if( thread_allocator_valid ) {
+    return &thread_allocator;
+  }
+
+  return &global_allocator;
+}
+
+static bool
+validate_allocator( const struct stumpless_allocator *allocator ) {
+  if( !allocator->malloc_func ) {
+    raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "malloc_func" ) );
+    return false;
+  }
+
+  if( !allocator->realloc_func ) {
+    raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "realloc_func" ) );
+    return false;
+  }
+
+  if( !allocator->free_func ) {
+    raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "free_func" ) );
+    return false;
+  }
+
+  return true;
+}
+
 void
 stumpless_free_all( void ) {
   // thread-local resources must be destroyed before the global resources as
@@ -48,9 +120,29 @@ stumpless_free_all( void ) {
   entry_free_all(  );
   strbuilder_free_all(  );
   config_network_free_all(  );
+  config_name_interning_free_all(  );
   config_thread_safety_free_all(  );
 }
 
+struct stumpless_memory_stats *
+stumpless_get_memory_stats( struct stumpless_memory_stats *stats ) {
+  VALIDATE_ARG_NOT_NULL( stats );
+
+  memset( stats, 0, sizeof( *stats ) );
+  entry_get_cache_usage( &stats->entry_cache );
+  strbuilder_get_usage( &stats->strbuilders );
+  config_get_lock_cache_usage( &stats->lock_cache );
+  config_network_get_usage( &stats->tcp_send_buffers );
+  config_journald_get_usage( &stats->journald_buffers );
+  target_get_usage( &stats->targets );
+  config_async_get_usage( &stats->async_queues );
+  file_get_usage( &stats->file_buffers );
+  stream_get_usage( &stats->stream_buffers );
+
+  clear_error(  );
+  return stats;
+}
+
 void
 stumpless_free_thread( void ) {
   clear_error(  );
@@ -59,12 +151,26 @@ stumpless_free_thread( void ) {
   target_free_thread(  );
 }
 
+const struct stumpless_allocator *
+stumpless_set_allocator( const struct stumpless_allocator *allocator ) {
+  VALIDATE_ARG_NOT_NULL( allocator );
+
+  if( !validate_allocator( allocator ) ) {
+    return NULL;
+  }
+
+  clear_error(  );
+  global_allocator = *allocator;
+  return &global_allocator;
+}
+
 malloc_func_t
 stumpless_set_malloc( malloc_func_t malloc_func ) {
   VALIDATE_ARG_NOT_NULL( malloc_func );
 
   clear_error(  );
   stumpless_malloc = malloc_func;
+  global_allocator.malloc_func = default_malloc;
   return stumpless_malloc;
 }
 
@@ -74,6 +180,7 @@ stumpless_set_free( free_func_t free_func ) {
 
   clear_error(  );
   stumpless_free = free_func;
+  global_allocator.free_func = default_free;
   return stumpless_free;
 }
 
@@ -83,14 +190,34 @@ stumpless_set_realloc( realloc_func_t realloc_func ) {
 
   clear_error(  );
   stumpless_realloc = realloc_func;
+  global_allocator.realloc_func = default_realloc;
   return stumpless_realloc;
 }
 
+const struct stumpless_allocator *
+stumpless_set_thread_allocator( const struct stumpless_allocator *allocator ) {
+  if( !allocator ) {
+    thread_allocator_valid = false;
+    clear_error(  );
+    return &global_allocator;
+  }
+
+  if( !validate_allocator( allocator ) ) {
+    return NULL;
+  }
+
+  thread_allocator = *allocator;
+  thread_allocator_valid = true;
+  clear_error(  );
+  return &thread_allocator;
+}
+
 /* private functions */
 
 void *
 alloc_mem( size_t size ) {
-  void *mem = stumpless_malloc( size );
+  const struct stumpless_allocator *allocator = get_allocator(  );
+  void *mem = allocator->malloc_func( size, allocator->context );
 
   if( !mem ) {
     raise_memory_allocation_failure(  );
@@ -101,7 +228,49 @@ alloc_mem( size_t size ) {
 
 void
 free_mem( const void *mem ) {
-  stumpless_free( ( void * ) mem );
+  free_sized_mem( mem, 0 );
+}
+
+void
+free_sized_mem( const void *mem, size_t size ) {
+  const struct stumpless_allocator *allocator;
+
+  if( !mem ) {
+    return;
+  }
+
+  allocator = get_allocator(  );
+  allocator->free_func( ( void * ) mem, size, allocator->context );
+}
+
+size_t
+get_grown_capacity( size_t capacity,
+                    size_t required,
+                    size_t max_capacity ) {
+  size_t new_capacity;
+
+  // a requirement past the limit is left for the caller to reject
+  if( required > max_capacity ) {
+    return required;
+  }
+
+  if( capacity < 4 ) {
+    new_capacity = 4;
+  } else if( capacity > max_capacity / 2 ) {
+    return max_capacity;
+  } else {
+    new_capacity = capacity * 2;
+  }
+
+  while( new_capacity < required ) {
+    if( new_capacity > max_capacity / 2 ) {
+      return max_capacity;
+    }
+
+    new_capacity *= 2;
+  }
+
+  return new_capacity;
 }
 
 size_t
@@ -118,7 +287,8 @@ get_paged_size( size_t size ) {
 
 void *
 realloc_mem( void *mem, size_t size ) {
-  void *new_mem = stumpless_realloc( mem, size );
+  const struct stumpless_allocator *allocator = get_allocator(  );
+  void *new_mem = allocator->realloc_func( mem, size, allocator->context );
 
   if( !new_mem ) {
     raise_memory_allocation_failure(  );
@@ -18,8 +18,11 @@
 
 #include <stddef.h>
 #include <string.h>
+#include <stumpless/arena.h>
 #include <stumpless/param.h>
+#include "private/arena.h"
 #include "private/config/wrapper/journald.h"
+#include "private/config/wrapper/name_interning.h"
 #include "private/config/wrapper/thread_safety.h"
 #include "private/error.h"
 #include "private/memory.h"
@@ -30,12 +33,13 @@
 struct stumpless_param *
 stumpless_copy_param( const struct stumpless_param *param ) {
   struct stumpless_param *result;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( param );
 
-  lock_param( param );
+  locked = lock_param( param );
   result = stumpless_new_param( param->name, param->value );
-  unlock_param( param );
+  unlock_param( param, locked );
 
   return result;
 }
@@ -46,19 +50,39 @@ stumpless_destroy_param( const struct stumpless_param *param ) {
     return;
   }
 
-  config_destroy_cached_mutex( param->mutex );
-  free_mem( param->name );
-  free_mem( param->value );
-  free_mem( param );
+  // frozen params may be shared, and are only destroyed by the last owner
+  if( config_read_flag( &param->frozen ) &&
+      config_decrement_size( ( size_t * ) &param->reference_count ) != 0 ) {
+    return;
+  }
+
+  config_destroy_arena_rwlock( param->mutex, param->arena );
+  config_destroy_name( param->arena, param->name, param->name_length );
+  destroy_param_value( param );
+  arena_free_mem( param->arena, param, sizeof( *param ) );
+}
+
+struct stumpless_param *
+stumpless_freeze_param( struct stumpless_param *param ) {
+  VALIDATE_ARG_NOT_NULL( param );
+
+  if( lock_mutable_param( param ) ) {
+    config_write_flag( &param->frozen, true );
+    unlock_mutable_param( param );
+  }
+
+  clear_error(  );
+  return param;
 }
 
 const char *
 stumpless_get_param_name( const struct stumpless_param *param ) {
   char *name_copy;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( param );
 
-  lock_param( param );
+  locked = lock_param( param );
   name_copy = alloc_mem( param->name_length + 1 );
   if( !name_copy ) {
     goto cleanup_and_return;
@@ -67,17 +91,18 @@ stumpless_get_param_name( const struct stumpless_param *param ) {
   clear_error(  );
 
 cleanup_and_return:
-  unlock_param( param );
+  unlock_param( param, locked );
   return name_copy;
 }
 
 const char *
 stumpless_get_param_value( const struct stumpless_param *param ) {
   char *value_copy;
+  bool locked;
 
   VALIDATE_ARG_NOT_NULL( param );
 
-  lock_param( param );
+  locked = lock_param( param );
   value_copy = alloc_mem( param->value_length + 1 );
   if( !value_copy ) {
     goto cleanup_and_return;
@@ -86,58 +111,22 @@ stumpless_get_param_value( const struct stumpless_param *param ) {
   clear_error(  );
 
 cleanup_and_return:
-  unlock_param( param );
+  unlock_param( param, locked );
   return value_copy;
 }
 
 struct stumpless_param *
-stumpless_new_param( const char *name, const char *value ) {
-  struct stumpless_param *param;
-
-  VALIDATE_ARG_NOT_NULL( name );
-  VALIDATE_ARG_NOT_NULL( value );
+stumpless_new_arena_param( struct stumpless_arena *arena,
+                           const char *name,
+                           const char *value ) {
+  VALIDATE_ARG_NOT_NULL( arena );
 
-  if ( !validate_param_name( name ) ||
-       !validate_param_name_length( name )) {
-    goto fail;
-  }
-
-  param = alloc_mem( sizeof( *param ) );
-  if( !param ) {
-    goto fail;
-  }
-
-  param->name = copy_cstring_with_length( name, &( param->name_length ) );
-  if( !param->name ) {
-    goto fail_name;
-  }
-
-  param->value = copy_cstring_with_length( value, &( param->value_length ) );
-  if( !param->value ) {
-    goto fail_value;
-  }
-
-  config_assign_cached_mutex( param->mutex );
-  if( !config_check_mutex_valid( param->mutex ) ) {
-    goto fail_mutex;
-  }
-
-  config_init_journald_param( param );
-
-  clear_error(  );
-  return param;
-
-fail_mutex:
-  free_mem( param->value );
-
-fail_value:
-  free_mem( param->name );
-
-fail_name:
-  free_mem( param );
+  return new_param( arena, name, value );
+}
 
-fail:
-  return NULL;
+struct stumpless_param *
+stumpless_new_param( const char *name, const char *value ) {
+  return new_param( NULL, name, value );
 }
 
 struct stumpless_param *
@@ -145,6 +134,7 @@ stumpless_set_param_name( struct stumpless_param *param, const char *name ) {
   char *new_name;
   size_t new_size;
   const char *old_name;
+  size_t old_size;
 
   VALIDATE_ARG_NOT_NULL( param );
   VALIDATE_ARG_NOT_NULL( name );
@@ -154,18 +144,23 @@ stumpless_set_param_name( struct stumpless_param *param, const char *name ) {
     goto fail;
   }
 
-  new_name = copy_cstring_with_length( name, &new_size );
+  new_name = config_copy_name( param->arena, name, &new_size );
   if( !new_name ) {
     goto fail;
   }
 
-  lock_param( param );
+  if( !lock_mutable_param( param ) ) {
+    config_destroy_name( param->arena, new_name, new_size );
+    goto fail;
+  }
+
   old_name = param->name;
+  old_size = param->name_length;
   param->name = new_name;
   param->name_length = new_size;
-  unlock_param( param );
+  unlock_mutable_param( param );
 
-  free_mem( old_name );
+  config_destroy_name( param->arena, old_name, old_size );
   clear_error(  );
   return param;
 
@@ -175,30 +170,23 @@ fail:
 
 struct stumpless_param *
 stumpless_set_param_value( struct stumpless_param *param, const char *value ) {
-  char *new_value;
-  size_t new_size;
-  const char *old_value;
+  struct stumpless_param *result;
 
   VALIDATE_ARG_NOT_NULL( param );
   VALIDATE_ARG_NOT_NULL( value );
 
-  new_value = copy_cstring_with_length( value, &new_size );
-  if( !new_value ) {
-    goto fail;
+  if( !lock_mutable_param( param ) ) {
+    return NULL;
   }
 
-  lock_param( param );
-  old_value = param->value;
-  param->value = new_value;
-  param->value_length = new_size;
-  unlock_param( param );
+  result = locked_set_param_value( param, value );
+  unlock_mutable_param( param );
 
-  free_mem( old_value );
-  clear_error(  );
-  return param;
+  if( result ) {
+    clear_error(  );
+  }
 
-fail:
-  return NULL;
+  return result;
 }
 
 const char *
@@ -208,10 +196,11 @@ stumpless_param_to_string( const struct stumpless_param *param ) {
     const char *value;
     size_t value_len;
     size_t name_len;
+    bool locked;
 
     VALIDATE_ARG_NOT_NULL( param );
 
-    lock_param( param );
+    locked = lock_param( param );
 
     name  = param->name;
     value = param->value;
@@ -227,7 +216,7 @@ stumpless_param_to_string( const struct stumpless_param *param ) {
     memcpy(format + 1, name, name_len);
     memcpy(format + name_len + 4, value, value_len);
 
-    unlock_param( param );
+    unlock_param( param, locked );
 
     format[0] = '<';
     format[name_len + 1] = '>';
@@ -241,18 +230,197 @@ stumpless_param_to_string( const struct stumpless_param *param ) {
     return format;
 
 fail:
-    unlock_param( param );
+    unlock_param( param, locked );
     return NULL;
 }
 
 /* private functions */
 
 void
+destroy_param_value( const struct stumpless_param *param ) {
+  if( param->value != param->value_buffer ) {
+    arena_free_mem( param->arena, param->value, param->value_capacity );
+  }
+}
+
+bool
 lock_param( const struct stumpless_param *param ) {
-  config_lock_mutex( param->mutex );
+  // frozen is read once, so that the caller unlocks exactly what was locked
+  if( config_read_flag( &param->frozen ) ) {
+    return false;
+  }
+
+  config_read_lock_rwlock( param->mutex );
+  return true;
+}
+
+bool
+lock_mutable_param( struct stumpless_param *param ) {
+  // once frozen a param stays frozen, so there is no need to lock it to check
+  if( config_read_flag( &param->frozen ) ) {
+    raise_object_frozen(  );
+    return false;
+  }
+
+  config_write_lock_rwlock( param->mutex );
+
+  // the param may have been frozen while waiting for the lock
+  if( config_read_flag( &param->frozen ) ) {
+    config_write_unlock_rwlock( param->mutex );
+    raise_object_frozen(  );
+    return false;
+  }
+
+  return true;
+}
+
+struct stumpless_param *
+locked_reserve_param_value( struct stumpless_param *param, size_t size ) {
+  char *new_value;
+
+  if( size <= STUMPLESS_PARAM_VALUE_BUFFER_SIZE ||
+      size <= param->value_capacity ) {
+    return param;
+  }
+
+  new_value = arena_alloc_mem( param->arena, size );
+  if( !new_value ) {
+    return NULL;
+  }
+
+  memcpy( new_value, param->value, param->value_length + 1 );
+  destroy_param_value( param );
+  param->value = new_value;
+  param->value_capacity = size;
+
+  return param;
+}
+
+struct stumpless_param *
+locked_set_param_value( struct stumpless_param *param, const char *value ) {
+  size_t new_size;
+  char *new_value;
+
+  new_size = strlen( value );
+
+  // the new value may be part of the current value, so memmove is needed
+  if( new_size < STUMPLESS_PARAM_VALUE_BUFFER_SIZE ) {
+    memmove( param->value_buffer, value, new_size + 1 );
+    destroy_param_value( param );
+    param->value = param->value_buffer;
+    param->value_capacity = sizeof( param->value_buffer );
+
+  } else if( new_size < param->value_capacity ) {
+    memmove( param->value, value, new_size + 1 );
+
+  } else {
+    new_value = arena_alloc_mem( param->arena, new_size + 1 );
+    if( !new_value ) {
+      return NULL;
+    }
+
+    memcpy( new_value, value, new_size + 1 );
+    destroy_param_value( param );
+    param->value = new_value;
+    param->value_capacity = new_size + 1;
+  }
+
+  param->value_length = new_size;
+  return param;
+}
+
+struct stumpless_param *
+new_param( struct stumpless_arena *arena,
+           const char *name,
+           const char *value ) {
+  struct stumpless_param *param;
+
+  VALIDATE_ARG_NOT_NULL( name );
+  VALIDATE_ARG_NOT_NULL( value );
+
+  if ( !validate_param_name( name ) ||
+       !validate_param_name_length( name )) {
+    goto fail;
+  }
+
+  param = arena_alloc_mem( arena, sizeof( *param ) );
+  if( !param ) {
+    goto fail;
+  }
+
+  param->arena = arena;
+  param->name = config_copy_name( arena, name, &( param->name_length ) );
+  if( !param->name ) {
+    goto fail_name;
+  }
+
+  param->value_length = strlen( value );
+  if( param->value_length < STUMPLESS_PARAM_VALUE_BUFFER_SIZE ) {
+    memcpy( param->value_buffer, value, param->value_length + 1 );
+    param->value = param->value_buffer;
+    param->value_capacity = sizeof( param->value_buffer );
+
+  } else {
+    param->value = arena_copy_cstring_with_length( arena,
+                                                   value,
+                                                   &( param->value_length ) );
+    if( !param->value ) {
+      goto fail_value;
+    }
+    param->value_capacity = param->value_length + 1;
+  }
+
+  param->frozen = false;
+  param->reference_count = 1;
+
+  config_assign_arena_rwlock( param->mutex, arena );
+  if( !config_check_rwlock_valid( param->mutex ) ) {
+    goto fail_mutex;
+  }
+
+  config_init_journald_param( param );
+
+  clear_error(  );
+  return param;
+
+fail_mutex:
+  destroy_param_value( param );
+
+fail_value:
+  config_destroy_name( arena, param->name, param->name_length );
+
+fail_name:
+  arena_free_mem( arena, param, sizeof( *param ) );
+
+fail:
+  return NULL;
+}
+
+void
+retain_param( struct stumpless_param *param ) {
+  if( config_read_flag( &param->frozen ) ) {
+    config_increment_size( &param->reference_count );
+  }
+}
+
+struct stumpless_param *
+share_param( struct stumpless_param *param ) {
+  if( config_read_flag( &param->frozen ) && !param->arena ) {
+    config_increment_size( &param->reference_count );
+    return param;
+  }
+
+  return stumpless_copy_param( param );
+}
+
+void
+unlock_param( const struct stumpless_param *param, bool locked ) {
+  if( locked ) {
+    config_read_unlock_rwlock( param->mutex );
+  }
 }
 
 void
-unlock_param( const struct stumpless_param *param ) {
-  config_unlock_mutex( param->mutex );
+unlock_mutable_param( struct stumpless_param *param ) {
+  config_write_unlock_rwlock( param->mutex );
 }
@@ -18,13 +18,16 @@
 
 #include <stddef.h>
 #include <string.h>
+#include <stumpless/memory.h>
 #include "private/cache.h"
 #include "private/config/wrapper.h"
+#include "private/config/wrapper/thread_safety.h"
 #include "private/inthelper.h"
 #include "private/memory.h"
 #include "private/strbuilder.h"
 
 static struct cache *strbuilder_cache = NULL;
+static size_t buffer_bytes = 0;
 
 static void
 strbuilder_init( void *builder ) {
@@ -37,7 +40,10 @@ static void
 strbuilder_teardown( void *builder ) {
   const struct strbuilder *b = ( struct strbuilder * ) builder;
 
-  free_mem( b->buffer );
+  if( b->buffer ) {
+    config_subtract_size( &buffer_bytes, b->buffer_end - b->buffer );
+    free_sized_mem( b->buffer, b->buffer_end - b->buffer );
+  }
 }
 
 static size_t
@@ -58,6 +64,7 @@ increase_size( struct strbuilder *builder ) {
   builder->position = new_buffer + ( builder->position - old_buffer );
   builder->buffer = new_buffer;
   builder->buffer_end = new_buffer + new_size;
+  config_add_size( &buffer_bytes, new_size - old_size );
 
   return old_size;
 }
@@ -166,6 +173,12 @@ strbuilder_free_all( void ) {
   strbuilder_cache = NULL;
 }
 
+void
+strbuilder_get_usage( struct stumpless_memory_usage *usage ) {
+  cache_get_usage( strbuilder_cache, usage );
+  usage->bytes += config_read_size( &buffer_bytes );
+}
+
 char *
 strbuilder_get_buffer( struct strbuilder *builder, size_t * length ) {
   *length = builder->position - builder->buffer;
@@ -207,6 +220,7 @@ strbuilder_new( void ) {
     }
 
     builder->buffer_end = builder->buffer + size;
+    config_add_size( &buffer_bytes, size );
   }
 
   builder->position = builder->buffer;
@@ -26,6 +26,7 @@
 #include <stumpless/error.h>
 #include <stumpless/facility.h>
 #include <stumpless/filter.h>
+#include <stumpless/memory.h>
 #include <stumpless/option.h>
 #include <stumpless/severity.h>
 #include <stumpless/target.h>
@@ -38,6 +39,7 @@
 #include "private/config/network_support_wrapper.h"
 #include "private/config/locale/wrapper.h"
 #include "private/config/wrapper.h"
+#include "private/config/wrapper/async.h"
 #include "private/config/wrapper/journald.h"
 #include "private/config/wrapper/socket.h"
 #include "private/config/wrapper/thread_safety.h"
@@ -63,6 +65,8 @@ static config_atomic_ptr_t default_target = config_atomic_ptr_initializer;
 static config_atomic_ptr_t cons_stream = config_atomic_ptr_initializer;
 static config_atomic_bool_t cons_stream_free = config_atomic_bool_true;
 static config_atomic_bool_t cons_stream_valid = config_atomic_bool_false;
+static size_t target_bytes = 0;
+static size_t target_count = 0;
 
 /* per-thread static variables */
 static CONFIG_THREAD_LOCAL_STORAGE struct stumpless_entry *cached_entry = NULL;
@@ -76,100 +80,139 @@ close_unsupported_target( const struct stumpless_target *target ) {
   raise_target_unsupported( L10N_CLOSE_UNSUPPORTED_TARGET_ERROR_MESSAGE );
 }
 
+/**
+ * True if the formatted entries for the target can be concatenated and sent in
+ * a single write.
+ */
+static
+bool
+target_accepts_batches( const struct stumpless_target *target ) {
+  return target->type == STUMPLESS_FILE_TARGET ||
+         target->type == STUMPLESS_STREAM_TARGET;
+}
+
 int
-stumpless_add_entry( struct stumpless_target *target,
-                     const struct stumpless_entry *entry ) {
+stumpless_add_entries( struct stumpless_target *target,
+                       struct stumpless_entry * const *entries,
+                       size_t count ) {
   stumpless_filter_func_t filter;
-  struct strbuilder *builder = NULL;
-  size_t builder_length;
-  const char *buffer = NULL;
-  int result;
+  char timestamp[RFC_5424_TIMESTAMP_BUFFER_SIZE];
+  size_t timestamp_size;
+  struct strbuilder *builder;
+  const char *buffer;
+  size_t buffer_length;
+  size_t sent_count = 0;
+  int most_severe = STUMPLESS_SEVERITY_DEBUG;
+  int severity;
+  size_t i;
 
   VALIDATE_ARG_NOT_NULL_INT_RETURN( target );
-  VALIDATE_ARG_NOT_NULL_INT_RETURN( entry );
+  VALIDATE_ARG_NOT_NULL_INT_RETURN( entries );
 
   if( unlikely( !target->id ) ) {
     raise_invalid_id(  );
     return -1;
   }
 
-  filter = stumpless_get_target_filter( target );
-  if( filter && !filter( target, entry ) ) {
-    return 0;
+  for( i = 0; i < count; i++ ) {
+    VALIDATE_ARG_NOT_NULL_INT_RETURN( entries[i] );
   }
 
-  if( stumpless_get_option( target, STUMPLESS_OPTION_PERROR ) ){
-    builder = format_entry( entry, target );
-    if( !builder ) {
-      return -1;
+  filter = stumpless_get_target_filter( target );
+
+  if( !target_accepts_batches( target ) ) {
+    for( i = 0; i < count; i++ ) {
+      if( filter && !filter( target, entries[i] ) ) {
+        continue;
+      }
+
+      if( send_entry_to_target( target, entries[i] ) < 0 ) {
+        // the error is left set so that a partial batch can be told apart
+        // from a complete one
+        if( sent_count == 0 ) {
+          return -1;
+        }
+
+        return cap_size_t_to_int( sent_count );
+      }
+
+      sent_count++;
     }
-    buffer = strbuilder_get_buffer( builder, &builder_length );
-    write_to_error_stream( buffer, builder_length );
-  }
 
-  // function targets are not formatted
-  if( target->type == STUMPLESS_FUNCTION_TARGET ) {
-    result = send_entry_to_function_target( target, entry );
-    goto finish;
+    clear_error(  );
+    return cap_size_t_to_int( sent_count );
   }
 
-  // journald targets are not formatted
-  if( target->type == STUMPLESS_JOURNALD_TARGET ) {
-    result = config_send_entry_to_journald_target( target, entry );
-    goto finish;
-  }
+  // do this as soon as possible to be closer to invocation
+  timestamp_size = config_get_now( timestamp );
 
-  // windows targets are not formatted in code
-  // instead their formatting comes from message text files
-  if( target->type == STUMPLESS_WINDOWS_EVENT_LOG_TARGET ) {
-    result = config_send_entry_to_wel_target( target->id, entry );
-    goto finish;
+  builder = strbuilder_new(  );
+  if( !builder ) {
+    return -1;
   }
 
-  // entry was not formatted before
-  if( !buffer ){
-    builder = format_entry( entry, target );
-    if( !builder ) {
-      return -1;
+  for( i = 0; i < count; i++ ) {
+    if( filter && !filter( target, entries[i] ) ) {
+      continue;
     }
-    buffer = strbuilder_get_buffer( builder, &builder_length );
+
+    if( !append_formatted_entry( builder,
+                                 entries[i],
+                                 target,
+                                 timestamp,
+                                 timestamp_size ) ) {
+      goto fail;
+    }
+
+    severity = stumpless_get_entry_severity( entries[i] );
+    if( severity < most_severe ) {
+      most_severe = severity;
+    }
+
+    sent_count++;
   }
 
-  switch ( target->type ) {
+  if( sent_count > 0 ) {
+    buffer = strbuilder_get_buffer( builder, &buffer_length );
 
-    case STUMPLESS_BUFFER_TARGET:
-      result = sendto_buffer_target( target->id, buffer, builder_length );
-      break;
+    if( stumpless_get_option( target, STUMPLESS_OPTION_PERROR ) ) {
+      write_to_error_stream( buffer, buffer_length );
+    }
 
-    case STUMPLESS_FILE_TARGET:
-      result = sendto_file_target( target->id, buffer, builder_length );
-      break;
+    if( sendto_target( target, buffer, buffer_length ) < 0 ||
+        flush_target_for_severity( target, most_severe ) != 0 ) {
+      goto fail;
+    }
+  }
 
-    case STUMPLESS_NETWORK_TARGET:
-      result = config_sendto_network_target( target->id,
-                                             buffer,
-                                             builder_length );
-      break;
+  strbuilder_destroy( builder );
+  clear_error(  );
+  return cap_size_t_to_int( sent_count );
 
-    case STUMPLESS_SOCKET_TARGET:
-      result = config_sendto_socket_target( target->id,
-                                            buffer,
-                                            builder_length );
-      break;
+fail:
+  strbuilder_destroy( builder );
+  return -1;
+}
 
-    case STUMPLESS_STREAM_TARGET:
-      result = sendto_stream_target( target->id, buffer, builder_length );
-      break;
+int
+stumpless_add_entry( struct stumpless_target *target,
+                     const struct stumpless_entry *entry ) {
+  stumpless_filter_func_t filter;
 
-    default:
-      result = sendto_unsupported_target( target, buffer, builder_length );
+  VALIDATE_ARG_NOT_NULL_INT_RETURN( target );
+  VALIDATE_ARG_NOT_NULL_INT_RETURN( entry );
+
+  if( unlikely( !target->id ) ) {
+    raise_invalid_id(  );
+    return -1;
   }
 
-finish:
-  if( builder ) {
-    strbuilder_destroy( builder );
+  filter = stumpless_get_target_filter( target );
+  if( filter && !filter( target, entry ) ) {
+    return 0;
   }
-  return result;
+
+  return send_entry_to_target( target, entry );
 }
 
 int
@@ -261,6 +304,10 @@ stumpless_close_target( struct stumpless_target *target ) {
   clear_error(  );
 
   switch( target->type ) {
+    case STUMPLESS_ASYNC_TARGET:
+      config_close_async_target( target );
+      break;
+
     case STUMPLESS_BUFFER_TARGET:
       stumpless_close_buffer_target( target );
       break;
@@ -299,6 +346,33 @@ stumpless_close_target( struct stumpless_target *target ) {
   }
 }
 
+struct stumpless_target *
+stumpless_flush_target( struct stumpless_target *target ) {
+  struct stumpless_target *wrapped;
+
+  VALIDATE_ARG_NOT_NULL( target );
+
+  if( target->type == STUMPLESS_ASYNC_TARGET ) {
+    wrapped = config_flush_async_target( target );
+    if( wrapped && !stumpless_flush_target( wrapped ) ) {
+      return NULL;
+    }
+  }
+
+  if( target->type == STUMPLESS_FILE_TARGET &&
+      flush_file_target( target->id ) != 0 ) {
+    return NULL;
+  }
+
+  if( target->type == STUMPLESS_STREAM_TARGET &&
+      flush_stream_target( target->id ) != 0 ) {
+    return NULL;
+  }
+
+  clear_error(  );
+  return target;
+}
+
 struct stumpless_target *
 stumpless_get_current_target( void ) {
   struct stumpless_target *result;
@@ -791,9 +865,19 @@ vstumpless_add_log( struct stumpless_target *target,
                     const char *message,
                     va_list subs ) {
   const struct stumpless_entry *set_result;
+  int result;
 
   VALIDATE_ARG_NOT_NULL_INT_RETURN( target );
 
+  if( target->type == STUMPLESS_ASYNC_TARGET &&
+      config_send_deferred_log_to_async_target( target,
+                                                priority,
+                                                message,
+                                                subs,
+                                                &result ) ) {
+    return result;
+  }
+
   // TODO it would be better for the cached entry to be a static buffer instead
   // of heap allocated. This can be done once a way to create an entry within a
   // given buffer is exposed.
@@ -911,14 +995,32 @@ void
 destroy_target( const struct stumpless_target *target ) {
   config_compare_exchange_ptr( &current_target, target, NULL );
 
+  config_subtract_size( &target_bytes,
+                        sizeof( *target ) + target->name_length + 1 );
+  config_decrement_size( &target_count );
+
   config_destroy_cached_mutex( target->mutex );
-  free_mem( target->name );
-  free_mem( target );
+  free_sized_mem( target->name, target->name_length + 1 );
+  free_sized_mem( target, sizeof( *target ) );
+}
+
+int
+flush_target_for_severity( const struct stumpless_target *target,
+                           int severity ) {
+  if( target->type == STUMPLESS_FILE_TARGET ) {
+    return flush_file_target_for_severity( target->id, severity );
+  }
+
+  if( target->type == STUMPLESS_STREAM_TARGET ) {
+    return flush_stream_target_for_severity( target->id, severity );
+  }
+
+  return 0;
 }
 
 void
 lock_target( const struct stumpless_target *target ) {
-  config_lock_mutex( target->mutex );
+  config_lock_cached_mutex( target->mutex );
 }
 
 struct stumpless_target *
@@ -951,6 +1053,9 @@ new_target( enum stumpless_target_type type, const char *name ) {
   target->mask = STUMPLESS_SEVERITY_MASK_UPTO( STUMPLESS_SEVERITY_DEBUG_VALUE );
   target->filter = stumpless_mask_filter;
 
+  config_add_size( &target_bytes, sizeof( *target ) + target->name_length + 1 );
+  config_increment_size( &target_count );
+
   return target;
 
 fail_mutex:
@@ -969,6 +1074,73 @@ open_unsupported_target( struct stumpless_target *target ) {
   return NULL;
 }
 
+int
+send_entry_to_target( const struct stumpless_target *target,
+                      const struct stumpless_entry *entry ) {
+  struct strbuilder *builder = NULL;
+  size_t builder_length;
+  const char *buffer = NULL;
+  int severity;
+  int result;
+
+  if( stumpless_get_option( target, STUMPLESS_OPTION_PERROR ) ){
+    builder = format_entry( entry, target );
+    if( !builder ) {
+      return -1;
+    }
+    buffer = strbuilder_get_buffer( builder, &builder_length );
+    write_to_error_stream( buffer, builder_length );
+  }
+
+  // async targets hand the entry off to their writer thread
+  if( target->type == STUMPLESS_ASYNC_TARGET ) {
+    result = config_send_entry_to_async_target( target, entry );
+    goto finish;
+  }
+
+  // function targets are not formatted
+  if( target->type == STUMPLESS_FUNCTION_TARGET ) {
+    result = send_entry_to_function_target( target, entry );
+    goto finish;
+  }
+
+  // journald targets are not formatted
+  if( target->type == STUMPLESS_JOURNALD_TARGET ) {
+    result = config_send_entry_to_journald_target( target, entry );
+    goto finish;
+  }
+
+  // windows targets are not formatted in code
+  // instead their formatting comes from message text files
+  if( target->type == STUMPLESS_WINDOWS_EVENT_LOG_TARGET ) {
+    result = config_send_entry_to_wel_target( target->id, entry );
+    goto finish;
+  }
+
+  // entry was not formatted before
+  if( !buffer ){
+    builder = format_entry( entry, target );
+    if( !builder ) {
+      return -1;
+    }
+    buffer = strbuilder_get_buffer( builder, &builder_length );
+  }
+
+  result = sendto_target( target, buffer, builder_length );
+  if( result >= 0 && target_accepts_batches( target ) ) {
+    severity = stumpless_get_entry_severity( entry );
+    if( flush_target_for_severity( target, severity ) != 0 ) {
+      result = -1;
+    }
+  }
+
+finish:
+  if( builder ) {
+    strbuilder_destroy( builder );
+  }
+  return result;
+}
+
 int
 send_entry_to_unsupported_target( const struct stumpless_target *target,
                                   const struct stumpless_entry *entry ) {
@@ -981,6 +1153,32 @@ send_entry_to_unsupported_target( const struct stumpless_target *target,
   return -1;
 }
 
+int
+sendto_target( const struct stumpless_target *target,
+               const char *msg,
+               size_t msg_length ) {
+  switch ( target->type ) {
+
+    case STUMPLESS_BUFFER_TARGET:
+      return sendto_buffer_target( target->id, msg, msg_length );
+
+    case STUMPLESS_FILE_TARGET:
+      return sendto_file_target( target->id, msg, msg_length );
+
+    case STUMPLESS_NETWORK_TARGET:
+      return config_sendto_network_target( target->id, msg, msg_length );
+
+    case STUMPLESS_SOCKET_TARGET:
+      return config_sendto_socket_target( target->id, msg, msg_length );
+
+    case STUMPLESS_STREAM_TARGET:
+      return sendto_stream_target( target->id, msg, msg_length );
+
+    default:
+      return sendto_unsupported_target( target, msg, msg_length );
+  }
+}
+
 int
 sendto_unsupported_target( const struct stumpless_target *target,
                            const char *msg,
@@ -1010,9 +1208,29 @@ target_free_thread( void ) {
   cached_trace = NULL;
 }
 
+bool
+target_is_unformatted( const struct stumpless_target *target ) {
+  switch( target->type ) {
+    case STUMPLESS_ASYNC_TARGET:
+    case STUMPLESS_FUNCTION_TARGET:
+    case STUMPLESS_JOURNALD_TARGET:
+    case STUMPLESS_WINDOWS_EVENT_LOG_TARGET:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+void
+target_get_usage( struct stumpless_memory_usage *usage ) {
+  usage->bytes += config_read_size( &target_bytes );
+  usage->count += config_read_size( &target_count );
+}
+
 void
 unlock_target( const struct stumpless_target *target ) {
-  config_unlock_mutex( target->mutex );
+  config_unlock_cached_mutex( target->mutex );
 }
 
 int
@@ -0,0 +1,1094 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stumpless/entry.h>
+#include <stumpless/filter.h>
+#include <stumpless/memory.h>
+#include <stumpless/option.h>
+#include <stumpless/severity.h>
+#include <stumpless/target.h>
+#include <stumpless/target/async.h>
+#include "private/config/locale/wrapper.h"
+#include "private/config/wrapper.h"
+#include "private/config/wrapper/thread_safety.h"
+#include "private/deferred.h"
+#include "private/error.h"
+#include "private/formatter.h"
+#include "private/memory.h"
+#include "private/severity.h"
+#include "private/strbuilder.h"
+#include "private/target.h"
+#include "private/target/async.h"
+#include "private/validate.h"
+
+/* global static variables */
+static size_t queue_bytes = 0;
+static size_t queue_count = 0;
+
+static size_t
+get_pool_bytes( const struct deferred_pool *pool ) {
+  if( !pool ) {
+    return 0;
+  }
+
+  return sizeof( *pool ) +
+         ( ( sizeof( *pool->slots ) + pool->record_size ) * pool->capacity );
+}
+
+static size_t
+get_queue_bytes( const struct async_target *async ) {
+  return sizeof( *async ) +
+         ( sizeof( *async->slots ) * async->capacity ) +
+         async->writer_buffer_size +
+         get_pool_bytes( async->deferred_pool );
+}
+
+static struct async_slot *
+get_slot( const struct async_target *async, size_t position ) {
+  return &async->slots[position & ( async->capacity - 1 )];
+}
+
+/*
+ * True if the slot at the next enqueue position still holds a message that
+ * the writer thread has not taken. This uses sequentially consistent loads so
+ * that a producer that registers itself as waiting and then sees a full queue
+ * is guaranteed to be woken by the writer thread.
+ */
+static bool
+queue_is_full( const struct async_target *async ) {
+  size_t position;
+  size_t sequence;
+
+  position = atomic_load( &async->enqueue_position );
+  sequence = atomic_load( &get_slot( async, position )->sequence );
+
+  return ( intptr_t ) ( sequence - position ) < 0;
+}
+
+static bool
+message_is_ready( const struct async_target *async ) {
+  size_t position;
+
+  position = atomic_load( &async->dequeue_position );
+
+  return atomic_load( &get_slot( async, position )->sequence ) == position + 1;
+}
+
+/*
+ * The number of messages in the queue. The dequeue position is read first so
+ * that the depth is never negative, and then retried until it is unchanged so
+ * that the two positions are from the same point in time.
+ */
+static size_t
+get_depth( const struct async_target *async ) {
+  size_t dequeue_position;
+  size_t previous_position;
+  size_t enqueue_position;
+
+  dequeue_position = atomic_load( &async->dequeue_position );
+  do {
+    previous_position = dequeue_position;
+    enqueue_position = atomic_load( &async->enqueue_position );
+    dequeue_position = atomic_load( &async->dequeue_position );
+  } while( dequeue_position != previous_position );
+
+  return enqueue_position - dequeue_position;
+}
+
+/*
+ * True if the message at the front of the queue has been published and is
+ * less severe than the given severity, meaning that it could be dropped to make
+ * room for a new message of that severity.
+ */
+static bool
+oldest_is_less_severe( const struct async_target *async, int severity ) {
+  size_t position;
+  const struct async_slot *slot;
+
+  position = atomic_load( &async->dequeue_position );
+  slot = get_slot( async, position );
+
+  return atomic_load( &slot->sequence ) == position + 1 &&
+         atomic_load_explicit( &slot->severity, memory_order_relaxed ) >
+           severity;
+}
+
+static void
+count_drop( struct async_target *async, int severity ) {
+  atomic_fetch_add( &async->drop_counts[severity], 1 );
+}
+
+static void
+destroy_message( const struct async_message *message ) {
+  if( message->entry ) {
+    stumpless_destroy_entry_and_contents( message->entry );
+  } else if( message->builder ) {
+    strbuilder_destroy( message->builder );
+  } else {
+    destroy_deferred_log( message->deferred );
+  }
+}
+
+/*
+ * Claims the next position in the queue without blocking, returning NULL if
+ * the queue is full.
+ */
+static struct async_slot *
+try_claim_slot( struct async_target *async, size_t *position ) {
+  struct async_slot *slot;
+  size_t current;
+  intptr_t difference;
+
+  current = atomic_load_explicit( &async->enqueue_position,
+                                  memory_order_relaxed );
+  for( ;; ) {
+    slot = get_slot( async, current );
+    difference = ( intptr_t ) ( atomic_load_explicit( &slot->sequence,
+                                                      memory_order_acquire ) -
+                                current );
+
+    if( difference == 0 ) {
+      if( atomic_compare_exchange_weak_explicit( &async->enqueue_position,
+                                                 &current,
+                                                 current + 1,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed ) ) {
+        *position = current;
+        return slot;
+      }
+
+    } else if( difference < 0 ) {
+      return NULL;
+
+    } else {
+      current = atomic_load_explicit( &async->enqueue_position,
+                                      memory_order_relaxed );
+    }
+  }
+}
+
+/*
+ * Takes the next message from the queue if it is less severe than the given
+ * severity, returning false if it is not, if the queue is empty, or if the
+ * next message has not been published yet.
+ */
+static bool
+take_less_severe_message( struct async_target *async,
+                          int severity,
+                          size_t *position,
+                          struct async_message *message ) {
+  struct async_slot *slot;
+  size_t current;
+  intptr_t difference;
+
+  current = atomic_load_explicit( &async->dequeue_position,
+                                  memory_order_relaxed );
+  for( ;; ) {
+    slot = get_slot( async, current );
+    difference = ( intptr_t ) ( atomic_load_explicit( &slot->sequence,
+                                                      memory_order_acquire ) -
+                                ( current + 1 ) );
+
+    if( difference == 0 ) {
+      if( atomic_load_explicit( &slot->severity, memory_order_relaxed ) <=
+            severity ) {
+        return false;
+      }
+
+      if( atomic_compare_exchange_weak_explicit( &async->dequeue_position,
+                                                 &current,
+                                                 current + 1,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed ) ) {
+        break;
+      }
+
+    } else if( difference < 0 ) {
+      return false;
+
+    } else {
+      current = atomic_load_explicit( &async->dequeue_position,
+                                      memory_order_relaxed );
+    }
+  }
+
+  *position = current;
+  *message = slot->message;
+
+  atomic_store( &slot->sequence, current + async->capacity );
+
+  if( atomic_load( &async->waiting_producers ) > 0 ) {
+    config_lock_mutex( &async->mutex );
+    config_broadcast_cond( &async->space_available );
+    config_unlock_mutex( &async->mutex );
+  }
+
+  return true;
+}
+
+/*
+ * Takes the next message from the queue, returning false if it is empty or the
+ * next message has not been published yet.
+ */
+static bool
+take_message( struct async_target *async,
+              size_t *position,
+              struct async_message *message ) {
+  // every severity is less severe than this
+  return take_less_severe_message( async, -1, position, message );
+}
+
+/*
+ * Waits until the writer thread makes room in the queue if it is full. If
+ * deadline is not zero and it passes first, then false is returned.
+ */
+static bool
+wait_for_space( struct async_target *async, unsigned long long deadline ) {
+  bool timed_out = false;
+
+  config_lock_mutex( &async->mutex );
+  atomic_fetch_add( &async->waiting_producers, 1 );
+  if( queue_is_full( async ) ) {
+    if( deadline == 0 ) {
+      config_wait_cond( &async->space_available, &async->mutex );
+    } else {
+      timed_out = !config_timed_wait_cond( &async->space_available,
+                                           &async->mutex,
+                                           deadline );
+    }
+  }
+  atomic_fetch_sub( &async->waiting_producers, 1 );
+  config_unlock_mutex( &async->mutex );
+
+  return !timed_out;
+}
+
+/*
+ * Claims the next position in the queue, waiting for room if it is full. If
+ * timeout is not zero and no room is made within that many milliseconds, then
+ * NULL is returned.
+ */
+static struct async_slot *
+wait_for_slot( struct async_target *async,
+               size_t *position,
+               unsigned int timeout ) {
+  struct async_slot *slot;
+  unsigned long long deadline = 0;
+  bool timed_out = false;
+
+  if( timeout != 0 ) {
+    deadline = config_get_monotonic_milliseconds(  ) + timeout;
+  }
+
+  for( ;; ) {
+    slot = try_claim_slot( async, position );
+    if( slot || timed_out ) {
+      return slot;
+    }
+
+    timed_out = !wait_for_space( async, deadline );
+  }
+}
+
+/*
+ * Claims the next position in the queue, dropping the oldest messages in it
+ * until there is room.
+ */
+static struct async_slot *
+claim_slot_dropping_oldest( struct async_target *async, size_t *position ) {
+  struct async_slot *slot;
+  size_t oldest_position;
+  struct async_message oldest;
+
+  for( ;; ) {
+    slot = try_claim_slot( async, position );
+    if( slot ) {
+      return slot;
+    }
+
+    if( take_message( async, &oldest_position, &oldest ) ) {
+      destroy_message( &oldest );
+      count_drop( async, oldest.severity );
+    } else {
+      // the oldest message is still being added by another thread
+      sched_yield(  );
+    }
+  }
+}
+
+/*
+ * Claims the next position in the queue for a message of the given severity,
+ * dropping the oldest messages in it while they are less severe. If the oldest
+ * message is as severe or more, then NULL is returned right away for messages
+ * less severe than critical, and after waiting for room for up to the block
+ * timeout, or ASYNC_SEVERE_BLOCK_TIMEOUT if there is none, for the rest.
+ */
+static struct async_slot *
+claim_slot_dropping_less_severe( struct async_target *async,
+                                 int severity,
+                                 size_t *position ) {
+  struct async_slot *slot;
+  size_t oldest_position;
+  struct async_message oldest;
+  unsigned int timeout;
+  unsigned long long deadline = 0;
+
+  for( ;; ) {
+    slot = try_claim_slot( async, position );
+    if( slot ) {
+      return slot;
+    }
+
+    if( take_less_severe_message( async,
+                                  severity,
+                                  &oldest_position,
+                                  &oldest ) ) {
+      destroy_message( &oldest );
+      count_drop( async, oldest.severity );
+      continue;
+    }
+
+    if( severity > STUMPLESS_SEVERITY_CRIT_VALUE ) {
+      return NULL;
+    }
+
+    if( deadline == 0 ) {
+      timeout = atomic_load( &async->block_timeout );
+      if( timeout == 0 ) {
+        timeout = ASYNC_SEVERE_BLOCK_TIMEOUT;
+      }
+      deadline = config_get_monotonic_milliseconds(  ) + timeout;
+    }
+
+    if( !wait_for_space( async, deadline ) ) {
+      return try_claim_slot( async, position );
+    }
+  }
+}
+
+/*
+ * Claims the next position in the queue according to the overflow policy,
+ * returning NULL if the message should be dropped instead.
+ */
+static struct async_slot *
+claim_slot( struct async_target *async, int severity, size_t *position ) {
+  switch( atomic_load( &async->overflow_policy ) ) {
+    case STUMPLESS_ASYNC_OVERFLOW_DROP_NEWEST:
+      return try_claim_slot( async, position );
+
+    case STUMPLESS_ASYNC_OVERFLOW_DROP_OLDEST:
+      return claim_slot_dropping_oldest( async, position );
+
+    case STUMPLESS_ASYNC_OVERFLOW_DROP_LOWEST_SEVERITY:
+      return claim_slot_dropping_less_severe( async, severity, position );
+
+    default:
+      return wait_for_slot( async,
+                            position,
+                            atomic_load( &async->block_timeout ) );
+  }
+}
+
+/*
+ * True if a new message of the given severity should be dropped without being
+ * formatted, because the lowest severity policy is in use, the queue is full,
+ * and the message could neither replace the oldest one nor wait for room.
+ */
+static bool
+message_is_shed( const struct async_target *async, int severity ) {
+  return atomic_load( &async->overflow_policy ) ==
+           STUMPLESS_ASYNC_OVERFLOW_DROP_LOWEST_SEVERITY &&
+         severity > STUMPLESS_SEVERITY_CRIT_VALUE &&
+         queue_is_full( async ) &&
+         !oldest_is_less_severe( async, severity );
+}
+
+/*
+ * True if the filter of the target can be applied using only the severity of
+ * a message, without an entry.
+ */
+static bool
+filter_can_be_deferred( const struct stumpless_target *target ) {
+  stumpless_filter_func_t filter;
+
+  filter = stumpless_get_target_filter( target );
+  return !filter || filter == stumpless_mask_filter;
+}
+
+static bool
+passes_mask( const struct stumpless_target *target, int severity ) {
+  if( !stumpless_get_target_filter( target ) ) {
+    return true;
+  }
+
+  return ( STUMPLESS_SEVERITY_MASK( severity ) &
+           stumpless_get_target_mask( target ) ) != 0;
+}
+
+static void
+publish_slot( struct async_target *async,
+              struct async_slot *slot,
+              size_t position ) {
+  atomic_store( &slot->sequence, position + 1 );
+
+  if( atomic_load( &async->writer_sleeping ) ) {
+    config_lock_mutex( &async->mutex );
+    config_signal_cond( &async->message_added );
+    config_unlock_mutex( &async->mutex );
+  }
+}
+
+/*
+ * Adds a message to the queue according to the overflow policy, destroying it
+ * and counting it as dropped if there is no room.
+ */
+static void
+queue_message( struct async_target *async,
+               const struct async_message *message ) {
+  struct async_slot *slot;
+  size_t position;
+
+  slot = claim_slot( async, message->severity, &position );
+  if( !slot ) {
+    destroy_message( message );
+    count_drop( async, message->severity );
+    return;
+  }
+
+  slot->message = *message;
+  atomic_store_explicit( &slot->severity,
+                         message->severity,
+                         memory_order_relaxed );
+  publish_slot( async, slot, position );
+}
+
+/*
+ * Moves the finished position of the queue forward, waking any threads waiting
+ * in a flush. Only the writer thread may call this.
+ */
+static void
+finish_messages( struct async_target *async, size_t position ) {
+  if( position <= atomic_load( &async->finished_position ) ) {
+    return;
+  }
+
+  atomic_store( &async->finished_position, position );
+
+  if( atomic_load( &async->waiting_flushers ) > 0 ) {
+    config_lock_mutex( &async->mutex );
+    config_broadcast_cond( &async->message_sent );
+    config_unlock_mutex( &async->mutex );
+  }
+}
+
+static void
+send_builder( struct async_target *async,
+              struct strbuilder *builder,
+              int severity ) {
+  const char *buffer;
+  size_t length;
+
+  buffer = strbuilder_get_buffer( builder, &length );
+  if( sendto_target( async->wrapped, buffer, length ) >= 0 ) {
+    flush_target_for_severity( async->wrapped, severity );
+  }
+}
+
+/*
+ * Formats a deferred log into the entry kept by the writer thread and sends
+ * it. Failures are ignored, as there is no caller to report them to.
+ */
+static void
+send_deferred_log( struct async_target *async,
+                   const struct deferred_log *deferred ) {
+  struct stumpless_entry *entry;
+  char timestamp[RFC_5424_TIMESTAMP_BUFFER_SIZE];
+  size_t timestamp_size;
+  size_t old_buffer_size;
+  struct strbuilder *builder;
+  const char *buffer;
+  size_t length;
+
+  if( !async->writer_entry ) {
+    async->writer_entry = stumpless_new_entry_str( STUMPLESS_FACILITY_USER,
+                                                   STUMPLESS_SEVERITY_INFO,
+                                                   NULL,
+                                                   NULL,
+                                                   NULL );
+    if( !async->writer_entry ) {
+      return;
+    }
+  }
+
+  old_buffer_size = async->writer_buffer_size;
+  if( format_deferred_log( deferred,
+                           &async->writer_buffer,
+                           &async->writer_buffer_size ) < 0 ) {
+    return;
+  }
+  config_add_size( &queue_bytes,
+                   async->writer_buffer_size - old_buffer_size );
+
+  entry = stumpless_set_entry_message_str( async->writer_entry,
+                                           async->writer_buffer );
+  if( !entry ) {
+    return;
+  }
+
+  // the writer entry is never shared, so it does not need to be locked
+  entry->prival = deferred->prival;
+  memcpy( entry->app_name,
+          deferred->app_name,
+          deferred->app_name_length + 1 );
+  entry->app_name_length = deferred->app_name_length;
+  memcpy( entry->msgid, deferred->msgid, deferred->msgid_length + 1 );
+  entry->msgid_length = deferred->msgid_length;
+
+  if( target_is_unformatted( async->wrapped ) ) {
+    send_entry_to_target( async->wrapped, entry );
+    return;
+  }
+
+  timestamp_size = config_format_time( timestamp, &deferred->timestamp );
+  builder = format_entry_with_timestamp( entry,
+                                         async->wrapped,
+                                         timestamp,
+                                         timestamp_size );
+  if( !builder ) {
+    return;
+  }
+
+  if( stumpless_get_option( async->wrapped, STUMPLESS_OPTION_PERROR ) ) {
+    buffer = strbuilder_get_buffer( builder, &length );
+    write_to_error_stream( buffer, length );
+  }
+
+  send_builder( async, builder, get_severity( deferred->prival ) );
+  strbuilder_destroy( builder );
+}
+
+static void
+send_message( struct async_target *async,
+              const struct async_message *message ) {
+  if( message->entry ) {
+    send_entry_to_target( async->wrapped, message->entry );
+  } else if( message->builder ) {
+    send_builder( async, message->builder, message->severity );
+  } else {
+    send_deferred_log( async, message->deferred );
+  }
+
+  destroy_message( message );
+}
+
+static void *
+run_writer( void *arg ) {
+  struct async_target *async = arg;
+  size_t position;
+  struct async_message message;
+
+  for( ;; ) {
+    while( take_message( async, &position, &message ) ) {
+      send_message( async, &message );
+      finish_messages( async, position + 1 );
+    }
+
+    // any other messages taken from the queue by now were dropped
+    finish_messages( async, atomic_load( &async->dequeue_position ) );
+
+    config_lock_mutex( &async->mutex );
+    atomic_store( &async->writer_sleeping, true );
+    while( !message_is_ready( async ) && !atomic_load( &async->stopping ) ) {
+      config_wait_cond( &async->message_added, &async->mutex );
+    }
+    atomic_store( &async->writer_sleeping, false );
+    config_unlock_mutex( &async->mutex );
+
+    // the queue is drained before stopping so that close does not lose logs
+    if( !message_is_ready( async ) && atomic_load( &async->stopping ) ) {
+      break;
+    }
+  }
+
+  stumpless_free_thread(  );
+  return NULL;
+}
+
+static void
+destroy_async_target( struct async_target *async ) {
+  config_subtract_size( &queue_bytes, get_queue_bytes( async ) );
+  config_decrement_size( &queue_count );
+
+  config_destroy_cond( &async->message_sent );
+  config_destroy_cond( &async->space_available );
+  config_destroy_cond( &async->message_added );
+  config_destroy_mutex( &async->mutex );
+  stumpless_destroy_entry_and_contents( async->writer_entry );
+  free_sized_mem( async->writer_buffer, async->writer_buffer_size );
+  destroy_deferred_pool( async->deferred_pool );
+  free_sized_mem( async->slots, sizeof( *async->slots ) * async->capacity );
+  free_sized_mem( async, sizeof( *async ) );
+}
+
+static struct async_target *
+new_async_target( struct stumpless_target *wrapped, size_t queue_size ) {
+  struct async_target *async;
+  size_t capacity;
+  size_t i;
+  int result;
+
+  if( queue_size == 0 ) {
+    queue_size = STUMPLESS_DEFAULT_ASYNC_QUEUE_SIZE;
+  }
+
+  // a queue this large could never be allocated, and rounding it up would
+  // overflow the capacity
+  if( queue_size > SIZE_MAX / 2 / sizeof( *async->slots ) ) {
+    raise_memory_allocation_failure(  );
+    goto fail;
+  }
+
+  // a single slot could not tell a queued message apart from a free slot
+  capacity = 2;
+  while( capacity < queue_size ) {
+    capacity <<= 1;
+  }
+
+  async = alloc_mem( sizeof( *async ) );
+  if( !async ) {
+    goto fail;
+  }
+
+  async->slots = alloc_mem( sizeof( *async->slots ) * capacity );
+  if( !async->slots ) {
+    goto fail_slots;
+  }
+
+  for( i = 0; i < capacity; i++ ) {
+    atomic_init( &async->slots[i].sequence, i );
+    atomic_init( &async->slots[i].severity, 0 );
+    async->slots[i].message.entry = NULL;
+    async->slots[i].message.builder = NULL;
+    async->slots[i].message.deferred = NULL;
+    async->slots[i].message.severity = 0;
+  }
+
+  for( i = 0; i <= STUMPLESS_SEVERITY_DEBUG_VALUE; i++ ) {
+    atomic_init( &async->drop_counts[i], 0 );
+  }
+
+  async->wrapped = wrapped;
+  async->capacity = capacity;
+  atomic_init( &async->enqueue_position, 0 );
+  atomic_init( &async->dequeue_position, 0 );
+  atomic_init( &async->finished_position, 0 );
+  atomic_init( &async->overflow_policy, STUMPLESS_ASYNC_OVERFLOW_BLOCK );
+  atomic_init( &async->block_timeout, 0 );
+  atomic_init( &async->deferred_formatting, false );
+  async->deferred_pool = NULL;
+  async->writer_entry = NULL;
+  async->writer_buffer = NULL;
+  async->writer_buffer_size = 0;
+  atomic_init( &async->stopping, false );
+  atomic_init( &async->writer_sleeping, false );
+  atomic_init( &async->waiting_producers, 0 );
+  atomic_init( &async->waiting_flushers, 0 );
+  config_init_mutex( &async->mutex );
+  config_init_cond( &async->message_added );
+  config_init_cond( &async->space_available );
+  config_init_cond( &async->message_sent );
+
+  config_add_size( &queue_bytes, get_queue_bytes( async ) );
+  config_increment_size( &queue_count );
+
+  result = pthread_create( &async->writer, NULL, run_writer, async );
+  if( result != 0 ) {
+    raise_thread_failure( result );
+    destroy_async_target( async );
+    goto fail;
+  }
+
+  return async;
+
+fail_slots:
+  free_sized_mem( async, sizeof( *async ) );
+fail:
+  return NULL;
+}
+
+void
+stumpless_close_async_target( const struct stumpless_target *target ) {
+  struct async_target *async;
+
+  if( !target ) {
+    raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "target" ) );
+    return;
+  }
+
+  if( target->type != STUMPLESS_ASYNC_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return;
+  }
+
+  async = target->id;
+
+  config_lock_mutex( &async->mutex );
+  atomic_store( &async->stopping, true );
+  config_signal_cond( &async->message_added );
+  config_unlock_mutex( &async->mutex );
+  pthread_join( async->writer, NULL );
+
+  destroy_async_target( async );
+  destroy_target( target );
+  clear_error(  );
+}
+
+size_t
+stumpless_get_async_drop_count( const struct stumpless_target *target,
+                                enum stumpless_severity severity ) {
+  struct async_target *async;
+
+  if( !target ) {
+    raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "target" ) );
+    return 0;
+  }
+
+  if( target->type != STUMPLESS_ASYNC_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return 0;
+  }
+
+  if( severity_is_invalid( severity ) ) {
+    raise_invalid_severity( severity );
+    return 0;
+  }
+
+  async = target->id;
+
+  clear_error(  );
+  return atomic_load( &async->drop_counts[severity] );
+}
+
+size_t
+stumpless_get_async_queue_depth( const struct stumpless_target *target ) {
+  const struct async_target *async;
+
+  if( !target ) {
+    raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "target" ) );
+    return 0;
+  }
+
+  if( target->type != STUMPLESS_ASYNC_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return 0;
+  }
+
+  async = target->id;
+
+  clear_error(  );
+  return get_depth( async );
+}
+
+size_t
+stumpless_get_async_total_drop_count( const struct stumpless_target *target ) {
+  struct async_target *async;
+  size_t total = 0;
+  size_t i;
+
+  if( !target ) {
+    raise_argument_empty( L10N_NULL_ARG_ERROR_MESSAGE( "target" ) );
+    return 0;
+  }
+
+  if( target->type != STUMPLESS_ASYNC_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return 0;
+  }
+
+  async = target->id;
+  for( i = 0; i <= STUMPLESS_SEVERITY_DEBUG_VALUE; i++ ) {
+    total += atomic_load( &async->drop_counts[i] );
+  }
+
+  clear_error(  );
+  return total;
+}
+
+struct stumpless_target *
+stumpless_open_async_target( const char *name,
+                             struct stumpless_target *wrapped,
+                             size_t queue_size ) {
+  struct stumpless_target *target;
+
+  VALIDATE_ARG_NOT_NULL( name );
+  VALIDATE_ARG_NOT_NULL( wrapped );
+
+  target = new_target( STUMPLESS_ASYNC_TARGET, name );
+  if( !target ) {
+    goto fail;
+  }
+
+  target->id = new_async_target( wrapped, queue_size );
+  if( !target->id ) {
+    goto fail_id;
+  }
+
+  stumpless_set_current_target( target );
+  return target;
+
+fail_id:
+  destroy_target( target );
+fail:
+  return NULL;
+}
+
+struct stumpless_target *
+stumpless_set_async_block_timeout( struct stumpless_target *target,
+                                   unsigned int milliseconds ) {
+  struct async_target *async;
+
+  VALIDATE_ARG_NOT_NULL( target );
+
+  if( target->type != STUMPLESS_ASYNC_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  async = target->id;
+  atomic_store( &async->block_timeout, milliseconds );
+
+  clear_error(  );
+  return target;
+}
+
+struct stumpless_target *
+stumpless_set_async_deferred_formatting( struct stumpless_target *target,
+                                         bool deferred ) {
+  struct async_target *async;
+
+  VALIDATE_ARG_NOT_NULL( target );
+
+  if( target->type != STUMPLESS_ASYNC_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  async = target->id;
+
+  if( deferred ) {
+    config_lock_mutex( &async->mutex );
+    if( !async->deferred_pool ) {
+      async->deferred_pool = new_deferred_pool( async->capacity );
+      config_add_size( &queue_bytes, get_pool_bytes( async->deferred_pool ) );
+    }
+    config_unlock_mutex( &async->mutex );
+
+    if( !async->deferred_pool ) {
+      return NULL;
+    }
+  }
+
+  atomic_store( &async->deferred_formatting, deferred );
+
+  clear_error(  );
+  return target;
+}
+
+struct stumpless_target *
+stumpless_set_async_overflow_policy( struct stumpless_target *target,
+                                     enum stumpless_async_overflow_policy
+                                     policy ) {
+  struct async_target *async;
+
+  VALIDATE_ARG_NOT_NULL( target );
+
+  if( target->type != STUMPLESS_ASYNC_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  if( policy < STUMPLESS_ASYNC_OVERFLOW_BLOCK ||
+      policy > STUMPLESS_ASYNC_OVERFLOW_DROP_LOWEST_SEVERITY ) {
+    raise_index_out_of_bounds(
+      L10N_INVALID_INDEX_ERROR_MESSAGE( "overflow policy" ),
+      policy
+    );
+    return NULL;
+  }
+
+  async = target->id;
+  atomic_store( &async->overflow_policy, policy );
+
+  clear_error(  );
+  return target;
+}
+
+/* private definitions */
+
+void
+async_get_usage( struct stumpless_memory_usage *usage ) {
+  usage->bytes += config_read_size( &queue_bytes );
+  usage->count += config_read_size( &queue_count );
+}
+
+struct stumpless_target *
+flush_async_target( const struct stumpless_target *target ) {
+  struct async_target *async;
+  size_t target_position;
+
+  async = target->id;
+
+  // every position claimed before this point must be finished
+  target_position = atomic_load( &async->enqueue_position );
+
+  if( atomic_load( &async->finished_position ) >= target_position ) {
+    return async->wrapped;
+  }
+
+  config_lock_mutex( &async->mutex );
+  atomic_fetch_add( &async->waiting_flushers, 1 );
+  while( atomic_load( &async->finished_position ) < target_position ) {
+    config_wait_cond( &async->message_sent, &async->mutex );
+  }
+  atomic_fetch_sub( &async->waiting_flushers, 1 );
+  config_unlock_mutex( &async->mutex );
+
+  return async->wrapped;
+}
+
+bool
+send_deferred_log_to_async_target( struct stumpless_target *target,
+                                   int priority,
+                                   const char *message,
+                                   va_list subs,
+                                   int *result ) {
+  struct async_target *async;
+  int severity;
+  struct async_message queued;
+  bool supported;
+
+  async = target->id;
+
+  if( !atomic_load( &async->deferred_formatting ) || !message ) {
+    return false;
+  }
+
+  // the message must be formatted now to be echoed to the error stream, so
+  // there is nothing to gain by deferring it
+  if( stumpless_get_option( target, STUMPLESS_OPTION_PERROR ) ) {
+    return false;
+  }
+
+  severity = get_severity( priority );
+  if( !filter_can_be_deferred( target ) ||
+      !filter_can_be_deferred( async->wrapped ) ) {
+    return false;
+  }
+
+  *result = 0;
+  clear_error(  );
+
+  if( !passes_mask( target, severity ) ||
+      !passes_mask( async->wrapped, severity ) ) {
+    return true;
+  }
+
+  if( message_is_shed( async, severity ) ) {
+    count_drop( async, severity );
+    return true;
+  }
+
+  queued.entry = NULL;
+  queued.builder = NULL;
+  queued.severity = severity;
+  queued.deferred = new_deferred_log( async->deferred_pool,
+                                      target,
+                                      priority,
+                                      message,
+                                      subs,
+                                      &supported );
+  if( !queued.deferred ) {
+    if( !supported ) {
+      return false;
+    }
+
+    *result = -1;
+    return true;
+  }
+
+  queue_message( async, &queued );
+  return true;
+}
+
+int
+send_entry_to_async_target( const struct stumpless_target *target,
+                            const struct stumpless_entry *entry ) {
+  struct async_target *async;
+  stumpless_filter_func_t filter;
+  struct async_message queued;
+  const char *buffer;
+  size_t length;
+
+  async = target->id;
+
+  filter = stumpless_get_target_filter( async->wrapped );
+  if( filter && !filter( async->wrapped, entry ) ) {
+    return 0;
+  }
+
+  queued.entry = NULL;
+  queued.builder = NULL;
+  queued.deferred = NULL;
+  queued.severity = stumpless_get_entry_severity( entry );
+
+  if( message_is_shed( async, queued.severity ) ) {
+    count_drop( async, queued.severity );
+    clear_error(  );
+    return 0;
+  }
+
+  if( target_is_unformatted( async->wrapped ) ) {
+    queued.entry = stumpless_copy_entry( entry );
+    if( !queued.entry ) {
+      return -1;
+    }
+
+  } else {
+    queued.builder = format_entry( entry, async->wrapped );
+    if( !queued.builder ) {
+      return -1;
+    }
+
+    if( stumpless_get_option( async->wrapped, STUMPLESS_OPTION_PERROR ) ) {
+      buffer = strbuilder_get_buffer( queued.builder, &length );
+      write_to_error_stream( buffer, length );
+    }
+  }
+
+  queue_message( async, &queued );
+
+  clear_error(  );
+  return 0;
+}
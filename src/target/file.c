@@ -16,20 +16,725 @@
  * limitations under the License.
  */
 
+#include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include <stumpless/memory.h>
+#include <stumpless/severity.h>
 #include <stumpless/target.h>
 #include <stumpless/target/file.h>
 #include "private/config/locale/wrapper.h"
+#include "private/config/wrapper/gzip.h"
+#include "private/config/wrapper/io_uring.h"
+#include "private/config/wrapper/segment.h"
 #include "private/config/wrapper/thread_safety.h"
 #include "private/config/wrapper.h"
 #include "private/error.h"
 #include "private/inthelper.h"
 #include "private/memory.h"
+#include "private/severity.h"
 #include "private/target.h"
 #include "private/target/file.h"
 #include "private/validate.h"
 
+static size_t buffer_bytes = 0;
+static size_t buffer_count = 0;
+
+// the number of threads that have written to a sharded file target
+static size_t shard_thread_count = 0;
+
+// one more than the index of the current thread among shard_thread_count
+static CONFIG_THREAD_LOCAL_STORAGE size_t shard_thread_index = 0;
+
+/* The ways that a file target can write to its file. */
+enum file_target_kind {
+  FILE_TARGET_STREAM,
+  FILE_TARGET_RAW,
+  FILE_TARGET_SEGMENTS,
+  FILE_TARGET_GZIP,
+  FILE_TARGET_SHARDS
+};
+
+/* A shard being read back while merging the shards of a file target. */
+struct shard_reader {
+  FILE *file;
+  unsigned long long sequence;
+  char *record;
+  size_t record_size;
+  size_t record_length;
+  bool done;
+};
+
+/*
+ * Builds the name of a shard file in path, which must be at least the length
+ * of the name plus SHARD_SUFFIX_SIZE bytes long.
+ */
+static
+void
+get_shard_name( char *path,
+                size_t path_size,
+                const char *name,
+                unsigned int shard ) {
+  snprintf( path, path_size, "%s.shard%u", name, shard );
+}
+
+/*
+ * Opens the shard files of a sharded file target, closing the ones already
+ * opened if any of them fail.
+ */
+static
+struct file_shard *
+open_shards( const char *name, unsigned int shard_count ) {
+  struct file_shard *shards;
+  char *path;
+  size_t path_size;
+  unsigned int i;
+
+  shards = alloc_mem( sizeof( *shards ) * shard_count );
+  if( !shards ) {
+    goto fail;
+  }
+
+  path_size = strlen( name ) + SHARD_SUFFIX_SIZE;
+  path = alloc_mem( path_size );
+  if( !path ) {
+    goto fail_path;
+  }
+
+  for( i = 0; i < shard_count; i++ ) {
+    get_shard_name( path, path_size, name, i );
+    shards[i].fd = config_open_append_fd( path );
+    if( shards[i].fd == -1 ) {
+      raise_file_open_failure(  );
+      goto fail_open;
+    }
+
+    config_init_mutex( &shards[i].mutex );
+  }
+
+  free_mem( path );
+  return shards;
+
+fail_open:
+  while( i > 0 ) {
+    i--;
+    config_destroy_mutex( &shards[i].mutex );
+    config_close_fd( shards[i].fd );
+  }
+  free_mem( path );
+fail_path:
+  free_mem( shards );
+fail:
+  return NULL;
+}
+
+/*
+ * Creates the internal representation of a file target, opening the file as
+ * a stream, a raw file descriptor, a set of mapped segments, a file descriptor
+ * with a gzip writer, or a set of shard files. The setting is the segment size
+ * of segment targets, the compression level of gzip targets, or the number of
+ * shards of sharded targets, and is otherwise ignored.
+ */
+static
+struct file_target *
+new_file_target_of_kind( const char *filename,
+                         enum file_target_kind kind,
+                         size_t setting ) {
+  struct file_target *target;
+
+  target = alloc_mem( sizeof( *target ) );
+  if( !target ) {
+    goto fail;
+  }
+
+  target->stream = NULL;
+  target->fd = -1;
+  target->segments = NULL;
+  target->gzip = NULL;
+  target->shards = NULL;
+  target->shard_count = 0;
+  target->shard_sequence = 0;
+
+  if( kind == FILE_TARGET_SHARDS ) {
+    target->shards = open_shards( filename, ( unsigned int ) setting );
+    if( !target->shards ) {
+      goto fail_file;
+    }
+    target->shard_count = ( unsigned int ) setting;
+
+  } else if( kind == FILE_TARGET_SEGMENTS ) {
+    target->segments = config_new_segment_writer( filename, setting );
+    if( !target->segments ) {
+      goto fail_file;
+    }
+
+  } else if( kind == FILE_TARGET_RAW || kind == FILE_TARGET_GZIP ) {
+    target->fd = config_open_append_fd( filename );
+    if( target->fd == -1 ) {
+      raise_file_open_failure(  );
+      goto fail_file;
+    }
+
+    if( kind == FILE_TARGET_GZIP ) {
+      target->gzip = config_new_gzip_writer( target->fd, ( int ) setting );
+      if( !target->gzip ) {
+        config_close_fd( target->fd );
+        goto fail_file;
+      }
+    }
+
+  } else {
+    target->stream = config_fopen( filename, "a" );
+    if( !target->stream ) {
+      raise_file_open_failure(  );
+      goto fail_file;
+    }
+  }
+
+  target->buffer = NULL;
+  target->buffer_size = 0;
+  target->buffer_used = 0;
+  target->flush_interval = 0;
+  target->buffer_start = 0;
+  config_write_ptr( &target->uring, NULL );
+  target->rotate_size = 0;
+  target->rotate_deadline = 0;
+  target->rotate_written = 0;
+  target->rotate_age = 0;
+  target->rotate_keep = 0;
+  target->rotate_paths = NULL;
+  target->rotate_path_size = 0;
+  target->rotate_name_length = 0;
+  target->durability = STUMPLESS_FILE_DURABILITY_NONE;
+  target->sync_severity = 0;
+  target->sync_period = 0;
+  target->sync_deadline = 0;
+  target->sync_requested = 0;
+  target->synced = 0;
+  config_init_mutex( &target->stream_mutex );
+  config_init_mutex( &target->sync_mutex );
+
+  return target;
+
+fail_file:
+  free_mem( target );
+fail:
+  return NULL;
+}
+
+/*
+ * Opens a file target of the given kind.
+ */
+static
+struct stumpless_target *
+open_file_target( const char *name,
+                  enum file_target_kind kind,
+                  size_t setting ) {
+  struct stumpless_target *target;
+
+  target = new_target( STUMPLESS_FILE_TARGET, name );
+
+  if( !target ) {
+    goto fail;
+  }
+
+  target->id = new_file_target_of_kind( name, kind, setting );
+  if( !target->id ) {
+    goto fail_id;
+  }
+
+  stumpless_set_current_target( target );
+  return target;
+
+fail_id:
+  destroy_target( target );
+fail:
+  return NULL;
+}
+
+/*
+ * Writes the messages in the buffer of the target to the file. The
+ * stream_mutex of the target must be held by the caller.
+ *
+ * The buffer is emptied even if the write fails, as there is no way to know
+ * how much of it was written.
+ */
+static
+int
+write_buffer( struct file_target *target ) {
+  size_t used;
+
+  used = target->buffer_used;
+  if( used == 0 ) {
+    return 0;
+  }
+
+  target->buffer_used = 0;
+  if( !config_write_stream( target->stream, target->buffer, used ) ) {
+    raise_file_write_failure(  );
+    return -1;
+  }
+
+  return 0;
+}
+
+/*
+ * Writes anything that the target is holding back to its file. The
+ * stream_mutex of the target must be held by the caller.
+ */
+static
+int
+write_held_messages( struct file_target *target ) {
+  struct io_uring_writer *uring;
+
+  if( target->gzip ) {
+    target->buffer_used = 0;
+    return config_flush_gzip_writer( target->gzip );
+  }
+
+  if( !target->stream ) {
+    uring = config_read_ptr( &target->uring );
+    return uring ? config_flush_io_uring_writer( uring ) : 0;
+  }
+
+  if( target->buffer ) {
+    return write_buffer( target );
+  }
+
+  if( fflush( target->stream ) != 0 ) {
+    raise_file_write_failure(  );
+    return -1;
+  }
+
+  return 0;
+}
+
+/*
+ * Gets the current size of a file, or zero if it cannot be found.
+ */
+static
+size_t
+get_file_size( const char *filename ) {
+  FILE *file;
+  long size;
+
+  file = config_fopen( filename, "rb" );
+  if( !file ) {
+    return 0;
+  }
+
+  size = fseek( file, 0, SEEK_END ) == 0 ? ftell( file ) : -1;
+  fclose( file );
+
+  return size < 0 ? 0 : ( size_t ) size;
+}
+
+static
+size_t
+get_monotonic_seconds( void ) {
+  return ( size_t ) ( config_get_monotonic_milliseconds(  ) / 1000 );
+}
+
+/*
+ * Builds the name of the file with the given rotation number in one of the
+ * two rotate_paths buffers of the target. Number zero is the file itself.
+ */
+static
+const char *
+get_rotated_name( const struct file_target *target,
+                  size_t buffer,
+                  unsigned int number ) {
+  char *path;
+
+  path = target->rotate_paths + ( buffer * target->rotate_path_size );
+  if( number == 0 ) {
+    path[target->rotate_name_length] = '\0';
+  } else {
+    snprintf( path + target->rotate_name_length,
+              target->rotate_path_size - target->rotate_name_length,
+              ".%u",
+              number );
+  }
+
+  return path;
+}
+
+/*
+ * Moves each rotated file along by one number and the file itself to number
+ * one, deleting the file that no longer fits in the number kept. Files that
+ * do not exist are skipped.
+ */
+static
+int
+rename_rotated_files( const struct file_target *target ) {
+  unsigned int i;
+
+  if( remove( get_rotated_name( target, 0, target->rotate_keep ) ) != 0 &&
+      errno != ENOENT ) {
+    return -1;
+  }
+
+  for( i = target->rotate_keep; i > 0; i-- ) {
+    if( rename( get_rotated_name( target, 0, i - 1 ),
+                get_rotated_name( target, 1, i ) ) != 0 &&
+        errno != ENOENT ) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Checks whether the file has reached either of its rotation limits.
+ */
+static
+bool
+rotation_due( struct file_target *target, size_t written ) {
+  size_t max_size;
+  size_t deadline;
+
+  max_size = config_read_size( &target->rotate_size );
+  if( max_size != 0 && written >= max_size ) {
+    return true;
+  }
+
+  deadline = config_read_size( &target->rotate_deadline );
+  return deadline != 0 && get_monotonic_seconds(  ) >= deadline;
+}
+
+/*
+ * Opens the file of the target again after it has been renamed. The
+ * stream_mutex of the target must be held by the caller.
+ *
+ * Raw file targets replace their file descriptor with one for the new file
+ * using dup2, so writes made without the lock go to one file or the other.
+ */
+static
+bool
+reopen_file( struct file_target *target ) {
+  const char *name;
+  FILE *new_stream;
+
+  name = get_rotated_name( target, 0, 0 );
+
+  if( !target->stream ) {
+    return config_reopen_append_fd( target->fd, name ) == 0;
+  }
+
+  new_stream = config_fopen( name, "a" );
+  if( !new_stream ) {
+    return false;
+  }
+
+  fclose( target->stream );
+  target->stream = new_stream;
+  return true;
+}
+
+/*
+ * Renames the file of the target and opens a new one in its place. The
+ * stream_mutex of the target must be held by the caller.
+ *
+ * If the new file cannot be opened, the target keeps writing to the renamed
+ * one. Either way, the limits are reset so that a failure is not retried for
+ * every message.
+ */
+static
+int
+rotate_file( struct file_target *target ) {
+  int result;
+
+  result = write_held_messages( target );
+
+  if( rename_rotated_files( target ) != 0 || !reopen_file( target ) ) {
+    raise_file_rotation_failure(  );
+    result = -1;
+  }
+
+  config_write_size( &target->rotate_written, 0 );
+  if( target->rotate_age != 0 ) {
+    config_write_size( &target->rotate_deadline,
+                       get_monotonic_seconds(  ) + target->rotate_age );
+  }
+
+  return result;
+}
+
+/*
+ * Counts a message written to the file of the target, and rotates the file if
+ * this takes it past one of its limits. The lock is only taken if a rotation
+ * is due, and the limits are checked again once it is held in case another
+ * thread has already done the rotation.
+ */
+static
+int
+rotate_if_due( struct file_target *target, size_t msg_length ) {
+  size_t written;
+  int result = 0;
+
+  if( config_read_size( &target->rotate_size ) == 0 &&
+      config_read_size( &target->rotate_deadline ) == 0 ) {
+    return 0;
+  }
+
+  written = config_add_size( &target->rotate_written, msg_length );
+  if( !rotation_due( target, written ) ) {
+    return 0;
+  }
+
+  config_lock_mutex( &target->stream_mutex );
+  if( target->rotate_paths &&
+      rotation_due( target,
+                    config_read_size( &target->rotate_written ) ) ) {
+    result = rotate_file( target );
+  }
+  config_unlock_mutex( &target->stream_mutex );
+
+  return result;
+}
+
+/*
+ * Writes anything that the target is holding back to its file and
+ * synchronizes the file with the disk.
+ *
+ * Raw file targets without an io_uring writer have nothing held back, and so
+ * synchronize their file descriptor without taking the stream_mutex, letting
+ * other threads keep writing while the synchronization is in progress.
+ */
+static
+int
+sync_file( struct file_target *target ) {
+  unsigned int i;
+  int result;
+
+  if( target->shards ) {
+    for( i = 0; i < target->shard_count; i++ ) {
+      if( config_sync_fd( target->shards[i].fd ) != 0 ) {
+        raise_file_write_failure(  );
+        return -1;
+      }
+    }
+
+    return 0;
+  }
+
+  if( target->segments ) {
+    return config_flush_segment_writer( target->segments );
+  }
+
+  if( !target->stream &&
+      !target->gzip &&
+      !config_read_ptr( &target->uring ) ) {
+    if( config_sync_fd( target->fd ) != 0 ) {
+      raise_file_write_failure(  );
+      return -1;
+    }
+
+    return 0;
+  }
+
+  config_lock_mutex( &target->stream_mutex );
+
+  result = write_held_messages( target );
+  if( result == 0 &&
+      ( target->stream ? config_sync_stream( target->stream ) :
+                         config_sync_fd( target->fd ) ) != 0 ) {
+    raise_file_write_failure(  );
+    result = -1;
+  }
+
+  config_unlock_mutex( &target->stream_mutex );
+
+  return result;
+}
+
+/*
+ * Makes sure that a message that was just written is on disk, sharing the
+ * synchronization with any other threads doing the same.
+ *
+ * Each message takes a number once it is written. A thread that gets the
+ * sync_mutex synchronizes the file on behalf of every message numbered so far,
+ * and any thread that was waiting behind it returns without doing anything if
+ * its own message was one of these.
+ */
+static
+int
+sync_file_group( struct file_target *target ) {
+  size_t requested;
+  size_t covered;
+  int result = 0;
+
+  requested = config_increment_size( &target->sync_requested );
+
+  config_lock_mutex( &target->sync_mutex );
+
+  // unsigned subtraction keeps the comparison correct if the count wraps
+  if( requested - target->synced - 1 < SIZE_MAX / 2 ) {
+    covered = config_read_size( &target->sync_requested );
+    result = sync_file( target );
+    if( result == 0 ) {
+      target->synced = covered;
+    }
+  }
+
+  config_unlock_mutex( &target->sync_mutex );
+
+  return result;
+}
+
+/*
+ * Synchronizes the file if the period set for it has passed. The lock is only
+ * taken if the deadline has passed, and it is checked again once it is held in
+ * case another thread has already done the synchronization.
+ */
+static
+int
+sync_file_periodically( struct file_target *target ) {
+  size_t now;
+  int result = 0;
+
+  now = ( size_t ) config_get_monotonic_milliseconds(  );
+  if( now - config_read_size( &target->sync_deadline ) >= SIZE_MAX / 2 ) {
+    return 0;
+  }
+
+  config_lock_mutex( &target->sync_mutex );
+
+  if( now - config_read_size( &target->sync_deadline ) < SIZE_MAX / 2 ) {
+    result = sync_file( target );
+    config_write_size( &target->sync_deadline,
+                       ( size_t ) config_get_monotonic_milliseconds(  ) +
+                         config_read_size( &target->sync_period ) );
+  }
+
+  config_unlock_mutex( &target->sync_mutex );
+
+  return result;
+}
+
+/*
+ * Gets the shard of a sharded file target that the current thread writes to.
+ * Each thread is given the next index the first time that it writes to any
+ * sharded target, so that threads only share a shard once there are more of
+ * them than there are shards.
+ */
+static
+struct file_shard *
+get_thread_shard( const struct file_target *target ) {
+  if( shard_thread_index == 0 ) {
+    shard_thread_index = config_increment_size( &shard_thread_count );
+  }
+
+  return &target->shards[( shard_thread_index - 1 ) % target->shard_count];
+}
+
+/*
+ * Reads the next record of a shard. The shard is marked done once the end of
+ * it is reached, including when the last record was only partly written.
+ */
+static
+int
+read_shard_record( struct shard_reader *reader ) {
+  unsigned long long length;
+  char *new_record;
+
+  if( fscanf( reader->file,
+              "%llu %llu",
+              &reader->sequence,
+              &length ) != 2 ||
+      fgetc( reader->file ) != ' ' ) {
+    reader->done = true;
+    return 0;
+  }
+
+  if( length > reader->record_size ) {
+    new_record = realloc_mem( reader->record, ( size_t ) length );
+    if( !new_record ) {
+      return -1;
+    }
+
+    reader->record = new_record;
+    reader->record_size = ( size_t ) length;
+  }
+
+  reader->record_length = fread( reader->record,
+                                 sizeof( char ),
+                                 ( size_t ) length,
+                                 reader->file );
+  if( reader->record_length != length ) {
+    reader->done = true;
+  }
+
+  return 0;
+}
+
+/*
+ * Writes a message to the shard of the current thread as a record starting
+ * with the next sequence number of the target and the length of the message.
+ * The sequence number is taken and the record written while holding the mutex
+ * of the shard, so that each shard is in sequence order even when threads
+ * share it. The message is copied into place first so that as little as
+ * possible is done while holding the mutex, using a buffer on the stack
+ * unless the message is too long to fit in it.
+ */
+static
+int
+send_to_shard( struct file_target *target,
+               const char *msg,
+               size_t msg_length ) {
+  char buffer[SHARD_RECORD_BUFFER_SIZE];
+  char header[SHARD_RECORD_HEADER_SIZE];
+  char *record = buffer;
+  char *record_start;
+  struct file_shard *shard;
+  size_t header_length;
+  bool write_result;
+
+  // the header is put right before the message once it is known, so room is
+  // left for the longest possible one
+  if( SHARD_RECORD_HEADER_SIZE + msg_length > sizeof( buffer ) ) {
+    record = alloc_mem( SHARD_RECORD_HEADER_SIZE + msg_length );
+    if( !record ) {
+      return -1;
+    }
+  }
+
+  memcpy( record + SHARD_RECORD_HEADER_SIZE, msg, msg_length );
+
+  shard = get_thread_shard( target );
+  config_lock_mutex( &shard->mutex );
+
+  header_length = ( size_t ) snprintf(
+    header,
+    sizeof( header ),
+    "%llu %llu ",
+    ( unsigned long long ) config_increment_size( &target->shard_sequence ),
+    ( unsigned long long ) msg_length
+  );
+  record_start = record + SHARD_RECORD_HEADER_SIZE - header_length;
+  memcpy( record_start, header, header_length );
+  write_result = config_write_fd( shard->fd,
+                                  record_start,
+                                  header_length + msg_length );
+
+  config_unlock_mutex( &shard->mutex );
+
+  if( record != buffer ) {
+    free_mem( record );
+  }
+
+  if( !write_result ) {
+    raise_file_write_failure(  );
+    return -1;
+  }
+
+  return cap_size_t_to_int( msg_length + 1 );
+}
+
 void
 stumpless_close_file_target( struct stumpless_target *target ) {
   if( !target ) {
@@ -37,48 +742,478 @@ stumpless_close_file_target( struct stumpless_target *target ) {
     return;
   }
 
-  if( target->type != STUMPLESS_FILE_TARGET ) {
-    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
-    return;
+  if( target->type != STUMPLESS_FILE_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return;
+  }
+
+  destroy_file_target( target->id );
+  destroy_target( target );
+  clear_error(  );
+}
+
+int
+stumpless_merge_file_shards( const char *name,
+                             unsigned int shard_count,
+                             const char *output ) {
+  struct shard_reader *readers;
+  struct shard_reader *next;
+  FILE *output_file;
+  char *path;
+  size_t path_size;
+  size_t merged = 0;
+  unsigned int opened;
+  unsigned int i;
+  int result = -1;
+
+  VALIDATE_ARG_NOT_NULL_INT_RETURN( name );
+  VALIDATE_ARG_NOT_NULL_INT_RETURN( output );
+
+  if( shard_count == 0 ) {
+    shard_count = STUMPLESS_DEFAULT_SHARD_COUNT;
+  }
+
+  readers = alloc_mem( sizeof( *readers ) * shard_count );
+  if( !readers ) {
+    goto fail;
+  }
+
+  path_size = strlen( name ) + SHARD_SUFFIX_SIZE;
+  path = alloc_mem( path_size );
+  if( !path ) {
+    goto fail_path;
+  }
+
+  for( opened = 0; opened < shard_count; opened++ ) {
+    get_shard_name( path, path_size, name, opened );
+    readers[opened].file = config_fopen( path, "rb" );
+    if( !readers[opened].file ) {
+      raise_file_open_failure(  );
+      goto fail_open;
+    }
+
+    readers[opened].record = NULL;
+    readers[opened].record_size = 0;
+    readers[opened].done = false;
+  }
+
+  output_file = config_fopen( output, "ab" );
+  if( !output_file ) {
+    raise_file_open_failure(  );
+    goto fail_open;
+  }
+
+  for( i = 0; i < shard_count; i++ ) {
+    if( read_shard_record( &readers[i] ) != 0 ) {
+      goto finish;
+    }
   }
 
-  destroy_file_target( target->id );
-  destroy_target( target );
+  // each shard is in sequence order, so the lowest next record comes first
+  while( true ) {
+    next = NULL;
+    for( i = 0; i < shard_count; i++ ) {
+      if( !readers[i].done &&
+          ( !next || readers[i].sequence < next->sequence ) ) {
+        next = &readers[i];
+      }
+    }
+
+    if( !next ) {
+      break;
+    }
+
+    if( fwrite( next->record,
+                sizeof( char ),
+                next->record_length,
+                output_file ) != next->record_length ) {
+      raise_file_write_failure(  );
+      goto finish;
+    }
+
+    merged++;
+
+    if( read_shard_record( next ) != 0 ) {
+      goto finish;
+    }
+  }
+
+  if( fflush( output_file ) != 0 ) {
+    raise_file_write_failure(  );
+    goto finish;
+  }
+
+  result = cap_size_t_to_int( merged );
   clear_error(  );
+
+finish:
+  fclose( output_file );
+fail_open:
+  for( i = 0; i < opened; i++ ) {
+    free_mem( readers[i].record );
+    fclose( readers[i].file );
+  }
+  free_mem( path );
+fail_path:
+  free_mem( readers );
+fail:
+  return result;
 }
 
 struct stumpless_target *
 stumpless_open_file_target( const char *name ) {
-  struct stumpless_target *target;
+  VALIDATE_ARG_NOT_NULL( name );
+
+  return open_file_target( name, FILE_TARGET_STREAM, 0 );
+}
 
+struct stumpless_target *
+stumpless_open_gzip_file_target( const char *name, unsigned int level ) {
   VALIDATE_ARG_NOT_NULL( name );
 
-  target = new_target( STUMPLESS_FILE_TARGET, name );
+  if( level > 9 ) {
+    level = 9;
+  }
 
-  if( !target ) {
-    goto fail;
+  return open_file_target( name,
+                           FILE_TARGET_GZIP,
+                           level == 0 ? ( size_t ) STUMPLESS_DEFAULT_GZIP_LEVEL :
+                                        level );
+}
+
+struct stumpless_target *
+stumpless_open_raw_file_target( const char *name ) {
+  VALIDATE_ARG_NOT_NULL( name );
+
+  return open_file_target( name, FILE_TARGET_RAW, 0 );
+}
+
+struct stumpless_target *
+stumpless_open_segment_file_target( const char *name, size_t segment_size ) {
+  VALIDATE_ARG_NOT_NULL( name );
+
+  if( segment_size == 0 ) {
+    segment_size = STUMPLESS_DEFAULT_SEGMENT_SIZE;
   }
 
-  target->id = new_file_target( name );
-  if( !target->id ) {
-    goto fail_id;
+  return open_file_target( name, FILE_TARGET_SEGMENTS, segment_size );
+}
+
+struct stumpless_target *
+stumpless_open_sharded_file_target( const char *name,
+                                    unsigned int shard_count ) {
+  VALIDATE_ARG_NOT_NULL( name );
+
+  if( shard_count == 0 ) {
+    shard_count = STUMPLESS_DEFAULT_SHARD_COUNT;
   }
 
-  stumpless_set_current_target( target );
+  return open_file_target( name, FILE_TARGET_SHARDS, shard_count );
+}
+
+struct stumpless_target *
+stumpless_set_file_buffer_size( struct stumpless_target *target,
+                                size_t size ) {
+  struct file_target *file;
+  char *new_buffer = NULL;
+  int result;
+
+  VALIDATE_ARG_NOT_NULL( target );
+
+  if( target->type != STUMPLESS_FILE_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  file = target->id;
+  if( !file->stream ) {
+    // raw, segment, and sharded file targets write messages without a lock,
+    // so cannot share a buffer, and gzip file targets already collect their
+    // output
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  if( size > 0 ) {
+    new_buffer = alloc_mem( size );
+    if( !new_buffer ) {
+      return NULL;
+    }
+  }
+
+  config_lock_mutex( &file->stream_mutex );
+
+  if( file->buffer ) {
+    result = write_buffer( file );
+    free_sized_mem( file->buffer, file->buffer_size );
+    config_subtract_size( &buffer_bytes, file->buffer_size );
+    config_decrement_size( &buffer_count );
+  } else {
+    // anything already in the stream must be written before the buffer
+    result = fflush( file->stream ) == 0 ? 0 : -1;
+    if( result != 0 ) {
+      raise_file_write_failure(  );
+    }
+  }
+
+  file->buffer = new_buffer;
+  file->buffer_size = size;
+  file->buffer_used = 0;
+
+  if( new_buffer ) {
+    config_add_size( &buffer_bytes, size );
+    config_increment_size( &buffer_count );
+  }
+
+  config_unlock_mutex( &file->stream_mutex );
+
+  if( result != 0 ) {
+    return NULL;
+  }
+
+  clear_error(  );
   return target;
+}
 
-fail_id:
-  destroy_target( target );
-fail:
-  return NULL;
+struct stumpless_target *
+stumpless_set_file_io_uring_depth( struct stumpless_target *target,
+                                   unsigned int depth ) {
+  struct file_target *file;
+  struct io_uring_writer *new_uring = NULL;
+  struct io_uring_writer *old_uring;
+  int result = 0;
+
+  VALIDATE_ARG_NOT_NULL( target );
+
+  if( target->type != STUMPLESS_FILE_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  file = target->id;
+  if( file->stream || file->segments || file->gzip || file->shards ) {
+    // writes queued on the ring would bypass anything the stream or the
+    // compressor is holding, segment file targets do not write to a file
+    // descriptor, and sharded file targets write to more than one
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  if( depth > 0 ) {
+    new_uring = config_new_io_uring_writer( file->fd, depth );
+    if( !new_uring ) {
+      return NULL;
+    }
+  }
+
+  config_lock_mutex( &file->stream_mutex );
+
+  old_uring = config_read_ptr( &file->uring );
+  if( old_uring ) {
+    result = config_flush_io_uring_writer( old_uring );
+    config_destroy_io_uring_writer( old_uring );
+  }
+
+  config_write_ptr( &file->uring, new_uring );
+
+  config_unlock_mutex( &file->stream_mutex );
+
+  if( result != 0 ) {
+    return NULL;
+  }
+
+  clear_error(  );
+  return target;
+}
+
+struct stumpless_target *
+stumpless_set_file_rotation( struct stumpless_target *target,
+                             size_t max_size,
+                             unsigned int max_age,
+                             unsigned int keep ) {
+  struct file_target *file;
+  char *new_paths = NULL;
+  size_t path_size = 0;
+  char *old_paths;
+  size_t old_path_size;
+  size_t size;
+  int result;
+
+  VALIDATE_ARG_NOT_NULL( target );
+
+  if( target->type != STUMPLESS_FILE_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  file = target->id;
+  if( file->segments || file->shards ) {
+    // segment and sharded file targets already split their output into
+    // separate files
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  if( max_size != 0 || max_age != 0 ) {
+    // room for the longest suffix of a dot and an unsigned int
+    path_size = target->name_length + 12;
+    new_paths = alloc_mem( path_size * 2 );
+    if( !new_paths ) {
+      return NULL;
+    }
+
+    memcpy( new_paths, target->name, target->name_length );
+    memcpy( new_paths + path_size, target->name, target->name_length );
+  }
+
+  config_lock_mutex( &file->stream_mutex );
+
+  result = write_held_messages( file );
+  size = get_file_size( target->name );
+
+  old_paths = file->rotate_paths;
+  old_path_size = file->rotate_path_size;
+
+  file->rotate_paths = new_paths;
+  file->rotate_path_size = path_size;
+  file->rotate_name_length = target->name_length;
+  file->rotate_age = max_age;
+  file->rotate_keep = keep;
+  config_write_size( &file->rotate_written, size );
+  config_write_size( &file->rotate_size, max_size );
+  config_write_size( &file->rotate_deadline,
+                     max_age == 0 ? 0 : get_monotonic_seconds(  ) + max_age );
+
+  config_unlock_mutex( &file->stream_mutex );
+
+  if( old_paths ) {
+    free_sized_mem( old_paths, old_path_size * 2 );
+  }
+
+  if( result != 0 ) {
+    return NULL;
+  }
+
+  clear_error(  );
+  return target;
+}
+
+struct stumpless_target *
+stumpless_set_file_flush_interval( struct stumpless_target *target,
+                                   unsigned int milliseconds ) {
+  struct file_target *file;
+
+  VALIDATE_ARG_NOT_NULL( target );
+
+  if( target->type != STUMPLESS_FILE_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  file = target->id;
+  config_lock_mutex( &file->stream_mutex );
+  file->flush_interval = milliseconds;
+  file->buffer_start = config_get_monotonic_milliseconds(  );
+  config_unlock_mutex( &file->stream_mutex );
+
+  clear_error(  );
+  return target;
+}
+
+struct stumpless_target *
+stumpless_set_file_durability( struct stumpless_target *target,
+                               enum stumpless_file_durability durability,
+                               unsigned int setting ) {
+  struct file_target *file;
+
+  VALIDATE_ARG_NOT_NULL( target );
+
+  if( target->type != STUMPLESS_FILE_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  if( durability < STUMPLESS_FILE_DURABILITY_NONE ||
+      durability > STUMPLESS_FILE_DURABILITY_GROUP_COMMIT ) {
+    raise_index_out_of_bounds(
+      L10N_INVALID_INDEX_ERROR_MESSAGE( "durability" ),
+      durability
+    );
+    return NULL;
+  }
+
+  if( durability == STUMPLESS_FILE_DURABILITY_SEVERITY &&
+      severity_is_invalid( cap_size_t_to_int( setting ) ) ) {
+    raise_invalid_severity( cap_size_t_to_int( setting ) );
+    return NULL;
+  }
+
+  file = target->id;
+  config_lock_mutex( &file->sync_mutex );
+  if( durability == STUMPLESS_FILE_DURABILITY_SEVERITY ) {
+    config_write_int( &file->sync_severity, ( int ) setting );
+  } else {
+    config_write_size( &file->sync_period, setting );
+    config_write_size( &file->sync_deadline,
+                       ( size_t ) config_get_monotonic_milliseconds(  ) +
+                         setting );
+  }
+  config_write_int( &file->durability, durability );
+  config_unlock_mutex( &file->sync_mutex );
+
+  clear_error(  );
+  return target;
 }
 
 /* private definitions */
 
 void
 destroy_file_target( struct file_target *target ) {
+  struct io_uring_writer *uring;
+  unsigned int i;
+
+  if( config_read_int( &target->durability ) !=
+        STUMPLESS_FILE_DURABILITY_NONE ) {
+    sync_file( target );
+  }
+
+  if( target->buffer ) {
+    write_buffer( target );
+    free_sized_mem( target->buffer, target->buffer_size );
+    config_subtract_size( &buffer_bytes, target->buffer_size );
+    config_decrement_size( &buffer_count );
+  }
+
+  uring = config_read_ptr( &target->uring );
+  if( uring ) {
+    config_destroy_io_uring_writer( uring );
+  }
+
+  if( target->rotate_paths ) {
+    free_sized_mem( target->rotate_paths, target->rotate_path_size * 2 );
+  }
+
+  if( target->gzip ) {
+    config_destroy_gzip_writer( target->gzip );
+  }
+
   config_destroy_mutex( &target->stream_mutex );
-  fclose( target->stream );
+  config_destroy_mutex( &target->sync_mutex );
+
+  if( target->shards ) {
+    for( i = 0; i < target->shard_count; i++ ) {
+      config_destroy_mutex( &target->shards[i].mutex );
+      config_close_fd( target->shards[i].fd );
+    }
+    free_mem( target->shards );
+  } else if( target->segments ) {
+    config_destroy_segment_writer( target->segments );
+  } else if( target->stream ) {
+    fclose( target->stream );
+  } else {
+    config_close_fd( target->fd );
+  }
+
   free_mem( target );
 }
 
@@ -87,48 +1222,238 @@ file_open_default_target( void ) {
   return stumpless_open_file_target( STUMPLESS_DEFAULT_FILE );
 }
 
-struct file_target *
-new_file_target( const char *filename ) {
-  struct file_target *target;
+void
+file_get_usage( struct stumpless_memory_usage *usage ) {
+  usage->bytes += config_read_size( &buffer_bytes );
+  usage->count += config_read_size( &buffer_count );
+  config_io_uring_get_usage( usage );
+}
 
-  target = alloc_mem( sizeof( *target ) );
-  if( !target ) {
-    goto fail;
+int
+flush_file_target( struct file_target *target ) {
+  int result = 0;
+  struct io_uring_writer *uring;
+
+  if( target->segments ) {
+    return config_flush_segment_writer( target->segments );
+  }
+
+  if( target->gzip ) {
+    config_lock_mutex( &target->stream_mutex );
+    result = write_held_messages( target );
+    config_unlock_mutex( &target->stream_mutex );
+
+    return result;
   }
 
-  target->stream = config_fopen( filename, "a" );
   if( !target->stream ) {
-    raise_file_open_failure(  );
-    goto fail_stream;
+    // raw file targets only hold messages back when they use io_uring
+    if( !config_read_ptr( &target->uring ) ) {
+      return 0;
+    }
+
+    config_lock_mutex( &target->stream_mutex );
+    uring = config_read_ptr( &target->uring );
+    if( uring ) {
+      result = config_flush_io_uring_writer( uring );
+    }
+    config_unlock_mutex( &target->stream_mutex );
+
+    return result;
   }
 
-  config_init_mutex( &target->stream_mutex );
+  config_lock_mutex( &target->stream_mutex );
 
-  return target;
+  if( target->buffer ) {
+    result = write_buffer( target );
+  } else if( fflush( target->stream ) != 0 ) {
+    raise_file_write_failure(  );
+    result = -1;
+  }
 
-fail_stream:
-  free_mem( target );
-fail:
-  return NULL;
+  config_unlock_mutex( &target->stream_mutex );
+
+  return result;
 }
 
 int
-sendto_file_target( struct file_target *target,
-                    const char *msg,
-                    size_t msg_length ) {
+flush_file_target_for_severity( struct file_target *target, int severity ) {
+  int durability;
+
+  if( severity <= STUMPLESS_SEVERITY_ERR &&
+      flush_file_target( target ) != 0 ) {
+    return -1;
+  }
+
+  durability = config_read_int( &target->durability );
+  if( durability == STUMPLESS_FILE_DURABILITY_GROUP_COMMIT ) {
+    return sync_file_group( target );
+  }
+
+  if( durability == STUMPLESS_FILE_DURABILITY_SEVERITY &&
+      severity <= config_read_int( &target->sync_severity ) ) {
+    return sync_file_group( target );
+  }
+
+  if( durability == STUMPLESS_FILE_DURABILITY_PERIODIC ) {
+    return sync_file_periodically( target );
+  }
+
+  return 0;
+}
+
+struct file_target *
+new_file_target( const char *filename ) {
+  return new_file_target_of_kind( filename, FILE_TARGET_STREAM, 0 );
+}
+
+struct file_target *
+new_raw_file_target( const char *filename ) {
+  return new_file_target_of_kind( filename, FILE_TARGET_RAW, 0 );
+}
+
+/*
+ * Writes a message to the file of a stream or raw file target.
+ */
+static
+int
+write_message( struct file_target *target,
+               const char *msg,
+               size_t msg_length ) {
   size_t fwrite_result;
+  bool write_result;
+  struct io_uring_writer *uring;
+  int send_result;
+
+  if( target->gzip ) {
+    config_lock_mutex( &target->stream_mutex );
+
+    if( target->buffer_used == 0 && target->flush_interval != 0 ) {
+      target->buffer_start = config_get_monotonic_milliseconds(  );
+    }
+
+    send_result = config_send_to_gzip_writer( target->gzip, msg, msg_length );
+    target->buffer_used += msg_length;
+
+    if( send_result == 0 &&
+        target->flush_interval != 0 &&
+        config_get_monotonic_milliseconds(  ) - target->buffer_start >=
+          target->flush_interval ) {
+      send_result = write_held_messages( target );
+    }
+
+    config_unlock_mutex( &target->stream_mutex );
+    return send_result == 0 ? cap_size_t_to_int( msg_length + 1 ) : -1;
+  }
+
+  if( !target->stream ) {
+    // O_APPEND makes small enough writes atomic without a lock of our own
+    if( msg_length <= CONFIG_ATOMIC_APPEND_SIZE &&
+        !config_read_ptr( &target->uring ) ) {
+      write_result = config_write_fd( target->fd, msg, msg_length );
+    } else {
+      config_lock_mutex( &target->stream_mutex );
+
+      uring = config_read_ptr( &target->uring );
+      if( uring ) {
+        send_result = config_send_to_io_uring_writer( uring, msg, msg_length );
+        config_unlock_mutex( &target->stream_mutex );
+        return send_result == 0 ? cap_size_t_to_int( msg_length + 1 ) : -1;
+      }
+
+      write_result = config_write_fd( target->fd, msg, msg_length );
+      config_unlock_mutex( &target->stream_mutex );
+    }
+
+    if( !write_result ) {
+      goto write_failure;
+    }
+
+    return cap_size_t_to_int( msg_length + 1 );
+  }
 
   config_lock_mutex( &target->stream_mutex );
-  fwrite_result = fwrite( msg, sizeof( char ), msg_length, target->stream );
-  config_unlock_mutex( &target->stream_mutex );
 
-  if( fwrite_result != msg_length ) {
-    goto write_failure;
+  if( !target->buffer ) {
+    fwrite_result = fwrite( msg, sizeof( char ), msg_length, target->stream );
+    config_unlock_mutex( &target->stream_mutex );
+
+    if( fwrite_result != msg_length ) {
+      goto write_failure;
+    }
+
+    return cap_size_t_to_int( fwrite_result + 1 );
+  }
+
+  if( msg_length > target->buffer_size - target->buffer_used &&
+      write_buffer( target ) != 0 ) {
+    goto fail_locked;
+  }
+
+  if( msg_length >= target->buffer_size ) {
+    // too large to combine with anything else
+    if( !config_write_stream( target->stream, msg, msg_length ) ) {
+      config_unlock_mutex( &target->stream_mutex );
+      goto write_failure;
+    }
+
+  } else {
+    if( target->buffer_used == 0 && target->flush_interval != 0 ) {
+      target->buffer_start = config_get_monotonic_milliseconds(  );
+    }
+
+    memcpy( target->buffer + target->buffer_used, msg, msg_length );
+    target->buffer_used += msg_length;
+
+    if( target->flush_interval != 0 &&
+        config_get_monotonic_milliseconds(  ) - target->buffer_start >=
+          target->flush_interval &&
+        write_buffer( target ) != 0 ) {
+      goto fail_locked;
+    }
   }
 
-  return cap_size_t_to_int( fwrite_result + 1 );
+  config_unlock_mutex( &target->stream_mutex );
+  return cap_size_t_to_int( msg_length + 1 );
+
+fail_locked:
+  config_unlock_mutex( &target->stream_mutex );
+  return -1;
 
 write_failure:
   raise_file_write_failure(  );
   return -1;
 }
+
+int
+sendto_file_target( struct file_target *target,
+                    const char *msg,
+                    size_t msg_length ) {
+  int result;
+
+  if( target->shards ) {
+    return send_to_shard( target, msg, msg_length );
+  }
+
+  if( target->segments ) {
+    // space is reserved in the mapped segment without any lock
+    if( config_send_to_segment_writer( target->segments,
+                                       msg,
+                                       msg_length ) != 0 ) {
+      return -1;
+    }
+
+    return cap_size_t_to_int( msg_length + 1 );
+  }
+
+  result = write_message( target, msg, msg_length );
+  if( result < 0 ) {
+    return result;
+  }
+
+  if( rotate_if_due( target, msg_length ) != 0 ) {
+    return -1;
+  }
+
+  return result;
+}
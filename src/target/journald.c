@@ -19,10 +19,12 @@
 // keeps systemd from showing stumpless itself as the source of the entries
 #define SD_JOURNAL_SUPPRESS_LOCATION 1
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 #include <stumpless/element.h>
 #include <stumpless/entry.h>
+#include <stumpless/memory.h>
 #include <stumpless/param.h>
 #include <stumpless/target.h>
 #include <stumpless/target/journald.h>
@@ -74,6 +76,52 @@ static CONFIG_THREAD_LOCAL_STORAGE char *message_buffer = NULL;
 static CONFIG_THREAD_LOCAL_STORAGE size_t message_buffer_length = 0;
 static CONFIG_THREAD_LOCAL_STORAGE char *sd_buffer = NULL;
 static CONFIG_THREAD_LOCAL_STORAGE size_t sd_buffer_size = 0;
+static CONFIG_THREAD_LOCAL_STORAGE bool *sd_locks = NULL;
+static CONFIG_THREAD_LOCAL_STORAGE size_t sd_locks_length = 0;
+
+/* global static variables */
+static size_t buffer_bytes = 0;
+static size_t buffer_count = 0;
+
+/*
+ * Updates the usage totals for a per-thread buffer that is resized from
+ * old_size to new_size, where a size of zero means no buffer.
+ */
+static void
+track_buffer( size_t old_size, size_t new_size ) {
+  if( old_size == 0 && new_size != 0 ) {
+    config_increment_size( &buffer_count );
+  } else if( old_size != 0 && new_size == 0 ) {
+    config_decrement_size( &buffer_count );
+  }
+
+  config_add_size( &buffer_bytes, new_size );
+  config_subtract_size( &buffer_bytes, old_size );
+}
+
+/*
+ * Makes sure that sd_locks has room for at least count results of locking the
+ * elements and params of an entry, keeping any results already in it.
+ */
+static bool
+reserve_sd_locks( size_t count ) {
+  bool *new_locks;
+
+  if( sd_locks_length >= count ) {
+    return true;
+  }
+
+  new_locks = realloc_mem( sd_locks, sizeof( *sd_locks ) * count );
+  if( !new_locks ) {
+    return false;
+  }
+
+  track_buffer( sizeof( *sd_locks ) * sd_locks_length,
+                sizeof( *sd_locks ) * count );
+  sd_locks = new_locks;
+  sd_locks_length = count;
+  return true;
+}
 
 void
 stumpless_close_journald_target( const struct stumpless_target *target ) {
@@ -196,6 +244,9 @@ init_fields( size_t field_count ) {
     return;
   }
 
+  track_buffer( sizeof( *fields ) * fields_length,
+                sizeof( *fields ) * field_count );
+
   fields = new_fields;
   fields_length = field_count;
   set_field_bases(  );
@@ -208,6 +259,8 @@ init_fixed_fields( void ){
     return;
   }
 
+  track_buffer( 0, sizeof( *fixed_fields ) );
+
   memcpy( fixed_fields->priority, "PRIORITY=", PRIORITY_PREFIX_SIZE );
   memcpy( fixed_fields->facility, "SYSLOG_FACILITY=", FACILITY_PREFIX_SIZE );
   memcpy( fixed_fields->timestamp, "SYSLOG_TIMESTAMP=", TIMESTAMP_PREFIX_SIZE );
@@ -224,20 +277,37 @@ init_fixed_fields( void ){
 
 void
 journald_free_thread( void ) {
-  free_mem( fields );
+  track_buffer( sizeof( *fields ) * fields_length, 0 );
+  free_sized_mem( fields, sizeof( *fields ) * fields_length );
   fields = NULL;
   fields_length = 0;
 
-  free_mem( fixed_fields );
-  fixed_fields = NULL;
+  if( fixed_fields ) {
+    track_buffer( sizeof( *fixed_fields ), 0 );
+    free_sized_mem( fixed_fields, sizeof( *fixed_fields ) );
+    fixed_fields = NULL;
+  }
 
-  free_mem( message_buffer );
+  track_buffer( message_buffer_length, 0 );
+  free_sized_mem( message_buffer, message_buffer_length );
   message_buffer = NULL;
   message_buffer_length = 0;
 
-  free_mem( sd_buffer );
+  track_buffer( sd_buffer_size, 0 );
+  free_sized_mem( sd_buffer, sd_buffer_size );
   sd_buffer = NULL;
   sd_buffer_size = 0;
+
+  track_buffer( sizeof( *sd_locks ) * sd_locks_length, 0 );
+  free_sized_mem( sd_locks, sizeof( *sd_locks ) * sd_locks_length );
+  sd_locks = NULL;
+  sd_locks_length = 0;
+}
+
+void
+journald_get_usage( struct stumpless_memory_usage *usage ) {
+  usage->bytes += config_read_size( &buffer_bytes );
+  usage->count += config_read_size( &buffer_count );
 }
 
 void
@@ -274,6 +344,7 @@ load_message( const struct stumpless_entry *entry ) {
     if( !new_message_buffer ) {
       return NULL;
     }
+    track_buffer( message_buffer_length, fields[6].iov_len );
     message_buffer = new_message_buffer;
     message_buffer_length = fields[6].iov_len;
     memcpy( message_buffer, "MESSAGE=", MESSAGE_PREFIX_SIZE );
@@ -344,16 +415,27 @@ load_sd_fields( const struct stumpless_entry *entry ) {
   char *pos;
   struct iovec *vec;
   size_t size_left;
+  bool element_locked;
+  size_t lock_count = 0;
+  size_t lock_index;
 
+  // the elements and params stay locked until their fields are loaded, so
+  // whether each one was locked is kept in sd_locks in the order locked
   field_count = fields_offset + entry->element_count;
   for( i = 0; i < entry->element_count; i++ ) {
     element = entry->elements[i];
-    lock_element( element );
+    element_locked = lock_element( element );
+    if( !reserve_sd_locks( lock_count + 1 + element->param_count ) ) {
+      unlock_element( element, element_locked );
+      goto fail;
+    }
+
+    sd_locks[lock_count++] = element_locked;
     size_needed += element->get_journald_name( entry, i, NULL, 0 ) + 1;
     field_count += element->param_count;
     for( j = 0; j < element->param_count; j++ ) {
       param = element->params[j];
-      lock_param( param );
+      sd_locks[lock_count++] = lock_param( param );
       size_needed += param->get_journald_name( entry, i, j, NULL, 0 );
       size_needed += 1 + param->value_length;
     }
@@ -372,13 +454,16 @@ load_sd_fields( const struct stumpless_entry *entry ) {
       goto fail;
     }
 
+    track_buffer( sd_buffer_size, size_needed );
     sd_buffer = new_sd_buffer;
     sd_buffer_size = size_needed;
   }
 
   pos = sd_buffer;
+  lock_index = 0;
   for( i = 0; i < entry->element_count; i++ ) {
     element = entry->elements[i];
+    element_locked = sd_locks[lock_index++];
     vec = &fields[fields_offset++];
     vec->iov_base = pos;
     size_left = sd_buffer_size - ( pos - sd_buffer );
@@ -394,22 +479,25 @@ load_sd_fields( const struct stumpless_entry *entry ) {
       *( pos++ ) = '=';
       memcpy( pos, param->value, param->value_length );
       pos += param->value_length;
-      unlock_param( param );
+      unlock_param( param, sd_locks[lock_index++] );
       vec->iov_len = pos - ( char * ) vec->iov_base;
     }
 
-    unlock_element( element );
+    unlock_element( element, element_locked );
   }
 
   return field_count;
 
 fail:
-  for( i = 0; i < entry->element_count; i++ ) {
-    for( j = 0; j < entry->elements[i]->param_count; j++ ) {
-      unlock_param( entry->elements[i]->params[j] );
+  lock_index = 0;
+  for( i = 0; lock_index < lock_count; i++ ) {
+    element = entry->elements[i];
+    element_locked = sd_locks[lock_index++];
+    for( j = 0; j < element->param_count; j++ ) {
+      unlock_param( element->params[j], sd_locks[lock_index++] );
     }
 
-    unlock_element( entry->elements[i] );
+    unlock_element( element, element_locked );
   }
 
   return 0;
@@ -430,6 +518,7 @@ send_entry_to_journald_target( const struct stumpless_target *target,
   size_t pid_size;
   size_t field_count;
   int sendv_result;
+  bool locked;
 
   if( !fixed_fields ) {
     init_fixed_fields(  );
@@ -441,7 +530,7 @@ send_entry_to_journald_target( const struct stumpless_target *target,
   timestamp_size = load_timestamp(  );
   pid_size = load_pid(  );
 
-  lock_entry( entry );
+  locked = lock_entry( entry );
 
   field_count = load_sd_fields( entry );
   if( field_count == 0 ) {
@@ -457,7 +546,7 @@ send_entry_to_journald_target( const struct stumpless_target *target,
   load_identifier( entry );
   load_msgid( entry );
 
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 
   fields[2].iov_len = timestamp_size;
   fields[4].iov_len = pid_size;
@@ -470,7 +559,7 @@ send_entry_to_journald_target( const struct stumpless_target *target,
   return sendv_result;
 
 fail_locked:
-  unlock_entry( entry );
+  unlock_entry( entry, locked );
 fail:
   return -1;
 }
@@ -19,6 +19,7 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
+#include <stumpless/memory.h>
 #include <stumpless/target.h>
 #include <stumpless/target/network.h>
 #include "private/config/locale/wrapper.h"
@@ -34,6 +35,10 @@
 static CONFIG_THREAD_LOCAL_STORAGE char *tcp_send_buffer = NULL;
 static CONFIG_THREAD_LOCAL_STORAGE size_t tcp_send_buffer_length = 0;
 
+// totals of the send buffers across all threads, for memory usage reporting
+static size_t tcp_send_buffer_bytes = 0;
+static size_t tcp_send_buffer_count = 0;
+
 static
 void
 destroy_ipv4_target( const struct network_target *target ) {
@@ -260,6 +265,12 @@ sendto_tcp_target( struct network_target *target,
       return -1;
 
     } else {
+      if( tcp_send_buffer_length == 0 ) {
+        config_increment_size( &tcp_send_buffer_count );
+      }
+      config_add_size( &tcp_send_buffer_bytes,
+                       required_length - tcp_send_buffer_length );
+
       tcp_send_buffer = new_buffer;
       tcp_send_buffer_length = required_length;
 
@@ -671,11 +682,22 @@ lock_network_target( const struct network_target *target ) {
 
 void
 network_free_all( void ) {
-  free_mem( tcp_send_buffer );
+  if( tcp_send_buffer_length != 0 ) {
+    config_decrement_size( &tcp_send_buffer_count );
+    config_subtract_size( &tcp_send_buffer_bytes, tcp_send_buffer_length );
+  }
+
+  free_sized_mem( tcp_send_buffer, tcp_send_buffer_length );
   tcp_send_buffer = NULL;
   tcp_send_buffer_length = 0;
 }
 
+void
+network_get_usage( struct stumpless_memory_usage *usage ) {
+  usage->bytes += config_read_size( &tcp_send_buffer_bytes );
+  usage->count += config_read_size( &tcp_send_buffer_count );
+}
+
 int
 network_target_is_open( const struct stumpless_target *target ) {
   const struct network_target *net_target;
@@ -16,12 +16,17 @@
  * limitations under the License.
  */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
+#include <stumpless/memory.h>
+#include <stumpless/severity.h>
 #include <stumpless/target.h>
 #include <stumpless/target/stream.h>
 #include "private/config/locale/wrapper.h"
 #include "private/config/wrapper/thread_safety.h"
+#include "private/config/wrapper.h"
 #include "private/error.h"
 #include "private/inthelper.h"
 #include "private/memory.h"
@@ -29,6 +34,59 @@
 #include "private/target/stream.h"
 #include "private/validate.h"
 
+static size_t buffer_bytes = 0;
+static size_t buffer_count = 0;
+
+/*
+ * Writes the messages in the buffer of the target to the stream, and flushes
+ * the stream if anything has been written to it since it was last flushed.
+ * The stream_mutex of the target must be held by the caller.
+ *
+ * The buffer is emptied even if the write fails, as there is no way to know
+ * how much of it was written.
+ */
+static
+int
+write_held_messages( struct stream_target *target ) {
+  size_t used;
+
+  used = target->buffer_used;
+  if( used != 0 ) {
+    target->buffer_used = 0;
+    target->unflushed = true;
+    if( fwrite( target->buffer, sizeof( char ), used, target->stream ) !=
+          used ) {
+      raise_stream_write_failure(  );
+      return -1;
+    }
+  }
+
+  if( !target->unflushed ) {
+    return 0;
+  }
+
+  target->unflushed = false;
+  if( fflush( target->stream ) != 0 ) {
+    raise_stream_write_failure(  );
+    return -1;
+  }
+
+  return 0;
+}
+
+/*
+ * Checks whether the oldest message held by the target has waited for longer
+ * than the flush interval. The stream_mutex of the target must be held by the
+ * caller.
+ */
+static
+bool
+flush_interval_passed( const struct stream_target *target ) {
+  return target->flush_interval != 0 &&
+         config_get_monotonic_milliseconds(  ) - target->flush_start >=
+           target->flush_interval;
+}
+
 void
 stumpless_close_stream_target( const struct stumpless_target *target ) {
   if( !target ) {
@@ -41,9 +99,9 @@ stumpless_close_stream_target( const struct stumpless_target *target ) {
     return;
   }
 
-  clear_error(  );
   destroy_stream_target( target->id );
   destroy_target( target );
+  clear_error(  );
 }
 
 struct stumpless_target *
@@ -85,14 +143,150 @@ fail:
   return NULL;
 }
 
+struct stumpless_target *
+stumpless_set_stream_buffering( struct stumpless_target *target,
+                                enum stumpless_stream_buffering buffering,
+                                size_t size ) {
+  struct stream_target *stream;
+  char *new_buffer = NULL;
+  char *old_buffer;
+  size_t old_size;
+  int result;
+
+  VALIDATE_ARG_NOT_NULL( target );
+
+  if( target->type != STUMPLESS_STREAM_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  if( buffering < STUMPLESS_STREAM_BUFFERING_DEFAULT ||
+      buffering > STUMPLESS_STREAM_BUFFERING_FULL ) {
+    raise_index_out_of_bounds(
+      L10N_INVALID_INDEX_ERROR_MESSAGE( "buffering" ),
+      buffering
+    );
+    return NULL;
+  }
+
+  if( buffering == STUMPLESS_STREAM_BUFFERING_FULL ) {
+    if( size == 0 ) {
+      size = STUMPLESS_DEFAULT_STREAM_BUFFER_SIZE;
+    }
+
+    new_buffer = alloc_mem( size );
+    if( !new_buffer ) {
+      return NULL;
+    }
+
+  } else {
+    size = 0;
+  }
+
+  stream = target->id;
+  config_lock_mutex( &stream->stream_mutex );
+
+  // anything already held must be written before the buffering changes
+  stream->unflushed = true;
+  result = write_held_messages( stream );
+
+  old_buffer = stream->buffer;
+  old_size = stream->buffer_size;
+
+  stream->buffering = buffering;
+  stream->buffer = new_buffer;
+  stream->buffer_size = size;
+  stream->buffer_used = 0;
+
+  config_unlock_mutex( &stream->stream_mutex );
+
+  if( old_buffer ) {
+    free_sized_mem( old_buffer, old_size );
+    config_subtract_size( &buffer_bytes, old_size );
+    config_decrement_size( &buffer_count );
+  }
+
+  if( new_buffer ) {
+    config_add_size( &buffer_bytes, size );
+    config_increment_size( &buffer_count );
+  }
+
+  if( result != 0 ) {
+    return NULL;
+  }
+
+  clear_error(  );
+  return target;
+}
+
+struct stumpless_target *
+stumpless_set_stream_flush_interval( struct stumpless_target *target,
+                                     unsigned int milliseconds ) {
+  struct stream_target *stream;
+
+  VALIDATE_ARG_NOT_NULL( target );
+
+  if( target->type != STUMPLESS_STREAM_TARGET ) {
+    raise_target_incompatible( L10N_INVALID_TARGET_TYPE_ERROR_MESSAGE );
+    return NULL;
+  }
+
+  stream = target->id;
+  config_lock_mutex( &stream->stream_mutex );
+  stream->flush_interval = milliseconds;
+  stream->flush_start = config_get_monotonic_milliseconds(  );
+  config_unlock_mutex( &stream->stream_mutex );
+
+  clear_error(  );
+  return target;
+}
+
 /* private definitions */
 
 void
-destroy_stream_target( const struct stream_target *target ) {
+destroy_stream_target( struct stream_target *target ) {
+  if( target->buffer || target->flush_interval != 0 ) {
+    write_held_messages( target );
+  }
+
+  if( target->buffer ) {
+    free_sized_mem( target->buffer, target->buffer_size );
+    config_subtract_size( &buffer_bytes, target->buffer_size );
+    config_decrement_size( &buffer_count );
+  }
+
   config_destroy_mutex( &target->stream_mutex );
   free_mem( target );
 }
 
+int
+flush_stream_target( struct stream_target *target ) {
+  int result;
+
+  config_lock_mutex( &target->stream_mutex );
+  target->unflushed = true;
+  result = write_held_messages( target );
+  config_unlock_mutex( &target->stream_mutex );
+
+  return result;
+}
+
+int
+flush_stream_target_for_severity( struct stream_target *target,
+                                  int severity ) {
+  int result;
+
+  if( severity > STUMPLESS_SEVERITY_ERR ) {
+    return 0;
+  }
+
+  config_lock_mutex( &target->stream_mutex );
+  result = target->buffer ? write_held_messages( target ) : 0;
+  config_unlock_mutex( &target->stream_mutex );
+
+  return result;
+}
+
 struct stream_target *
 new_stream_target( FILE *stream ) {
   struct stream_target *target;
@@ -104,6 +298,13 @@ new_stream_target( FILE *stream ) {
 
   config_init_mutex( &target->stream_mutex );
   target->stream = stream;
+  target->buffering = STUMPLESS_STREAM_BUFFERING_DEFAULT;
+  target->buffer = NULL;
+  target->buffer_size = 0;
+  target->buffer_used = 0;
+  target->unflushed = false;
+  target->flush_interval = 0;
+  target->flush_start = 0;
 
   return target;
 }
@@ -115,16 +316,73 @@ sendto_stream_target( struct stream_target *target,
   size_t fwrite_result;
 
   config_lock_mutex( &target->stream_mutex );
-  fwrite_result = fwrite( msg, sizeof( char ), msg_length, target->stream );
-  config_unlock_mutex( &target->stream_mutex );
 
-  if( fwrite_result != msg_length ) {
-    goto write_failure;
+  if( !target->buffer ) {
+    fwrite_result = fwrite( msg, sizeof( char ), msg_length, target->stream );
+    if( fwrite_result != msg_length ) {
+      goto write_failure;
+    }
+
+    if( target->buffering == STUMPLESS_STREAM_BUFFERING_LINE ) {
+      if( fflush( target->stream ) != 0 ) {
+        goto write_failure;
+      }
+
+    } else if( target->flush_interval != 0 ) {
+      if( !target->unflushed ) {
+        target->unflushed = true;
+        target->flush_start = config_get_monotonic_milliseconds(  );
+      }
+
+      if( flush_interval_passed( target ) &&
+          write_held_messages( target ) != 0 ) {
+        goto fail_locked;
+      }
+    }
+
+    config_unlock_mutex( &target->stream_mutex );
+    return cap_size_t_to_int( fwrite_result + 1 );
   }
 
-  return cap_size_t_to_int( fwrite_result + 1 );
+  if( msg_length > target->buffer_size - target->buffer_used &&
+      write_held_messages( target ) != 0 ) {
+    goto fail_locked;
+  }
+
+  if( msg_length >= target->buffer_size ) {
+    // too large to combine with anything else
+    if( fwrite( msg, sizeof( char ), msg_length, target->stream ) !=
+          msg_length ||
+        fflush( target->stream ) != 0 ) {
+      goto write_failure;
+    }
+
+  } else {
+    if( target->buffer_used == 0 ) {
+      target->flush_start = config_get_monotonic_milliseconds(  );
+    }
+
+    memcpy( target->buffer + target->buffer_used, msg, msg_length );
+    target->buffer_used += msg_length;
+
+    if( flush_interval_passed( target ) &&
+        write_held_messages( target ) != 0 ) {
+      goto fail_locked;
+    }
+  }
+
+  config_unlock_mutex( &target->stream_mutex );
+  return cap_size_t_to_int( msg_length + 1 );
 
 write_failure:
   raise_stream_write_failure(  );
+fail_locked:
+  config_unlock_mutex( &target->stream_mutex );
   return -1;
 }
+
+void
+stream_get_usage( struct stumpless_memory_usage *usage ) {
+  usage->bytes += config_read_size( &buffer_bytes );
+  usage->count += config_read_size( &buffer_count );
+}
@@ -0,0 +1,393 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stumpless.h>
+#include "test/helper/assert.hpp"
+#include "test/helper/memory_allocation.hpp"
+
+namespace {
+
+  class ArenaTest : public::testing::Test {
+    protected:
+      struct stumpless_arena *arena;
+
+      virtual void
+      SetUp( void ) {
+        arena = stumpless_new_arena( 0 );
+      }
+
+      virtual void
+      TearDown( void ) {
+        stumpless_destroy_arena( arena );
+        stumpless_free_all(  );
+      }
+
+      struct stumpless_entry *
+      build_entry( void ) {
+        struct stumpless_entry *entry;
+        const struct stumpless_entry *result;
+
+        entry = stumpless_new_arena_entry( arena,
+                                           STUMPLESS_FACILITY_USER,
+                                           STUMPLESS_SEVERITY_INFO,
+                                           "arena-app",
+                                           "arena-msgid",
+                                           "request %d handled",
+                                           42 );
+        if( !entry ) {
+          return NULL;
+        }
+
+        result = stumpless_add_new_param_to_entry( entry,
+                                                   "request",
+                                                   "method",
+                                                   "GET" );
+        if( !result ) {
+          return NULL;
+        }
+
+        result = stumpless_add_new_param_to_entry( entry,
+                                                   "request",
+                                                   "path",
+                                                   "/a/path/that/is/too/long/to/"
+                                                   "be/held/inline/in/a/param" );
+        if( !result ) {
+          return NULL;
+        }
+
+        result = stumpless_add_new_param_to_entry( entry,
+                                                   "response",
+                                                   "status",
+                                                   "200" );
+        if( !result ) {
+          return NULL;
+        }
+
+        return entry;
+      }
+  };
+
+  TEST_F( ArenaTest, BuildEntry ) {
+    const struct stumpless_entry *entry;
+    const struct stumpless_element *element;
+    const struct stumpless_param *param;
+
+    ASSERT_NOT_NULL( arena );
+
+    entry = build_entry(  );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( entry );
+
+    EXPECT_EQ( entry->arena, arena );
+    EXPECT_STREQ( entry->message, "request 42 handled" );
+    EXPECT_EQ( entry->message_length, 18 );
+    EXPECT_EQ( entry->element_count, 2 );
+
+    element = entry->elements[0];
+    EXPECT_EQ( element->arena, arena );
+    EXPECT_STREQ( element->name, "request" );
+    EXPECT_EQ( element->param_count, 2 );
+
+    param = element->params[1];
+    EXPECT_EQ( param->arena, arena );
+    EXPECT_STREQ( param->name, "path" );
+    EXPECT_STREQ( param->value,
+                  "/a/path/that/is/too/long/to/be/held/inline/in/a/param" );
+  }
+
+#ifndef STUMPLESS_NAME_INTERNING_ENABLED
+  // the first use of each name allocates space for it in the interning table
+  TEST_F( ArenaTest, BuildEntryWithoutMalloc ) {
+    void * (*set_malloc_result)(size_t);
+    const struct stumpless_entry *entry;
+
+    ASSERT_NOT_NULL( arena );
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    entry = build_entry(  );
+    EXPECT_NO_ERROR;
+    EXPECT_NOT_NULL( entry );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    EXPECT_TRUE( set_malloc_result == malloc );
+  }
+#endif
+
+  TEST_F( ArenaTest, CopyEntryOutlivesReset ) {
+    struct stumpless_entry *entry;
+    struct stumpless_entry *copy;
+    const struct stumpless_arena *result;
+
+    entry = build_entry(  );
+    ASSERT_NOT_NULL( entry );
+    stumpless_freeze_entry( entry );
+
+    copy = stumpless_copy_entry( entry );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( copy );
+    EXPECT_NULL( copy->arena );
+    EXPECT_NULL( copy->elements[0]->arena );
+    EXPECT_NULL( copy->elements[0]->params[0]->arena );
+
+    result = stumpless_reset_arena( arena );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, arena );
+
+    // overwrite the old objects to make sure the copy does not use them
+    build_entry(  );
+
+    EXPECT_STREQ( copy->message, "request 42 handled" );
+    EXPECT_STREQ( copy->elements[1]->name, "response" );
+    EXPECT_STREQ( copy->elements[1]->params[0]->value, "200" );
+
+    stumpless_destroy_entry_and_contents( copy );
+  }
+
+  TEST_F( ArenaTest, DestroyArenaEntry ) {
+    const struct stumpless_entry *entry;
+
+    entry = build_entry(  );
+    ASSERT_NOT_NULL( entry );
+
+    stumpless_destroy_entry_and_contents( entry );
+    EXPECT_NO_ERROR;
+  }
+
+  TEST_F( ArenaTest, FormatFailure ) {
+    const wchar_t invalid_string[] = { ( wchar_t ) 0x110000, L'\0' };
+    const struct stumpless_entry *entry;
+    const struct stumpless_error *error;
+
+    ASSERT_NOT_NULL( arena );
+
+    entry = stumpless_new_arena_entry( arena,
+                                       STUMPLESS_FACILITY_USER,
+                                       STUMPLESS_SEVERITY_INFO,
+                                       "arena-app",
+                                       "arena-msgid",
+                                       "bad %ls",
+                                       invalid_string );
+    EXPECT_NULL( entry );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_FORMAT_FAILURE );
+  }
+
+  TEST_F( ArenaTest, Grow ) {
+    struct stumpless_arena *small_arena;
+    struct stumpless_element *element;
+    const struct stumpless_element *result;
+    char param_name[16];
+    char param_value[64];
+    size_t i;
+
+    small_arena = stumpless_new_arena( 64 );
+    ASSERT_NOT_NULL( small_arena );
+
+    element = stumpless_new_arena_element( small_arena, "many-params" );
+    ASSERT_NOT_NULL( element );
+
+    for( i = 0; i < 50; i++ ) {
+      snprintf( param_name, sizeof( param_name ), "param-%zu", i );
+      snprintf( param_value,
+                sizeof( param_value ),
+                "a-value-long-enough-to-be-copied-to-the-arena-%zu",
+                i );
+
+      result = stumpless_add_new_param( element, param_name, param_value );
+      EXPECT_NO_ERROR;
+      ASSERT_EQ( result, element );
+    }
+
+    EXPECT_EQ( element->param_count, 50 );
+    for( i = 0; i < 50; i++ ) {
+      snprintf( param_name, sizeof( param_name ), "param-%zu", i );
+      snprintf( param_value,
+                sizeof( param_value ),
+                "a-value-long-enough-to-be-copied-to-the-arena-%zu",
+                i );
+
+      EXPECT_STREQ( element->params[i]->name, param_name );
+      EXPECT_STREQ( element->params[i]->value, param_value );
+    }
+
+    stumpless_destroy_arena( small_arena );
+  }
+
+  TEST_F( ArenaTest, LogEntry ) {
+    char buffer[1024];
+    struct stumpless_target *target;
+    const struct stumpless_entry *entry;
+    int result;
+
+    target = stumpless_open_buffer_target( "arena-buffer",
+                                           buffer,
+                                           sizeof( buffer ) );
+    ASSERT_NOT_NULL( target );
+
+    entry = build_entry(  );
+    ASSERT_NOT_NULL( entry );
+
+    result = stumpless_add_entry( target, entry );
+    EXPECT_NO_ERROR;
+    EXPECT_GE( result, 0 );
+
+    EXPECT_THAT( buffer, testing::HasSubstr( "[request method=\"GET\"" ) );
+    EXPECT_THAT( buffer, testing::HasSubstr( "[response status=\"200\"]" ) );
+    EXPECT_THAT( buffer, testing::HasSubstr( "request 42 handled" ) );
+
+    stumpless_close_buffer_target( target );
+  }
+
+  TEST_F( ArenaTest, ResetReusesMemory ) {
+    struct stumpless_arena *small_arena;
+    void * (*set_malloc_result)(size_t);
+    const struct stumpless_arena *result;
+    const struct stumpless_entry *first_entry;
+    const struct stumpless_entry *second_entry;
+
+    small_arena = stumpless_new_arena( 128 );
+    ASSERT_NOT_NULL( small_arena );
+    stumpless_destroy_arena( arena );
+    arena = small_arena;
+
+    first_entry = build_entry(  );
+    ASSERT_NOT_NULL( first_entry );
+
+    result = stumpless_reset_arena( arena );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, arena );
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    second_entry = build_entry(  );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( second_entry, first_entry );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    EXPECT_TRUE( set_malloc_result == malloc );
+  }
+
+  TEST_F( ArenaTest, SetValues ) {
+    struct stumpless_entry *entry;
+    struct stumpless_element *element;
+    struct stumpless_param *param;
+    const void *result;
+
+    entry = build_entry(  );
+    ASSERT_NOT_NULL( entry );
+
+    result = stumpless_set_entry_message_str( entry, "a new message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, entry );
+    EXPECT_STREQ( entry->message, "a new message" );
+
+    element = entry->elements[0];
+    result = stumpless_set_element_name( element, "renamed" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, element );
+    EXPECT_STREQ( element->name, "renamed" );
+
+    param = element->params[0];
+    result = stumpless_set_param_value( param, "a-value-that-is-also-too-long-"
+                                               "to-be-held-inline" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, param );
+    EXPECT_STREQ( param->value,
+                  "a-value-that-is-also-too-long-to-be-held-inline" );
+  }
+
+  /* non-fixture tests */
+
+  TEST( ArenaDestroyTest, NullArena ) {
+    stumpless_destroy_arena( NULL );
+  }
+
+  TEST( NewArenaTest, MemoryFailure ) {
+    void * (*set_malloc_result)(size_t);
+    const struct stumpless_arena *arena;
+    const struct stumpless_error *error;
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    arena = stumpless_new_arena( 0 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_NULL( arena );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    EXPECT_TRUE( set_malloc_result == malloc );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( NewArenaElementTest, NullArena ) {
+    const struct stumpless_element *element;
+    const struct stumpless_error *error;
+
+    element = stumpless_new_arena_element( NULL, "element" );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( element );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( NewArenaEntryTest, NullArena ) {
+    const struct stumpless_entry *entry;
+    const struct stumpless_error *error;
+
+    entry = stumpless_new_arena_entry( NULL,
+                                       STUMPLESS_FACILITY_USER,
+                                       STUMPLESS_SEVERITY_INFO,
+                                       "app-name",
+                                       "msgid",
+                                       "message" );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( entry );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( NewArenaParamTest, NullArena ) {
+    const struct stumpless_param *param;
+    const struct stumpless_error *error;
+
+    param = stumpless_new_arena_param( NULL, "name", "value" );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( param );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( ResetArenaTest, NullArena ) {
+    const struct stumpless_arena *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_reset_arena( NULL );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+}
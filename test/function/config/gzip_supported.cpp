@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <stdio.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string>
+#include <stumpless.h>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+#include "test/helper/assert.hpp"
+#include "test/helper/memory_allocation.hpp"
+#include "test/helper/rfc5424.hpp"
+
+namespace {
+  std::vector<std::string>
+  read_lines( const char *filename ) {
+    std::vector<std::string> lines;
+    std::string line;
+    char buffer[4096];
+    gzFile file;
+
+    file = gzopen( filename, "rb" );
+    if( !file ) {
+      return lines;
+    }
+
+    // gzgets reads through all of the members in the file
+    while( gzgets( file, buffer, sizeof( buffer ) ) ) {
+      line += buffer;
+      if( line.back(  ) == '\n' ) {
+        line.pop_back(  );
+        lines.push_back( line );
+        line.clear(  );
+      }
+    }
+
+    gzclose( file );
+    return lines;
+  }
+
+  class GzipFileTargetTest : public::testing::Test {
+    protected:
+      const char *filename = "gzip_test.log.gz";
+      struct stumpless_target *target;
+
+    virtual void
+    SetUp( void ) {
+      remove( filename );
+      target = stumpless_open_gzip_file_target( filename, 0 );
+    }
+
+    virtual void
+    TearDown( void ) {
+      stumpless_close_file_target( target );
+      remove( filename );
+      stumpless_free_all(  );
+    }
+  };
+
+  TEST_F( GzipFileTargetTest, Appended ) {
+    std::vector<std::string> lines;
+
+    ASSERT_NOT_NULL( target );
+
+    stumpless_add_message( target, "first message" );
+    EXPECT_NO_ERROR;
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+
+    // the existing file is added to with a new member
+    target = stumpless_open_gzip_file_target( filename, 0 );
+    ASSERT_NOT_NULL( target );
+    stumpless_add_message( target, "second message" );
+    EXPECT_NO_ERROR;
+    stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+
+    lines = read_lines( filename );
+    ASSERT_EQ( lines.size(  ), 2 );
+    EXPECT_THAT( lines[0], testing::EndsWith( "first message" ) );
+    EXPECT_THAT( lines[1], testing::EndsWith( "second message" ) );
+  }
+
+  TEST_F( GzipFileTargetTest, Compressed ) {
+    std::vector<std::string> lines;
+    FILE *file;
+    long compressed_size;
+    size_t message_count = 200;
+    size_t i;
+
+    ASSERT_NOT_NULL( target );
+
+    for( i = 0; i < message_count; i++ ) {
+      stumpless_add_message( target, "compressed message %zu", i );
+      EXPECT_NO_ERROR;
+    }
+
+    stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+
+    lines = read_lines( filename );
+    ASSERT_EQ( lines.size(  ), message_count );
+    for( i = 0; i < message_count; i++ ) {
+      TestRFC5424Compliance( lines[i].c_str(  ) );
+      EXPECT_THAT( lines[i],
+                   testing::EndsWith( "compressed message " +
+                                      std::to_string( i ) ) );
+    }
+
+    file = fopen( filename, "rb" );
+    ASSERT_NOT_NULL( file );
+    fseek( file, 0, SEEK_END );
+    compressed_size = ftell( file );
+    fclose( file );
+    EXPECT_LT( compressed_size, message_count * 20 );
+  }
+
+  TEST_F( GzipFileTargetTest, FlushedBySeverity ) {
+    int mask;
+
+    ASSERT_NOT_NULL( target );
+
+    mask = STUMPLESS_SEVERITY_MASK_UPTO( STUMPLESS_SEVERITY_DEBUG );
+    stumpless_set_target_mask( target, mask );
+
+    stumpless_add_log( target, STUMPLESS_SEVERITY_INFO, "info message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( read_lines( filename ).size(  ), 0 );
+
+    stumpless_add_log( target, STUMPLESS_SEVERITY_ERR, "error message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( read_lines( filename ).size(  ), 2 );
+  }
+
+  TEST_F( GzipFileTargetTest, FlushInterval ) {
+    const struct stumpless_target *result;
+
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_flush_interval( target, 1 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "first message" );
+    EXPECT_NO_ERROR;
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+
+    stumpless_add_message( target, "second message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( read_lines( filename ).size(  ), 2 );
+  }
+
+  TEST_F( GzipFileTargetTest, IncompatibleSettings ) {
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_buffer_size( target, 1024 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_file_io_uring_depth( target, 8 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+  }
+
+  TEST_F( GzipFileTargetTest, LargeMessage ) {
+    std::string large_message;
+    std::vector<std::string> lines;
+    size_t i;
+
+    ASSERT_NOT_NULL( target );
+
+    // varied enough that the compressed output fills the buffer several times
+    srand( 2022 );
+    for( i = 0; i < 128 * 1024; i++ ) {
+      large_message += ( char ) ( 'a' + rand(  ) % 26 );
+    }
+
+    stumpless_add_message( target, large_message.c_str(  ) );
+    EXPECT_NO_ERROR;
+    stumpless_add_message( target, "small message" );
+    EXPECT_NO_ERROR;
+    stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+
+    lines = read_lines( filename );
+    ASSERT_EQ( lines.size(  ), 2 );
+    EXPECT_THAT( lines[0], testing::EndsWith( large_message ) );
+    EXPECT_THAT( lines[1], testing::EndsWith( "small message" ) );
+  }
+
+  TEST_F( GzipFileTargetTest, Rotated ) {
+    const char *rotated = "gzip_test.log.gz.1";
+    std::vector<std::string> lines;
+
+    ASSERT_NOT_NULL( target );
+    remove( rotated );
+
+    stumpless_set_file_rotation( target, 1, 0, 1 );
+    EXPECT_NO_ERROR;
+
+    stumpless_add_message( target, "rotated message" );
+    EXPECT_NO_ERROR;
+
+    // the member is finished before the file is renamed
+    lines = read_lines( rotated );
+    ASSERT_EQ( lines.size(  ), 1 );
+    EXPECT_THAT( lines[0], testing::EndsWith( "rotated message" ) );
+
+    remove( rotated );
+  }
+
+  /* non-fixture tests */
+
+  TEST( GzipFileTargetOpenTest, Directory ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_gzip_file_target( "./", 0 );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_FILE_OPEN_FAILURE );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( GzipFileTargetOpenTest, LevelTooHigh ) {
+    const char *filename = "gzip_level_test.log.gz";
+    struct stumpless_target *target;
+
+    remove( filename );
+    target = stumpless_open_gzip_file_target( filename, 100 );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+
+    stumpless_add_message( target, "level message" );
+    stumpless_close_file_target( target );
+    EXPECT_EQ( read_lines( filename ).size(  ), 1 );
+
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( GzipFileTargetOpenTest, MallocFailure ) {
+    const char *filename = "gzip_malloc_failure_test.log.gz";
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+    void *(*set_malloc_result)(size_t);
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    target = stumpless_open_gzip_file_target( filename, 0 );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    ASSERT_TRUE( set_malloc_result == malloc );
+
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( GzipFileTargetOpenTest, NullName ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_gzip_file_target( NULL, 0 );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_free_all(  );
+  }
+}
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <stumpless.h>
+#include "test/helper/assert.hpp"
+
+namespace {
+
+  TEST( GzipFileTargetOpenTest, Unsupported ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_gzip_file_target( "gzip_unsupported.log.gz", 0 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_UNSUPPORTED );
+    EXPECT_NULL( target );
+
+    remove( "gzip_unsupported.log.gz" );
+    stumpless_free_all(  );
+  }
+}
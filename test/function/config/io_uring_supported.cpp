@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stddef.h>
+#include <string>
+#include <stumpless.h>
+#include "test/helper/assert.hpp"
+#include "test/helper/rfc5424.hpp"
+
+namespace {
+  size_t
+  count_lines( const char *filename ) {
+    std::ifstream infile( filename );
+    std::string line;
+    size_t count = 0;
+
+    while( std::getline( infile, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      count++;
+    }
+
+    return count;
+  }
+
+  class IoUringTest : public::testing::Test {
+    protected:
+      const char *filename = "io_uring_test.log";
+      struct stumpless_target *target;
+
+    virtual void
+    SetUp( void ) {
+      remove( filename );
+      target = stumpless_open_raw_file_target( filename );
+    }
+
+    virtual void
+    TearDown( void ) {
+      stumpless_close_file_target( target );
+      remove( filename );
+      stumpless_free_all(  );
+    }
+  };
+
+  TEST_F( IoUringTest, ClosedWithQueuedMessages ) {
+    const struct stumpless_target *result;
+    size_t i;
+
+    result = stumpless_set_file_io_uring_depth( target, 64 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    for( i = 0; i < 3; i++ ) {
+      stumpless_add_message( target, "queued message %zu", i );
+      EXPECT_NO_ERROR;
+    }
+
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+    target = stumpless_open_raw_file_target( filename );
+
+    EXPECT_EQ( count_lines( filename ), 3 );
+  }
+
+  TEST_F( IoUringTest, FlushedBySeverity ) {
+    const struct stumpless_target *result;
+    int mask;
+
+    mask = STUMPLESS_SEVERITY_MASK_UPTO( STUMPLESS_SEVERITY_DEBUG );
+    stumpless_set_target_mask( target, mask );
+
+    result = stumpless_set_file_io_uring_depth( target, 64 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    // a single message is not enough for a batch to be submitted
+    stumpless_add_log( target, STUMPLESS_SEVERITY_INFO, "info message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 0 );
+
+    stumpless_add_log( target, STUMPLESS_SEVERITY_ERR, "error message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 2 );
+  }
+
+  TEST_F( IoUringTest, LargeMessage ) {
+    const struct stumpless_target *result;
+    std::string large_message( 8 * 1024, 'x' );
+    std::ifstream infile;
+    std::string line;
+    size_t i;
+
+    result = stumpless_set_file_io_uring_depth( target, 8 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "first message" );
+    EXPECT_NO_ERROR;
+    stumpless_add_message( target, large_message.c_str(  ) );
+    EXPECT_NO_ERROR;
+    stumpless_add_message( target, "last message" );
+    EXPECT_NO_ERROR;
+
+    stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+
+    infile.open( filename );
+    i = 0;
+    while( std::getline( infile, line ) ) {
+      if( i == 0 ) {
+        EXPECT_THAT( line, testing::EndsWith( "first message" ) );
+      } else if( i == 1 ) {
+        EXPECT_THAT( line, testing::EndsWith( large_message ) );
+      } else {
+        EXPECT_THAT( line, testing::EndsWith( "last message" ) );
+      }
+      i++;
+    }
+    EXPECT_EQ( i, 3 );
+  }
+
+  TEST_F( IoUringTest, MemoryStats ) {
+    struct stumpless_memory_stats before;
+    struct stumpless_memory_stats during;
+    struct stumpless_memory_stats after;
+
+    stumpless_get_memory_stats( &before );
+
+    stumpless_set_file_io_uring_depth( target, 16 );
+    EXPECT_NO_ERROR;
+    stumpless_get_memory_stats( &during );
+    EXPECT_GE( during.file_buffers.bytes, before.file_buffers.bytes + 16 * 4096 );
+    EXPECT_EQ( during.file_buffers.count, before.file_buffers.count + 1 );
+
+    stumpless_set_file_io_uring_depth( target, 0 );
+    EXPECT_NO_ERROR;
+    stumpless_get_memory_stats( &after );
+    EXPECT_EQ( after.file_buffers.bytes, before.file_buffers.bytes );
+    EXPECT_EQ( after.file_buffers.count, before.file_buffers.count );
+  }
+
+  TEST_F( IoUringTest, MessagesInOrder ) {
+    const struct stumpless_target *result;
+    std::ifstream infile;
+    std::string line;
+    size_t message_count = 1000;
+    size_t i;
+
+    // a small depth forces the queue to wrap around many times
+    result = stumpless_set_file_io_uring_depth( target, 4 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    for( i = 0; i < message_count; i++ ) {
+      stumpless_add_message( target, "ordered message %zu", i );
+      EXPECT_NO_ERROR;
+    }
+
+    result = stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    infile.open( filename );
+    i = 0;
+    while( std::getline( infile, line ) ) {
+      TestRFC5424Compliance( line.c_str(  ) );
+      EXPECT_THAT( line,
+                   testing::EndsWith( "ordered message " +
+                                      std::to_string( i ) ) );
+      i++;
+    }
+    EXPECT_EQ( i, message_count );
+  }
+
+  TEST_F( IoUringTest, Removed ) {
+    const struct stumpless_target *result;
+
+    result = stumpless_set_file_io_uring_depth( target, 64 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "queued message" );
+    EXPECT_NO_ERROR;
+
+    // removing the ring writes everything queued on it
+    result = stumpless_set_file_io_uring_depth( target, 0 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+    EXPECT_EQ( count_lines( filename ), 1 );
+
+    stumpless_add_message( target, "direct message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 2 );
+  }
+
+  /* non-fixture tests */
+
+  TEST( IoUringDepthTest, NotRegularFile ) {
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_raw_file_target( "/dev/null" );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_io_uring_depth( target, 8 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    stumpless_close_file_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( IoUringDepthTest, NullTarget ) {
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_file_io_uring_depth( NULL, 8 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( IoUringDepthTest, StreamFileTarget ) {
+    const char *filename = "io_uring_stream_test.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_io_uring_depth( target, 8 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( IoUringDepthTest, WrongTargetType ) {
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_stdout_target( "io-uring-wrong-type" );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_io_uring_depth( target, 8 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    stumpless_close_stream_target( target );
+    stumpless_free_all(  );
+  }
+}
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <stumpless.h>
+#include "test/helper/assert.hpp"
+
+namespace {
+
+  TEST( IoUringDepthTest, Unsupported ) {
+    const char *filename = "io_uring_unsupported_test.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    remove( filename );
+    target = stumpless_open_raw_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_io_uring_depth( target, 8 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_UNSUPPORTED );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_file_io_uring_depth( target, 0 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "direct message" );
+    EXPECT_NO_ERROR;
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+}
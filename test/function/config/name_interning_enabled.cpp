@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stddef.h>
+#include <stumpless.h>
+#include "test/helper/assert.hpp"
+
+namespace {
+
+  TEST( NameInterningTest, CopiedElementSharesName ) {
+    struct stumpless_element *element;
+    struct stumpless_element *copy;
+
+    element = stumpless_new_element( "interned-element" );
+    ASSERT_NOT_NULL( element );
+
+    copy = stumpless_copy_element( element );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( copy );
+    EXPECT_EQ( copy->name, element->name );
+
+    stumpless_destroy_element_and_contents( copy );
+    stumpless_destroy_element_and_contents( element );
+    stumpless_free_all(  );
+  }
+
+  TEST( NameInterningTest, EntryLookups ) {
+    struct stumpless_entry *entry;
+    const struct stumpless_element *element;
+    bool has_element;
+
+    entry = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                                 STUMPLESS_SEVERITY_INFO,
+                                 "app-name",
+                                 "msgid",
+                                 "message" );
+    ASSERT_NOT_NULL( entry );
+
+    stumpless_add_new_element( entry, "lookup-element" );
+    EXPECT_NO_ERROR;
+
+    element = stumpless_get_element_by_name( entry, "lookup-element" );
+    EXPECT_NO_ERROR;
+    EXPECT_NOT_NULL( element );
+
+    has_element = stumpless_entry_has_element( entry, "never-interned" );
+    EXPECT_NO_ERROR;
+    EXPECT_FALSE( has_element );
+
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_free_all(  );
+  }
+
+  TEST( NameInterningTest, NewParamsShareName ) {
+    struct stumpless_param *param_1;
+    struct stumpless_param *param_2;
+
+    param_1 = stumpless_new_param( "interned-param", "value-1" );
+    ASSERT_NOT_NULL( param_1 );
+
+    param_2 = stumpless_new_param( "interned-param", "value-2" );
+    ASSERT_NOT_NULL( param_2 );
+
+    EXPECT_EQ( param_1->name, param_2->name );
+    EXPECT_NE( param_1->value, param_2->value );
+
+    stumpless_destroy_param( param_1 );
+    stumpless_destroy_param( param_2 );
+    stumpless_free_all(  );
+  }
+
+  TEST( NameInterningTest, ParamLookups ) {
+    struct stumpless_element *element;
+    const char *value;
+
+    element = stumpless_new_element( "param-lookup-element" );
+    ASSERT_NOT_NULL( element );
+
+    stumpless_add_new_param( element, "lookup-param", "lookup-value" );
+    EXPECT_NO_ERROR;
+
+    value = stumpless_get_param_value_by_name( element, "lookup-param" );
+    EXPECT_NO_ERROR;
+    EXPECT_STREQ( value, "lookup-value" );
+    free( ( void * ) value );
+
+    EXPECT_FALSE( stumpless_element_has_param( element, "never-interned" ) );
+    EXPECT_NO_ERROR;
+
+    stumpless_destroy_element_and_contents( element );
+    stumpless_free_all(  );
+  }
+
+  TEST( NameInterningTest, SetNames ) {
+    struct stumpless_element *element_1;
+    struct stumpless_element *element_2;
+    const struct stumpless_element *result;
+
+    element_1 = stumpless_new_element( "first-name" );
+    ASSERT_NOT_NULL( element_1 );
+
+    element_2 = stumpless_new_element( "second-name" );
+    ASSERT_NOT_NULL( element_2 );
+    EXPECT_NE( element_1->name, element_2->name );
+
+    result = stumpless_set_element_name( element_2, "first-name" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, element_2 );
+    EXPECT_EQ( element_1->name, element_2->name );
+    EXPECT_EQ( element_2->name_length, 10 );
+
+    stumpless_destroy_element_and_contents( element_1 );
+    stumpless_destroy_element_and_contents( element_2 );
+    stumpless_free_all(  );
+  }
+}
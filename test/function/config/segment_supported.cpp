@@ -0,0 +1,267 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stddef.h>
+#include <string>
+#include <stumpless.h>
+#include "test/helper/assert.hpp"
+#include "test/helper/memory_allocation.hpp"
+#include "test/helper/rfc5424.hpp"
+
+namespace {
+  std::string
+  segment_name( const char *name, size_t number ) {
+    return std::string( name ) + "." + std::to_string( number );
+  }
+
+  void
+  remove_segments( const char *name ) {
+    size_t i;
+
+    for( i = 1; i < 100; i++ ) {
+      remove( segment_name( name, i ).c_str(  ) );
+    }
+  }
+
+  class SegmentFileTargetTest : public::testing::Test {
+    protected:
+      const char *name = "segment_test.log";
+      struct stumpless_target *target;
+
+    virtual void
+    SetUp( void ) {
+      remove_segments( name );
+      target = stumpless_open_segment_file_target( name, 1024 );
+    }
+
+    virtual void
+    TearDown( void ) {
+      stumpless_close_file_target( target );
+      remove_segments( name );
+      stumpless_free_all(  );
+    }
+  };
+
+  TEST_F( SegmentFileTargetTest, ExistingSegmentKept ) {
+    const char *existing_name = "segment_existing_test.log";
+    struct stumpless_target *existing_target;
+    std::ifstream first_segment;
+    std::ifstream second_segment;
+    std::string line;
+
+    remove_segments( existing_name );
+    {
+      std::ofstream existing_segment( segment_name( existing_name, 1 ) );
+      existing_segment << "existing line" << std::endl;
+    }
+
+    existing_target = stumpless_open_segment_file_target( existing_name, 1024 );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( existing_target );
+
+    stumpless_add_message( existing_target, "new message" );
+    EXPECT_NO_ERROR;
+    stumpless_close_file_target( existing_target );
+
+    first_segment.open( segment_name( existing_name, 1 ) );
+    ASSERT_TRUE( std::getline( first_segment, line ) );
+    EXPECT_EQ( line, "existing line" );
+    EXPECT_FALSE( std::getline( first_segment, line ) );
+
+    second_segment.open( segment_name( existing_name, 2 ) );
+    ASSERT_TRUE( std::getline( second_segment, line ) );
+    EXPECT_THAT( line, testing::EndsWith( "new message" ) );
+
+    remove_segments( existing_name );
+  }
+
+  TEST_F( SegmentFileTargetTest, Flush ) {
+    const struct stumpless_target *result;
+
+    ASSERT_NOT_NULL( target );
+
+    stumpless_add_message( target, "flushed message" );
+    EXPECT_NO_ERROR;
+
+    result = stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+  }
+
+  TEST_F( SegmentFileTargetTest, IncompatibleSettings ) {
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_buffer_size( target, 1024 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_file_io_uring_depth( target, 8 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_file_rotation( target, 1024, 0, 2 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+  }
+
+  TEST_F( SegmentFileTargetTest, MessageTooBig ) {
+    std::string large_message( 2048, 'x' );
+    const struct stumpless_error *error;
+    int result;
+
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_add_message( target, large_message.c_str(  ) );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_TOO_BIG );
+    EXPECT_LT( result, 0 );
+
+    // the target is still usable afterwards
+    stumpless_add_message( target, "small message" );
+    EXPECT_NO_ERROR;
+  }
+
+  TEST_F( SegmentFileTargetTest, Rolled ) {
+    std::ifstream segment;
+    std::string line;
+    size_t message_count = 100;
+    size_t segment_count;
+    size_t i;
+
+    ASSERT_NOT_NULL( target );
+
+    for( i = 0; i < message_count; i++ ) {
+      stumpless_add_message( target, "segment message %zu", i );
+      EXPECT_NO_ERROR;
+    }
+
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+    target = NULL;
+
+    i = 0;
+    for( segment_count = 1; segment_count < 100; segment_count++ ) {
+      segment.open( segment_name( name, segment_count ) );
+      if( !segment.is_open(  ) ) {
+        break;
+      }
+
+      // trimmed segments hold whole messages and no padding
+      while( std::getline( segment, line ) ) {
+        TestRFC5424Compliance( line.c_str(  ) );
+        EXPECT_THAT( line,
+                     testing::EndsWith( "segment message " +
+                                        std::to_string( i ) ) );
+        i++;
+      }
+
+      segment.close(  );
+      segment.clear(  );
+    }
+
+    EXPECT_EQ( i, message_count );
+    EXPECT_GT( segment_count, 2 );
+
+    target = stumpless_open_segment_file_target( name, 1024 );
+  }
+
+  /* non-fixture tests */
+
+  TEST( SegmentFileTargetOpenTest, DefaultSize ) {
+    const char *name = "segment_default_size_test.log";
+    struct stumpless_target *target;
+
+    remove_segments( name );
+
+    target = stumpless_open_segment_file_target( name, 0 );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+
+    stumpless_add_message( target, "default size message" );
+    EXPECT_NO_ERROR;
+
+    stumpless_close_file_target( target );
+    remove_segments( name );
+    stumpless_free_all(  );
+  }
+
+  TEST( SegmentFileTargetOpenTest, Directory ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_segment_file_target( "./missing-dir/segment", 1024 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_FILE_OPEN_FAILURE );
+    EXPECT_NULL( target );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( SegmentFileTargetOpenTest, MallocFailure ) {
+    const char *name = "segment_malloc_failure_test.log";
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+    void *(*set_malloc_result)(size_t);
+
+    remove_segments( name );
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    target = stumpless_open_segment_file_target( name, 1024 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_NULL( target );
+
+    stumpless_set_malloc( malloc );
+    remove_segments( name );
+    stumpless_free_all(  );
+  }
+
+  TEST( SegmentFileTargetOpenTest, NullName ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_segment_file_target( NULL, 1024 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( target );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( SegmentFileTargetOpenTest, TooBig ) {
+    const char *name = "segment_too_big_test.log";
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    remove_segments( name );
+
+    target = stumpless_open_segment_file_target( name, SIZE_MAX );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_FILE_OPEN_FAILURE );
+    EXPECT_NULL( target );
+
+    remove_segments( name );
+    stumpless_free_all(  );
+  }
+}
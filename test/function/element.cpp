@@ -17,6 +17,7 @@
  */
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -221,6 +222,8 @@ namespace {
     EXPECT_TRUE( set_malloc_result == malloc );
   }
 
+#ifndef STUMPLESS_NAME_INTERNING_ENABLED
+  // interned param names are not copied, so this allocation never happens
   TEST_F( ElementTest, CopyMallocFailureOnParamName ) {
     void * (*set_malloc_result)(size_t);
     const struct stumpless_element *result;
@@ -237,6 +240,7 @@ namespace {
     set_malloc_result = stumpless_set_malloc( malloc );
     EXPECT_TRUE( set_malloc_result == malloc );
   }
+#endif
 
   TEST_F( ElementTest, CopyReallocFailure ) {
     struct stumpless_element *result;
@@ -289,6 +293,146 @@ namespace {
     stumpless_destroy_element_and_contents( result );
   }
 
+  TEST_F( ElementTest, Freeze ) {
+    const struct stumpless_element *result;
+    const char *value;
+
+    result = stumpless_freeze_element( element_with_params );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, element_with_params );
+    EXPECT_TRUE( element_with_params->frozen );
+    EXPECT_TRUE( param_1->frozen );
+    EXPECT_TRUE( param_2->frozen );
+    EXPECT_FALSE( basic_element->frozen );
+
+    value = stumpless_get_param_value_by_name( element_with_params,
+                                               param_2_name );
+    EXPECT_NO_ERROR;
+    EXPECT_STREQ( value, param_2_value );
+    free( ( void * ) value );
+
+    EXPECT_TRUE( stumpless_element_has_param( element_with_params,
+                                              param_1_name ) );
+  }
+
+  TEST_F( ElementTest, FreezeThenModify ) {
+    const struct stumpless_element *result;
+    struct stumpless_param *param;
+    const struct stumpless_error *error;
+
+    stumpless_freeze_element( element_with_params );
+    EXPECT_NO_ERROR;
+
+    param = stumpless_new_param( "new-param", "new-value" );
+    ASSERT_NOT_NULL( param );
+
+    result = stumpless_add_param( element_with_params, param );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_param( element_with_params, 0, param );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    stumpless_destroy_param( param );
+
+    result = stumpless_add_new_param( element_with_params, "new", "value" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_element_name( element_with_params, "new-name" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_param_value_by_index( element_with_params, 0, "v" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_param_value_by_name( element_with_params,
+                                                param_1_name,
+                                                "v" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_reserve_params( element_with_params, 100 );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    EXPECT_EQ( stumpless_get_param_count( element_with_params ), 2 );
+    EXPECT_STREQ( element_with_params->name, with_params_name );
+    EXPECT_STREQ( param_1->value, param_1_value );
+  }
+  TEST_F( ElementTest, FreezeThenCopyOnWriteAfterDestroy ) {
+    struct stumpless_element *copy;
+    const struct stumpless_element *result;
+    const char *value;
+
+    stumpless_freeze_element( element_with_params );
+    EXPECT_NO_ERROR;
+
+    copy = stumpless_copy_element( element_with_params );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( copy );
+
+    // the copy is now the only owner of the frozen params
+    stumpless_destroy_element_and_contents( element_with_params );
+    element_with_params = copy;
+    EXPECT_EQ( copy->params[0]->reference_count, 1 );
+
+    result = stumpless_set_param_value_by_index( copy, 0, "new-value" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, copy );
+    EXPECT_FALSE( copy->params[0]->frozen );
+
+    value = stumpless_get_param_value_by_index( copy, 0 );
+    EXPECT_NO_ERROR;
+    EXPECT_STREQ( value, "new-value" );
+    free( ( void * ) value );
+  }
+
+  TEST_F( ElementTest, FreezeThenCopyOnWrite ) {
+    struct stumpless_element *copy;
+    const struct stumpless_element *result;
+    const char *value;
+
+    stumpless_freeze_element( element_with_params );
+    EXPECT_NO_ERROR;
+
+    copy = stumpless_copy_element( element_with_params );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( copy );
+    EXPECT_FALSE( copy->frozen );
+    ASSERT_EQ( copy->param_count, 2 );
+    EXPECT_EQ( copy->params[0], param_1 );
+    EXPECT_EQ( copy->params[1], param_2 );
+    EXPECT_EQ( param_1->reference_count, 2 );
+
+    result = stumpless_set_param_value_by_name( copy,
+                                                param_1_name,
+                                                "new-value" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, copy );
+    EXPECT_NE( copy->params[0], param_1 );
+    EXPECT_EQ( param_1->reference_count, 1 );
+
+    result = stumpless_set_param_value_by_index( copy, 1, "other-value" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, copy );
+    EXPECT_NE( copy->params[1], param_2 );
+    EXPECT_EQ( param_2->reference_count, 1 );
+
+    value = stumpless_get_param_value_by_index( copy, 0 );
+    EXPECT_STREQ( value, "new-value" );
+    free( ( void * ) value );
+
+    value = stumpless_get_param_value_by_index( element_with_params, 0 );
+    EXPECT_STREQ( value, param_1_value );
+    free( ( void * ) value );
+
+    stumpless_destroy_element_and_contents( copy );
+  }
+
+
   TEST_F( ElementTest, GetName ) {
     const char *name;
 
@@ -598,6 +742,72 @@ namespace {
     EXPECT_ERROR_ID_EQ( STUMPLESS_INVALID_ENCODING );
   }
   
+  TEST_F( ElementTest, ReserveParams ) {
+    const struct stumpless_element *result;
+    const struct stumpless_param *param;
+    void * (*set_realloc_result)(void *, size_t);
+    size_t i;
+
+    result = stumpless_reserve_params( element_with_params, 20 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, element_with_params );
+    EXPECT_GE( element_with_params->param_capacity, 20 );
+    EXPECT_EQ( stumpless_get_param_count( element_with_params ), 2 );
+
+    // no further reallocation should be needed to fill the reserved space
+    set_realloc_result = stumpless_set_realloc( REALLOC_FAIL );
+    ASSERT_NOT_NULL( set_realloc_result );
+
+    for( i = 2; i < 20; i++ ) {
+      result = stumpless_add_new_param( element_with_params,
+                                        "reserved-param",
+                                        "reserved-value" );
+      EXPECT_NO_ERROR;
+      EXPECT_EQ( result, element_with_params );
+    }
+
+    stumpless_set_realloc( realloc );
+
+    EXPECT_EQ( stumpless_get_param_count( element_with_params ), 20 );
+    param = stumpless_get_param_by_index( element_with_params, 0 );
+    EXPECT_EQ( param, param_1 );
+  }
+
+  TEST_F( ElementTest, ReserveParamsMemoryFailure ) {
+    const struct stumpless_element *result;
+    const struct stumpless_error *error;
+    void * (*set_realloc_result)(void *, size_t);
+    size_t original_capacity;
+
+    original_capacity = element_with_params->param_capacity;
+
+    set_realloc_result = stumpless_set_realloc( REALLOC_FAIL );
+    ASSERT_NOT_NULL( set_realloc_result );
+
+    result = stumpless_reserve_params( element_with_params,
+                                       original_capacity + 1 );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_EQ( element_with_params->param_capacity, original_capacity );
+    EXPECT_EQ( stumpless_get_param_count( element_with_params ), 2 );
+
+    stumpless_set_realloc( realloc );
+  }
+
+  TEST_F( ElementTest, ReserveParamsOverflow ) {
+    const struct stumpless_element *result;
+    const struct stumpless_error *error;
+    size_t original_capacity;
+
+    original_capacity = element_with_params->param_capacity;
+
+    result = stumpless_reserve_params( element_with_params, SIZE_MAX );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_EQ( element_with_params->param_capacity, original_capacity );
+    EXPECT_EQ( stumpless_get_param_count( element_with_params ), 2 );
+  }
+
   TEST_F( ElementTest, SetNameMemoryFailure ) {
     void * (*set_malloc_result)(size_t);
     const char *new_name = "this-wont-work";
@@ -794,6 +1004,88 @@ namespace {
     EXPECT_NULL( result );
   }
 
+  TEST_F( ElementTest, SetParamValues ) {
+    const char *values[] = { "new-value-1", "new-value-2" };
+    const struct stumpless_element *result;
+
+    result = stumpless_set_param_values( element_with_params, values, 2 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, element_with_params );
+
+    EXPECT_STREQ( param_1->value, "new-value-1" );
+    EXPECT_STREQ( param_2->value, "new-value-2" );
+  }
+
+  TEST_F( ElementTest, SetParamValuesFrozen ) {
+    const char *values[] = { "new-value-1" };
+    const struct stumpless_element *result;
+    const struct stumpless_error *error;
+
+    stumpless_freeze_element( element_with_params );
+
+    result = stumpless_set_param_values( element_with_params, values, 1 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+    EXPECT_NULL( result );
+  }
+
+  TEST_F( ElementTest, SetParamValuesNullValue ) {
+    const char *values[] = { NULL, "new-value-2" };
+    const struct stumpless_element *result;
+
+    result = stumpless_set_param_values( element_with_params, values, 2 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, element_with_params );
+
+    EXPECT_STREQ( param_1->value, param_1_value );
+    EXPECT_STREQ( param_2->value, "new-value-2" );
+  }
+
+  TEST_F( ElementTest, SetParamValuesNullValues ) {
+    const struct stumpless_element *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_param_values( element_with_params, NULL, 2 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+  }
+
+  TEST_F( ElementTest, SetParamValuesMemoryFailure ) {
+    const char *values[] = {
+      "new-value-1",
+      "a new value that is too long to be held inside of the param"
+    };
+    const struct stumpless_element *result;
+    const struct stumpless_error *error;
+    void * (*set_malloc_result)(size_t);
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_set_param_values( element_with_params, values, 2 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_NULL( result );
+
+    EXPECT_STREQ( param_1->value, param_1_value );
+    EXPECT_STREQ( param_2->value, param_2_value );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    ASSERT_TRUE( set_malloc_result == malloc );
+  }
+
+  TEST_F( ElementTest, SetParamValuesTooMany ) {
+    const char *values[] = { "new-value-1", "new-value-2", "new-value-3" };
+    const struct stumpless_element *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_param_values( element_with_params, values, 3 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_INDEX_OUT_OF_BOUNDS );
+    EXPECT_EQ( error->code, 2 );
+    EXPECT_NULL( result );
+
+    EXPECT_STREQ( param_1->value, param_1_value );
+    EXPECT_STREQ( param_2->value, param_2_value );
+  }
+
   TEST_F( ElementTest, GetElementToStringWithParams) {
     const char *format;
 
@@ -884,6 +1176,17 @@ namespace {
     stumpless_destroy_element_and_contents( NULL );
   }
 
+  TEST( FreezeElementTest, NullElement ) {
+    const struct stumpless_element *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_freeze_element( NULL );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_free_all(  );
+  }
+
   TEST( GetElementNameTest, NullElement ) {
     const char *result;
     const struct stumpless_error *error;
@@ -1030,6 +1333,29 @@ namespace {
     stumpless_free_all(  );
   }
   
+  TEST( ReserveParamsTest, NullElement ) {
+    const struct stumpless_element *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_reserve_params( NULL, 4 );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( SetParamValuesTest, NullElement ) {
+    const char *values[] = { "value" };
+    const struct stumpless_element *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_param_values( NULL, values, 1 );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_free_all(  );
+  }
+
   TEST( SetElementNameTest, NullElement ) {
     const struct stumpless_element *result;
     const struct stumpless_error *error;
@@ -19,8 +19,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <string>
 #include <stumpless.h>
 #include "test/helper/assert.hpp"
 #include "test/helper/fixture.hpp"
@@ -130,6 +132,14 @@ namespace {
     const struct stumpless_error *error;
     void * (*set_realloc_result)(void *, size_t);
 
+    // fill the existing capacity so that the next add must grow the array
+    while( basic_entry->element_count < basic_entry->element_capacity ) {
+      std::string filler_name = "filler-" +
+                                std::to_string( basic_entry->element_count );
+      entry = stumpless_add_new_element( basic_entry, filler_name.c_str(  ) );
+      ASSERT_NOT_NULL( entry );
+    }
+
     element = stumpless_new_element( "test-memory-failure" );
     ASSERT_NOT_NULL( element );
     EXPECT_EQ( NULL, stumpless_get_error(  ) );
@@ -329,6 +339,8 @@ namespace {
     EXPECT_TRUE( set_malloc_result == malloc );
   }
 
+#ifndef STUMPLESS_NAME_INTERNING_ENABLED
+  // interned element names are not copied, so this allocation never happens
   TEST_F( EntryTest, CopyMallocFailureOnElementName ) {
     void * (*set_malloc_result)(size_t);
     const struct stumpless_entry *result;
@@ -345,6 +357,7 @@ namespace {
     set_malloc_result = stumpless_set_malloc( malloc );
     EXPECT_TRUE( set_malloc_result == malloc );
   }
+#endif
 
   TEST_F( EntryTest, CopyReallocFailure ) {
     const struct stumpless_entry *result;
@@ -395,6 +408,242 @@ namespace {
     EXPECT_TRUE( set_malloc_result == malloc );
   }
 
+  TEST_F( EntryTest, Freeze ) {
+    const struct stumpless_entry *result;
+    const struct stumpless_element *element;
+    const char *app_name;
+    const char *param_value;
+    const struct stumpless_error *error;
+
+    result = stumpless_freeze_entry( basic_entry );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_entry );
+    EXPECT_TRUE( basic_entry->frozen );
+    EXPECT_TRUE( element_1->frozen );
+    EXPECT_TRUE( param_1_1->frozen );
+
+    // reads still work as usual
+    app_name = stumpless_get_entry_app_name( basic_entry );
+    EXPECT_NO_ERROR;
+    EXPECT_STREQ( app_name, basic_app_name );
+    free( ( void * ) app_name );
+
+    element = stumpless_get_element_by_name( basic_entry, element_1_name );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( element, element_1 );
+
+    param_value = stumpless_get_entry_param_value_by_index( basic_entry, 0, 0 );
+    EXPECT_NO_ERROR;
+    EXPECT_STREQ( param_value, param_1_1_value );
+    free( ( void * ) param_value );
+
+    // freezing a second time has no effect
+    result = stumpless_freeze_entry( basic_entry );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_entry );
+  }
+
+  TEST_F( EntryTest, FreezeThenCopy ) {
+    struct stumpless_entry *copy;
+    const struct stumpless_entry *result;
+
+    stumpless_freeze_entry( basic_entry );
+    EXPECT_NO_ERROR;
+
+    copy = stumpless_copy_entry( basic_entry );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( copy );
+    EXPECT_FALSE( copy->frozen );
+
+    result = stumpless_set_entry_app_name( copy, "copy-app-name" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, copy );
+
+    result = stumpless_set_entry_param_value_by_index( copy, 0, 0, "new" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, copy );
+
+    stumpless_destroy_entry_and_contents( copy );
+  }
+
+  TEST_F( EntryTest, FreezeThenCopyOnWrite ) {
+    struct stumpless_entry *copy;
+    const struct stumpless_entry *result;
+    const char *value;
+
+    stumpless_freeze_entry( basic_entry );
+    EXPECT_NO_ERROR;
+
+    copy = stumpless_copy_entry( basic_entry );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( copy );
+
+    result = stumpless_set_entry_param_value_by_name( copy,
+                                                      element_1_name,
+                                                      param_1_1_name,
+                                                      "new-value" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, copy );
+
+    EXPECT_NE( copy->elements[0], element_1 );
+    EXPECT_FALSE( copy->elements[0]->frozen );
+    EXPECT_EQ( element_1->reference_count, 1 );
+    EXPECT_EQ( copy->elements[1], element_2 );
+    EXPECT_EQ( element_2->reference_count, 2 );
+
+    value = stumpless_get_entry_param_value_by_index( copy, 0, 0 );
+    EXPECT_NO_ERROR;
+    EXPECT_STREQ( value, "new-value" );
+    free( ( void * ) value );
+
+    value = stumpless_get_entry_param_value_by_index( basic_entry, 0, 0 );
+    EXPECT_NO_ERROR;
+    EXPECT_STREQ( value, param_1_1_value );
+    free( ( void * ) value );
+
+    stumpless_destroy_entry_and_contents( copy );
+    EXPECT_EQ( element_2->reference_count, 1 );
+  }
+
+  TEST_F( EntryTest, FreezeThenCopyOnWriteAfterDestroy ) {
+    struct stumpless_entry *copy;
+    const struct stumpless_entry *result;
+    const char *value;
+
+    stumpless_freeze_entry( basic_entry );
+    EXPECT_NO_ERROR;
+
+    copy = stumpless_copy_entry( basic_entry );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( copy );
+
+    // the copy is now the only owner of the frozen elements
+    stumpless_destroy_entry_and_contents( basic_entry );
+    basic_entry = copy;
+    EXPECT_EQ( copy->elements[0]->reference_count, 1 );
+
+    result = stumpless_set_entry_param_value_by_index( copy, 0, 0, "new" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, copy );
+    EXPECT_FALSE( copy->elements[0]->frozen );
+
+    value = stumpless_get_entry_param_value_by_index( copy, 0, 0 );
+    EXPECT_NO_ERROR;
+    EXPECT_STREQ( value, "new" );
+    free( ( void * ) value );
+  }
+
+  TEST_F( EntryTest, FreezeThenCopySharesElements ) {
+    struct stumpless_entry *copy;
+    size_t i;
+
+    stumpless_freeze_entry( basic_entry );
+    EXPECT_NO_ERROR;
+
+    copy = stumpless_copy_entry( basic_entry );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( copy );
+    ASSERT_EQ( copy->element_count, basic_entry->element_count );
+
+    for( i = 0; i < copy->element_count; i++ ) {
+      EXPECT_EQ( copy->elements[i], basic_entry->elements[i] );
+      EXPECT_EQ( copy->elements[i]->reference_count, 2 );
+    }
+
+    stumpless_destroy_entry_and_contents( basic_entry );
+
+    for( i = 0; i < copy->element_count; i++ ) {
+      EXPECT_EQ( copy->elements[i]->reference_count, 1 );
+    }
+
+    basic_entry = copy;
+  }
+
+  TEST_F( EntryTest, FreezeThenModify ) {
+    const struct stumpless_entry *result;
+    struct stumpless_element *element;
+    const struct stumpless_error *error;
+
+    stumpless_freeze_entry( basic_entry );
+    EXPECT_NO_ERROR;
+
+    element = stumpless_new_element( "frozen-element" );
+    ASSERT_NOT_NULL( element );
+
+    result = stumpless_add_element( basic_entry, element );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_element( basic_entry, 0, element );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    stumpless_destroy_element_and_contents( element );
+
+    result = stumpless_add_new_element( basic_entry, "new-element" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_add_new_param_to_entry( basic_entry,
+                                               element_1_name,
+                                               "new-param",
+                                               "new-value" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_entry_app_name( basic_entry, "new-app-name" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_entry_msgid( basic_entry, "new-msgid" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_entry_message( basic_entry, "new message %d", 2 );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_entry_message_str( basic_entry, "new message" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_entry_facility( basic_entry,
+                                           STUMPLESS_FACILITY_LOCAL0 );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_entry_severity( basic_entry,
+                                           STUMPLESS_SEVERITY_EMERG );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_entry_param_value_by_index( basic_entry,
+                                                       0,
+                                                       0,
+                                                       "new-value" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_entry_param_value_by_name( basic_entry,
+                                                      element_1_name,
+                                                      param_1_1_name,
+                                                      "new-value" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_reserve_elements( basic_entry, 100 );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    EXPECT_EQ( stumpless_get_element_count( basic_entry ), 2 );
+    EXPECT_EQ( stumpless_get_entry_prival( basic_entry ),
+               STUMPLESS_FACILITY_USER | STUMPLESS_SEVERITY_INFO );
+    confirm_entry_contents( basic_entry,
+                            basic_app_name,
+                            basic_msgid,
+                            basic_message );
+  }
+
   TEST_F( EntryTest, GetElementByIndex ) {
     const struct stumpless_element *result;
 
@@ -792,6 +1041,144 @@ namespace {
     EXPECT_ERROR_ID_EQ( STUMPLESS_INVALID_ENCODING );
   }
 
+  TEST_F( EntryTest, ReserveElements ) {
+    const struct stumpless_entry *result;
+    const struct stumpless_element *element;
+    void * (*set_realloc_result)(void *, size_t);
+    size_t i;
+
+    result = stumpless_reserve_elements( basic_entry, 20 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_entry );
+    EXPECT_GE( basic_entry->element_capacity, 20 );
+    EXPECT_EQ( stumpless_get_element_count( basic_entry ), 2 );
+
+    // no further reallocation should be needed to fill the reserved space
+    set_realloc_result = stumpless_set_realloc( REALLOC_FAIL );
+    ASSERT_NOT_NULL( set_realloc_result );
+
+    for( i = 2; i < 20; i++ ) {
+      std::string element_name = "reserved-" + std::to_string( i );
+      result = stumpless_add_new_element( basic_entry, element_name.c_str(  ) );
+      EXPECT_NO_ERROR;
+      EXPECT_EQ( result, basic_entry );
+    }
+
+    stumpless_set_realloc( realloc );
+
+    EXPECT_EQ( stumpless_get_element_count( basic_entry ), 20 );
+    element = stumpless_get_element_by_index( basic_entry, 0 );
+    EXPECT_EQ( element, element_1 );
+  }
+
+  TEST_F( EntryTest, ReserveElementsMemoryFailure ) {
+    const struct stumpless_entry *result;
+    const struct stumpless_error *error;
+    void * (*set_realloc_result)(void *, size_t);
+    size_t original_capacity;
+
+    original_capacity = basic_entry->element_capacity;
+
+    set_realloc_result = stumpless_set_realloc( REALLOC_FAIL );
+    ASSERT_NOT_NULL( set_realloc_result );
+
+    result = stumpless_reserve_elements( basic_entry, original_capacity + 1 );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_EQ( basic_entry->element_capacity, original_capacity );
+    EXPECT_EQ( stumpless_get_element_count( basic_entry ), 2 );
+
+    stumpless_set_realloc( realloc );
+  }
+
+  TEST_F( EntryTest, ReserveElementsOverflow ) {
+    const struct stumpless_entry *result;
+    const struct stumpless_error *error;
+    size_t original_capacity;
+
+    original_capacity = basic_entry->element_capacity;
+
+    result = stumpless_reserve_elements( basic_entry, SIZE_MAX );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_EQ( basic_entry->element_capacity, original_capacity );
+    EXPECT_EQ( stumpless_get_element_count( basic_entry ), 2 );
+  }
+
+  TEST_F( EntryTest, ReserveElementsSmallerThanCapacity ) {
+    const struct stumpless_entry *result;
+    size_t original_capacity;
+
+    original_capacity = basic_entry->element_capacity;
+
+    result = stumpless_reserve_elements( basic_entry, 1 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_entry );
+    EXPECT_EQ( basic_entry->element_capacity, original_capacity );
+    EXPECT_EQ( stumpless_get_element_count( basic_entry ), 2 );
+  }
+
+  TEST_F( EntryTest, Reset ) {
+    const struct stumpless_entry *result;
+
+    result = stumpless_reset_entry( basic_entry );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_entry );
+
+    EXPECT_EQ( basic_entry->message_length, 0 );
+    EXPECT_EQ( basic_entry->element_count, 2 );
+    EXPECT_EQ( element_1->param_count, 1 );
+    EXPECT_STREQ( param_1_1->name, param_1_1_name );
+    EXPECT_STREQ( param_1_1->value, "" );
+    EXPECT_EQ( param_1_1->value_length, 0 );
+  }
+
+  TEST_F( EntryTest, ResetFrozenElement ) {
+    struct stumpless_element *frozen_element;
+    const struct stumpless_entry *result;
+
+    frozen_element = stumpless_new_element( "frozen-element" );
+    ASSERT_NOT_NULL( frozen_element );
+    stumpless_add_new_param( frozen_element, "frozen-param", "frozen-value" );
+    stumpless_freeze_element( frozen_element );
+    stumpless_add_element( basic_entry, frozen_element );
+
+    result = stumpless_reset_entry( basic_entry );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_entry );
+
+    EXPECT_STREQ( param_1_1->value, "" );
+    EXPECT_STREQ( frozen_element->params[0]->value, "frozen-value" );
+
+    stumpless_destroy_element_and_contents( frozen_element );
+  }
+
+  TEST_F( EntryTest, ResetReusesValueMemory ) {
+    const char *long_value = "a value too long to be held inside of the param";
+    const char *values[] = { long_value };
+    const struct stumpless_entry *result;
+    void * (*set_malloc_result)(size_t);
+
+    result = stumpless_set_entry_param_values( basic_entry, values, 1 );
+    ASSERT_NOT_NULL( result );
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_reset_entry( basic_entry );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_entry );
+
+    values[0] = "another value still too long to be inline";
+    result = stumpless_set_entry_param_values( basic_entry, values, 1 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_entry );
+    EXPECT_STREQ( param_1_1->value, values[0] );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    EXPECT_TRUE( set_malloc_result == malloc );
+  }
+
   TEST_F( EntryTest, SetAppName ) {
     struct stumpless_entry *entry;
     const char *previous_app_name;
@@ -1231,13 +1618,13 @@ namespace {
     const struct stumpless_entry *result;
     const struct stumpless_error *error;
 
-    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL_ON_SIZE( 17 ) );
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL_ON_SIZE( 52 ) );
     ASSERT_NOT_NULL( set_malloc_result );
 
     result = stumpless_set_entry_param_value_by_name( basic_entry,
                                                       "doesnt-exist",
                                                       "new-name",
-                                                      "new-doomed-value" );
+                                                      "new-doomed-value-that-is-too-long-to-be-held-inline" );
     EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
     EXPECT_NULL( result );
 
@@ -1264,6 +1651,46 @@ namespace {
     ASSERT_TRUE( set_realloc_result == realloc );
   }
 
+  TEST_F( EntryTest, SetParamValueByNameFrozenElementInTwoEntries ) {
+    struct stumpless_element *frozen_element;
+    struct stumpless_entry *other_entry;
+    const struct stumpless_entry *result;
+
+    frozen_element = stumpless_new_element( "frozen-element" );
+    ASSERT_NOT_NULL( frozen_element );
+    stumpless_add_new_param( frozen_element, "frozen-param", "frozen-value" );
+    stumpless_freeze_element( frozen_element );
+
+    other_entry = stumpless_new_entry_str( STUMPLESS_FACILITY_USER,
+                                           STUMPLESS_SEVERITY_INFO,
+                                           basic_app_name,
+                                           basic_msgid,
+                                           basic_message );
+    ASSERT_NOT_NULL( other_entry );
+
+    stumpless_add_element( basic_entry, frozen_element );
+    EXPECT_NO_ERROR;
+    stumpless_add_element( other_entry, frozen_element );
+    EXPECT_NO_ERROR;
+
+    result = stumpless_set_entry_param_value_by_name( basic_entry,
+                                                      "frozen-element",
+                                                      "frozen-param",
+                                                      "new-value" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_entry );
+    EXPECT_STREQ( basic_entry->elements[2]->params[0]->value, "new-value" );
+
+    // the template and the other entry holding it are left as they were
+    EXPECT_STREQ( frozen_element->params[0]->value, "frozen-value" );
+    EXPECT_EQ( other_entry->elements[0], frozen_element );
+    EXPECT_STREQ( other_entry->elements[0]->params[0]->value, "frozen-value" );
+
+    stumpless_destroy_entry_and_contents( other_entry );
+    EXPECT_STREQ( frozen_element->params[0]->value, "frozen-value" );
+    stumpless_destroy_element_and_contents( frozen_element );
+  }
+
   TEST_F( EntryTest, SetParamValueByNameParamNameNotFound ) {
     const struct stumpless_entry *result;
 
@@ -1276,6 +1703,102 @@ namespace {
     EXPECT_TRUE( stumpless_element_has_param( element_1, "doesnt-exist" ) );
   }
 
+  TEST_F( EntryTest, SetParamValues ) {
+    const char *values[] = { "new-value-1", "new-value-2" };
+    const struct stumpless_entry *result;
+
+    stumpless_add_new_param( element_2, "param-2", "value-2" );
+
+    result = stumpless_set_entry_param_values( basic_entry, values, 2 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_entry );
+
+    EXPECT_STREQ( param_1_1->value, "new-value-1" );
+    EXPECT_STREQ( element_2->params[0]->value, "new-value-2" );
+  }
+
+  TEST_F( EntryTest, SetParamValuesNullValue ) {
+    const char *values[] = { NULL };
+    const struct stumpless_entry *result;
+
+    stumpless_freeze_element( element_1 );
+
+    // elements without new values are not modified, even if frozen
+    result = stumpless_set_entry_param_values( basic_entry, values, 1 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_entry );
+    EXPECT_STREQ( param_1_1->value, param_1_1_value );
+  }
+
+  TEST_F( EntryTest, SetParamValuesNullValues ) {
+    const struct stumpless_entry *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_entry_param_values( basic_entry, NULL, 1 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+  }
+
+  TEST_F( EntryTest, SetParamValuesSharedElement ) {
+    const char *values[] = { "new-value" };
+    struct stumpless_entry *copy;
+    const struct stumpless_entry *result;
+
+    stumpless_freeze_element( element_1 );
+    copy = stumpless_copy_entry( basic_entry );
+    ASSERT_NOT_NULL( copy );
+
+    result = stumpless_set_entry_param_values( copy, values, 1 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, copy );
+
+    EXPECT_STREQ( copy->elements[0]->params[0]->value, "new-value" );
+    EXPECT_STREQ( param_1_1->value, param_1_1_value );
+
+    stumpless_destroy_entry_and_contents( copy );
+  }
+
+  TEST_F( EntryTest, SetParamValuesMemoryFailure ) {
+    const char *values[] = {
+      "new-value-1",
+      "a new value that is too long to be held inside of the param"
+    };
+    const char *param_2_1_value = "param-2-1-value";
+    struct stumpless_param *param_2_1;
+    const struct stumpless_entry *result;
+    const struct stumpless_error *error;
+    void * (*set_malloc_result)(size_t);
+
+    param_2_1 = stumpless_new_param( "param-2-1", param_2_1_value );
+    ASSERT_NOT_NULL( param_2_1 );
+    ASSERT_NOT_NULL( stumpless_add_param( element_2, param_2_1 ) );
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_set_entry_param_values( basic_entry, values, 2 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_NULL( result );
+
+    EXPECT_STREQ( param_1_1->value, param_1_1_value );
+    EXPECT_STREQ( param_2_1->value, param_2_1_value );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    ASSERT_TRUE( set_malloc_result == malloc );
+  }
+
+  TEST_F( EntryTest, SetParamValuesTooMany ) {
+    const char *values[] = { "new-value-1", "new-value-2" };
+    const struct stumpless_entry *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_entry_param_values( basic_entry, values, 2 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_INDEX_OUT_OF_BOUNDS );
+    EXPECT_EQ( error->code, 1 );
+    EXPECT_NULL( result );
+    EXPECT_STREQ( param_1_1->value, param_1_1_value );
+  }
+
   TEST_F( EntryTest, SetPriorityInvalidFacility ) {
     int previous_prival;
     const struct stumpless_entry *result;
@@ -1441,6 +1964,17 @@ namespace {
     stumpless_destroy_entry_and_contents( NULL );
   }
 
+  TEST( FreezeEntryTest, NullEntry ) {
+    const struct stumpless_entry *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_freeze_entry( NULL );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+
   TEST( GetElementByIndexTest, NullEntry ) {
     const struct stumpless_element *result;
     const struct stumpless_error *error;
@@ -1982,6 +2516,28 @@ namespace {
     stumpless_free_all(  );
   }
 
+  TEST( ReserveElementsTest, NullEntry ) {
+    const struct stumpless_entry *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_reserve_elements( NULL, 4 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( ResetEntryTest, NullEntry ) {
+    const struct stumpless_entry *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_reset_entry( NULL );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_free_all(  );
+  }
+
   TEST( SetAppNameTest, NullEntry ) {
     const struct stumpless_entry *result;
     const struct stumpless_error *error;
@@ -2063,6 +2619,59 @@ namespace {
     stumpless_free_all(  );
   }
 
+  TEST( SetMessageTest, FormatFailure ) {
+    struct stumpless_entry *entry;
+    const wchar_t invalid_string[] = { ( wchar_t ) 0x110000, L'\0' };
+    const struct stumpless_entry *result;
+    const struct stumpless_error *error;
+
+    entry = create_empty_entry(  );
+    ASSERT_NOT_NULL( entry );
+
+    result = stumpless_set_entry_message( entry, "bad %ls", invalid_string );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_FORMAT_FAILURE );
+    EXPECT_STREQ( entry->message, "fixture message" );
+
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_free_all(  );
+  }
+
+  TEST( SetMessageTest, LongMessageReusesMemory ) {
+    struct stumpless_entry *entry;
+    std::string long_message( 200, 'a' );
+    void * (*set_malloc_result)(size_t);
+    const struct stumpless_entry *result;
+
+    entry = create_empty_entry(  );
+    ASSERT_NOT_NULL( entry );
+
+    result = stumpless_set_entry_message( entry, "%s!", long_message.c_str(  ) );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, entry );
+    EXPECT_EQ( entry->message_length, 201 );
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_set_entry_message( entry, "%s?", long_message.c_str(  ) );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, entry );
+    EXPECT_EQ( entry->message_length, 201 );
+    EXPECT_EQ( entry->message[200], '?' );
+
+    result = stumpless_set_entry_message( entry, "short message %d", 3 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, entry );
+    EXPECT_STREQ( entry->message, "short message 3" );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    EXPECT_TRUE( set_malloc_result == malloc );
+
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_free_all(  );
+  }
+
   TEST( SetMessageStrTest, MallocFailureOnMessage ) {
     void * (*set_malloc_result)(size_t);
     struct stumpless_entry *entry;
@@ -2073,12 +2682,14 @@ namespace {
     entry = create_empty_entry(  );
     ASSERT_NOT_NULL( entry );
 
-    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL_ON_SIZE( 46 ) );
+    // the message is longer than the current one, so it must be allocated
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
     ASSERT_NOT_NULL( set_malloc_result );
 
     result = stumpless_set_entry_message_str( entry, new_message );
     EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
     EXPECT_NULL( result );
+    EXPECT_STREQ( entry->message, "fixture message" );
 
     set_malloc_result = stumpless_set_malloc( malloc );
     EXPECT_TRUE( set_malloc_result == malloc );
@@ -2087,6 +2698,38 @@ namespace {
     stumpless_free_all(  );
   }
 
+  TEST( SetMessageStrTest, GrowsGeometrically ) {
+    struct stumpless_entry *entry;
+    std::string message;
+    const struct stumpless_entry *result;
+    size_t i;
+    size_t capacity_changes = 0;
+    size_t last_capacity;
+
+    entry = create_empty_entry(  );
+    ASSERT_NOT_NULL( entry );
+    last_capacity = entry->message_capacity;
+
+    for( i = 0; i < 1000; i++ ) {
+      message.push_back( 'a' );
+      result = stumpless_set_entry_message_str( entry, message.c_str(  ) );
+      EXPECT_NO_ERROR;
+      EXPECT_EQ( result, entry );
+      EXPECT_GT( entry->message_capacity, entry->message_length );
+
+      if( entry->message_capacity != last_capacity ) {
+        capacity_changes++;
+        last_capacity = entry->message_capacity;
+      }
+    }
+
+    EXPECT_LT( capacity_changes, 10 );
+    EXPECT_STREQ( entry->message, message.c_str(  ) );
+
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_free_all(  );
+  }
+
   TEST( SetMessageStrTest, NullEntry ) {
     const struct stumpless_entry *result;
     const struct stumpless_error *error;
@@ -2118,6 +2761,50 @@ namespace {
     stumpless_free_all(  );
   }
 
+  TEST( SetMessageStrTest, OwnSuffix ) {
+    struct stumpless_entry *entry;
+    const struct stumpless_entry *result;
+
+    entry = create_empty_entry(  );
+    ASSERT_NOT_NULL( entry );
+
+    result = stumpless_set_entry_message_str( entry, entry->message + 8 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, entry );
+    EXPECT_STREQ( entry->message, "message" );
+    EXPECT_EQ( entry->message_length, 7 );
+
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_free_all(  );
+  }
+
+  TEST( SetMessageStrTest, ShorterMessageReusesMemory ) {
+    struct stumpless_entry *entry;
+    const char *previous_message;
+    void * (*set_malloc_result)(size_t);
+    const struct stumpless_entry *result;
+
+    entry = create_empty_entry(  );
+    ASSERT_NOT_NULL( entry );
+    previous_message = entry->message;
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_set_entry_message_str( entry, "short" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, entry );
+    EXPECT_EQ( entry->message, previous_message );
+    EXPECT_STREQ( entry->message, "short" );
+    EXPECT_EQ( entry->message_length, 5 );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    EXPECT_TRUE( set_malloc_result == malloc );
+
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_free_all(  );
+  }
+
   TEST( SetParam, NullEntry ) {
     struct stumpless_param *param;
     const struct stumpless_entry *result;
@@ -2163,6 +2850,18 @@ namespace {
     stumpless_free_all(  );
   }
 
+  TEST( SetParamValues, NullEntry ) {
+    const char *values[] = { "new-value" };
+    const struct stumpless_entry *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_entry_param_values( NULL, values, 1 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+
   TEST( SetPrivalTest, NullEntry ) {
     int prival = STUMPLESS_FACILITY_USER | STUMPLESS_SEVERITY_INFO;
     const struct stumpless_entry *result;
@@ -18,6 +18,8 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <map>
+#include <thread>
 #include <gtest/gtest.h>
 #include <stumpless.h>
 #include "test/helper/assert.hpp"
@@ -26,10 +28,228 @@ namespace {
 
   class MemoryTest : public ::testing::Test {};
 
+  struct allocator_context {
+    std::map<void *, size_t> sizes;
+    size_t malloc_count;
+    size_t realloc_count;
+    size_t free_count;
+    size_t sized_free_count;
+    size_t wrong_size_count;
+  };
+
+  static void *
+  context_malloc( size_t size, void *context ) {
+    auto ctx = static_cast<struct allocator_context *>( context );
+    void *mem;
+
+    mem = malloc( size );
+    if( mem ) {
+      ctx->malloc_count++;
+      ctx->sizes[mem] = size;
+    }
+
+    return mem;
+  }
+
+  // realloc with a NULL pointer allocates new memory, so malloc_count does not
+  // always match free_count and the sizes map is used to find leaks instead
+  static void *
+  context_realloc( void *mem, size_t size, void *context ) {
+    auto ctx = static_cast<struct allocator_context *>( context );
+    void *new_mem;
+
+    new_mem = realloc( mem, size );
+    if( new_mem ) {
+      ctx->realloc_count++;
+      ctx->sizes.erase( mem );
+      ctx->sizes[new_mem] = size;
+    }
+
+    return new_mem;
+  }
+
+  static void
+  context_free( void *mem, size_t size, void *context ) {
+    auto ctx = static_cast<struct allocator_context *>( context );
+    std::map<void *, size_t>::iterator allocated;
+
+    ctx->free_count++;
+    if( size != 0 ) {
+      ctx->sized_free_count++;
+      allocated = ctx->sizes.find( mem );
+      if( allocated != ctx->sizes.end(  ) && allocated->second != size ) {
+        ctx->wrong_size_count++;
+      }
+    }
+
+    ctx->sizes.erase( mem );
+    free( mem );
+  }
+
+  static void
+  init_allocator( struct stumpless_allocator *allocator,
+                  struct allocator_context *context ) {
+    context->malloc_count = 0;
+    context->realloc_count = 0;
+    context->free_count = 0;
+    context->sized_free_count = 0;
+    context->wrong_size_count = 0;
+
+    allocator->malloc_func = context_malloc;
+    allocator->realloc_func = context_realloc;
+    allocator->free_func = context_free;
+    allocator->context = context;
+  }
+
+  static void
+  use_library( void ) {
+    struct stumpless_entry *entry;
+    char buffer[512];
+    struct stumpless_target *target;
+
+    entry = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                                 STUMPLESS_SEVERITY_INFO,
+                                 "allocator-app",
+                                 "allocator-msgid",
+                                 "message number %d",
+                                 1 );
+    stumpless_add_new_param_to_entry( entry,
+                                      "element",
+                                      "param",
+                                      "a value that is too long to be stored "
+                                      "inline in the param" );
+    stumpless_set_entry_message_str( entry, "a new message" );
+    stumpless_set_element_name( entry->elements[0], "new-element-name" );
+    stumpless_set_param_value( entry->elements[0]->params[0], "short" );
+
+    target = stumpless_open_buffer_target( "allocator-buffer",
+                                           buffer,
+                                           sizeof( buffer ) );
+    stumpless_add_entry( target, entry );
+
+    stumpless_close_buffer_target( target );
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_free_all(  );
+  }
+
   TEST( FreeAllTest, SimpleCall ) {
     stumpless_free_all(  );
   }
 
+  TEST( GetMemoryStatsTest, EntryAndTarget ) {
+    struct stumpless_memory_stats stats;
+    const struct stumpless_memory_stats *result;
+    char buffer[512];
+    struct stumpless_target *target;
+    struct stumpless_entry *entry;
+
+    stumpless_free_all(  );
+
+    result = stumpless_get_memory_stats( &stats );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, &stats );
+    EXPECT_EQ( stats.entry_cache.bytes, 0 );
+    EXPECT_EQ( stats.strbuilders.bytes, 0 );
+    EXPECT_EQ( stats.targets.bytes, 0 );
+    EXPECT_EQ( stats.targets.count, 0 );
+
+    target = stumpless_open_buffer_target( "memory-stats",
+                                           buffer,
+                                           sizeof( buffer ) );
+    ASSERT_NOT_NULL( target );
+
+    entry = stumpless_new_entry_str( STUMPLESS_FACILITY_USER,
+                                     STUMPLESS_SEVERITY_INFO,
+                                     "memory-stats-app",
+                                     "memory-stats-msgid",
+                                     "memory stats message" );
+    ASSERT_NOT_NULL( entry );
+
+    stumpless_add_entry( target, entry );
+
+    stumpless_get_memory_stats( &stats );
+    EXPECT_GT( stats.entry_cache.bytes, 0 );
+    EXPECT_EQ( stats.entry_cache.count, 1 );
+    EXPECT_GT( stats.strbuilders.bytes, 0 );
+    EXPECT_EQ( stats.strbuilders.count, 0 );
+    EXPECT_GE( stats.targets.bytes, sizeof( *target ) );
+    EXPECT_EQ( stats.targets.count, 1 );
+
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_close_buffer_target( target );
+
+    stumpless_get_memory_stats( &stats );
+    EXPECT_EQ( stats.entry_cache.count, 0 );
+    EXPECT_EQ( stats.targets.bytes, 0 );
+    EXPECT_EQ( stats.targets.count, 0 );
+
+    stumpless_free_all(  );
+
+    stumpless_get_memory_stats( &stats );
+    EXPECT_EQ( stats.entry_cache.bytes, 0 );
+    EXPECT_EQ( stats.strbuilders.bytes, 0 );
+    EXPECT_EQ( stats.lock_cache.bytes, 0 );
+  }
+
+  TEST( GetMemoryStatsTest, NullStats ) {
+    const struct stumpless_memory_stats *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_get_memory_stats( NULL );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+  }
+
+  TEST( SetAllocatorTest, CustomAllocator ) {
+    struct allocator_context context;
+    struct stumpless_allocator allocator;
+    const struct stumpless_allocator *result;
+
+    stumpless_free_all(  );
+    init_allocator( &allocator, &context );
+
+    result = stumpless_set_allocator( &allocator );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( result );
+    EXPECT_TRUE( result->malloc_func == context_malloc );
+    EXPECT_EQ( result->context, &context );
+
+    use_library(  );
+
+    stumpless_set_malloc( malloc );
+    stumpless_set_realloc( realloc );
+    stumpless_set_free( free );
+
+    EXPECT_GT( context.malloc_count, 0 );
+    EXPECT_GT( context.free_count, 0 );
+    EXPECT_GT( context.sized_free_count, 0 );
+    EXPECT_EQ( context.wrong_size_count, 0 );
+    EXPECT_TRUE( context.sizes.empty(  ) );
+  }
+
+  TEST( SetAllocatorTest, NullAllocator ) {
+    const struct stumpless_allocator *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_allocator( NULL );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+  }
+
+  TEST( SetAllocatorTest, NullFunction ) {
+    struct allocator_context context;
+    struct stumpless_allocator allocator;
+    const struct stumpless_allocator *result;
+    const struct stumpless_error *error;
+
+    init_allocator( &allocator, &context );
+    allocator.free_func = NULL;
+
+    result = stumpless_set_allocator( &allocator );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+  }
+
   TEST( SetFreeTest, CustomFunction ) {
     void (*result)(void *);
 
@@ -67,4 +287,60 @@ namespace {
     EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
   }
 
+  TEST( SetThreadAllocatorTest, CustomAllocator ) {
+    struct allocator_context context;
+    struct allocator_context other_context;
+    struct stumpless_allocator allocator;
+    struct stumpless_allocator other_allocator;
+    const struct stumpless_allocator *result;
+    std::thread *other_thread;
+
+    stumpless_free_all(  );
+    init_allocator( &allocator, &context );
+    init_allocator( &other_allocator, &other_context );
+
+    result = stumpless_set_thread_allocator( &allocator );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( result );
+    EXPECT_EQ( result->context, &context );
+
+    // the other thread uses its own allocator without affecting this one
+    other_thread = new std::thread( [&other_allocator]{
+      stumpless_set_thread_allocator( &other_allocator );
+      stumpless_destroy_element_and_contents(
+        stumpless_new_element( "other-thread" ) );
+      stumpless_set_thread_allocator( NULL );
+    } );
+    other_thread->join(  );
+    delete other_thread;
+
+    use_library(  );
+
+    result = stumpless_set_thread_allocator( NULL );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( result );
+    EXPECT_TRUE( result->context != &context );
+
+    EXPECT_GT( context.malloc_count, 0 );
+    EXPECT_GT( context.free_count, 0 );
+    EXPECT_EQ( context.wrong_size_count, 0 );
+    EXPECT_TRUE( context.sizes.empty(  ) );
+    // shared caches created by the other thread may still be in use, so only
+    // its use of its own allocator is checked
+    EXPECT_GT( other_context.malloc_count, 0 );
+  }
+
+  TEST( SetThreadAllocatorTest, NullFunction ) {
+    struct allocator_context context;
+    struct stumpless_allocator allocator;
+    const struct stumpless_allocator *result;
+    const struct stumpless_error *error;
+
+    init_allocator( &allocator, &context );
+    allocator.malloc_func = NULL;
+
+    result = stumpless_set_thread_allocator( &allocator );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+  }
 }
@@ -75,6 +75,33 @@ namespace {
     stumpless_destroy_param( result );
   }
 
+  TEST_F( ParamTest, Freeze ) {
+    const struct stumpless_param *result;
+    const char *value;
+    const struct stumpless_error *error;
+
+    result = stumpless_freeze_param( basic_param );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_param );
+    EXPECT_TRUE( basic_param->frozen );
+
+    value = stumpless_get_param_value( basic_param );
+    EXPECT_NO_ERROR;
+    EXPECT_STREQ( value, basic_value );
+    free( ( void * ) value );
+
+    result = stumpless_set_param_name( basic_param, "new-name" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    result = stumpless_set_param_value( basic_param, "new-value" );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_OBJECT_FROZEN );
+
+    EXPECT_STREQ( basic_param->name, basic_name );
+    EXPECT_STREQ( basic_param->value, basic_value );
+  }
+
   TEST_F( ParamTest, GetName ) {
     const char *name = stumpless_get_param_name( basic_param );
 
@@ -126,7 +153,7 @@ namespace {
 
   TEST_F( ParamTest, SetValueMemoryFailure ) {
     void * (*set_malloc_result)(size_t);
-    const char *new_value = "this-wont-work";
+    const char *new_value = "this-wont-work-since-it-is-too-long-to-be-inline";
     const struct stumpless_param *result;
     const struct stumpless_error *error;
     const char *after_value;
@@ -146,6 +173,86 @@ namespace {
     EXPECT_TRUE( set_malloc_result == malloc );
   }
 
+  TEST_F( ParamTest, SetValueLongThenShort ) {
+    const char *long_value = "a-value-that-is-too-long-to-fit-in-the-param";
+    const struct stumpless_param *result;
+    const char *value;
+
+    EXPECT_EQ( basic_param->value, basic_param->value_buffer );
+
+    result = stumpless_set_param_value( basic_param, long_value );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_param );
+    EXPECT_NE( basic_param->value, basic_param->value_buffer );
+    EXPECT_EQ( basic_param->value_length, strlen( long_value ) );
+
+    value = stumpless_get_param_value( basic_param );
+    EXPECT_STREQ( value, long_value );
+    free( ( void * ) value );
+
+    result = stumpless_set_param_value( basic_param, "200" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_param );
+    EXPECT_EQ( basic_param->value, basic_param->value_buffer );
+    EXPECT_EQ( basic_param->value_length, 3 );
+
+    value = stumpless_get_param_value( basic_param );
+    EXPECT_STREQ( value, "200" );
+    free( ( void * ) value );
+  }
+
+  TEST_F( ParamTest, SetValueLongThenShorterLong ) {
+    const char *long_value = "a-value-that-is-too-long-to-fit-in-the-param";
+    const char *shorter_value = "a-shorter-value-that-is-too-long-to-fit-in";
+    void * (*set_malloc_result)(size_t);
+    const struct stumpless_param *result;
+    const char *previous_value;
+
+    result = stumpless_set_param_value( basic_param, long_value );
+    ASSERT_NOT_NULL( result );
+    previous_value = basic_param->value;
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_set_param_value( basic_param, shorter_value );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_param );
+    EXPECT_EQ( basic_param->value, previous_value );
+    EXPECT_STREQ( basic_param->value, shorter_value );
+    EXPECT_EQ( basic_param->value_length, strlen( shorter_value ) );
+    EXPECT_EQ( basic_param->value_capacity, strlen( long_value ) + 1 );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    EXPECT_TRUE( set_malloc_result == malloc );
+  }
+
+  TEST_F( ParamTest, SetValueMallocFreeForShortValue ) {
+    void * (*set_malloc_result)(size_t);
+    const struct stumpless_param *result;
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_set_param_value( basic_param, "GET" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_param );
+    EXPECT_STREQ( basic_param->value, "GET" );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    EXPECT_TRUE( set_malloc_result == malloc );
+  }
+
+  TEST_F( ParamTest, SetValueToOwnSuffix ) {
+    const struct stumpless_param *result;
+
+    result = stumpless_set_param_value( basic_param, basic_param->value + 6 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, basic_param );
+    EXPECT_STREQ( basic_param->value, "value" );
+    EXPECT_EQ( basic_param->value_length, 5 );
+  }
+
   TEST_F( ParamTest, SetValueToNull ) {
     const struct stumpless_param *result;
     const struct stumpless_error *error;
@@ -207,6 +314,17 @@ namespace {
     stumpless_free_all(  );
   }
 
+  TEST( FreezeParamTest, NullParam ) {
+    const struct stumpless_param *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_freeze_param( NULL );
+    EXPECT_NULL( result );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_free_all(  );
+  }
+
   TEST( GetParamNameTest, NullParam ) {
     const char *result;
     const struct stumpless_error *error;
@@ -268,11 +386,11 @@ namespace {
 
   TEST( NewParamTest, MemoryFailureOnValue ) {
     void * (*set_malloc_result)(size_t);
-    const char *param_value = "this-value-is-awesome";
+    const char *param_value = "this-value-is-awesome-and-too-long-to-be-inline";
     const struct stumpless_param *param;
     const struct stumpless_error *error;
 
-    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL_ON_SIZE( 22 ) );
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL_ON_SIZE( 48 ) );
     ASSERT_NOT_NULL( set_malloc_result );
 
     param = stumpless_new_param( "name", param_value );
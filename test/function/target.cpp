@@ -30,6 +30,7 @@
 #include "test/helper/memory_allocation.hpp"
 #include "test/helper/rfc5424.hpp"
 
+using::testing::EndsWith;
 using::testing::HasSubstr;
 
 namespace {
@@ -71,6 +72,58 @@ namespace {
     }
   };
 
+  TEST_F( TargetTest, AddEntries ) {
+    struct stumpless_entry *entries[3];
+    char read_buffer[TEST_BUFFER_LENGTH];
+    char expected[32];
+    size_t i;
+    int mask;
+    int result;
+
+    ASSERT_NOT_NULL( target );
+
+    for( i = 0; i < 3; i++ ) {
+      entries[i] = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                                        STUMPLESS_SEVERITY_INFO,
+                                        "add-entries-app",
+                                        "add-entries-msgid",
+                                        "batch message %zu",
+                                        i );
+      ASSERT_NOT_NULL( entries[i] );
+    }
+
+    mask = STUMPLESS_SEVERITY_MASK( STUMPLESS_SEVERITY_INFO );
+    stumpless_set_target_mask( target, mask );
+    stumpless_set_entry_severity( entries[1], STUMPLESS_SEVERITY_DEBUG );
+
+    result = stumpless_add_entries( target, entries, 3 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 2 );
+
+    // buffer targets keep each entry as a separate message
+    for( i = 0; i < 3; i += 2 ) {
+      stumpless_read_buffer( target, read_buffer, sizeof( read_buffer ) );
+      TestRFC5424Compliance( read_buffer );
+      snprintf( expected, sizeof( expected ), "batch message %zu", i );
+      EXPECT_THAT( read_buffer, EndsWith( expected ) );
+    }
+
+    for( i = 0; i < 3; i++ ) {
+      stumpless_destroy_entry_and_contents( entries[i] );
+    }
+  }
+
+  TEST_F( TargetTest, AddEntriesNone ) {
+    struct stumpless_entry *entries[1];
+    int result;
+
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_add_entries( target, entries, 0 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 0 );
+  }
+
   TEST_F( TargetTest, FilterReject ) {
     const char *message = "filter-reject-message";
     int result;
@@ -247,12 +300,12 @@ namespace {
   TEST_F( TargetTest, TraceEntryMallocFailureOnFile ) {
     void * ( *set_malloc_result )( size_t );
     struct stumpless_entry *entry;
-    const char *filename = "trace_entry_test_malloc_failure.c";
+    const char *filename = "trace_entry_test_malloc_failure_on_file_name.c";
     const char *function_name = "TargetTest.TraceEntryMallocFailureOnFile";
     int result;
     const struct stumpless_error *error;
 
-    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL_ON_SIZE( 34 ) );
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL_ON_SIZE( 47 ) );
     ASSERT_NOT_NULL( set_malloc_result );
 
     entry = create_entry(  );
@@ -342,6 +395,66 @@ namespace {
 
   /* non-fixture tests */
 
+  TEST( AddEntriesTest, NullEntries ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+    char buffer[10];
+    int result;
+
+    target = stumpless_open_buffer_target( "null entries testing",
+                                           buffer,
+                                           sizeof( buffer ) );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_add_entries( target, NULL, 1 );
+    EXPECT_LT( result, 0 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_close_buffer_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( AddEntriesTest, NullEntryInArray ) {
+    struct stumpless_entry *entries[2];
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+    char buffer[10];
+    int result;
+
+    target = stumpless_open_buffer_target( "null entry in array testing",
+                                           buffer,
+                                           sizeof( buffer ) );
+    ASSERT_NOT_NULL( target );
+
+    entries[0] = create_entry(  );
+    ASSERT_NOT_NULL( entries[0] );
+    entries[1] = NULL;
+
+    result = stumpless_add_entries( target, entries, 2 );
+    EXPECT_LT( result, 0 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_destroy_entry_and_contents( entries[0] );
+    stumpless_close_buffer_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( AddEntriesTest, NullTarget ) {
+    struct stumpless_entry *entries[1];
+    const struct stumpless_error *error;
+    int result;
+
+    entries[0] = create_entry(  );
+    ASSERT_NOT_NULL( entries[0] );
+
+    result = stumpless_add_entries( NULL, entries, 1 );
+    EXPECT_LT( result, 0 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_destroy_entry_and_contents( entries[0] );
+    stumpless_free_all(  );
+  }
+
   TEST( AddEntryTest, NullEntry ) {
     int result;
     struct stumpless_target *target;
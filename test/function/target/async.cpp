@@ -0,0 +1,1192 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <stumpless.h>
+#include <thread>
+#include "test/helper/assert.hpp"
+#include "test/helper/fixture.hpp"
+#include "test/helper/memory_allocation.hpp"
+#include "test/helper/rfc5424.hpp"
+
+namespace {
+  const int LOG_BUFFER_SIZE = 8192;
+  const int READ_BUFFER_SIZE = 1024;
+  std::atomic_int call_count;
+  std::atomic_bool function_started;
+  std::atomic_bool function_released;
+  char last_message[READ_BUFFER_SIZE];
+
+  int
+  counting_log_function( const struct stumpless_target *target,
+                         const struct stumpless_entry *entry ) {
+    const char *message;
+
+    message = stumpless_get_entry_message( entry );
+    if( message ) {
+      strncpy( last_message, message, READ_BUFFER_SIZE - 1 );
+      free( ( void * ) message );
+    }
+
+    return call_count++;
+  }
+
+  bool
+  reject_debug_filter( const struct stumpless_target *target,
+                       const struct stumpless_entry *entry ) {
+    return stumpless_get_entry_severity( entry ) != STUMPLESS_SEVERITY_DEBUG;
+  }
+
+  int
+  waiting_log_function( const struct stumpless_target *target,
+                        const struct stumpless_entry *entry ) {
+    function_started = true;
+
+    while( !function_released ) {
+      std::this_thread::yield(  );
+    }
+
+    return counting_log_function( target, entry );
+  }
+
+  /*
+   * Opens an async target with a function target that waits to be released,
+   * and sends a first message to it so that the writer thread is stuck until
+   * function_released is set.
+   */
+  struct stumpless_target *
+  open_stalled_target( const char *name,
+                       struct stumpless_target **wrapped,
+                       size_t queue_size ) {
+    struct stumpless_target *target;
+
+    *wrapped = stumpless_open_function_target( name, waiting_log_function );
+    if( !*wrapped ) {
+      return NULL;
+    }
+
+    target = stumpless_open_async_target( name, *wrapped, queue_size );
+    if( !target ) {
+      return NULL;
+    }
+
+    call_count = 0;
+    function_started = false;
+    function_released = false;
+
+    stumpless_add_message( target, "first message" );
+    while( !function_started ) {
+      std::this_thread::yield(  );
+    }
+
+    return target;
+  }
+
+  class AsyncTargetTest : public::testing::Test {
+    protected:
+      char log_buffer[LOG_BUFFER_SIZE];
+      struct stumpless_target *buffer_target;
+      struct stumpless_target *target;
+      struct stumpless_entry *basic_entry;
+
+    virtual void
+    SetUp( void ) {
+      buffer_target = stumpless_open_buffer_target( "async-wrapped-buffer",
+                                                    log_buffer,
+                                                    sizeof( log_buffer ) );
+      target = stumpless_open_async_target( "async-target", buffer_target, 0 );
+      basic_entry = create_entry(  );
+    }
+
+    virtual void
+    TearDown( void ) {
+      stumpless_destroy_entry_and_contents( basic_entry );
+      stumpless_close_async_target( target );
+      stumpless_close_buffer_target( buffer_target );
+      stumpless_free_all(  );
+    }
+
+    void
+    read_message( char *read_buffer ) {
+      stumpless_read_buffer( buffer_target, read_buffer, READ_BUFFER_SIZE );
+    }
+  };
+
+  TEST_F( AsyncTargetTest, AddEntry ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    int result;
+    const struct stumpless_target *flush_result;
+
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_add_entry( target, basic_entry );
+    EXPECT_NO_ERROR;
+    EXPECT_GE( result, 0 );
+
+    flush_result = stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( flush_result, target );
+
+    read_message( read_buffer );
+    TestRFC5424Compliance( read_buffer );
+    EXPECT_THAT( read_buffer, testing::HasSubstr( basic_entry->message ) );
+  }
+
+  TEST_F( AsyncTargetTest, AddEntryFilteredByAsyncTarget ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    int result;
+
+    stumpless_set_target_mask( target, 0 );
+
+    result = stumpless_add_entry( target, basic_entry );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 0 );
+
+    stumpless_flush_target( target );
+    EXPECT_EQ( stumpless_get_async_queue_depth( target ), 0 );
+
+    read_message( read_buffer );
+    EXPECT_THAT( read_buffer,
+                 testing::Not( testing::HasSubstr( basic_entry->message ) ) );
+  }
+
+  TEST_F( AsyncTargetTest, AddEntryFilteredByWrappedTarget ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    int result;
+
+    stumpless_set_target_mask( buffer_target, 0 );
+
+    result = stumpless_add_entry( target, basic_entry );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 0 );
+
+    stumpless_flush_target( target );
+
+    read_message( read_buffer );
+    EXPECT_THAT( read_buffer,
+                 testing::Not( testing::HasSubstr( basic_entry->message ) ) );
+  }
+
+  TEST_F( AsyncTargetTest, AddMessagesInOrder ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    char expected[32];
+    int i;
+
+    for( i = 0; i < 20; i++ ) {
+      stumpless_add_message( target, "ordered message %d", i );
+      EXPECT_NO_ERROR;
+    }
+
+    stumpless_flush_target( target );
+    EXPECT_EQ( stumpless_get_async_queue_depth( target ), 0 );
+
+    for( i = 0; i < 20; i++ ) {
+      snprintf( expected, sizeof( expected ), "ordered message %d", i );
+      read_message( read_buffer );
+      EXPECT_THAT( read_buffer, testing::EndsWith( expected ) );
+    }
+  }
+
+  TEST_F( AsyncTargetTest, DeferredCustomFilter ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    const struct stumpless_target *result;
+
+    // custom filters need the full entry, so the message is formatted now
+    stumpless_set_target_filter( buffer_target, stumpless_mask_filter );
+    stumpless_set_target_filter( target, reject_debug_filter );
+    result = stumpless_set_async_deferred_formatting( target, true );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_log( target,
+                       STUMPLESS_SEVERITY_DEBUG,
+                       "filtered message %d",
+                       1 );
+    EXPECT_NO_ERROR;
+    stumpless_add_log( target,
+                       STUMPLESS_SEVERITY_INFO,
+                       "custom filter message %d",
+                       2 );
+    EXPECT_NO_ERROR;
+
+    stumpless_flush_target( target );
+
+    read_message( read_buffer );
+    TestRFC5424Compliance( read_buffer );
+    EXPECT_THAT( read_buffer, testing::EndsWith( "custom filter message 2" ) );
+  }
+
+  TEST_F( AsyncTargetTest, DeferredLargeArguments ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    std::string argument( 400, 'x' );
+
+    stumpless_set_async_deferred_formatting( target, true );
+
+    // too large for a pooled record, so this is allocated on its own
+    stumpless_add_message( target, "large: %s", argument.c_str(  ) );
+    EXPECT_NO_ERROR;
+
+    stumpless_flush_target( target );
+
+    read_message( read_buffer );
+    EXPECT_THAT( read_buffer, testing::EndsWith( "large: " + argument ) );
+  }
+
+  TEST_F( AsyncTargetTest, DeferredMaskFilter ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    int result;
+    int mask;
+
+    mask = STUMPLESS_SEVERITY_MASK_UPTO( STUMPLESS_SEVERITY_INFO );
+    stumpless_set_async_deferred_formatting( target, true );
+    stumpless_set_target_mask( target, mask );
+
+    result = stumpless_add_log( target,
+                                STUMPLESS_SEVERITY_DEBUG,
+                                "filtered message %d",
+                                1 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 0 );
+
+    stumpless_add_log( target,
+                       STUMPLESS_SEVERITY_INFO,
+                       "masked message %d",
+                       2 );
+    EXPECT_NO_ERROR;
+
+    stumpless_flush_target( target );
+
+    read_message( read_buffer );
+    EXPECT_THAT( read_buffer, testing::EndsWith( "masked message 2" ) );
+  }
+
+  TEST_F( AsyncTargetTest, DeferredMessage ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    char expected[READ_BUFFER_SIZE];
+    const char *format = "%s|%-5d|%+ld|%05.1f|%x|%llu|%zu|%c|%p|%e|%%";
+    int value = 42;
+    int result;
+
+    stumpless_set_async_deferred_formatting( target, true );
+
+    result = stumpless_add_message( target,
+                                    format,
+                                    "text",
+                                    -7,
+                                    123456789L,
+                                    3.14159,
+                                    255u,
+                                    18446744073709551615ULL,
+                                    sizeof( value ),
+                                    'z',
+                                    ( void * ) &value,
+                                    0.000123 );
+    EXPECT_NO_ERROR;
+    EXPECT_GE( result, 0 );
+
+    stumpless_flush_target( target );
+
+    snprintf( expected,
+              sizeof( expected ),
+              format,
+              "text",
+              -7,
+              123456789L,
+              3.14159,
+              255u,
+              18446744073709551615ULL,
+              sizeof( value ),
+              'z',
+              ( void * ) &value,
+              0.000123 );
+
+    read_message( read_buffer );
+    TestRFC5424Compliance( read_buffer );
+    EXPECT_THAT( read_buffer, testing::EndsWith( expected ) );
+  }
+
+  TEST_F( AsyncTargetTest, DeferredNullString ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    const char *null_string = NULL;
+
+    stumpless_set_async_deferred_formatting( target, true );
+
+    stumpless_add_message( target, "null string: %s", null_string );
+    EXPECT_NO_ERROR;
+
+    stumpless_flush_target( target );
+
+    read_message( read_buffer );
+    EXPECT_THAT( read_buffer, testing::EndsWith( "null string: (null)" ) );
+  }
+
+  TEST_F( AsyncTargetTest, DeferredPerror ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    const char *error_filename = "async-deferred-perror.log";
+    FILE *error_stream;
+    int result;
+
+    error_stream = fopen( error_filename, "w+" );
+    ASSERT_NOT_NULL( error_stream );
+    stumpless_set_error_stream( error_stream );
+
+    stumpless_set_async_deferred_formatting( target, true );
+    stumpless_set_option( target, STUMPLESS_OPTION_PERROR );
+    EXPECT_NO_ERROR;
+
+    result = stumpless_add_message( target, "perror message %d", 7 );
+    EXPECT_NO_ERROR;
+    EXPECT_GE( result, 0 );
+
+    stumpless_flush_target( target );
+
+    stumpless_set_error_stream( stderr );
+    fclose( error_stream );
+
+    read_message( read_buffer );
+    EXPECT_THAT( read_buffer, testing::EndsWith( "perror message 7" ) );
+
+    std::ifstream error_file( error_filename );
+    std::string line;
+    ASSERT_TRUE( std::getline( error_file, line ) );
+    TestRFC5424Compliance( line.c_str() );
+    EXPECT_THAT( line, testing::EndsWith( "perror message 7" ) );
+
+    remove( error_filename );
+  }
+
+  TEST_F( AsyncTargetTest, DeferredPriority ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    char expected[32];
+    int priority;
+
+    stumpless_set_async_deferred_formatting( target, true );
+    stumpless_set_target_default_app_name( target, "deferred-app" );
+    stumpless_set_target_default_msgid( target, "deferred-msgid" );
+
+    priority = STUMPLESS_FACILITY_LOCAL0 | STUMPLESS_SEVERITY_ERR;
+    stumpless_add_log( target, priority, "priority message %d", priority );
+    EXPECT_NO_ERROR;
+
+    // later changes to the target do not change messages already queued
+    stumpless_set_target_default_app_name( target, "changed-app" );
+
+    stumpless_flush_target( target );
+
+    read_message( read_buffer );
+    TestRFC5424Compliance( read_buffer );
+    snprintf( expected, sizeof( expected ), "<%d>1 ", priority );
+    EXPECT_THAT( read_buffer, testing::StartsWith( expected ) );
+    EXPECT_THAT( read_buffer,
+                 testing::HasSubstr( " deferred-app - deferred-msgid " ) );
+    snprintf( expected, sizeof( expected ), "priority message %d", priority );
+    EXPECT_THAT( read_buffer, testing::EndsWith( expected ) );
+  }
+
+  TEST_F( AsyncTargetTest, DeferredStringIsCopied ) {
+    char read_buffer[READ_BUFFER_SIZE];
+    char argument[] = "original";
+
+    stumpless_set_async_deferred_formatting( target, true );
+
+    stumpless_add_message( target, "%s and %.*s", argument, 4, argument );
+    EXPECT_NO_ERROR;
+
+    strcpy( argument, "changed!" );
+
+    stumpless_flush_target( target );
+
+    read_message( read_buffer );
+    EXPECT_THAT( read_buffer, testing::EndsWith( "original and orig" ) );
+  }
+
+  TEST_F( AsyncTargetTest, DeferredUnsupportedFormat ) {
+    char read_buffer[READ_BUFFER_SIZE];
+
+    stumpless_set_async_deferred_formatting( target, true );
+
+    // positional arguments cannot be deferred, so are formatted immediately
+    stumpless_add_message( target, "%2$s %1$s", "world", "hello" );
+    EXPECT_NO_ERROR;
+
+    stumpless_flush_target( target );
+
+    read_message( read_buffer );
+    EXPECT_THAT( read_buffer, testing::EndsWith( "hello world" ) );
+  }
+
+  TEST_F( AsyncTargetTest, FlushEmptyQueue ) {
+    const struct stumpless_target *result;
+
+    result = stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+  }
+
+  TEST_F( AsyncTargetTest, MemoryStats ) {
+    struct stumpless_memory_stats stats;
+
+    stumpless_get_memory_stats( &stats );
+    EXPECT_GT( stats.async_queues.bytes, 0 );
+    EXPECT_EQ( stats.async_queues.count, 1 );
+  }
+
+  TEST_F( AsyncTargetTest, QueueDepth ) {
+    size_t result;
+
+    result = stumpless_get_async_queue_depth( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 0 );
+  }
+
+  /* non-fixture tests */
+
+  TEST( AsyncTargetCloseTest, GenericCloseFunction ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+
+    wrapped = stumpless_open_function_target( "async-generic-close-wrapped",
+                                              counting_log_function );
+    ASSERT_NOT_NULL( wrapped );
+
+    target = stumpless_open_async_target( "async-generic-close", wrapped, 0 );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_close_target( target );
+    EXPECT_NO_ERROR;
+
+    stumpless_close_function_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetCloseTest, NullTarget ) {
+    const struct stumpless_error *error;
+
+    stumpless_close_async_target( NULL );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetCloseTest, SendsQueuedEntries ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    struct stumpless_memory_stats stats;
+    int i;
+
+    wrapped = stumpless_open_function_target( "async-close-wrapped",
+                                              counting_log_function );
+    ASSERT_NOT_NULL( wrapped );
+
+    target = stumpless_open_async_target( "async-close", wrapped, 4 );
+    ASSERT_NOT_NULL( target );
+
+    call_count = 0;
+    for( i = 0; i < 100; i++ ) {
+      stumpless_add_message( target, "message %d", i );
+      EXPECT_NO_ERROR;
+    }
+
+    stumpless_close_async_target( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( call_count, 100 );
+
+    stumpless_get_memory_stats( &stats );
+    EXPECT_EQ( stats.async_queues.bytes, 0 );
+    EXPECT_EQ( stats.async_queues.count, 0 );
+
+    stumpless_close_function_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetCloseTest, WrongTargetType ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_stdout_target( "not-an-async-target" );
+
+    stumpless_close_async_target( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+
+    stumpless_close_stream_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetFlushTest, BufferedFileTarget ) {
+    const char *filename = "async-buffered-file.log";
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    std::string line;
+    size_t line_count = 0;
+
+    remove( filename );
+    wrapped = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( wrapped );
+    stumpless_set_file_buffer_size( wrapped, 4096 );
+
+    target = stumpless_open_async_target( "async-buffered-file", wrapped, 0 );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_add_message( target, "buffered async message" );
+
+    // flushing the async target also flushes the buffer of the file target
+    result = stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    std::ifstream infile( filename );
+    while( std::getline( infile, line ) ) {
+      EXPECT_THAT( line, testing::EndsWith( "buffered async message" ) );
+      line_count++;
+    }
+    EXPECT_EQ( line_count, 1 );
+
+    stumpless_close_async_target( target );
+    stumpless_close_file_target( wrapped );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetFlushTest, NullTarget ) {
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_flush_target( NULL );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetFlushTest, SynchronousTarget ) {
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+
+    target = stumpless_open_stdout_target( "flush-synchronous-target" );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_close_stream_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetDeferredTest, MallocFailure ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+    void * ( *set_malloc_result )( size_t );
+
+    wrapped = stumpless_open_stdout_target( "deferred-malloc-failure-wrapped" );
+    ASSERT_NOT_NULL( wrapped );
+
+    target = stumpless_open_async_target( "deferred-malloc-failure",
+                                          wrapped,
+                                          0 );
+    ASSERT_NOT_NULL( target );
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_set_async_deferred_formatting( target, true );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_NULL( result );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    ASSERT_TRUE( set_malloc_result == malloc );
+
+    result = stumpless_set_async_deferred_formatting( target, true );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_close_async_target( target );
+    stumpless_close_stream_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetDeferredTest, NoAllocationWhenLogging ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    void * ( *set_malloc_result )( size_t );
+    int result;
+
+    target = open_stalled_target( "deferred-no-allocation", &wrapped, 8 );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_set_async_deferred_formatting( target, true );
+    EXPECT_NO_ERROR;
+
+    // the writer thread is stalled, so only the logging thread could allocate
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_add_message( target, "pooled message %d", 7 );
+    EXPECT_NO_ERROR;
+    EXPECT_GE( result, 0 );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    ASSERT_TRUE( set_malloc_result == malloc );
+
+    function_released = true;
+    stumpless_flush_target( target );
+    EXPECT_EQ( call_count, 2 );
+    EXPECT_STREQ( last_message, "pooled message 7" );
+
+    stumpless_close_async_target( target );
+    stumpless_close_function_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetDeferredTest, NullTarget ) {
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_async_deferred_formatting( NULL, true );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetDeferredTest, WrongTargetType ) {
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_stdout_target( "deferred-wrong-type" );
+
+    result = stumpless_set_async_deferred_formatting( target, true );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    stumpless_close_stream_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetDropCountTest, InvalidSeverity ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    size_t result;
+    const struct stumpless_error *error;
+
+    wrapped = stumpless_open_stdout_target( "drop-count-severity-wrapped" );
+    ASSERT_NOT_NULL( wrapped );
+
+    target = stumpless_open_async_target( "drop-count-severity", wrapped, 0 );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_get_async_drop_count( target,
+                                             ( enum stumpless_severity ) 8 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_INVALID_SEVERITY );
+    EXPECT_EQ( result, 0 );
+
+    stumpless_close_async_target( target );
+    stumpless_close_stream_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetDropCountTest, NullTarget ) {
+    size_t result;
+    const struct stumpless_error *error;
+
+    result = stumpless_get_async_drop_count( NULL, STUMPLESS_SEVERITY_INFO );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_EQ( result, 0 );
+
+    result = stumpless_get_async_total_drop_count( NULL );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_EQ( result, 0 );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetDropCountTest, WrongTargetType ) {
+    struct stumpless_target *target;
+    size_t result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_stdout_target( "drop-count-wrong-type" );
+
+    result = stumpless_get_async_drop_count( target, STUMPLESS_SEVERITY_INFO );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_EQ( result, 0 );
+
+    result = stumpless_get_async_total_drop_count( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_EQ( result, 0 );
+
+    stumpless_close_stream_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetFunctionTest, MessageIsCopied ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    struct stumpless_entry *entry;
+    int result;
+
+    wrapped = stumpless_open_function_target( "async-function-wrapped",
+                                              counting_log_function );
+    ASSERT_NOT_NULL( wrapped );
+
+    target = stumpless_open_async_target( "async-function", wrapped, 0 );
+    ASSERT_NOT_NULL( target );
+
+    entry = stumpless_new_entry_str( STUMPLESS_FACILITY_USER,
+                                     STUMPLESS_SEVERITY_INFO,
+                                     "async-app",
+                                     "async-msgid",
+                                     "a message with a literal %s in it" );
+    ASSERT_NOT_NULL( entry );
+
+    call_count = 0;
+    result = stumpless_add_entry( target, entry );
+    EXPECT_NO_ERROR;
+    EXPECT_GE( result, 0 );
+
+    // changing the entry after it is queued does not change what is logged
+    stumpless_set_entry_message_str( entry, "a changed message" );
+
+    stumpless_flush_target( target );
+    EXPECT_EQ( call_count, 1 );
+    EXPECT_STREQ( last_message, "a message with a literal %s in it" );
+
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_close_async_target( target );
+    stumpless_close_function_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOverflowTest, BlockTimeout ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    int add_result;
+
+    // the queue size is rounded up to two
+    target = open_stalled_target( "overflow-block-timeout", &wrapped, 1 );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_async_block_timeout( target, 10 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "first queued message" );
+    EXPECT_NO_ERROR;
+    stumpless_add_message( target, "queued message" );
+    EXPECT_NO_ERROR;
+
+    // there is no room, so this waits for the timeout and is dropped
+    add_result = stumpless_add_message( target, "timed out message" );
+    EXPECT_NO_ERROR;
+    EXPECT_GE( add_result, 0 );
+    EXPECT_EQ( stumpless_get_async_total_drop_count( target ), 1 );
+
+    function_released = true;
+    stumpless_flush_target( target );
+    EXPECT_EQ( call_count, 3 );
+    EXPECT_STREQ( last_message, "queued message" );
+
+    stumpless_close_async_target( target );
+    stumpless_close_function_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOverflowTest, DropLowestSeverity ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    int i;
+
+    target = open_stalled_target( "overflow-drop-severity", &wrapped, 8 );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_set_async_overflow_policy( target,
+                                STUMPLESS_ASYNC_OVERFLOW_DROP_LOWEST_SEVERITY );
+    EXPECT_NO_ERROR;
+
+    // debug messages may fill the queue, but cannot replace each other
+    for( i = 0; i < 9; i++ ) {
+      stumpless_add_log( target,
+                         STUMPLESS_FACILITY_USER | STUMPLESS_SEVERITY_DEBUG,
+                         "debug message %d", i );
+      EXPECT_NO_ERROR;
+    }
+    EXPECT_EQ( stumpless_get_async_queue_depth( target ), 8 );
+    EXPECT_EQ( stumpless_get_async_drop_count( target,
+                                               STUMPLESS_SEVERITY_DEBUG ), 1 );
+
+    // error messages replace the queued debug messages
+    for( i = 0; i < 8; i++ ) {
+      stumpless_add_log( target,
+                         STUMPLESS_FACILITY_USER | STUMPLESS_SEVERITY_ERR,
+                         "error message %d", i );
+      EXPECT_NO_ERROR;
+    }
+    EXPECT_EQ( stumpless_get_async_queue_depth( target ), 8 );
+    EXPECT_EQ( stumpless_get_async_drop_count( target,
+                                               STUMPLESS_SEVERITY_DEBUG ), 9 );
+    EXPECT_EQ( stumpless_get_async_drop_count( target,
+                                               STUMPLESS_SEVERITY_ERR ), 0 );
+
+    // a warning cannot replace an error
+    stumpless_add_log( target,
+                       STUMPLESS_FACILITY_USER | STUMPLESS_SEVERITY_WARNING,
+                       "warning message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( stumpless_get_async_drop_count( target,
+                                               STUMPLESS_SEVERITY_WARNING ),
+               1 );
+
+    // a critical message replaces the oldest error
+    stumpless_add_log( target,
+                       STUMPLESS_FACILITY_USER | STUMPLESS_SEVERITY_CRIT,
+                       "critical message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( stumpless_get_async_queue_depth( target ), 8 );
+    EXPECT_EQ( stumpless_get_async_drop_count( target,
+                                               STUMPLESS_SEVERITY_ERR ), 1 );
+    EXPECT_EQ( stumpless_get_async_total_drop_count( target ), 11 );
+
+    function_released = true;
+    stumpless_flush_target( target );
+    EXPECT_EQ( call_count, 9 );
+    EXPECT_STREQ( last_message, "critical message" );
+
+    stumpless_close_async_target( target );
+    stumpless_close_function_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOverflowTest, DropLowestSeverityCriticalTimeout ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    int add_result;
+    int i;
+
+    target = open_stalled_target( "overflow-drop-severity-timeout",
+                                  &wrapped,
+                                  2 );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_set_async_overflow_policy( target,
+                                STUMPLESS_ASYNC_OVERFLOW_DROP_LOWEST_SEVERITY );
+    EXPECT_NO_ERROR;
+    stumpless_set_async_block_timeout( target, 10 );
+    EXPECT_NO_ERROR;
+
+    for( i = 0; i < 2; i++ ) {
+      stumpless_add_log( target,
+                         STUMPLESS_FACILITY_USER | STUMPLESS_SEVERITY_CRIT,
+                         "critical message %d", i );
+      EXPECT_NO_ERROR;
+    }
+
+    // there is nothing less severe to replace, so this waits and is dropped
+    add_result = stumpless_add_log( target,
+                                    STUMPLESS_FACILITY_USER |
+                                      STUMPLESS_SEVERITY_CRIT,
+                                    "timed out message" );
+    EXPECT_NO_ERROR;
+    EXPECT_GE( add_result, 0 );
+    EXPECT_EQ( stumpless_get_async_drop_count( target,
+                                               STUMPLESS_SEVERITY_CRIT ), 1 );
+    EXPECT_EQ( stumpless_get_async_queue_depth( target ), 2 );
+
+    function_released = true;
+    stumpless_flush_target( target );
+    EXPECT_EQ( call_count, 3 );
+    EXPECT_STREQ( last_message, "critical message 1" );
+
+    stumpless_close_async_target( target );
+    stumpless_close_function_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOverflowTest, DropNewest ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    int i;
+
+    target = open_stalled_target( "overflow-drop-newest", &wrapped, 4 );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_async_overflow_policy( target,
+                                       STUMPLESS_ASYNC_OVERFLOW_DROP_NEWEST );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    for( i = 0; i < 7; i++ ) {
+      stumpless_add_message( target, "message %d", i );
+      EXPECT_NO_ERROR;
+    }
+
+    EXPECT_EQ( stumpless_get_async_queue_depth( target ), 4 );
+    EXPECT_EQ( stumpless_get_async_drop_count( target,
+                                               STUMPLESS_SEVERITY_INFO ), 3 );
+    EXPECT_EQ( stumpless_get_async_total_drop_count( target ), 3 );
+
+    function_released = true;
+    stumpless_flush_target( target );
+    EXPECT_EQ( call_count, 5 );
+    EXPECT_STREQ( last_message, "message 3" );
+
+    stumpless_close_async_target( target );
+    stumpless_close_function_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOverflowTest, DropOldest ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    int i;
+
+    target = open_stalled_target( "overflow-drop-oldest", &wrapped, 4 );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_set_async_overflow_policy( target,
+                                         STUMPLESS_ASYNC_OVERFLOW_DROP_OLDEST );
+    EXPECT_NO_ERROR;
+
+    for( i = 0; i < 7; i++ ) {
+      stumpless_add_message( target, "message %d", i );
+      EXPECT_NO_ERROR;
+    }
+
+    EXPECT_EQ( stumpless_get_async_queue_depth( target ), 4 );
+    EXPECT_EQ( stumpless_get_async_total_drop_count( target ), 3 );
+
+    function_released = true;
+    stumpless_flush_target( target );
+    EXPECT_EQ( call_count, 5 );
+    EXPECT_STREQ( last_message, "message 6" );
+
+    stumpless_close_async_target( target );
+    stumpless_close_function_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOverflowTest, InvalidPolicy ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    wrapped = stumpless_open_stdout_target( "overflow-invalid-wrapped" );
+    ASSERT_NOT_NULL( wrapped );
+
+    target = stumpless_open_async_target( "overflow-invalid", wrapped, 0 );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_async_overflow_policy( target,
+                              ( enum stumpless_async_overflow_policy ) 42 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_INDEX_OUT_OF_BOUNDS );
+    EXPECT_NULL( result );
+
+    stumpless_close_async_target( target );
+    stumpless_close_stream_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOverflowTest, NullTarget ) {
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_async_overflow_policy( NULL,
+                                       STUMPLESS_ASYNC_OVERFLOW_DROP_NEWEST );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_async_block_timeout( NULL, 10 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOverflowTest, WrongTargetType ) {
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_stdout_target( "overflow-wrong-type" );
+
+    result = stumpless_set_async_overflow_policy( target,
+                                       STUMPLESS_ASYNC_OVERFLOW_DROP_NEWEST );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_async_block_timeout( target, 10 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    stumpless_close_stream_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetQueueDepthTest, FullQueue ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    size_t result;
+    int i;
+
+    wrapped = stumpless_open_function_target( "async-depth-wrapped",
+                                              waiting_log_function );
+    ASSERT_NOT_NULL( wrapped );
+
+    target = stumpless_open_async_target( "async-depth", wrapped, 3 );
+    ASSERT_NOT_NULL( target );
+
+    call_count = 0;
+    function_started = false;
+    function_released = false;
+
+    // the writer thread takes the first message and waits in the function
+    stumpless_add_message( target, "first message" );
+    EXPECT_NO_ERROR;
+    while( !function_started ) {
+      std::this_thread::yield(  );
+    }
+
+    // the queue size was rounded up to four
+    for( i = 0; i < 4; i++ ) {
+      stumpless_add_message( target, "queued message %d", i );
+      EXPECT_NO_ERROR;
+    }
+
+    result = stumpless_get_async_queue_depth( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 4 );
+
+    function_released = true;
+    stumpless_flush_target( target );
+    EXPECT_EQ( call_count, 5 );
+    EXPECT_EQ( stumpless_get_async_queue_depth( target ), 0 );
+
+    stumpless_close_async_target( target );
+    stumpless_close_function_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetQueueDepthTest, NullTarget ) {
+    size_t result;
+    const struct stumpless_error *error;
+
+    result = stumpless_get_async_queue_depth( NULL );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_EQ( result, 0 );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetQueueDepthTest, WrongTargetType ) {
+    struct stumpless_target *target;
+    size_t result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_stdout_target( "queue-depth-wrong-type" );
+
+    result = stumpless_get_async_queue_depth( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_EQ( result, 0 );
+
+    stumpless_close_stream_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOpenTest, MallocFailure ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+    void * ( *set_malloc_result )( size_t );
+
+    wrapped = stumpless_open_stdout_target( "async-malloc-failure-wrapped" );
+    ASSERT_NOT_NULL( wrapped );
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    target = stumpless_open_async_target( "async-malloc-failure", wrapped, 0 );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    ASSERT_TRUE( set_malloc_result == malloc );
+
+    stumpless_close_stream_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOpenTest, NullName ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    wrapped = stumpless_open_stdout_target( "async-null-name-wrapped" );
+    ASSERT_NOT_NULL( wrapped );
+
+    target = stumpless_open_async_target( NULL, wrapped, 0 );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_close_stream_target( wrapped );
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOpenTest, NullWrappedTarget ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_async_target( "async-null-wrapped", NULL, 0 );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetOpenTest, TooLarge ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    wrapped = stumpless_open_stdout_target( "async-too-large-wrapped" );
+    ASSERT_NOT_NULL( wrapped );
+
+    target = stumpless_open_async_target( "async-too-large",
+                                          wrapped,
+                                          SIZE_MAX );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+
+    stumpless_close_stream_target( wrapped );
+    stumpless_free_all(  );
+  }
+}
@@ -16,15 +16,45 @@
  * limitations under the License.
  */
 
+#include <chrono>
 #include <fstream>
 #include <stddef.h>
 #include <stdlib.h>
 #include <stumpless.h>
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <string>
+#include <thread>
 #include "test/helper/assert.hpp"
+#include "test/helper/memory_allocation.hpp"
 #include "test/helper/rfc5424.hpp"
 
 namespace {
+  size_t
+  count_lines( const char *filename ) {
+    std::ifstream infile( filename );
+    std::string line;
+    size_t count = 0;
+
+    while( std::getline( infile, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      count++;
+    }
+
+    return count;
+  }
+
+  void
+  remove_shards( const char *name, unsigned int shard_count ) {
+    std::string shard;
+    unsigned int i;
+
+    for( i = 0; i < shard_count; i++ ) {
+      shard = std::string( name ) + ".shard" + std::to_string( i );
+      remove( shard.c_str(  ) );
+    }
+  }
+
   class FileTargetTest : public::testing::Test {
     protected:
       const char *filename = "testfile.log";
@@ -74,6 +104,263 @@ namespace {
 
   /* non-fixture tests */
 
+  TEST( FileTargetBufferTest, FlushedBySeverity ) {
+    const char *filename = "filebufferseveritytest.log";
+    struct stumpless_target *target;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_file_buffer_size( target, 4096 );
+
+    stumpless_add_log( target, STUMPLESS_SEVERITY_WARNING, "warning" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 0 );
+
+    stumpless_add_log( target, STUMPLESS_SEVERITY_ERR, "error" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 2 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetBufferTest, FlushedWhenFull ) {
+    const char *filename = "filebufferfulltest.log";
+    struct stumpless_target *target;
+    int i;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_file_buffer_size( target, 512 );
+
+    for( i = 0; i < 20; i++ ) {
+      stumpless_add_message( target, "buffered message %d", i );
+      EXPECT_NO_ERROR;
+    }
+
+    // some, but not all, of the messages have been written
+    EXPECT_GT( count_lines( filename ), 0 );
+    EXPECT_LT( count_lines( filename ), 20 );
+
+    stumpless_close_file_target( target );
+    EXPECT_EQ( count_lines( filename ), 20 );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetBufferTest, FlushInterval ) {
+    const char *filename = "filebufferintervaltest.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_file_buffer_size( target, 4096 );
+
+    result = stumpless_set_file_flush_interval( target, 1 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "first message" );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+    stumpless_add_message( target, "second message" );
+    EXPECT_EQ( count_lines( filename ), 2 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetBufferTest, LargeMessage ) {
+    const char *filename = "filebufferlargetest.log";
+    struct stumpless_target *target;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_file_buffer_size( target, 16 );
+
+    stumpless_add_message( target, "a message longer than the buffer" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 1 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetBufferTest, MallocFailure ) {
+    const char *filename = "filebuffermallocfailuretest.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+    void *(*set_malloc_result)(size_t);
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_set_file_buffer_size( target, 4096 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_NULL( result );
+
+    stumpless_set_malloc( malloc );
+
+    // the target still writes messages as they are logged
+    stumpless_add_message( target, "unbuffered message" );
+    stumpless_flush_target( target );
+    EXPECT_EQ( count_lines( filename ), 1 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetBufferTest, MemoryStats ) {
+    const char *filename = "filebufferstatstest.log";
+    struct stumpless_target *target;
+    struct stumpless_memory_stats stats;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_get_memory_stats( &stats );
+    EXPECT_EQ( stats.file_buffers.bytes, 0 );
+    EXPECT_EQ( stats.file_buffers.count, 0 );
+
+    stumpless_set_file_buffer_size( target, 4096 );
+    stumpless_get_memory_stats( &stats );
+    EXPECT_EQ( stats.file_buffers.bytes, 4096 );
+    EXPECT_EQ( stats.file_buffers.count, 1 );
+
+    stumpless_set_file_buffer_size( target, 0 );
+    stumpless_get_memory_stats( &stats );
+    EXPECT_EQ( stats.file_buffers.bytes, 0 );
+    EXPECT_EQ( stats.file_buffers.count, 0 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetBufferTest, NullTarget ) {
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_file_buffer_size( NULL, 4096 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_file_flush_interval( NULL, 10 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetBufferTest, RawTarget ) {
+    const char *filename = "filebufferrawtest.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    remove( filename );
+    target = stumpless_open_raw_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_buffer_size( target, 4096 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetBufferTest, Removed ) {
+    const char *filename = "filebufferremovedtest.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_buffer_size( target, 4096 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "buffered message" );
+    EXPECT_EQ( count_lines( filename ), 0 );
+
+    result = stumpless_set_file_buffer_size( target, 0 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+    EXPECT_EQ( count_lines( filename ), 1 );
+
+    stumpless_add_message( target, "unbuffered message" );
+    stumpless_flush_target( target );
+    EXPECT_EQ( count_lines( filename ), 2 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetBufferTest, WrittenOnFlush ) {
+    const char *filename = "filebufferflushtest.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    int i;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_file_buffer_size( target, 4096 );
+
+    for( i = 0; i < 3; i++ ) {
+      stumpless_add_message( target, "buffered message %d", i );
+      EXPECT_NO_ERROR;
+    }
+    EXPECT_EQ( count_lines( filename ), 0 );
+
+    result = stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+    EXPECT_EQ( count_lines( filename ), 3 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetBufferTest, WrongTargetType ) {
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_stdout_target( "file-buffer-wrong-type" );
+
+    result = stumpless_set_file_buffer_size( target, 4096 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_file_flush_interval( target, 10 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    stumpless_close_stream_target( target );
+    stumpless_free_all(  );
+  }
+
   TEST( FileTargetCloseTest, Generic ) {
     const char *filename = "genericclosetest.log";
     struct stumpless_target *target;
@@ -114,82 +401,1096 @@ namespace {
     stumpless_close_stream_target( target );
   }
 
-  TEST( FileTargetFormat, NewlineSeparator ) {
+  TEST( FileTargetDurabilityTest, GroupCommit ) {
+    const char *filename = "filedurabilitygrouptest.log";
     struct stumpless_target *target;
-    struct stumpless_entry *entry;
-    struct stumpless_element *element;
-    struct stumpless_param *param;
-    const char *filename = "filetargetformattest.log";
-    size_t line_count = 3;
-    size_t i;
+    const struct stumpless_target *result;
+    int i;
 
     remove( filename );
     target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_file_buffer_size( target, 4096 );
 
-    entry = stumpless_new_entry( STUMPLESS_FACILITY_USER,
-                                 STUMPLESS_SEVERITY_INFO,
-                                "stumpless-unit-test",
-                                "basic-entry",
-                                "basic test message" );
-
-    element = stumpless_new_element( "basic-element" );
-    stumpless_add_element( entry, element );
-
-    param = stumpless_new_param( "basic-param-name", "basic-param-value" );
-    stumpless_add_param( element, param );
+    result = stumpless_set_file_durability(
+      target,
+      STUMPLESS_FILE_DURABILITY_GROUP_COMMIT,
+      0
+    );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
 
-    for( i = 0; i < line_count; i++ ) {
-      stumpless_add_entry( target, entry );
+    // the buffer is written before each synchronization
+    for( i = 0; i < 5; i++ ) {
+      stumpless_add_message( target, "durable message %d", i );
+      EXPECT_NO_ERROR;
+      EXPECT_EQ( count_lines( filename ), i + 1 );
     }
 
-    stumpless_destroy_entry_and_contents( entry );
     stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
 
-    std::ifstream infile( filename );
-    std::string line;
-    i = 0;
-    while( std::getline( infile, line ) ) {
-      TestRFC5424Compliance( line.c_str() );
-      i++;
+  TEST( FileTargetDurabilityTest, GzipTarget ) {
+    const char *filename = "filedurabilitygziptest.log.gz";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    std::ifstream infile;
+    size_t size;
+
+    remove( filename );
+    target = stumpless_open_gzip_file_target( filename, 0 );
+    if( !target ) {
+      // gzip file targets are not supported in this build
+      stumpless_free_all(  );
+      return;
     }
 
-    EXPECT_EQ( i, line_count );
+    result = stumpless_set_file_durability(
+      target,
+      STUMPLESS_FILE_DURABILITY_GROUP_COMMIT,
+      0
+    );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "durable compressed message" );
+    EXPECT_NO_ERROR;
+
+    // the member holding the message has been finished and written
+    infile.open( filename, std::ios::binary | std::ios::ate );
+    size = static_cast<size_t>( infile.tellg(  ) );
+    EXPECT_GT( size, 0 );
+
+    stumpless_close_file_target( target );
     remove( filename );
+    stumpless_free_all(  );
   }
 
-  TEST( FileTargetOpenTest, Directory ) {
+  TEST( FileTargetDurabilityTest, InvalidDurability ) {
+    const char *filename = "filedurabilityinvalidtest.log";
     struct stumpless_target *target;
+    const struct stumpless_target *result;
     const struct stumpless_error *error;
-   
-    target = stumpless_open_file_target( "/" );
-    EXPECT_NULL( target );
-    EXPECT_ERROR_ID_EQ( STUMPLESS_FILE_OPEN_FAILURE );
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_durability(
+      target,
+      static_cast<enum stumpless_file_durability>( 42 ),
+      0
+    );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_INDEX_OUT_OF_BOUNDS );
+    EXPECT_NULL( result );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
   }
 
-  TEST( FileTargetOpenTest, MallocFailure ) {
-    const char *filename = "open-malloc-fail.log";
+  TEST( FileTargetDurabilityTest, InvalidSeverity ) {
+    const char *filename = "filedurabilityseverityinvalidtest.log";
     struct stumpless_target *target;
+    const struct stumpless_target *result;
     const struct stumpless_error *error;
-    void *(*set_malloc_result)(size_t);
 
-    set_malloc_result = stumpless_set_malloc( [](size_t size)->void *{ return NULL; } );
-    ASSERT_NOT_NULL( set_malloc_result );
-   
+    remove( filename );
     target = stumpless_open_file_target( filename );
-    EXPECT_NULL( target );
-    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    ASSERT_NOT_NULL( target );
 
-    set_malloc_result = stumpless_set_malloc( malloc );
-    ASSERT_TRUE( set_malloc_result == malloc );
+    result = stumpless_set_file_durability( target,
+                                            STUMPLESS_FILE_DURABILITY_SEVERITY,
+                                            42 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_INVALID_SEVERITY );
+    EXPECT_NULL( result );
+
+    stumpless_close_file_target( target );
     remove( filename );
+    stumpless_free_all(  );
   }
 
-  TEST( FileTargetOpenTest, NullName ) {
+  TEST( FileTargetDurabilityTest, None ) {
+    const char *filename = "filedurabilitynonetest.log";
     struct stumpless_target *target;
+    const struct stumpless_target *result;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_file_buffer_size( target, 4096 );
+
+    stumpless_set_file_durability( target,
+                                   STUMPLESS_FILE_DURABILITY_GROUP_COMMIT,
+                                   0 );
+    EXPECT_NO_ERROR;
+    result = stumpless_set_file_durability( target,
+                                            STUMPLESS_FILE_DURABILITY_NONE,
+                                            0 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "buffered message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 0 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetDurabilityTest, NullTarget ) {
+    const struct stumpless_target *result;
     const struct stumpless_error *error;
 
-    target = stumpless_open_file_target( NULL );
-    EXPECT_NULL( target );
+    result = stumpless_set_file_durability( NULL,
+                                            STUMPLESS_FILE_DURABILITY_NONE,
+                                            0 );
     EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetDurabilityTest, Periodic ) {
+    const char *filename = "filedurabilityperiodictest.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_file_buffer_size( target, 4096 );
+
+    result = stumpless_set_file_durability( target,
+                                            STUMPLESS_FILE_DURABILITY_PERIODIC,
+                                            60000 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "early message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 0 );
+
+    // a period of zero synchronizes after every message
+    stumpless_set_file_durability( target,
+                                   STUMPLESS_FILE_DURABILITY_PERIODIC,
+                                   0 );
+    EXPECT_NO_ERROR;
+
+    stumpless_add_message( target, "late message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 2 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetDurabilityTest, RawTarget ) {
+    const char *filename = "filedurabilityrawtest.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+
+    remove( filename );
+    target = stumpless_open_raw_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_durability(
+      target,
+      STUMPLESS_FILE_DURABILITY_GROUP_COMMIT,
+      0
+    );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "durable raw message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 1 );
+
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetDurabilityTest, Severity ) {
+    const char *filename = "filedurabilityseveritytest.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    int mask;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+    mask = STUMPLESS_SEVERITY_MASK_UPTO( STUMPLESS_SEVERITY_DEBUG );
+    stumpless_set_target_mask( target, mask );
+    stumpless_set_file_buffer_size( target, 4096 );
+
+    result = stumpless_set_file_durability( target,
+                                            STUMPLESS_FILE_DURABILITY_SEVERITY,
+                                            STUMPLESS_SEVERITY_WARNING );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_log( target, STUMPLESS_SEVERITY_INFO, "info" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 0 );
+
+    stumpless_add_log( target, STUMPLESS_SEVERITY_WARNING, "warning" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 2 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetDurabilityTest, WrongTargetType ) {
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_stdout_target( "file-durability-wrong-type" );
+
+    result = stumpless_set_file_durability( target,
+                                            STUMPLESS_FILE_DURABILITY_NONE,
+                                            0 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    stumpless_close_stream_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetFormat, NewlineSeparator ) {
+    struct stumpless_target *target;
+    struct stumpless_entry *entry;
+    struct stumpless_element *element;
+    struct stumpless_param *param;
+    const char *filename = "filetargetformattest.log";
+    size_t line_count = 3;
+    size_t i;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+
+    entry = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                                 STUMPLESS_SEVERITY_INFO,
+                                "stumpless-unit-test",
+                                "basic-entry",
+                                "basic test message" );
+
+    element = stumpless_new_element( "basic-element" );
+    stumpless_add_element( entry, element );
+
+    param = stumpless_new_param( "basic-param-name", "basic-param-value" );
+    stumpless_add_param( element, param );
+
+    for( i = 0; i < line_count; i++ ) {
+      stumpless_add_entry( target, entry );
+    }
+
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_close_file_target( target );
+
+    std::ifstream infile( filename );
+    std::string line;
+    i = 0;
+    while( std::getline( infile, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      i++;
+    }
+
+    EXPECT_EQ( i, line_count );
+    remove( filename );
+  }
+
+  TEST( FileTargetFormat, NewlineSeparatorForBatch ) {
+    struct stumpless_target *target;
+    struct stumpless_entry *entries[3];
+    const char *filename = "filetargetbatchformattest.log";
+    size_t entry_count = 3;
+    size_t i;
+    int mask;
+    int result;
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    for( i = 0; i < entry_count; i++ ) {
+      entries[i] = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                                        STUMPLESS_SEVERITY_INFO,
+                                        "stumpless-unit-test",
+                                        "batch-entry",
+                                        "batch test message %zu",
+                                        i );
+      ASSERT_NOT_NULL( entries[i] );
+    }
+
+    // the last entry is filtered out, so only two are written
+    mask = STUMPLESS_SEVERITY_MASK( STUMPLESS_SEVERITY_INFO );
+    stumpless_set_target_mask( target, mask );
+    stumpless_set_entry_severity( entries[2], STUMPLESS_SEVERITY_DEBUG );
+
+    result = stumpless_add_entries( target, entries, entry_count );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 2 );
+
+    for( i = 0; i < entry_count; i++ ) {
+      stumpless_destroy_entry_and_contents( entries[i] );
+    }
+    stumpless_close_file_target( target );
+
+    std::ifstream infile( filename );
+    std::string line;
+    i = 0;
+    while( std::getline( infile, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      EXPECT_THAT( line,
+                   testing::EndsWith( "batch test message " +
+                                      std::to_string( i ) ) );
+      i++;
+    }
+
+    EXPECT_EQ( i, 2 );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetOpenTest, Directory ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+   
+    target = stumpless_open_file_target( "/" );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_FILE_OPEN_FAILURE );
+  }
+
+  TEST( FileTargetOpenTest, MallocFailure ) {
+    const char *filename = "open-malloc-fail.log";
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+    void *(*set_malloc_result)(size_t);
+
+    set_malloc_result = stumpless_set_malloc( [](size_t size)->void *{ return NULL; } );
+    ASSERT_NOT_NULL( set_malloc_result );
+   
+    target = stumpless_open_file_target( filename );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    ASSERT_TRUE( set_malloc_result == malloc );
+    remove( filename );
+  }
+
+  TEST( FileTargetOpenTest, NullName ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_file_target( NULL );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+  }
+
+  TEST( FileTargetRotationTest, AgeLimit ) {
+    const char *filename = "rotationagetest.log";
+    const char *rotated = "rotationagetest.log.1";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+
+    remove( filename );
+    remove( rotated );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_rotation( target, 0, 1, 1 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "first message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( rotated ), 0 );
+
+    std::this_thread::sleep_for( std::chrono::seconds( 2 ) );
+
+    stumpless_add_message( target, "second message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( rotated ), 2 );
+    EXPECT_EQ( count_lines( filename ), 0 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    remove( rotated );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetRotationTest, Disabled ) {
+    const char *filename = "rotationdisabledtest.log";
+    const char *rotated = "rotationdisabledtest.log.1";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+
+    remove( filename );
+    remove( rotated );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_set_file_rotation( target, 1, 0, 1 );
+    EXPECT_NO_ERROR;
+
+    result = stumpless_set_file_rotation( target, 0, 0, 1 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "first message" );
+    stumpless_add_message( target, "second message" );
+    stumpless_flush_target( target );
+    EXPECT_EQ( count_lines( filename ), 2 );
+    EXPECT_EQ( count_lines( rotated ), 0 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetRotationTest, ExistingContents ) {
+    const char *filename = "rotationexistingtest.log";
+    const char *rotated = "rotationexistingtest.log.1";
+    struct stumpless_target *target;
+
+    remove( filename );
+    remove( rotated );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_add_message( target, "existing message" );
+    stumpless_set_file_rotation( target, 10, 0, 1 );
+    EXPECT_NO_ERROR;
+
+    // the existing message already takes the file past the limit
+    stumpless_add_message( target, "new message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( rotated ), 2 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    remove( rotated );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetRotationTest, KeepCount ) {
+    const char *filename = "rotationkeeptest.log";
+    std::string rotated[4];
+    struct stumpless_target *target;
+    size_t i;
+
+    for( i = 0; i < 4; i++ ) {
+      rotated[i] = std::string( filename ) + "." + std::to_string( i + 1 );
+      remove( rotated[i].c_str(  ) );
+    }
+    remove( filename );
+
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    // every message takes the file past the limit
+    stumpless_set_file_rotation( target, 1, 0, 3 );
+    EXPECT_NO_ERROR;
+
+    for( i = 0; i < 5; i++ ) {
+      stumpless_add_message( target, "rotated message %zu", i );
+      EXPECT_NO_ERROR;
+    }
+
+    EXPECT_EQ( count_lines( filename ), 0 );
+    EXPECT_EQ( count_lines( rotated[0].c_str(  ) ), 1 );
+    EXPECT_EQ( count_lines( rotated[1].c_str(  ) ), 1 );
+    EXPECT_EQ( count_lines( rotated[2].c_str(  ) ), 1 );
+    EXPECT_EQ( count_lines( rotated[3].c_str(  ) ), 0 );
+
+    std::ifstream newest( rotated[0] );
+    std::string line;
+    std::getline( newest, line );
+    EXPECT_THAT( line, testing::EndsWith( "rotated message 4" ) );
+
+    stumpless_close_file_target( target );
+    for( i = 0; i < 4; i++ ) {
+      remove( rotated[i].c_str(  ) );
+    }
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetRotationTest, KeepNone ) {
+    const char *filename = "rotationkeepnonetest.log";
+    const char *rotated = "rotationkeepnonetest.log.1";
+    struct stumpless_target *target;
+
+    remove( filename );
+    remove( rotated );
+    target = stumpless_open_raw_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_set_file_rotation( target, 1, 0, 0 );
+    EXPECT_NO_ERROR;
+
+    stumpless_add_message( target, "deleted message" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 0 );
+    EXPECT_EQ( count_lines( rotated ), 0 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetRotationTest, MallocFailure ) {
+    const char *filename = "rotationmallocfailuretest.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+    void *(*set_malloc_result)(size_t);
+
+    remove( filename );
+    target = stumpless_open_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_set_file_rotation( target, 1024, 0, 1 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_NULL( result );
+
+    stumpless_set_malloc( malloc );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetRotationTest, NullTarget ) {
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_file_rotation( NULL, 1024, 0, 1 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetRotationTest, RawTarget ) {
+    const char *filename = "rotationrawtest.log";
+    std::string rotated[3];
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    size_t total;
+    size_t i;
+
+    for( i = 0; i < 3; i++ ) {
+      rotated[i] = std::string( filename ) + "." + std::to_string( i + 1 );
+      remove( rotated[i].c_str(  ) );
+    }
+    remove( filename );
+
+    target = stumpless_open_raw_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_rotation( target, 1024, 0, 3 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    for( i = 0; i < 20; i++ ) {
+      stumpless_add_message( target, "raw rotated message %zu", i );
+      EXPECT_NO_ERROR;
+    }
+
+    EXPECT_GT( count_lines( rotated[0].c_str(  ) ), 0 );
+
+    total = count_lines( filename );
+    for( i = 0; i < 3; i++ ) {
+      total += count_lines( rotated[i].c_str(  ) );
+    }
+    EXPECT_EQ( total, 20 );
+
+    stumpless_close_file_target( target );
+    for( i = 0; i < 3; i++ ) {
+      remove( rotated[i].c_str(  ) );
+    }
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( FileTargetRotationTest, WrongTargetType ) {
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_stdout_target( "file-rotation-wrong-type" );
+
+    result = stumpless_set_file_rotation( target, 1024, 0, 1 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    stumpless_close_stream_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( RawFileTargetTest, Appends ) {
+    const char *filename = "rawfileappendtest.log";
+    struct stumpless_target *target;
+    int result;
+
+    remove( filename );
+
+    target = stumpless_open_raw_file_target( filename );
+    ASSERT_NOT_NULL( target );
+    result = stumpless_add_message( target, "first raw message" );
+    EXPECT_NO_ERROR;
+    EXPECT_GE( result, 0 );
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+
+    // reopening the file must not truncate the first message
+    target = stumpless_open_raw_file_target( filename );
+    ASSERT_NOT_NULL( target );
+    result = stumpless_add_message( target, "second raw message" );
+    EXPECT_NO_ERROR;
+    EXPECT_GE( result, 0 );
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+
+    EXPECT_EQ( count_lines( filename ), 2 );
+
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( RawFileTargetTest, Directory ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_raw_file_target( "/" );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_FILE_OPEN_FAILURE );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( RawFileTargetTest, Flush ) {
+    const char *filename = "rawfileflushtest.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+
+    remove( filename );
+    target = stumpless_open_raw_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_add_message( target, "raw message before flush" );
+    EXPECT_NO_ERROR;
+
+    // messages are written as they are logged
+    EXPECT_EQ( count_lines( filename ), 1 );
+
+    result = stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( RawFileTargetTest, LargeMessage ) {
+    const char *filename = "rawfilelargemessagetest.log";
+    struct stumpless_target *target;
+    std::string message( 8 * 1024, 'x' );
+    int result;
+
+    remove( filename );
+    target = stumpless_open_raw_file_target( filename );
+    ASSERT_NOT_NULL( target );
+
+    // too large to be appended atomically, so the target lock is used
+    result = stumpless_add_message( target, message.c_str(  ) );
+    EXPECT_NO_ERROR;
+    EXPECT_GT( result, 8 * 1024 );
+
+    result = stumpless_add_message( target, "small raw message" );
+    EXPECT_NO_ERROR;
+    EXPECT_GE( result, 0 );
+
+    EXPECT_EQ( count_lines( filename ), 2 );
+
+    stumpless_close_file_target( target );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( RawFileTargetTest, MallocFailure ) {
+    const char *filename = "rawfilemallocfailtest.log";
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+    void *(*set_malloc_result)(size_t);
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    target = stumpless_open_raw_file_target( filename );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    ASSERT_TRUE( set_malloc_result == malloc );
+
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( RawFileTargetTest, NullName ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_raw_file_target( NULL );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( ShardedFileTargetTest, IncompatibleSettings ) {
+    const char *filename = "shardedincompatibletest.log";
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    remove_shards( filename, 2 );
+    target = stumpless_open_sharded_file_target( filename, 2 );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_file_buffer_size( target, 4096 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_file_io_uring_depth( target, 8 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_file_rotation( target, 1024, 0, 1 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    stumpless_close_file_target( target );
+    remove_shards( filename, 2 );
+    stumpless_free_all(  );
+  }
+
+  TEST( ShardedFileTargetTest, LargeMessage ) {
+    const char *filename = "shardedlargetest.log";
+    const char *merged = "shardedlargetest-merged.log";
+    std::string large_message( 16 * 1024, 'x' );
+    struct stumpless_target *target;
+    std::ifstream infile;
+    std::string line;
+    int result;
+
+    remove_shards( filename, 1 );
+    remove( merged );
+    target = stumpless_open_sharded_file_target( filename, 1 );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_add_message( target, "first message" );
+    EXPECT_NO_ERROR;
+    stumpless_add_message( target, large_message.c_str(  ) );
+    EXPECT_NO_ERROR;
+    stumpless_add_message( target, "last message" );
+    EXPECT_NO_ERROR;
+
+    stumpless_close_file_target( target );
+
+    result = stumpless_merge_file_shards( filename, 1, merged );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 3 );
+
+    infile.open( merged );
+    std::getline( infile, line );
+    EXPECT_THAT( line, testing::EndsWith( "first message" ) );
+    std::getline( infile, line );
+    EXPECT_THAT( line, testing::EndsWith( large_message ) );
+    std::getline( infile, line );
+    EXPECT_THAT( line, testing::EndsWith( "last message" ) );
+    infile.close(  );
+
+    remove_shards( filename, 1 );
+    remove( merged );
+    stumpless_free_all(  );
+  }
+
+  TEST( ShardedFileTargetTest, MallocFailure ) {
+    const char *filename = "shardedmallocfailtest.log";
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+    void *(*set_malloc_result)(size_t);
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    target = stumpless_open_sharded_file_target( filename, 2 );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+
+    set_malloc_result = stumpless_set_malloc( malloc );
+    ASSERT_TRUE( set_malloc_result == malloc );
+
+    remove_shards( filename, 2 );
+    stumpless_free_all(  );
+  }
+
+  TEST( ShardedFileTargetTest, Merged ) {
+    const char *filename = "shardedmergetest.log";
+    const char *merged = "shardedmergetest-merged.log";
+    struct stumpless_target *target;
+    std::ifstream infile;
+    std::string line;
+    int result;
+    int i;
+
+    remove_shards( filename, 4 );
+    remove( merged );
+    target = stumpless_open_sharded_file_target( filename, 4 );
+    ASSERT_NOT_NULL( target );
+
+    for( i = 0; i < 10; i++ ) {
+      stumpless_add_message( target, "sharded message %d", i );
+      EXPECT_NO_ERROR;
+    }
+
+    stumpless_close_file_target( target );
+
+    result = stumpless_merge_file_shards( filename, 4, merged );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 10 );
+
+    infile.open( merged );
+    i = 0;
+    while( std::getline( infile, line ) ) {
+      TestRFC5424Compliance( line.c_str(  ) );
+      EXPECT_THAT( line,
+                   testing::EndsWith( "sharded message " +
+                                      std::to_string( i ) ) );
+      i++;
+    }
+    EXPECT_EQ( i, 10 );
+    infile.close(  );
+
+    remove_shards( filename, 4 );
+    remove( merged );
+    stumpless_free_all(  );
+  }
+
+  TEST( ShardedFileTargetTest, MergedFromThreads ) {
+    const char *filename = "shardedthreadtest.log";
+    const char *merged = "shardedthreadtest-merged.log";
+    const int thread_count = 4;
+    const int message_count = 50;
+    struct stumpless_target *target;
+    std::thread *threads[thread_count];
+    int next_message[thread_count] = { 0 };
+    std::ifstream infile;
+    std::string line;
+    size_t position;
+    int thread;
+    int result;
+    int i;
+
+    remove_shards( filename, thread_count );
+    remove( merged );
+    target = stumpless_open_sharded_file_target( filename, thread_count );
+    ASSERT_NOT_NULL( target );
+
+    for( i = 0; i < thread_count; i++ ) {
+      threads[i] = new std::thread( [target, i, message_count]{
+        int j;
+
+        for( j = 0; j < message_count; j++ ) {
+          stumpless_add_message( target, "thread %d message %d", i, j );
+        }
+
+        stumpless_free_thread(  );
+      } );
+    }
+
+    for( i = 0; i < thread_count; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    stumpless_close_file_target( target );
+
+    result = stumpless_merge_file_shards( filename, thread_count, merged );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, thread_count * message_count );
+
+    // the messages of each thread are in the order they were logged
+    infile.open( merged );
+    while( std::getline( infile, line ) ) {
+      TestRFC5424Compliance( line.c_str(  ) );
+      position = line.rfind( "thread " );
+      ASSERT_NE( position, std::string::npos );
+      ASSERT_EQ( sscanf( line.c_str(  ) + position,
+                         "thread %d message %d",
+                         &thread,
+                         &i ), 2 );
+      ASSERT_GE( thread, 0 );
+      ASSERT_LT( thread, thread_count );
+      EXPECT_EQ( i, next_message[thread] );
+      next_message[thread]++;
+    }
+    infile.close(  );
+
+    for( i = 0; i < thread_count; i++ ) {
+      EXPECT_EQ( next_message[i], message_count );
+    }
+
+    remove_shards( filename, thread_count );
+    remove( merged );
+    stumpless_free_all(  );
+  }
+
+  TEST( ShardedFileTargetTest, MissingDirectory ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_sharded_file_target( "./missing/sharded.log", 2 );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_FILE_OPEN_FAILURE );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( ShardedFileTargetTest, MissingShard ) {
+    const char *filename = "shardedmissingtest.log";
+    const char *merged = "shardedmissingtest-merged.log";
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+    int result;
+
+    remove_shards( filename, 3 );
+    target = stumpless_open_sharded_file_target( filename, 2 );
+    ASSERT_NOT_NULL( target );
+    stumpless_close_file_target( target );
+
+    result = stumpless_merge_file_shards( filename, 3, merged );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_FILE_OPEN_FAILURE );
+    EXPECT_EQ( result, -1 );
+
+    remove_shards( filename, 3 );
+    remove( merged );
+    stumpless_free_all(  );
+  }
+
+  TEST( ShardedFileTargetTest, NullName ) {
+    struct stumpless_target *target;
+    const struct stumpless_error *error;
+    int result;
+
+    target = stumpless_open_sharded_file_target( NULL, 2 );
+    EXPECT_NULL( target );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+
+    result = stumpless_merge_file_shards( NULL, 2, "merged.log" );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_EQ( result, -1 );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( ShardedFileTargetTest, NullOutput ) {
+    const struct stumpless_error *error;
+    int result;
+
+    result = stumpless_merge_file_shards( "shardednullouttest.log", 2, NULL );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_EQ( result, -1 );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( ShardedFileTargetTest, PartialRecord ) {
+    const char *filename = "shardedpartialtest.log";
+    const char *merged = "shardedpartialtest-merged.log";
+    std::string shard = std::string( filename ) + ".shard0";
+    struct stumpless_target *target;
+    std::ofstream outfile;
+    int result;
+
+    remove_shards( filename, 1 );
+    remove( merged );
+    target = stumpless_open_sharded_file_target( filename, 1 );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_add_message( target, "complete message" );
+    EXPECT_NO_ERROR;
+
+    stumpless_close_file_target( target );
+
+    // a record cut short, as if the program crashed while writing it
+    outfile.open( shard, std::ios::app | std::ios::binary );
+    outfile << "2 500 <14>1 - - - - - - cut short";
+    outfile.close(  );
+
+    result = stumpless_merge_file_shards( filename, 1, merged );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 1 );
+    EXPECT_EQ( count_lines( merged ), 1 );
+
+    remove_shards( filename, 1 );
+    remove( merged );
+    stumpless_free_all(  );
+  }
+
+  TEST( ShardedFileTargetTest, ShardContents ) {
+    const char *filename = "shardedcontentstest.log";
+    std::string shard = std::string( filename ) + ".shard0";
+    struct stumpless_target *target;
+    std::ifstream infile;
+    std::string line;
+    unsigned long long sequence;
+    unsigned long long length;
+    int offset;
+
+    remove_shards( filename, 1 );
+    target = stumpless_open_sharded_file_target( filename, 1 );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_add_message( target, "first message" );
+    EXPECT_NO_ERROR;
+    stumpless_add_message( target, "second message" );
+    EXPECT_NO_ERROR;
+
+    stumpless_close_file_target( target );
+
+    infile.open( shard );
+    std::getline( infile, line );
+    ASSERT_EQ( sscanf( line.c_str(  ), "%llu %llu %n", &sequence, &length,
+                       &offset ), 2 );
+    EXPECT_EQ( sequence, 1 );
+    EXPECT_EQ( length, line.length(  ) - offset + 1 );
+    TestRFC5424Compliance( line.c_str(  ) + offset );
+    EXPECT_THAT( line, testing::EndsWith( "first message" ) );
+
+    std::getline( infile, line );
+    ASSERT_EQ( sscanf( line.c_str(  ), "%llu", &sequence ), 1 );
+    EXPECT_EQ( sequence, 2 );
+    infile.close(  );
+
+    remove_shards( filename, 1 );
+    stumpless_free_all(  );
   }
 }
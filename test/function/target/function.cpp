@@ -41,6 +41,18 @@ namespace {
     return EXPECTED_FAILURE_VALUE;
   }
 
+  int
+  second_call_failing_log_function( const struct stumpless_target *target,
+                                    const struct stumpless_entry *entry ) {
+    static int call_count = 0;
+
+    if( ++call_count == 2 ) {
+      return EXPECTED_FAILURE_VALUE;
+    }
+
+    return EXPECTED_RETURN_VALUE;
+  }
+
   class FunctionTargetTest : public::testing::Test {
     protected:
       const char *target_name = "test-function-target";
@@ -137,6 +149,39 @@ namespace {
     stumpless_free_all( );
   }
 
+  TEST( FunctionTargetFailureTest, PartialAddEntries ) {
+    struct stumpless_target *target;
+    struct stumpless_entry *entries[3];
+    size_t i;
+    int result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_function_target( "partial-function-target",
+                                             second_call_failing_log_function );
+    ASSERT_NOT_NULL( target );
+
+    for( i = 0; i < 3; i++ ) {
+      entries[i] = stumpless_new_entry_str( STUMPLESS_FACILITY_USER,
+                                            STUMPLESS_SEVERITY_INFO,
+                                            "partial-app",
+                                            "partial-msgid",
+                                            "partial batch message" );
+      ASSERT_NOT_NULL( entries[i] );
+    }
+
+    // only the first entry is sent before the second one fails
+    result = stumpless_add_entries( target, entries, 3 );
+    EXPECT_EQ( result, 1 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_FUNCTION_TARGET_FAILURE );
+
+    for( i = 0; i < 3; i++ ) {
+      stumpless_destroy_entry_and_contents( entries[i] );
+    }
+
+    stumpless_close_function_target( target );
+    stumpless_free_all( );
+  }
+
   TEST( FunctionTargetOpenTest, MallocFailure ) {
     struct stumpless_target *target;
     const struct stumpless_error *error;
@@ -16,16 +16,35 @@
  * limitations under the License.
  */
 
+#include <chrono>
 #include <cstdio>
 #include <fstream>
 #include <stddef.h>
 #include <stdlib.h>
 #include <stumpless.h>
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <string>
+#include <thread>
 #include "test/helper/assert.hpp"
+#include "test/helper/memory_allocation.hpp"
 #include "test/helper/rfc5424.hpp"
 
 namespace {
+  size_t
+  count_lines( const char *filename ) {
+    std::ifstream infile( filename );
+    std::string line;
+    size_t count = 0;
+
+    while( std::getline( infile, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      count++;
+    }
+
+    return count;
+  }
+
   int
   basic_log_function( const struct stumpless_target *target,
                       const struct stumpless_entry *entry ) {
@@ -86,8 +105,393 @@ namespace {
     EXPECT_NO_ERROR;
   }
 
+  TEST_F( StreamTargetTest, AddEntries ) {
+    struct stumpless_entry *entries[3];
+    std::string line;
+    size_t i;
+    int result;
+
+    for( i = 0; i < 3; i++ ) {
+      entries[i] = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                                        STUMPLESS_SEVERITY_INFO,
+                                        "stumpless-unit-test",
+                                        "batch-entry",
+                                        "stream batch message %zu",
+                                        i );
+      ASSERT_NOT_NULL( entries[i] );
+    }
+
+    result = stumpless_add_entries( target, entries, 3 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, 3 );
+
+    fflush( stream );
+    std::ifstream infile( filename );
+    i = 0;
+    while( std::getline( infile, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      EXPECT_THAT( line,
+                   testing::EndsWith( "stream batch message " +
+                                      std::to_string( i ) ) );
+      i++;
+    }
+    EXPECT_EQ( i, 3 );
+
+    for( i = 0; i < 3; i++ ) {
+      stumpless_destroy_entry_and_contents( entries[i] );
+    }
+  }
+
   /* non-fixture tests */
 
+  TEST( StreamTargetBufferTest, FlushedBySeverity ) {
+    const char *filename = "streambufferseveritytest.log";
+    FILE *stream;
+    struct stumpless_target *target;
+
+    stream = fopen( filename, "w+" );
+    ASSERT_NOT_NULL( stream );
+    target = stumpless_open_stream_target( filename, stream );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_stream_buffering( target,
+                                    STUMPLESS_STREAM_BUFFERING_FULL,
+                                    4096 );
+
+    stumpless_add_log( target, STUMPLESS_SEVERITY_WARNING, "warning" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 0 );
+
+    stumpless_add_log( target, STUMPLESS_SEVERITY_ERR, "error" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 2 );
+
+    stumpless_close_stream_target( target );
+    fclose( stream );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( StreamTargetBufferTest, FlushedWhenFull ) {
+    const char *filename = "streambufferfulltest.log";
+    FILE *stream;
+    struct stumpless_target *target;
+    int i;
+
+    stream = fopen( filename, "w+" );
+    ASSERT_NOT_NULL( stream );
+    target = stumpless_open_stream_target( filename, stream );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_stream_buffering( target,
+                                    STUMPLESS_STREAM_BUFFERING_FULL,
+                                    512 );
+
+    for( i = 0; i < 20; i++ ) {
+      stumpless_add_message( target, "buffered message %d", i );
+      EXPECT_NO_ERROR;
+    }
+
+    // some, but not all, of the messages have been written
+    EXPECT_GT( count_lines( filename ), 0 );
+    EXPECT_LT( count_lines( filename ), 20 );
+
+    stumpless_close_stream_target( target );
+    EXPECT_EQ( count_lines( filename ), 20 );
+
+    fclose( stream );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( StreamTargetBufferTest, FlushInterval ) {
+    const char *filename = "streambufferintervaltest.log";
+    FILE *stream;
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+
+    stream = fopen( filename, "w+" );
+    ASSERT_NOT_NULL( stream );
+    target = stumpless_open_stream_target( filename, stream );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_stream_flush_interval( target, 1 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    // the interval also applies to the stream's own buffer
+    stumpless_add_message( target, "first message" );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+    stumpless_add_message( target, "second message" );
+    EXPECT_EQ( count_lines( filename ), 2 );
+
+    stumpless_set_stream_buffering( target,
+                                    STUMPLESS_STREAM_BUFFERING_FULL,
+                                    4096 );
+
+    stumpless_add_message( target, "third message" );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+    stumpless_add_message( target, "fourth message" );
+    EXPECT_EQ( count_lines( filename ), 4 );
+
+    stumpless_close_stream_target( target );
+    fclose( stream );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( StreamTargetBufferTest, InvalidBuffering ) {
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_stdout_target( "stream-invalid-buffering" );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_stream_buffering(
+      target,
+      ( enum stumpless_stream_buffering ) -1,
+      4096
+    );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_INDEX_OUT_OF_BOUNDS );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_stream_buffering(
+      target,
+      ( enum stumpless_stream_buffering ) 3,
+      4096
+    );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_INDEX_OUT_OF_BOUNDS );
+    EXPECT_NULL( result );
+
+    stumpless_close_stream_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( StreamTargetBufferTest, LargeMessage ) {
+    const char *filename = "streambufferlargetest.log";
+    FILE *stream;
+    struct stumpless_target *target;
+
+    stream = fopen( filename, "w+" );
+    ASSERT_NOT_NULL( stream );
+    target = stumpless_open_stream_target( filename, stream );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_stream_buffering( target,
+                                    STUMPLESS_STREAM_BUFFERING_FULL,
+                                    16 );
+
+    stumpless_add_message( target, "a message longer than the buffer" );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( count_lines( filename ), 1 );
+
+    stumpless_close_stream_target( target );
+    fclose( stream );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( StreamTargetBufferTest, LineBuffered ) {
+    const char *filename = "streambufferlinetest.log";
+    FILE *stream;
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    int i;
+
+    stream = fopen( filename, "w+" );
+    ASSERT_NOT_NULL( stream );
+    target = stumpless_open_stream_target( filename, stream );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_stream_buffering( target,
+                                             STUMPLESS_STREAM_BUFFERING_LINE,
+                                             0 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    for( i = 0; i < 3; i++ ) {
+      stumpless_add_message( target, "line buffered message %d", i );
+      EXPECT_NO_ERROR;
+      EXPECT_EQ( count_lines( filename ), i + 1 );
+    }
+
+    stumpless_close_stream_target( target );
+    fclose( stream );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( StreamTargetBufferTest, MallocFailure ) {
+    const char *filename = "streambuffermallocfailuretest.log";
+    FILE *stream;
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+    void *(*set_malloc_result)(size_t);
+
+    stream = fopen( filename, "w+" );
+    ASSERT_NOT_NULL( stream );
+    target = stumpless_open_stream_target( filename, stream );
+    ASSERT_NOT_NULL( target );
+
+    set_malloc_result = stumpless_set_malloc( MALLOC_FAIL );
+    ASSERT_NOT_NULL( set_malloc_result );
+
+    result = stumpless_set_stream_buffering( target,
+                                             STUMPLESS_STREAM_BUFFERING_FULL,
+                                             4096 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_MEMORY_ALLOCATION_FAILURE );
+    EXPECT_NULL( result );
+
+    stumpless_set_malloc( malloc );
+
+    // the target still writes messages as they are logged
+    stumpless_add_message( target, "unbuffered message" );
+    stumpless_flush_target( target );
+    EXPECT_EQ( count_lines( filename ), 1 );
+
+    stumpless_close_stream_target( target );
+    fclose( stream );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( StreamTargetBufferTest, MemoryStats ) {
+    struct stumpless_target *target;
+    struct stumpless_memory_stats stats;
+
+    target = stumpless_open_stdout_target( "stream-buffer-stats" );
+    ASSERT_NOT_NULL( target );
+
+    stumpless_get_memory_stats( &stats );
+    EXPECT_EQ( stats.stream_buffers.bytes, 0 );
+    EXPECT_EQ( stats.stream_buffers.count, 0 );
+
+    stumpless_set_stream_buffering( target,
+                                    STUMPLESS_STREAM_BUFFERING_FULL,
+                                    0 );
+    stumpless_get_memory_stats( &stats );
+    EXPECT_EQ( stats.stream_buffers.bytes,
+               STUMPLESS_DEFAULT_STREAM_BUFFER_SIZE );
+    EXPECT_EQ( stats.stream_buffers.count, 1 );
+
+    stumpless_close_stream_target( target );
+    stumpless_get_memory_stats( &stats );
+    EXPECT_EQ( stats.stream_buffers.bytes, 0 );
+    EXPECT_EQ( stats.stream_buffers.count, 0 );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( StreamTargetBufferTest, NullTarget ) {
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    result = stumpless_set_stream_buffering( NULL,
+                                             STUMPLESS_STREAM_BUFFERING_FULL,
+                                             4096 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_stream_flush_interval( NULL, 10 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_ARGUMENT_EMPTY );
+    EXPECT_NULL( result );
+
+    stumpless_free_all(  );
+  }
+
+  TEST( StreamTargetBufferTest, Removed ) {
+    const char *filename = "streambufferremovedtest.log";
+    FILE *stream;
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+
+    stream = fopen( filename, "w+" );
+    ASSERT_NOT_NULL( stream );
+    target = stumpless_open_stream_target( filename, stream );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_stream_buffering( target,
+                                             STUMPLESS_STREAM_BUFFERING_FULL,
+                                             4096 );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+
+    stumpless_add_message( target, "buffered message" );
+    EXPECT_EQ( count_lines( filename ), 0 );
+
+    result = stumpless_set_stream_buffering(
+      target,
+      STUMPLESS_STREAM_BUFFERING_DEFAULT,
+      0
+    );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+    EXPECT_EQ( count_lines( filename ), 1 );
+
+    stumpless_add_message( target, "unbuffered message" );
+    stumpless_flush_target( target );
+    EXPECT_EQ( count_lines( filename ), 2 );
+
+    stumpless_close_stream_target( target );
+    fclose( stream );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( StreamTargetBufferTest, WrittenOnFlush ) {
+    const char *filename = "streambufferflushtest.log";
+    FILE *stream;
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    int i;
+
+    stream = fopen( filename, "w+" );
+    ASSERT_NOT_NULL( stream );
+    target = stumpless_open_stream_target( filename, stream );
+    ASSERT_NOT_NULL( target );
+    stumpless_set_stream_buffering( target,
+                                    STUMPLESS_STREAM_BUFFERING_FULL,
+                                    4096 );
+
+    for( i = 0; i < 3; i++ ) {
+      stumpless_add_message( target, "buffered message %d", i );
+      EXPECT_NO_ERROR;
+    }
+    EXPECT_EQ( count_lines( filename ), 0 );
+
+    result = stumpless_flush_target( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( result, target );
+    EXPECT_EQ( count_lines( filename ), 3 );
+
+    stumpless_close_stream_target( target );
+    fclose( stream );
+    remove( filename );
+    stumpless_free_all(  );
+  }
+
+  TEST( StreamTargetBufferTest, WrongTargetType ) {
+    struct stumpless_target *target;
+    const struct stumpless_target *result;
+    const struct stumpless_error *error;
+
+    target = stumpless_open_function_target( "stream-buffer-wrong-type",
+                                             basic_log_function );
+    ASSERT_NOT_NULL( target );
+
+    result = stumpless_set_stream_buffering( target,
+                                             STUMPLESS_STREAM_BUFFERING_FULL,
+                                             4096 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    result = stumpless_set_stream_flush_interval( target, 10 );
+    EXPECT_ERROR_ID_EQ( STUMPLESS_TARGET_INCOMPATIBLE );
+    EXPECT_NULL( result );
+
+    stumpless_close_function_target( target );
+    stumpless_free_all(  );
+  }
+
   TEST( StreamTargetCloseTest, Generic ) {
     const char *filename = "genericclosetest.log";
     FILE *stream;
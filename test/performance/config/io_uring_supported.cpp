@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <stumpless.h>
+
+static void AddEntryToRawFile( benchmark::State& state ) {
+  struct stumpless_target *target;
+  struct stumpless_entry *entry;
+  const char *filename = "io-uring-perf.log";
+
+  remove( filename );
+  target = stumpless_open_raw_file_target( filename );
+  // a depth of zero leaves the raw target writing directly for comparison
+  if( !stumpless_set_file_io_uring_depth( target, state.range( 0 ) ) ) {
+    state.SkipWithError( "could not set the io_uring depth" );
+  }
+
+  entry = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                               STUMPLESS_SEVERITY_INFO,
+                               "io-uring-perf",
+                               "io-uring-msgid",
+                               "io_uring message" );
+
+  for(auto _ : state){
+    if( stumpless_add_entry( target, entry ) < 0 ) {
+      state.SkipWithError( "could not send an entry" );
+    }
+  }
+
+  stumpless_destroy_entry_and_contents( entry );
+  stumpless_close_file_target( target );
+  stumpless_free_all(  );
+  remove( filename );
+
+  state.SetItemsProcessed( state.iterations(  ) );
+}
+
+BENCHMARK( AddEntryToRawFile )->Arg( 0 )->Arg( 64 )->Arg( 256 );
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <stumpless.h>
+
+static void AddEntryToSegmentFile( benchmark::State& state ) {
+  struct stumpless_target *target;
+  struct stumpless_entry *entry;
+  const char *name = "segment-perf.log";
+  size_t i;
+
+  target = stumpless_open_segment_file_target( name, state.range( 0 ) );
+  entry = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                               STUMPLESS_SEVERITY_INFO,
+                               "segment-perf",
+                               "segment-msgid",
+                               "segment message" );
+
+  for(auto _ : state){
+    if( stumpless_add_entry( target, entry ) < 0 ) {
+      state.SkipWithError( "could not send an entry" );
+    }
+  }
+
+  stumpless_destroy_entry_and_contents( entry );
+  stumpless_close_file_target( target );
+  stumpless_free_all(  );
+
+  for( i = 1; remove( ( std::string( name ) + "." +
+                        std::to_string( i ) ).c_str(  ) ) == 0; i++ );
+
+  state.SetItemsProcessed( state.iterations(  ) );
+}
+
+BENCHMARK( AddEntryToSegmentFile )->Arg( 1024 * 1024 )->Arg( 64 * 1024 * 1024 );
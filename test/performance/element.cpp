@@ -17,10 +17,64 @@
  */
 
 #include <benchmark/benchmark.h>
+#include <stdio.h>
 #include <stumpless.h>
 #include "test/helper/memory_counter.hpp"
 
+NEW_MEMORY_COUNTER( add_many_params )
+NEW_MEMORY_COUNTER( add_many_params_reserved )
 NEW_MEMORY_COUNTER( copy_element )
+NEW_MEMORY_COUNTER( get_param_by_name )
+NEW_MEMORY_COUNTER( new_element_with_params )
+
+static const size_t MANY_PARAM_COUNT = 32;
+
+static void AddManyParams(benchmark::State& state){
+  struct stumpless_element *element;
+  const struct stumpless_element *result;
+  size_t i;
+
+  INIT_MEMORY_COUNTER( add_many_params );
+
+  for(auto _ : state){
+    element = stumpless_new_element( "add-many-params-perf" );
+
+    for( i = 0; i < MANY_PARAM_COUNT; i++ ) {
+      result = stumpless_add_new_param( element, "param", "value" );
+      if( !result ) {
+        state.SkipWithError( "could not add a param to the element" );
+      }
+    }
+
+    stumpless_destroy_element_and_contents( element );
+  }
+
+  SET_STATE_COUNTERS( state, add_many_params );
+}
+
+static void AddManyParamsReserved(benchmark::State& state){
+  struct stumpless_element *element;
+  const struct stumpless_element *result;
+  size_t i;
+
+  INIT_MEMORY_COUNTER( add_many_params_reserved );
+
+  for(auto _ : state){
+    element = stumpless_new_element( "add-many-params-perf" );
+    stumpless_reserve_params( element, MANY_PARAM_COUNT );
+
+    for( i = 0; i < MANY_PARAM_COUNT; i++ ) {
+      result = stumpless_add_new_param( element, "param", "value" );
+      if( !result ) {
+        state.SkipWithError( "could not add a param to the element" );
+      }
+    }
+
+    stumpless_destroy_element_and_contents( element );
+  }
+
+  SET_STATE_COUNTERS( state, add_many_params_reserved );
+}
 
 static void CopyElement(benchmark::State& state){
   struct stumpless_element *element;
@@ -53,4 +107,57 @@ static void CopyElement(benchmark::State& state){
   state.counters["MemoryFreed"] = ( double ) copy_element_memory_counter.free_total;
 }
 
+static void GetParamByName(benchmark::State& state){
+  struct stumpless_element *element;
+  const struct stumpless_param *result;
+  char param_name[32];
+  size_t i;
+
+  INIT_MEMORY_COUNTER( get_param_by_name );
+
+  element = stumpless_new_element( "get-param-by-name-perf" );
+  for( i = 0; i < MANY_PARAM_COUNT; i++ ) {
+    snprintf( param_name, sizeof( param_name ), "request-param-%zu", i );
+    stumpless_add_new_param( element, param_name, "value" );
+  }
+
+  for(auto _ : state){
+    result = stumpless_get_param_by_name( element, param_name );
+    if( !result ) {
+      state.SkipWithError( "could not find the param" );
+    }
+  }
+
+  stumpless_destroy_element_and_contents( element );
+
+  SET_STATE_COUNTERS( state, get_param_by_name );
+}
+
+static void NewElementWithParams(benchmark::State& state){
+  struct stumpless_element *element;
+  const struct stumpless_element *result;
+
+  INIT_MEMORY_COUNTER( new_element_with_params );
+
+  for(auto _ : state){
+    element = stumpless_new_element( "request" );
+    stumpless_reserve_params( element, 4 );
+    stumpless_add_new_param( element, "method", "GET" );
+    stumpless_add_new_param( element, "path", "/index.html" );
+    stumpless_add_new_param( element, "status", "200" );
+    result = stumpless_add_new_param( element, "user-agent", "benchmark" );
+    if( !result ) {
+      state.SkipWithError( "could not build the element" );
+    }
+
+    stumpless_destroy_element_and_contents( element );
+  }
+
+  SET_STATE_COUNTERS( state, new_element_with_params );
+}
+
+BENCHMARK(AddManyParams);
+BENCHMARK(AddManyParamsReserved);
 BENCHMARK(CopyElement);
+BENCHMARK(GetParamByName);
+BENCHMARK(NewElementWithParams);
@@ -17,12 +17,55 @@
  */
 
 #include <benchmark/benchmark.h>
+#include <stdio.h>
 #include <stumpless.h>
 #include "test/helper/fixture.hpp"
 #include "test/helper/memory_counter.hpp"
 
 NEW_MEMORY_COUNTER( add_entry )
+NEW_MEMORY_COUNTER( add_frozen_entry )
+NEW_MEMORY_COUNTER( add_many_elements )
 NEW_MEMORY_COUNTER( add_message )
+NEW_MEMORY_COUNTER( add_message_str )
+NEW_MEMORY_COUNTER( build_arena_entry )
+NEW_MEMORY_COUNTER( build_entry )
+NEW_MEMORY_COUNTER( copy_entry )
+NEW_MEMORY_COUNTER( copy_frozen_entry )
+NEW_MEMORY_COUNTER( reuse_entry )
+
+static const size_t MANY_ELEMENT_COUNT = 32;
+
+static struct stumpless_entry *
+build_request_entry( struct stumpless_arena *arena ) {
+  struct stumpless_entry *entry;
+
+  if( arena ) {
+    entry = stumpless_new_arena_entry( arena,
+                                       STUMPLESS_FACILITY_USER,
+                                       STUMPLESS_SEVERITY_INFO,
+                                       "perf-app",
+                                       "perf-msgid",
+                                       "request %d handled",
+                                       42 );
+  } else {
+    entry = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                                 STUMPLESS_SEVERITY_INFO,
+                                 "perf-app",
+                                 "perf-msgid",
+                                 "request %d handled",
+                                 42 );
+  }
+
+  stumpless_add_new_param_to_entry( entry, "request", "method", "GET" );
+  stumpless_add_new_param_to_entry( entry, "request", "path", "/index.html" );
+  stumpless_add_new_param_to_entry( entry, "request", "user-agent",
+                                    "Mozilla/5.0 (X11; Linux x86_64; rv:102.0)"
+                                    " Gecko/20100101 Firefox/102.0" );
+  stumpless_add_new_param_to_entry( entry, "response", "status", "200" );
+  stumpless_add_new_param_to_entry( entry, "response", "bytes", "5120" );
+
+  return entry;
+}
 
 static void AddEntry(benchmark::State& state){
   struct stumpless_entry *entry;
@@ -50,6 +93,100 @@ static void AddEntry(benchmark::State& state){
   SET_STATE_COUNTERS( state, add_entry );
 }
 
+static void AddFrozenEntry(benchmark::State& state){
+  struct stumpless_entry *entry;
+  char buffer[1024];
+  struct stumpless_target *target;
+  int result;
+
+  INIT_MEMORY_COUNTER( add_frozen_entry );
+
+  entry = create_entry(  );
+  stumpless_freeze_entry( entry );
+  target = stumpless_open_buffer_target( "add-frozen-entry-perf",
+                                         buffer,
+                                         sizeof( buffer ) );
+
+  for(auto _ : state){
+    result = stumpless_add_entry( target, entry );
+    if( result <= 0 ) {
+      state.SkipWithError( "could not send an entry to the target" );
+    }
+  }
+
+  stumpless_close_buffer_target( target );
+  stumpless_destroy_entry_and_contents( entry );
+
+  SET_STATE_COUNTERS( state, add_frozen_entry );
+}
+
+static struct stumpless_entry *shared_entry = NULL;
+
+static void AddSharedEntry(benchmark::State& state){
+  char buffer[1024];
+  struct stumpless_target *target;
+  int result;
+
+  if( state.thread_index(  ) == 0 ) {
+    shared_entry = create_entry(  );
+  }
+
+  target = stumpless_open_buffer_target( "add-shared-entry-perf",
+                                         buffer,
+                                         sizeof( buffer ) );
+
+  for(auto _ : state){
+    result = stumpless_add_entry( target, shared_entry );
+    if( result <= 0 ) {
+      state.SkipWithError( "could not send an entry to the target" );
+    }
+  }
+
+  stumpless_close_buffer_target( target );
+
+  if( state.thread_index(  ) == 0 ) {
+    stumpless_destroy_entry_and_contents( shared_entry );
+  }
+}
+
+static void AddManyElements(benchmark::State& state){
+  struct stumpless_entry *entry;
+  struct stumpless_element *elements[MANY_ELEMENT_COUNT];
+  const struct stumpless_entry *result;
+  char name[32];
+  size_t i;
+
+  INIT_MEMORY_COUNTER( add_many_elements );
+
+  entry = create_empty_entry(  );
+  for( i = 0; i < MANY_ELEMENT_COUNT; i++ ) {
+    snprintf( name, sizeof( name ), "element-%zu", i );
+    elements[i] = stumpless_new_element( name );
+  }
+
+  for(auto _ : state){
+    for( i = 0; i < MANY_ELEMENT_COUNT; i++ ) {
+      result = stumpless_add_element( entry, elements[i] );
+      if( !result ) {
+        state.SkipWithError( "could not add an element to the entry" );
+      }
+    }
+
+    // detach the elements so that the next iteration starts from scratch
+    state.PauseTiming(  );
+    stumpless_destroy_entry_only( entry );
+    entry = create_empty_entry(  );
+    state.ResumeTiming(  );
+  }
+
+  stumpless_destroy_entry_only( entry );
+  for( i = 0; i < MANY_ELEMENT_COUNT; i++ ) {
+    stumpless_destroy_element_and_contents( elements[i] );
+  }
+
+  SET_STATE_COUNTERS( state, add_many_elements );
+}
+
 static void AddMessage(benchmark::State& state){
   char buffer[1024];
   struct stumpless_target *target;
@@ -74,5 +211,155 @@ static void AddMessage(benchmark::State& state){
   SET_STATE_COUNTERS( state, add_message );
 }
 
+static void AddMessageStr(benchmark::State& state){
+  char buffer[1024];
+  struct stumpless_target *target;
+  const char *messages[] = {
+    "a short message",
+    "a message that is quite a bit longer than the one before it",
+    "a medium length message"
+  };
+  size_t i = 0;
+  int result;
+
+  INIT_MEMORY_COUNTER( add_message_str );
+
+  target = stumpless_open_buffer_target( "add-message-str-perf",
+                                         buffer,
+                                         sizeof( buffer ) );
+
+  for(auto _ : state){
+    result = stumpless_add_message_str( target, messages[i++ % 3] );
+    if( result <= 0 ) {
+      state.SkipWithError( "could not send a message to the target" );
+    }
+  }
+
+  stumpless_close_buffer_target( target );
+
+  SET_STATE_COUNTERS( state, add_message_str );
+}
+
+static void BuildArenaEntry(benchmark::State& state){
+  struct stumpless_arena *arena;
+  const struct stumpless_entry *entry;
+
+  arena = stumpless_new_arena( 0 );
+
+  INIT_MEMORY_COUNTER( build_arena_entry );
+
+  for(auto _ : state){
+    entry = build_request_entry( arena );
+    if( !entry || stumpless_has_error(  ) ) {
+      state.SkipWithError( "could not build the entry" );
+    }
+
+    stumpless_reset_arena( arena );
+  }
+
+  SET_STATE_COUNTERS( state, build_arena_entry );
+
+  stumpless_destroy_arena( arena );
+}
+
+static void BuildEntry(benchmark::State& state){
+  const struct stumpless_entry *entry;
+
+  INIT_MEMORY_COUNTER( build_entry );
+
+  for(auto _ : state){
+    entry = build_request_entry( NULL );
+    if( !entry || stumpless_has_error(  ) ) {
+      state.SkipWithError( "could not build the entry" );
+    }
+
+    stumpless_destroy_entry_and_contents( entry );
+  }
+
+  SET_STATE_COUNTERS( state, build_entry );
+}
+
+static void CopyEntry(benchmark::State& state){
+  struct stumpless_entry *entry;
+  const struct stumpless_entry *copy;
+
+  INIT_MEMORY_COUNTER( copy_entry );
+
+  entry = create_entry(  );
+
+  for(auto _ : state){
+    copy = stumpless_copy_entry( entry );
+    if( !copy ) {
+      state.SkipWithError( "could not copy the entry" );
+    }
+
+    stumpless_destroy_entry_and_contents( copy );
+  }
+
+  stumpless_destroy_entry_and_contents( entry );
+
+  SET_STATE_COUNTERS( state, copy_entry );
+}
+
+static void CopyFrozenEntry(benchmark::State& state){
+  struct stumpless_entry *entry;
+  const struct stumpless_entry *copy;
+
+  INIT_MEMORY_COUNTER( copy_frozen_entry );
+
+  entry = create_entry(  );
+  stumpless_freeze_entry( entry );
+
+  for(auto _ : state){
+    copy = stumpless_copy_entry( entry );
+    if( !copy ) {
+      state.SkipWithError( "could not copy the entry" );
+    }
+
+    stumpless_destroy_entry_and_contents( copy );
+  }
+
+  stumpless_destroy_entry_and_contents( entry );
+
+  SET_STATE_COUNTERS( state, copy_frozen_entry );
+}
+
+static void ReuseEntry(benchmark::State& state){
+  struct stumpless_entry *entry;
+  const struct stumpless_entry *result;
+  const char *values[] = {
+    "POST",
+    "/api/v1/requests",
+    "Mozilla/5.0 (X11; Linux x86_64; rv:102.0) Gecko/20100101 Firefox/102.0",
+    "201",
+    "2048"
+  };
+
+  entry = build_request_entry( NULL );
+
+  INIT_MEMORY_COUNTER( reuse_entry );
+
+  for(auto _ : state){
+    stumpless_reset_entry( entry );
+    result = stumpless_set_entry_param_values( entry, values, 5 );
+    if( !result ) {
+      state.SkipWithError( "could not set the param values" );
+    }
+  }
+
+  SET_STATE_COUNTERS( state, reuse_entry );
+
+  stumpless_destroy_entry_and_contents( entry );
+}
+
 BENCHMARK( AddEntry );
+BENCHMARK( AddFrozenEntry );
+BENCHMARK( AddManyElements );
+BENCHMARK( AddSharedEntry )->ThreadRange( 1, 8 );
 BENCHMARK( AddMessage );
+BENCHMARK( AddMessageStr );
+BENCHMARK( BuildArenaEntry );
+BENCHMARK( BuildEntry );
+BENCHMARK( CopyEntry );
+BENCHMARK( CopyFrozenEntry );
+BENCHMARK( ReuseEntry );
@@ -17,12 +17,134 @@
  */
 
 #include <benchmark/benchmark.h>
+#include <cstdio>
 #include <stumpless.h>
 #include "test/helper/memory_counter.hpp"
 
 NEW_MEMORY_COUNTER( stump )
 NEW_MEMORY_COUNTER( stumplog )
 
+static const size_t BATCH_SIZE = 100;
+
+static void AddEntriesToFile( benchmark::State& state ) {
+  struct stumpless_target *target;
+  struct stumpless_entry *entries[BATCH_SIZE];
+  const char *filename = "add-entries-perf.log";
+  size_t i;
+
+  target = stumpless_open_file_target( filename );
+  for( i = 0; i < BATCH_SIZE; i++ ) {
+    entries[i] = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                                      STUMPLESS_SEVERITY_INFO,
+                                      "batch-perf",
+                                      "batch-msgid",
+                                      "batch message %zu",
+                                      i );
+  }
+
+  for(auto _ : state){
+    if( stumpless_add_entries( target, entries, BATCH_SIZE ) < 0 ) {
+      state.SkipWithError( "could not send the entries" );
+    }
+  }
+
+  for( i = 0; i < BATCH_SIZE; i++ ) {
+    stumpless_destroy_entry_and_contents( entries[i] );
+  }
+  stumpless_close_file_target( target );
+  stumpless_free_all(  );
+  remove( filename );
+
+  state.SetItemsProcessed( state.iterations(  ) * BATCH_SIZE );
+}
+
+static void AddEntryToFileInLoop( benchmark::State& state ) {
+  struct stumpless_target *target;
+  struct stumpless_entry *entries[BATCH_SIZE];
+  const char *filename = "add-entry-loop-perf.log";
+  size_t i;
+
+  target = stumpless_open_file_target( filename );
+  for( i = 0; i < BATCH_SIZE; i++ ) {
+    entries[i] = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                                      STUMPLESS_SEVERITY_INFO,
+                                      "batch-perf",
+                                      "batch-msgid",
+                                      "batch message %zu",
+                                      i );
+  }
+
+  for(auto _ : state){
+    for( i = 0; i < BATCH_SIZE; i++ ) {
+      if( stumpless_add_entry( target, entries[i] ) < 0 ) {
+        state.SkipWithError( "could not send an entry" );
+      }
+    }
+  }
+
+  for( i = 0; i < BATCH_SIZE; i++ ) {
+    stumpless_destroy_entry_and_contents( entries[i] );
+  }
+  stumpless_close_file_target( target );
+  stumpless_free_all(  );
+  remove( filename );
+
+  state.SetItemsProcessed( state.iterations(  ) * BATCH_SIZE );
+}
+
+static void AddEntryToBufferedFile( benchmark::State& state ) {
+  struct stumpless_target *target;
+  struct stumpless_entry *entry;
+  const char *filename = "add-entry-buffered-perf.log";
+
+  target = stumpless_open_file_target( filename );
+  stumpless_set_file_buffer_size( target, state.range( 0 ) );
+  entry = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                               STUMPLESS_SEVERITY_INFO,
+                               "buffer-perf",
+                               "buffer-msgid",
+                               "buffered message" );
+
+  for(auto _ : state){
+    if( stumpless_add_entry( target, entry ) < 0 ) {
+      state.SkipWithError( "could not send an entry" );
+    }
+  }
+
+  stumpless_destroy_entry_and_contents( entry );
+  stumpless_close_file_target( target );
+  stumpless_free_all(  );
+  remove( filename );
+
+  state.SetItemsProcessed( state.iterations(  ) );
+}
+
+static void AddEntryToRawFile( benchmark::State& state ) {
+  struct stumpless_target *target;
+  struct stumpless_entry *entry;
+  const char *filename = "add-entry-raw-perf.log";
+
+  target = stumpless_open_raw_file_target( filename );
+  entry = stumpless_new_entry( STUMPLESS_FACILITY_USER,
+                               STUMPLESS_SEVERITY_INFO,
+                               "raw-perf",
+                               "raw-msgid",
+                               "raw message" );
+
+  for(auto _ : state){
+    if( stumpless_add_entry( target, entry ) < 0 ) {
+      state.SkipWithError( "could not send an entry" );
+    }
+  }
+
+  stumpless_destroy_entry_and_contents( entry );
+  stumpless_close_file_target( target );
+  stumpless_free_all(  );
+  remove( filename );
+
+  state.SetItemsProcessed( state.iterations(  ) );
+}
+
 static void Stump(benchmark::State& state){
   char buffer[1000];
   struct stumpless_target *target;
@@ -77,5 +199,9 @@ static void Stumplog( benchmark::State& state ) {
   state.counters["MemoryFreed"] = ( double ) stumplog_memory_counter.free_total;
 }
 
+BENCHMARK( AddEntriesToFile );
+BENCHMARK( AddEntryToBufferedFile )->Arg( 0 )->Arg( 256 * 1024 );
+BENCHMARK( AddEntryToFileInLoop );
+BENCHMARK( AddEntryToRawFile );
 BENCHMARK( Stump );
 BENCHMARK( Stumplog );
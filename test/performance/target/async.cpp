@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <stumpless.h>
+#include "test/helper/fixture.hpp"
+
+/*
+ * The memory counters used by the other performance tests are not safe to use
+ * from more than one thread, and the writer thread of an async target frees
+ * memory at the same time the benchmark allocates it, so they are not used
+ * here.
+ */
+
+static const char *log_filename = "async-perf.log";
+
+static int
+stub_log_function( const struct stumpless_target *target,
+                   const struct stumpless_entry *entry ) {
+  return 1;
+}
+
+class AsyncFixture : public::benchmark::Fixture {
+protected:
+  struct stumpless_target *file_target;
+  struct stumpless_target *function_target;
+  struct stumpless_target *async_file_target;
+  struct stumpless_target *async_function_target;
+  struct stumpless_entry *entry;
+
+public:
+  void SetUp( const ::benchmark::State &state ) {
+    file_target = stumpless_open_file_target( log_filename );
+    function_target = stumpless_open_function_target( "async-perf-function",
+                                                      stub_log_function );
+    async_file_target = stumpless_open_async_target( "async-perf-file",
+                                                     file_target,
+                                                     0 );
+    async_function_target = stumpless_open_async_target( "async-perf-func",
+                                                         function_target,
+                                                         0 );
+    entry = create_entry(  );
+  }
+
+  void TearDown( const ::benchmark::State &state ) {
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_close_async_target( async_function_target );
+    stumpless_close_async_target( async_file_target );
+    stumpless_close_function_target( function_target );
+    stumpless_close_file_target( file_target );
+    stumpless_free_all(  );
+    remove( log_filename );
+  }
+};
+
+BENCHMARK_F( AsyncFixture, AddEntryToAsyncFile )( benchmark::State &state ) {
+  for( auto _ : state ) {
+    if( stumpless_add_entry( async_file_target, entry ) < 0 ) {
+      state.SkipWithError( "could not queue an entry" );
+    }
+  }
+
+  stumpless_flush_target( async_file_target );
+}
+
+BENCHMARK_F( AsyncFixture, AddEntryToAsyncFunction )( benchmark::State &state ) {
+  for( auto _ : state ) {
+    if( stumpless_add_entry( async_function_target, entry ) < 0 ) {
+      state.SkipWithError( "could not queue an entry" );
+    }
+  }
+
+  stumpless_flush_target( async_function_target );
+}
+
+BENCHMARK_F( AsyncFixture, AddDeferredMessageToAsyncFile )( benchmark::State &state ) {
+  int result;
+
+  stumpless_set_async_deferred_formatting( async_file_target, true );
+
+  for( auto _ : state ) {
+    result = stumpless_add_message( async_file_target,
+                                    "request %s finished in %d ms (%f%%)",
+                                    "GET /index.html",
+                                    42,
+                                    97.5 );
+    if( result < 0 ) {
+      state.SkipWithError( "could not queue a message" );
+    }
+  }
+
+  stumpless_flush_target( async_file_target );
+}
+
+BENCHMARK_F( AsyncFixture, AddEntryToFile )( benchmark::State &state ) {
+  for( auto _ : state ) {
+    if( stumpless_add_entry( file_target, entry ) <= 0 ) {
+      state.SkipWithError( "could not send an entry" );
+    }
+  }
+}
+
+BENCHMARK_F( AsyncFixture, AddMessageToAsyncFile )( benchmark::State &state ) {
+  int result;
+
+  for( auto _ : state ) {
+    result = stumpless_add_message( async_file_target,
+                                    "request %s finished in %d ms (%f%%)",
+                                    "GET /index.html",
+                                    42,
+                                    97.5 );
+    if( result < 0 ) {
+      state.SkipWithError( "could not queue a message" );
+    }
+  }
+
+  stumpless_flush_target( async_file_target );
+}
+
+BENCHMARK_F( AsyncFixture, FlushAfterEachEntry )( benchmark::State &state ) {
+  for( auto _ : state ) {
+    if( stumpless_add_entry( async_file_target, entry ) < 0 ) {
+      state.SkipWithError( "could not queue an entry" );
+    }
+
+    stumpless_flush_target( async_file_target );
+  }
+}
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stumpless.h>
+#include <thread>
+#include "test/helper/assert.hpp"
+
+/*
+ * Params, elements, and entries are guarded by futex reader-writer locks and
+ * targets by futex mutexes in this build, so these tests exercise the locks
+ * through the public functions that take them.
+ */
+
+namespace {
+  const int THREAD_COUNT = 16;
+  const int ITERATION_COUNT = 1000;
+  const int WRITE_COUNT = 100;
+  const int LOG_BUFFER_SIZE = 1024;
+  const char *long_value = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa";
+  const char *short_value = "bbbbbbbb";
+
+  bool
+  is_whole_value( const char *value ) {
+    return strcmp( value, long_value ) == 0 ||
+           strcmp( value, short_value ) == 0;
+  }
+
+  void
+  read_until_done( const struct stumpless_param *param,
+                   const std::atomic_bool *done,
+                   std::atomic_int *torn_reads ) {
+    const char *value;
+
+    while( !*done ) {
+      value = stumpless_get_param_value( param );
+      if( !value || !is_whole_value( value ) ) {
+        ( *torn_reads )++;
+      }
+
+      free( ( void * ) value );
+    }
+  }
+
+  void
+  write_values( struct stumpless_param *param, std::atomic_int *writes ) {
+    for( int i = 0; i < WRITE_COUNT; i++ ) {
+      stumpless_set_param_value( param, i % 2 == 0 ? short_value : long_value );
+      ( *writes )++;
+    }
+  }
+
+  void
+  write_app_names( struct stumpless_target *target ) {
+    const char *app_name;
+    std::ostringstream app_name_stream;
+
+    app_name_stream << "app-" << std::this_thread::get_id(  );
+    std::string own_app_name( app_name_stream.str(  ) );
+
+    for( int i = 0; i < ITERATION_COUNT; i++ ) {
+      stumpless_set_target_default_app_name( target, own_app_name.c_str(  ) );
+      app_name = stumpless_get_target_default_app_name( target );
+      free( ( void * ) app_name );
+    }
+  }
+
+  TEST( FutexLocksTest, WriterExcludedUnderReaderContention ) {
+    struct stumpless_param *param;
+    std::atomic_bool done( false );
+    std::atomic_int torn_reads( 0 );
+    std::atomic_int writes( 0 );
+    std::thread *reader_threads[THREAD_COUNT];
+    std::thread *writer_threads[2];
+    int i;
+
+    param = stumpless_new_param( "futex-param", short_value );
+    ASSERT_NOT_NULL( param );
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      reader_threads[i] = new std::thread( read_until_done,
+                                           param,
+                                           &done,
+                                           &torn_reads );
+    }
+
+    for( i = 0; i < 2; i++ ) {
+      writer_threads[i] = new std::thread( write_values, param, &writes );
+    }
+
+    for( i = 0; i < 2; i++ ) {
+      writer_threads[i]->join(  );
+      delete writer_threads[i];
+    }
+
+    done = true;
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      reader_threads[i]->join(  );
+      delete reader_threads[i];
+    }
+
+    EXPECT_EQ( torn_reads, 0 );
+    EXPECT_EQ( writes, 2 * WRITE_COUNT );
+    EXPECT_TRUE( is_whole_value( param->value ) );
+
+    stumpless_destroy_param( param );
+    stumpless_free_all(  );
+  }
+
+  TEST( FutexLocksTest, WakeupAfterUnlock ) {
+    char log_buffer[LOG_BUFFER_SIZE];
+    struct stumpless_target *target;
+    const char *app_name;
+    std::thread *threads[THREAD_COUNT];
+    int i;
+
+    target = stumpless_open_buffer_target( "futex-target",
+                                           log_buffer,
+                                           LOG_BUFFER_SIZE );
+    ASSERT_NOT_NULL( target );
+
+    // every thread must be woken after blocking on the mutex to finish
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i] = new std::thread( write_app_names, target );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    app_name = stumpless_get_target_default_app_name( target );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( app_name );
+    EXPECT_EQ( strncmp( app_name, "app-", 4 ), 0 );
+
+    free( ( void * ) app_name );
+    stumpless_close_buffer_target( target );
+    stumpless_free_all(  );
+  }
+
+  TEST( FutexLocksTest, WriterProgressesAgainstContinuousReaders ) {
+    struct stumpless_param *param;
+    std::atomic_bool done( false );
+    std::atomic_int torn_reads( 0 );
+    std::atomic_int writes( 0 );
+    std::thread *reader_threads[THREAD_COUNT];
+    std::thread *writer_thread;
+    std::chrono::steady_clock::time_point deadline;
+    int i;
+
+    param = stumpless_new_param( "futex-param", short_value );
+    ASSERT_NOT_NULL( param );
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      reader_threads[i] = new std::thread( read_until_done,
+                                           param,
+                                           &done,
+                                           &torn_reads );
+    }
+
+    writer_thread = new std::thread( write_values, param, &writes );
+
+    // the readers keep going until the writer is finished or the time is up
+    deadline = std::chrono::steady_clock::now(  ) + std::chrono::seconds( 30 );
+    while( writes < WRITE_COUNT &&
+           std::chrono::steady_clock::now(  ) < deadline ) {
+      std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+
+    EXPECT_EQ( writes, WRITE_COUNT );
+
+    done = true;
+    writer_thread->join(  );
+    delete writer_thread;
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      reader_threads[i]->join(  );
+      delete reader_threads[i];
+    }
+
+    EXPECT_EQ( torn_reads, 0 );
+
+    stumpless_destroy_param( param );
+    stumpless_free_all(  );
+  }
+}
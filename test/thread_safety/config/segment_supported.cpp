@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2020-2021 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <stumpless.h>
+#include <thread>
+#include "test/helper/assert.hpp"
+#include "test/helper/rfc5424.hpp"
+#include "test/helper/usage.hpp"
+
+namespace {
+  const int THREAD_COUNT = 16;
+  const int MESSAGE_COUNT = 100;
+
+  TEST( SegmentWriteConsistency, SimultaneousWrites ) {
+    const char *name = "segment_file_target_thread_safety.log";
+    struct stumpless_target *target;
+    size_t i;
+    size_t segment_number;
+    std::thread *threads[THREAD_COUNT];
+    std::string segment_name;
+
+    for( segment_number = 1; segment_number < 100; segment_number++ ) {
+      segment_name = std::string( name ) + "." +
+                     std::to_string( segment_number );
+      remove( segment_name.c_str(  ) );
+    }
+
+    // small segments make the threads roll them while others are writing
+    target = stumpless_open_segment_file_target( name, 4096 );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i] = new std::thread( add_messages, target, MESSAGE_COUNT );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    // cleanup after the test
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+
+    stumpless_free_all(  );
+
+    // check for consistency in the segment files
+    i = 0;
+    for( segment_number = 1; ; segment_number++ ) {
+      segment_name = std::string( name ) + "." +
+                     std::to_string( segment_number );
+      std::ifstream segment( segment_name );
+      if( !segment.is_open(  ) ) {
+        break;
+      }
+
+      std::string line;
+      while( std::getline( segment, line ) ) {
+        TestRFC5424Compliance( line.c_str() );
+        i++;
+      }
+
+      segment.close(  );
+      remove( segment_name.c_str(  ) );
+    }
+    EXPECT_EQ( i, THREAD_COUNT * MESSAGE_COUNT );
+  }
+}
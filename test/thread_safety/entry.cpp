@@ -92,6 +92,25 @@ namespace {
     }
   }
 
+  void
+  send_frozen_entry( const struct stumpless_entry *entry ) {
+    char buffer[1024];
+    struct stumpless_target *target;
+
+    target = stumpless_open_buffer_target( "frozen-entry-target",
+                                           buffer,
+                                           sizeof( buffer ) );
+
+    for( int i = 0; i < ITERATION_COUNT; i++ ) {
+      stumpless_add_entry( target, entry );
+      stumpless_get_entry_severity( entry );
+      stumpless_get_element_by_name( entry, "frozen-element" );
+    }
+
+    stumpless_close_buffer_target( target );
+    stumpless_free_thread(  );
+  }
+
   void
   write_entry( struct stumpless_entry *entry ) {
     std::thread::id thread_id = std::this_thread::get_id(  );
@@ -181,4 +200,70 @@ namespace {
     stumpless_destroy_entry_and_contents( entry );
     stumpless_free_all(  );
   }
+
+  TEST( EntryConsistency, SimultaneousFrozenReads ) {
+    struct stumpless_entry *entry;
+    size_t i;
+    std::thread *threads[THREAD_COUNT];
+
+    entry = create_entry(  );
+    ASSERT_NOT_NULL( entry );
+    stumpless_add_new_param_to_entry( entry,
+                                      "frozen-element",
+                                      "frozen-param",
+                                      "frozen-value" );
+    EXPECT_NO_ERROR;
+
+    stumpless_freeze_entry( entry );
+    EXPECT_NO_ERROR;
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i] = new std::thread( send_frozen_entry, entry );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    // a frozen entry must not have been changed by the readers
+    EXPECT_TRUE( entry->frozen );
+    EXPECT_EQ( stumpless_get_element_count( entry ), 2 );
+
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_free_all(  );
+  }
+
+  TEST( EntryConsistency, SimultaneousReadsAndFreeze ) {
+    struct stumpless_entry *entry;
+    size_t i;
+    std::thread *threads[THREAD_COUNT];
+
+    entry = create_entry(  );
+    ASSERT_NOT_NULL( entry );
+    stumpless_add_new_param_to_entry( entry,
+                                      "frozen-element",
+                                      "frozen-param",
+                                      "frozen-value" );
+    EXPECT_NO_ERROR;
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i] = new std::thread( send_frozen_entry, entry );
+    }
+
+    // readers that locked the entry before it was frozen must still unlock it
+    stumpless_freeze_entry( entry );
+    EXPECT_NO_ERROR;
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    EXPECT_TRUE( entry->frozen );
+    EXPECT_EQ( stumpless_get_element_count( entry ), 2 );
+
+    stumpless_destroy_entry_and_contents( entry );
+    stumpless_free_all(  );
+  }
 }
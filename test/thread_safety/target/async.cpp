@@ -0,0 +1,242 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Copyright 2022 Joel E. Anderson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stumpless.h>
+#include <thread>
+#include "test/helper/assert.hpp"
+#include "test/helper/rfc5424.hpp"
+#include "test/helper/usage.hpp"
+
+namespace {
+  const int THREAD_COUNT = 16;
+  const int MESSAGE_COUNT = 1000;
+  const int STREAM_MESSAGE_COUNT = 100;
+  const size_t QUEUE_SIZE = 16;
+  std::atomic_int call_count;
+  std::atomic_bool writers_done;
+
+  int
+  atomic_increment_func( const struct stumpless_target *target,
+                         const struct stumpless_entry *entry ) {
+    return call_count++;
+  }
+
+  void
+  flush_and_check_depth( struct stumpless_target *target ) {
+    size_t depth;
+
+    while( !writers_done ) {
+      stumpless_flush_target( target );
+      EXPECT_NO_ERROR;
+
+      depth = stumpless_get_async_queue_depth( target );
+      EXPECT_NO_ERROR;
+      EXPECT_LE( depth, QUEUE_SIZE );
+    }
+
+    stumpless_free_thread(  );
+  }
+
+  void
+  test_drop_policy( enum stumpless_async_overflow_policy policy ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    size_t i;
+    std::thread *writer_threads[THREAD_COUNT];
+    std::thread *flush_thread;
+    size_t drop_count;
+
+    wrapped = stumpless_open_function_target( "thread-safety-test-drop-func",
+                                              atomic_increment_func );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( wrapped );
+
+    target = stumpless_open_async_target( "thread-safety-test-drop",
+                                          wrapped,
+                                          QUEUE_SIZE );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+
+    stumpless_set_async_overflow_policy( target, policy );
+    EXPECT_NO_ERROR;
+
+    call_count = 0;
+    writers_done = false;
+    flush_thread = new std::thread( flush_and_check_depth, target );
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      writer_threads[i] = new std::thread( add_messages, target, MESSAGE_COUNT );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      writer_threads[i]->join(  );
+      delete writer_threads[i];
+    }
+
+    writers_done = true;
+    flush_thread->join(  );
+    delete flush_thread;
+
+    // every message is either sent or counted as dropped, but never both
+    stumpless_flush_target( target );
+    drop_count = stumpless_get_async_total_drop_count( target );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( call_count + drop_count, THREAD_COUNT * MESSAGE_COUNT );
+
+    stumpless_close_async_target( target );
+    EXPECT_NO_ERROR;
+
+    stumpless_close_function_target( wrapped );
+    EXPECT_NO_ERROR;
+
+    stumpless_free_all(  );
+  }
+
+  TEST( AsyncTargetConsistency, SimultaneousWritesDroppingNewest ) {
+    test_drop_policy( STUMPLESS_ASYNC_OVERFLOW_DROP_NEWEST );
+  }
+
+  TEST( AsyncTargetConsistency, SimultaneousWritesDroppingOldest ) {
+    test_drop_policy( STUMPLESS_ASYNC_OVERFLOW_DROP_OLDEST );
+  }
+
+  TEST( AsyncTargetConsistency, SimultaneousWritesDroppingLowestSeverity ) {
+    test_drop_policy( STUMPLESS_ASYNC_OVERFLOW_DROP_LOWEST_SEVERITY );
+  }
+
+  TEST( AsyncTargetConsistency, SimultaneousWritesAndFlushes ) {
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    size_t i;
+    std::thread *writer_threads[THREAD_COUNT];
+    std::thread *flush_thread;
+
+    // set up the target to log to
+    wrapped = stumpless_open_function_target( "thread-safety-test-async-func",
+                                              atomic_increment_func );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( wrapped );
+
+    // a small queue makes the writers wait on the writer thread often
+    target = stumpless_open_async_target( "thread-safety-test-async",
+                                          wrapped,
+                                          QUEUE_SIZE );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+
+    call_count = 0;
+    writers_done = false;
+    flush_thread = new std::thread( flush_and_check_depth, target );
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      writer_threads[i] = new std::thread( add_messages, target, MESSAGE_COUNT );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      writer_threads[i]->join(  );
+      delete writer_threads[i];
+    }
+
+    writers_done = true;
+    flush_thread->join(  );
+    delete flush_thread;
+
+    stumpless_flush_target( target );
+    EXPECT_EQ( call_count, THREAD_COUNT * MESSAGE_COUNT );
+
+    // cleanup after the test
+    stumpless_close_async_target( target );
+    EXPECT_NO_ERROR;
+
+    stumpless_close_function_target( wrapped );
+    EXPECT_NO_ERROR;
+
+    stumpless_free_all(  );
+  }
+
+  void
+  test_stream_writes( const char *filename, bool deferred ) {
+    FILE *log_stream;
+    struct stumpless_target *wrapped;
+    struct stumpless_target *target;
+    size_t i;
+    std::thread *threads[THREAD_COUNT];
+
+    log_stream = fopen( filename, "w+" );
+    ASSERT_NOT_NULL( log_stream );
+
+    // set up the target to log to
+    wrapped = stumpless_open_stream_target( filename, log_stream );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( wrapped );
+
+    target = stumpless_open_async_target( "thread-safety-test-async-stream",
+                                          wrapped,
+                                          QUEUE_SIZE );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+
+    stumpless_set_async_deferred_formatting( target, deferred );
+    EXPECT_NO_ERROR;
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i] = new std::thread( add_messages,
+                                    target,
+                                    STREAM_MESSAGE_COUNT );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    // cleanup after the test, which sends everything left in the queue
+    stumpless_close_async_target( target );
+    EXPECT_NO_ERROR;
+
+    stumpless_close_stream_target( wrapped );
+    fclose( log_stream );
+    EXPECT_NO_ERROR;
+
+    stumpless_free_all(  );
+
+    // check for consistency in the log file
+    std::ifstream log_file( filename );
+    std::string line;
+    i = 0;
+    while( std::getline( log_file, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      i++;
+    }
+    EXPECT_EQ( i, THREAD_COUNT * STREAM_MESSAGE_COUNT );
+
+    remove( filename );
+  }
+
+  TEST( AsyncTargetConsistency, SimultaneousDeferredWritesToStream ) {
+    // the small queue also uses up the pool, so some logs are allocated
+    test_stream_writes( "async_target_deferred_thread_safety.log", true );
+  }
+
+  TEST( AsyncTargetConsistency, SimultaneousWritesToStream ) {
+    test_stream_writes( "async_target_thread_safety.log", false );
+  }
+}
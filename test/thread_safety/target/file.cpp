@@ -19,6 +19,8 @@
 #include <cstddef>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <map>
+#include <string>
 #include <stumpless.h>
 #include <thread>
 #include "test/helper/assert.hpp"
@@ -29,6 +31,286 @@ namespace {
   const int THREAD_COUNT = 16;
   const int MESSAGE_COUNT = 100;
 
+  /*
+   * Reads the records of a shard into a map from their sequence numbers to
+   * their messages, checking that the sequence numbers only increase.
+   */
+  void
+  read_shard( const std::string &shard,
+              std::map<unsigned long long, std::string> &records ) {
+    std::ifstream shard_file( shard, std::ios::binary );
+    unsigned long long sequence;
+    unsigned long long length;
+    unsigned long long previous = 0;
+    std::string message;
+
+    while( shard_file >> sequence >> length ) {
+      shard_file.get(  );
+      message.resize( length );
+      shard_file.read( &message[0], length );
+
+      EXPECT_GT( sequence, previous );
+      previous = sequence;
+      records[sequence] = message;
+    }
+  }
+
+  TEST( FileWriteConsistency, SimultaneousBufferedWrites ) {
+    const char *filename = "file_target_buffered_thread_safety.log";
+    struct stumpless_target *target;
+    size_t i;
+    std::thread *threads[THREAD_COUNT];
+
+    remove( filename );
+
+    // set up the target to log to, with a buffer small enough to fill often
+    target = stumpless_open_file_target( filename );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+    stumpless_set_file_buffer_size( target, 4096 );
+    EXPECT_NO_ERROR;
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i] = new std::thread( add_messages, target, MESSAGE_COUNT );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    // cleanup after the test
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+
+    stumpless_free_all(  );
+
+    // check for consistency in the log file
+    std::ifstream log_file( filename );
+    std::string line;
+    i = 0;
+    while( std::getline( log_file, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      i++;
+    }
+    EXPECT_EQ( i, THREAD_COUNT * MESSAGE_COUNT );
+
+    remove( filename );
+  }
+
+  TEST( FileWriteConsistency, SimultaneousGroupCommitWrites ) {
+    const char *filename = "file_target_group_commit_thread_safety.log";
+    struct stumpless_target *target;
+    size_t i;
+    std::thread *threads[THREAD_COUNT];
+
+    remove( filename );
+
+    // set up the target so that threads share synchronizations of the file
+    target = stumpless_open_file_target( filename );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+    stumpless_set_file_buffer_size( target, 4096 );
+    EXPECT_NO_ERROR;
+    stumpless_set_file_durability( target,
+                                   STUMPLESS_FILE_DURABILITY_GROUP_COMMIT,
+                                   0 );
+    EXPECT_NO_ERROR;
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i] = new std::thread( add_messages, target, MESSAGE_COUNT );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    // cleanup after the test
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+
+    stumpless_free_all(  );
+
+    // check for consistency in the log file
+    std::ifstream log_file( filename );
+    std::string line;
+    i = 0;
+    while( std::getline( log_file, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      i++;
+    }
+    EXPECT_EQ( i, THREAD_COUNT * MESSAGE_COUNT );
+
+    remove( filename );
+  }
+
+  TEST( FileWriteConsistency, SimultaneousRawWrites ) {
+    const char *filename = "raw_file_target_thread_safety.log";
+    struct stumpless_target *target;
+    size_t i;
+    std::thread *threads[THREAD_COUNT];
+
+    remove( filename );
+
+    // set up the target to log to, without any locking for these messages
+    target = stumpless_open_raw_file_target( filename );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i] = new std::thread( add_messages, target, MESSAGE_COUNT );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    // cleanup after the test
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+
+    stumpless_free_all(  );
+
+    // check for consistency in the log file
+    std::ifstream log_file( filename );
+    std::string line;
+    i = 0;
+    while( std::getline( log_file, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      i++;
+    }
+    EXPECT_EQ( i, THREAD_COUNT * MESSAGE_COUNT );
+
+    remove( filename );
+  }
+
+  TEST( FileWriteConsistency, SimultaneousRotatedRawWrites ) {
+    const char *filename = "rotated_file_target_thread_safety.log";
+    const unsigned int keep = 64;
+    std::string rotated;
+    struct stumpless_target *target;
+    size_t i;
+    std::thread *threads[THREAD_COUNT];
+
+    remove( filename );
+    for( i = 1; i <= keep; i++ ) {
+      rotated = std::string( filename ) + "." + std::to_string( i );
+      remove( rotated.c_str(  ) );
+    }
+
+    // set up the target to rotate many times, keeping every file
+    target = stumpless_open_raw_file_target( filename );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+    stumpless_set_file_rotation( target, 16 * 1024, 0, keep );
+    EXPECT_NO_ERROR;
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i] = new std::thread( add_messages, target, MESSAGE_COUNT );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    // cleanup after the test
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+
+    stumpless_free_all(  );
+
+    // check that every message is in exactly one of the files
+    size_t line_count = 0;
+    std::string line;
+    for( i = 0; i <= keep; i++ ) {
+      rotated = std::string( filename );
+      if( i > 0 ) {
+        rotated += "." + std::to_string( i );
+      }
+
+      std::ifstream log_file( rotated );
+      while( std::getline( log_file, line ) ) {
+        TestRFC5424Compliance( line.c_str() );
+        line_count++;
+      }
+
+      remove( rotated.c_str(  ) );
+    }
+    EXPECT_EQ( line_count, THREAD_COUNT * MESSAGE_COUNT );
+  }
+
+  TEST( FileWriteConsistency, SimultaneousShardedWrites ) {
+    const char *filename = "sharded_file_target_thread_safety.log";
+    const char *merged = "sharded_file_target_thread_safety_merged.log";
+    const unsigned int shard_count = THREAD_COUNT / 2;
+    std::string shard;
+    struct stumpless_target *target;
+    size_t i;
+    std::thread *threads[THREAD_COUNT];
+    int merge_result;
+
+    remove( merged );
+    for( i = 0; i < shard_count; i++ ) {
+      shard = std::string( filename ) + ".shard" + std::to_string( i );
+      remove( shard.c_str(  ) );
+    }
+
+    // set up the target with fewer shards than threads, so that some share
+    target = stumpless_open_sharded_file_target( filename, shard_count );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i] = new std::thread( add_messages, target, MESSAGE_COUNT );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    // cleanup after the test
+    stumpless_close_file_target( target );
+    EXPECT_NO_ERROR;
+
+    merge_result = stumpless_merge_file_shards( filename, shard_count, merged );
+    EXPECT_NO_ERROR;
+    EXPECT_EQ( merge_result, THREAD_COUNT * MESSAGE_COUNT );
+
+    stumpless_free_all(  );
+
+    // check that each shard is in sequence order, even those that were shared
+    std::map<unsigned long long, std::string> records;
+    for( i = 0; i < shard_count; i++ ) {
+      shard = std::string( filename ) + ".shard" + std::to_string( i );
+      read_shard( shard, records );
+    }
+    EXPECT_EQ( records.size(  ), THREAD_COUNT * MESSAGE_COUNT );
+
+    // check that the merged file has every message in sequence order
+    std::ifstream log_file( merged );
+    std::string line;
+    auto record = records.begin(  );
+    i = 0;
+    while( std::getline( log_file, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      ASSERT_NE( record, records.end(  ) );
+      EXPECT_EQ( line + "\n", record->second );
+      record++;
+      i++;
+    }
+    EXPECT_EQ( i, THREAD_COUNT * MESSAGE_COUNT );
+
+    remove( merged );
+    for( i = 0; i < shard_count; i++ ) {
+      shard = std::string( filename ) + ".shard" + std::to_string( i );
+      remove( shard.c_str(  ) );
+    }
+  }
+
   TEST( FileWriteConsistency, SimultaneousWrites ) {
     const char *filename = "file_target_thread_safety.log";
     struct stumpless_target *target;
@@ -30,6 +30,55 @@ namespace {
   const int THREAD_COUNT = 16;
   const int MESSAGE_COUNT = 100;
 
+  TEST( StreamWriteConsistency, SimultaneousBufferedWrites ) {
+    const char *filename = "buffered_stream_target_thread_safety.log";
+    FILE *log_stream;
+    struct stumpless_target *target;
+    size_t i;
+    std::thread *threads[THREAD_COUNT];
+
+    log_stream = fopen( filename, "w+" );
+    ASSERT_NOT_NULL( log_stream );
+
+    // a small buffer so that batches are written while other threads log
+    target = stumpless_open_stream_target( filename, log_stream );
+    EXPECT_NO_ERROR;
+    ASSERT_NOT_NULL( target );
+    stumpless_set_stream_buffering( target,
+                                    STUMPLESS_STREAM_BUFFERING_FULL,
+                                    1024 );
+    stumpless_set_stream_flush_interval( target, 1 );
+    EXPECT_NO_ERROR;
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i] = new std::thread( add_messages, target, MESSAGE_COUNT );
+    }
+
+    for( i = 0; i < THREAD_COUNT; i++ ) {
+      threads[i]->join(  );
+      delete threads[i];
+    }
+
+    // cleanup after the test
+    stumpless_close_stream_target( target );
+    fclose( log_stream );
+    EXPECT_NO_ERROR;
+
+    stumpless_free_all(  );
+
+    // check for consistency in the log file
+    std::ifstream log_file( filename );
+    std::string line;
+    i = 0;
+    while( std::getline( log_file, line ) ) {
+      TestRFC5424Compliance( line.c_str() );
+      i++;
+    }
+    EXPECT_EQ( i, THREAD_COUNT * MESSAGE_COUNT );
+
+    remove( filename );
+  }
+
   TEST( StreamWriteConsistency, SimultaneousWrites ) {
     const char *filename = "stream_target_thread_safety.log";
     FILE *log_stream;